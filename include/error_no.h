@@ -15,6 +15,7 @@ constexpr int32_t OpenDirFailed = 105;
 constexpr int32_t CreateFileFailed = 106;
 constexpr int32_t CreateDirFailed = 107;
 constexpr int32_t ParseDataFialed = 108;
+constexpr int32_t ParseCanceled = 109;
 
 }
 
@@ -0,0 +1,582 @@
+#ifndef __JSON_BIND_H_
+#define __JSON_BIND_H_
+
+#include <os_common.h>
+#include <error_no.h>
+#include <json_obj.h>
+#include <json_handler.h>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    // the number and string forms of GetJsonStr, written to lpOut, which
+    // returns the end of the output. Numbers take at most 25 bytes, a NaN
+    // or an infinity being written as null, and a string, quotes included,
+    // at most uLen * 6 + 2
+    EXPORT char *FormatJsonInt(int64_t nValue, char *lpOut);
+    EXPORT char *FormatJsonUInt(uint64_t uValue, char *lpOut);
+    EXPORT char *FormatJsonDouble(double dValue, char *lpOut);
+    EXPORT char *FormatJsonString(const char *lpStr, uint64_t uLen, char *lpOut);
+#ifdef __cplusplus
+}
+#endif
+
+/*
+ * Binds the listed members of a struct to the keys of the same names:
+ *
+ *   struct Order { int64_t id; double price; std::vector<Fill> fills; };
+ *   CPPBASE_JSON_FIELDS(Order, id, price, fills)
+ *
+ * after which ParseJsonStruct fills an Order from json and WriteJsonStruct
+ * writes one out, neither of them building a document. The macro goes
+ * where Order is declared, at namespace scope, up to 32 members of types
+ * bool, integers, floating point, std::string, bound structs and vectors
+ * of any of these but bool. Each key read is hashed once and switched on
+ * over the hashes of the member names computed at compile time.
+ */
+#define CPPBASE_JSON_FIELDS(Type, ...)                                                                     \
+    inline bool JsonBindKey(Type &stValue, uint64_t uHash, const char *lpKey, uint32_t uLen,                \
+                            ::cppbase::JsonBindTarget *lpTarget)                                            \
+    {                                                                                                       \
+        switch (uHash)                                                                                      \
+        {                                                                                                   \
+            CPPBASE_JSON_EACH(CPPBASE_JSON_FIELD_CASE, __VA_ARGS__)                                         \
+        }                                                                                                   \
+        return false;                                                                                       \
+    }                                                                                                       \
+    inline void JsonBindReset(Type &stValue, const Type &stDefault)                                         \
+    {                                                                                                       \
+        CPPBASE_JSON_EACH(CPPBASE_JSON_FIELD_RESET, __VA_ARGS__)                                            \
+    }                                                                                                       \
+    inline void JsonBindWrite(const Type &stValue, ::cppbase::CJsonBindWriter &writer)                      \
+    {                                                                                                       \
+        auto uStart = writer.GetSize();                                                                     \
+        CPPBASE_JSON_EACH(CPPBASE_JSON_FIELD_WRITE, __VA_ARGS__)                                            \
+        writer.EndFields(uStart);                                                                           \
+    }
+
+#define CPPBASE_JSON_FIELD_CASE(field)                                                                     \
+    case ::cppbase::IJsonObj::Key::ConstHash(#field, sizeof(#field) - 1):                                  \
+        return ::cppbase::JsonBindMember(stValue.field, #field, lpKey, uLen, lpTarget);
+
+#define CPPBASE_JSON_FIELD_RESET(field)                                                                    \
+    ::cppbase::JsonBindValue<decltype(stValue.field)>::Reset(stValue.field, stDefault.field);
+
+#define CPPBASE_JSON_FIELD_WRITE(field)                                                                    \
+    ::cppbase::JsonBindWriteMember(writer, ",\"" #field "\":", stValue.field);
+
+#define CPPBASE_JSON_CONCAT(a, b) CPPBASE_JSON_CONCAT_(a, b)
+#define CPPBASE_JSON_CONCAT_(a, b) a##b
+#define CPPBASE_JSON_COUNT(...)                                                                            \
+    CPPBASE_JSON_COUNT_(__VA_ARGS__, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, \
+                        13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)
+#define CPPBASE_JSON_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, \
+                            _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, N, ...)  \
+    N
+#define CPPBASE_JSON_EACH(m, ...)                                                                          \
+    CPPBASE_JSON_CONCAT(CPPBASE_JSON_EACH_, CPPBASE_JSON_COUNT(__VA_ARGS__))(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_1(m, x) m(x)
+#define CPPBASE_JSON_EACH_2(m, x, ...) m(x) CPPBASE_JSON_EACH_1(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_3(m, x, ...) m(x) CPPBASE_JSON_EACH_2(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_4(m, x, ...) m(x) CPPBASE_JSON_EACH_3(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_5(m, x, ...) m(x) CPPBASE_JSON_EACH_4(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_6(m, x, ...) m(x) CPPBASE_JSON_EACH_5(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_7(m, x, ...) m(x) CPPBASE_JSON_EACH_6(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_8(m, x, ...) m(x) CPPBASE_JSON_EACH_7(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_9(m, x, ...) m(x) CPPBASE_JSON_EACH_8(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_10(m, x, ...) m(x) CPPBASE_JSON_EACH_9(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_11(m, x, ...) m(x) CPPBASE_JSON_EACH_10(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_12(m, x, ...) m(x) CPPBASE_JSON_EACH_11(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_13(m, x, ...) m(x) CPPBASE_JSON_EACH_12(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_14(m, x, ...) m(x) CPPBASE_JSON_EACH_13(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_15(m, x, ...) m(x) CPPBASE_JSON_EACH_14(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_16(m, x, ...) m(x) CPPBASE_JSON_EACH_15(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_17(m, x, ...) m(x) CPPBASE_JSON_EACH_16(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_18(m, x, ...) m(x) CPPBASE_JSON_EACH_17(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_19(m, x, ...) m(x) CPPBASE_JSON_EACH_18(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_20(m, x, ...) m(x) CPPBASE_JSON_EACH_19(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_21(m, x, ...) m(x) CPPBASE_JSON_EACH_20(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_22(m, x, ...) m(x) CPPBASE_JSON_EACH_21(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_23(m, x, ...) m(x) CPPBASE_JSON_EACH_22(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_24(m, x, ...) m(x) CPPBASE_JSON_EACH_23(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_25(m, x, ...) m(x) CPPBASE_JSON_EACH_24(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_26(m, x, ...) m(x) CPPBASE_JSON_EACH_25(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_27(m, x, ...) m(x) CPPBASE_JSON_EACH_26(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_28(m, x, ...) m(x) CPPBASE_JSON_EACH_27(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_29(m, x, ...) m(x) CPPBASE_JSON_EACH_28(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_30(m, x, ...) m(x) CPPBASE_JSON_EACH_29(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_31(m, x, ...) m(x) CPPBASE_JSON_EACH_30(m, __VA_ARGS__)
+#define CPPBASE_JSON_EACH_32(m, x, ...) m(x) CPPBASE_JSON_EACH_31(m, __VA_ARGS__)
+
+namespace cppbase
+{
+
+struct JsonBindOps;
+
+// what the next value read goes to, lpOps being nullptr for a value that
+// is skipped
+struct JsonBindTarget
+{
+    void *lpValue;
+    const JsonBindOps *lpOps;
+};
+
+// how a bound type takes the events of the parser; nullptr for the events
+// that do not fit it, which fail the parse
+struct JsonBindOps
+{
+    bool (*lpOnBool)(void *lpValue, bool bValue);
+    bool (*lpOnInt)(void *lpValue, int64_t nValue);
+    bool (*lpOnDouble)(void *lpValue, double dValue);
+    bool (*lpOnString)(void *lpValue, const char *lpStr, uint32_t uLen);
+    // objects: sets *lpTarget to the member of the key, or its lpOps to
+    // nullptr when there is none
+    void (*lpOnKey)(void *lpValue, const char *lpKey, uint32_t uLen, JsonBindTarget *lpTarget);
+    // arrays: sets *lpTarget to element uIndex, and keeps uCount of them
+    // at the ']'
+    void (*lpOnElement)(void *lpValue, uint32_t uIndex, JsonBindTarget *lpTarget);
+    void (*lpOnEndArray)(void *lpValue, uint32_t uCount);
+};
+
+// Output of WriteJsonStruct, appended to a string whose capacity is kept.
+class CJsonBindWriter
+{
+public:
+    static constexpr uint32_t MaxNumberChars = 25;
+
+    explicit CJsonBindWriter(std::string &strOut) : m_strOut(strOut) {}
+
+    inline uint64_t GetSize() const { return m_strOut.size(); }
+
+    inline void WriteRaw(const char *lpData, uint64_t uLen) { m_strOut.append(lpData, uLen); }
+    inline void WriteChar(char ch) { m_strOut.push_back(ch); }
+    inline void WriteBool(bool bValue) { bValue ? m_strOut.append("true", 4) : m_strOut.append("false", 5); }
+
+    inline void WriteInt(int64_t nValue)
+    {
+        char szNumber[MaxNumberChars];
+        m_strOut.append(szNumber, FormatJsonInt(nValue, szNumber) - szNumber);
+    }
+
+    inline void WriteUInt(uint64_t uValue)
+    {
+        char szNumber[MaxNumberChars];
+        m_strOut.append(szNumber, FormatJsonUInt(uValue, szNumber) - szNumber);
+    }
+
+    inline void WriteDouble(double dValue)
+    {
+        char szNumber[MaxNumberChars];
+        m_strOut.append(szNumber, FormatJsonDouble(dValue, szNumber) - szNumber);
+    }
+
+    inline void WriteString(const char *lpStr, uint64_t uLen)
+    {
+        auto uSize = m_strOut.size();
+        m_strOut.resize(uSize + uLen * 6 + 2);
+        auto lpOut = &m_strOut[uSize];
+        m_strOut.resize(uSize + (FormatJsonString(lpStr, uLen, lpOut) - lpOut));
+    }
+
+    // every member is written after a ',', the first of which becomes the
+    // '{'; uStart is GetSize() before the first member
+    inline void EndFields(uint64_t uStart)
+    {
+        m_strOut[uStart] = '{';
+        m_strOut.push_back('}');
+    }
+
+private:
+    std::string &m_strOut;
+};
+
+// Binding of a type: GetOps for reading and Write for writing. This one
+// is for the structs of CPPBASE_JSON_FIELDS, through the functions the
+// macro declares beside them.
+template <typename T, typename Enable = void>
+struct JsonBindValue
+{
+    static void OnKey(void *lpValue, const char *lpKey, uint32_t uLen, JsonBindTarget *lpTarget)
+    {
+        auto uHash = IJsonObj::Key::Hash(lpKey, uLen);
+        if (!JsonBindKey(*static_cast<T *>(lpValue), uHash, lpKey, uLen, lpTarget))
+        {
+            lpTarget->lpOps = nullptr;
+        }
+    }
+
+    static const JsonBindOps *GetOps()
+    {
+        static const JsonBindOps stOps = {nullptr, nullptr, nullptr, nullptr, OnKey, nullptr, nullptr};
+        return &stOps;
+    }
+
+    static void Reset(T &stValue, const T &stDefault) { JsonBindReset(stValue, stDefault); }
+
+    static void Write(CJsonBindWriter &writer, const T &stValue) { JsonBindWrite(stValue, writer); }
+};
+
+template <>
+struct JsonBindValue<bool>
+{
+    static bool OnBool(void *lpValue, bool bValue)
+    {
+        *static_cast<bool *>(lpValue) = bValue;
+        return true;
+    }
+
+    static const JsonBindOps *GetOps()
+    {
+        static const JsonBindOps stOps = {OnBool, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+        return &stOps;
+    }
+
+    static void Reset(bool &bValue, bool bDefault) { bValue = bDefault; }
+
+    static void Write(CJsonBindWriter &writer, bool bValue) { writer.WriteBool(bValue); }
+};
+
+// integers fail the parse when the number does not fit them
+template <typename T>
+struct JsonBindValue<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+{
+    static bool OnInt(void *lpValue, int64_t nValue)
+    {
+        if (std::is_signed<T>::value ? nValue < int64_t(std::numeric_limits<T>::min()) ||
+                                           nValue > int64_t(std::numeric_limits<T>::max())
+                                     : nValue < 0 || uint64_t(nValue) > uint64_t(std::numeric_limits<T>::max()))
+        {
+            return false;
+        }
+
+        *static_cast<T *>(lpValue) = T(nValue);
+        return true;
+    }
+
+    static const JsonBindOps *GetOps()
+    {
+        static const JsonBindOps stOps = {nullptr, OnInt, nullptr, nullptr, nullptr, nullptr, nullptr};
+        return &stOps;
+    }
+
+    static void Reset(T &value, T defaultValue) { value = defaultValue; }
+
+    static void Write(CJsonBindWriter &writer, T value)
+    {
+        std::is_signed<T>::value ? writer.WriteInt(int64_t(value)) : writer.WriteUInt(uint64_t(value));
+    }
+};
+
+// floating point takes integers as well
+template <typename T>
+struct JsonBindValue<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+    static bool OnInt(void *lpValue, int64_t nValue)
+    {
+        *static_cast<T *>(lpValue) = T(nValue);
+        return true;
+    }
+
+    static bool OnDouble(void *lpValue, double dValue)
+    {
+        *static_cast<T *>(lpValue) = T(dValue);
+        return true;
+    }
+
+    static const JsonBindOps *GetOps()
+    {
+        static const JsonBindOps stOps = {nullptr, OnInt, OnDouble, nullptr, nullptr, nullptr, nullptr};
+        return &stOps;
+    }
+
+    static void Reset(T &value, T defaultValue) { value = defaultValue; }
+
+    static void Write(CJsonBindWriter &writer, T value) { writer.WriteDouble(double(value)); }
+};
+
+template <>
+struct JsonBindValue<std::string>
+{
+    static bool OnString(void *lpValue, const char *lpStr, uint32_t uLen)
+    {
+        static_cast<std::string *>(lpValue)->assign(lpStr, uLen);
+        return true;
+    }
+
+    static const JsonBindOps *GetOps()
+    {
+        static const JsonBindOps stOps = {nullptr, nullptr, nullptr, OnString, nullptr, nullptr, nullptr};
+        return &stOps;
+    }
+
+    // assigned rather than replaced, so that the buffer is kept
+    static void Reset(std::string &strValue, const std::string &strDefault) { strValue = strDefault; }
+
+    static void Write(CJsonBindWriter &writer, const std::string &strValue)
+    {
+        writer.WriteString(strValue.data(), strValue.size());
+    }
+};
+
+// The elements already there are read over, reset to the members of a
+// default-constructed one first, so a vector parsed into again keeps the
+// storage of its elements and their strings and vectors. An element is
+// not moved while it is being read: the vector only grows when the next
+// one starts.
+template <typename T>
+struct JsonBindValue<std::vector<T>>
+{
+    static void OnElement(void *lpValue, uint32_t uIndex, JsonBindTarget *lpTarget)
+    {
+        static const T stDefault = T();
+        auto lpVec = static_cast<std::vector<T> *>(lpValue);
+        if (uIndex < lpVec->size())
+        {
+            JsonBindValue<T>::Reset((*lpVec)[uIndex], stDefault);
+        }
+        else
+        {
+            lpVec->emplace_back();
+        }
+        lpTarget->lpValue = &(*lpVec)[uIndex];
+        lpTarget->lpOps = JsonBindValue<T>::GetOps();
+    }
+
+    static void OnEndArray(void *lpValue, uint32_t uCount)
+    {
+        static_cast<std::vector<T> *>(lpValue)->resize(uCount);
+    }
+
+    static const JsonBindOps *GetOps()
+    {
+        static const JsonBindOps stOps = {nullptr, nullptr, nullptr, nullptr, nullptr, OnElement, OnEndArray};
+        return &stOps;
+    }
+
+    static void Reset(std::vector<T> &vecValue, const std::vector<T> &vecDefault) { vecValue = vecDefault; }
+
+    static void Write(CJsonBindWriter &writer, const std::vector<T> &vecValue)
+    {
+        writer.WriteChar('[');
+        for (size_t i = 0; i < vecValue.size(); i++)
+        {
+            if (i > 0)
+            {
+                writer.WriteChar(',');
+            }
+            JsonBindValue<T>::Write(writer, vecValue[i]);
+        }
+        writer.WriteChar(']');
+    }
+};
+
+// the case of a member name in JsonBindKey: the hashes matched, the names
+// are compared to rule out a collision
+template <typename T, uint32_t N>
+inline bool JsonBindMember(T &value, const char (&szName)[N], const char *lpKey, uint32_t uLen,
+                           JsonBindTarget *lpTarget)
+{
+    if (uLen != N - 1 || memcmp(lpKey, szName, uLen) != 0)
+    {
+        return false;
+    }
+
+    lpTarget->lpValue = &value;
+    lpTarget->lpOps = JsonBindValue<T>::GetOps();
+    return true;
+}
+
+template <typename T, uint32_t N>
+inline void JsonBindWriteMember(CJsonBindWriter &writer, const char (&szKey)[N], const T &value)
+{
+    writer.WriteRaw(szKey, N - 1);
+    JsonBindValue<T>::Write(writer, value);
+}
+
+/*
+ * The handler ParseJsonStruct parses with: a stack of the containers being
+ * filled, each with its binding. Keys without a member and their values
+ * are skipped, as are nulls, which leave the member as it was.
+ */
+class CJsonBindReader : public IJsonHandler
+{
+public:
+    CJsonBindReader(void *lpValue, const JsonBindOps *lpOps) : m_stNext{lpValue, lpOps} {}
+
+    // the document did not fit the bound types
+    inline bool IsMismatch() const { return m_bMismatch; }
+
+    bool OnNull() override
+    {
+        NextTarget();
+        return true;
+    }
+
+    bool OnBool(bool bValue) override
+    {
+        auto lpTarget = NextTarget();
+        return lpTarget == nullptr ||
+               Check(lpTarget->lpOps->lpOnBool != nullptr && lpTarget->lpOps->lpOnBool(lpTarget->lpValue, bValue));
+    }
+
+    bool OnInt(int64_t nValue) override
+    {
+        auto lpTarget = NextTarget();
+        return lpTarget == nullptr ||
+               Check(lpTarget->lpOps->lpOnInt != nullptr && lpTarget->lpOps->lpOnInt(lpTarget->lpValue, nValue));
+    }
+
+    bool OnDouble(double dValue) override
+    {
+        auto lpTarget = NextTarget();
+        return lpTarget == nullptr || Check(lpTarget->lpOps->lpOnDouble != nullptr &&
+                                            lpTarget->lpOps->lpOnDouble(lpTarget->lpValue, dValue));
+    }
+
+    bool OnString(const char *lpStr, uint32_t uLen) override
+    {
+        auto lpTarget = NextTarget();
+        return lpTarget == nullptr || Check(lpTarget->lpOps->lpOnString != nullptr &&
+                                            lpTarget->lpOps->lpOnString(lpTarget->lpValue, lpStr, uLen));
+    }
+
+    bool OnKey(const char *lpKey, uint32_t uLen) override
+    {
+        if (m_uSkipDepth == 0)
+        {
+            auto &stTop = m_vecStack.back().stTarget;
+            stTop.lpOps->lpOnKey(stTop.lpValue, lpKey, uLen, &m_stNext);
+        }
+        return true;
+    }
+
+    bool OnStartObject() override
+    {
+        auto lpTarget = NextTarget();
+        if (lpTarget == nullptr)
+        {
+            m_uSkipDepth++;
+            return true;
+        }
+
+        if (!Check(lpTarget->lpOps->lpOnKey != nullptr))
+        {
+            return false;
+        }
+
+        m_vecStack.push_back(Container{*lpTarget, 0});
+        return true;
+    }
+
+    bool OnEndObject() override
+    {
+        if (m_uSkipDepth > 0)
+        {
+            m_uSkipDepth--;
+        }
+        else
+        {
+            m_vecStack.pop_back();
+        }
+        return true;
+    }
+
+    bool OnStartArray() override
+    {
+        auto lpTarget = NextTarget();
+        if (lpTarget == nullptr)
+        {
+            m_uSkipDepth++;
+            return true;
+        }
+
+        if (!Check(lpTarget->lpOps->lpOnElement != nullptr))
+        {
+            return false;
+        }
+
+        m_vecStack.push_back(Container{*lpTarget, 0});
+        return true;
+    }
+
+    bool OnEndArray() override
+    {
+        if (m_uSkipDepth > 0)
+        {
+            m_uSkipDepth--;
+        }
+        else
+        {
+            auto &stTop = m_vecStack.back();
+            stTop.stTarget.lpOps->lpOnEndArray(stTop.stTarget.lpValue, stTop.uCount);
+            m_vecStack.pop_back();
+        }
+        return true;
+    }
+
+private:
+    struct Container
+    {
+        JsonBindTarget stTarget;
+        uint32_t uCount; // elements so far, for an array
+    };
+
+    // where the value starting now goes, nullptr when it is skipped
+    inline JsonBindTarget *NextTarget()
+    {
+        if (m_uSkipDepth > 0)
+        {
+            return nullptr;
+        }
+
+        if (!m_vecStack.empty() && m_vecStack.back().stTarget.lpOps->lpOnElement != nullptr)
+        {
+            auto &stTop = m_vecStack.back();
+            stTop.stTarget.lpOps->lpOnElement(stTop.stTarget.lpValue, stTop.uCount++, &m_stNext);
+        }
+        return m_stNext.lpOps != nullptr ? &m_stNext : nullptr;
+    }
+
+    inline bool Check(bool bFits)
+    {
+        m_bMismatch = m_bMismatch || !bFits;
+        return bFits;
+    }
+
+private:
+    JsonBindTarget m_stNext;
+    std::vector<Container> m_vecStack;
+    uint32_t m_uSkipDepth{0};
+    bool m_bMismatch{false};
+};
+
+// Fills stValue, a bound struct or a vector of them, from the uLen bytes
+// of lpContent. Members whose keys are absent keep their values; a value
+// of the wrong type, or an integer that does not fit its member, fails
+// with ParseDataFialed, the members read before it being filled.
+template <typename T>
+inline int32_t ParseJsonStruct(const char *lpContent, uint64_t uLen, T &stValue)
+{
+    CJsonBindReader reader(&stValue, JsonBindValue<T>::GetOps());
+    auto iErrorNo = ParseJsonWithHandler(lpContent, uLen, &reader);
+    return reader.IsMismatch() ? ParseDataFialed : iErrorNo;
+}
+
+// replaces the contents of strJson with the compact json of stValue, the
+// members in the order CPPBASE_JSON_FIELDS lists them
+template <typename T>
+inline void WriteJsonStruct(const T &stValue, std::string &strJson)
+{
+    strJson.clear();
+    CJsonBindWriter writer(strJson);
+    JsonBindValue<T>::Write(writer, stValue);
+}
+
+}
+
+#endif //__JSON_BIND_H_
@@ -0,0 +1,83 @@
+#ifndef __JSON_HANDLER_H_
+#define __JSON_HANDLER_H_
+
+#include <os_common.h>
+
+namespace cppbase
+{
+
+class IJsonObj;
+
+/*
+ * Event sink of the streaming parser: values are reported in document
+ * order without building a tree. Every callback returns false to stop the
+ * parse, which then fails with ParseCanceled. Strings and keys are
+ * unescaped, not NUL-terminated and only valid during the call.
+ */
+class IJsonHandler
+{
+public:
+    virtual ~IJsonHandler() = default;
+
+    virtual bool OnNull() { return true; }
+
+    virtual bool OnBool(bool bValue) { return true; }
+
+    virtual bool OnInt(int64_t nValue) { return true; }
+
+    virtual bool OnDouble(double dValue) { return true; }
+
+    virtual bool OnString(const char *lpStr, uint32_t uLen) { return true; }
+
+    virtual bool OnKey(const char *lpKey, uint32_t uLen) { return true; }
+
+    virtual bool OnStartObject() { return true; }
+
+    virtual bool OnEndObject() { return true; }
+
+    virtual bool OnStartArray() { return true; }
+
+    virtual bool OnEndArray() { return true; }
+};
+
+/*
+ * Resumable parser for documents arriving in pieces: each Feed continues
+ * where the previous one stopped, even inside a string, an escape or a
+ * number, and reports the values completed so far.
+ */
+class IJsonPushParser
+{
+protected:
+    virtual ~IJsonPushParser() = default;
+
+public:
+    virtual int32_t Feed(const char *lpData, uint64_t uLen) = 0;
+
+    // fails unless the pieces fed so far form exactly one complete value
+    virtual int32_t Finish() = 0;
+
+    // drops the current document so the parser can take the next one
+    virtual void Reset() = 0;
+};
+
+}
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    // parses uLen bytes of lpContent with the same scanner as IJsonObj, in
+    // memory bounded by the nesting depth rather than the document size;
+    // like IJsonObj it takes an array or object, not a bare scalar
+    EXPORT int32_t ParseJsonWithHandler(const char *lpContent, uint64_t uLen, cppbase::IJsonHandler *lpHandler);
+    // a parser for documents fed in pieces, whose root is again an array or
+    // object
+    EXPORT cppbase::IJsonPushParser *NewJsonPushParser(cppbase::IJsonHandler *lpHandler);
+    // the fed document is built into lpJsonObj, as OpenFromBuffer would do
+    EXPORT cppbase::IJsonPushParser *NewJsonObjPushParser(cppbase::IJsonObj *lpJsonObj);
+    EXPORT void DeleteJsonPushParser(cppbase::IJsonPushParser *lpParser);
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__JSON_HANDLER_H_
@@ -0,0 +1,60 @@
+#ifndef __JSON_LINES_H_
+#define __JSON_LINES_H_
+
+#include <os_common.h>
+#include <json_obj.h>
+
+namespace cppbase
+{
+
+/*
+ * Receiver of the records of a JSON Lines input, a batch at a time. Calls
+ * never overlap, whichever worker they come from. uOffset is where the
+ * first line of the batch starts in the input, and lpRecords[i] is nullptr
+ * for a line that is not a valid object or array; blank lines are no
+ * records. The records belong to the reader and are deleted when OnBatch
+ * returns. Returning false stops the read, which then fails with
+ * ParseCanceled.
+ */
+class IJsonLinesConsumer
+{
+public:
+    virtual ~IJsonLinesConsumer() = default;
+
+    virtual bool OnBatch(uint64_t uOffset, IJsonObj *const *lpRecords, uint32_t uCount) = 0;
+};
+
+/*
+ * Parser of newline-delimited json on a pool of worker threads: the input
+ * is cut into batches at line ends and each worker parses whole batches.
+ * A reader runs one read at a time.
+ */
+class IJsonLinesReader
+{
+protected:
+    virtual ~IJsonLinesReader() = default;
+
+public:
+    virtual int32_t ReadFile(const char *lpFile, IJsonLinesConsumer *lpConsumer) = 0;
+
+    virtual int32_t ReadBuffer(const char *lpBuffer, uint64_t uLen, IJsonLinesConsumer *lpConsumer) = 0;
+};
+
+}
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    // uThreads workers, one per cpu when 0, worker i bound to cpu
+    // iFirstCpu + i unless iFirstCpu is negative; batches of about
+    // uBatchSize bytes (1 MB when 0), delivered in input order when
+    // bOrdered and as soon as they are parsed otherwise
+    EXPORT cppbase::IJsonLinesReader *NewJsonLinesReader(uint32_t uThreads, int32_t iFirstCpu, uint64_t uBatchSize,
+                                                         bool bOrdered);
+    EXPORT void DeleteJsonLinesReader(cppbase::IJsonLinesReader *lpReader);
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__JSON_LINES_H_
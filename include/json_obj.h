@@ -2,6 +2,7 @@
 #define __JSON_OBJ_H_
 
 #include <os_common.h>
+#include <type_traits>
 
 namespace cppbase
 {
@@ -21,6 +22,13 @@ public:
         Unknow
     };
 
+    // the binary forms GetBinary writes and OpenFromBinary reads
+    enum class BinaryFormat : uint8_t
+    {
+        MessagePack = 0,
+        Cbor
+    };
+
     struct KvItem
     {
         ObjType eType;
@@ -29,12 +37,56 @@ public:
             bool IsNull;
             bool bValue;
             int64_t nValue;
+            double dValue;
             const char *strValue;
             IJsonObj *lpArray;
             IJsonObj *lpObj;
         };
     };
 
+    // position of a First/Next walk over an array or object; it is only
+    // meaningful to the node that filled it, and while that node is not
+    // modified
+    struct Cursor
+    {
+        alignas(8) uint8_t Reserve[16];
+    };
+
+    // a key prepared once for repeated lookups: its length and hash are
+    // computed here instead of on every call, and lpKey must outlive it
+    struct Key
+    {
+        const char *lpKey;
+        uint32_t uLen;
+        uint64_t uHash;
+
+        explicit Key(const char *lpStr) : Key(lpStr, lpStr != nullptr ? uint32_t(strlen(lpStr)) : 0) {}
+        Key(const char *lpStr, uint32_t uStrLen) : lpKey(lpStr), uLen(uStrLen), uHash(Hash(lpStr, uStrLen)) {}
+        // uStrHash must be Hash(lpStr, uStrLen); see JKEY
+        constexpr Key(const char *lpStr, uint32_t uStrLen, uint64_t uStrHash)
+            : lpKey(lpStr), uLen(uStrLen), uHash(uStrHash)
+        {
+        }
+
+        // FNV-1a, the hash the objects index their keys with
+        static inline uint64_t Hash(const char *lpStr, uint32_t uLen)
+        {
+            uint64_t uHash = 14695981039346656037ULL;
+            for (uint32_t i = 0; i < uLen; i++)
+            {
+                uHash = (uHash ^ uint8_t(lpStr[i])) * 1099511628211ULL;
+            }
+            return uHash;
+        }
+
+        // the same hash at compile time, for keys known in advance
+        static constexpr uint64_t ConstHash(const char *lpStr, uint32_t uLen,
+                                            uint64_t uHash = 14695981039346656037ULL)
+        {
+            return uLen == 0 ? uHash : ConstHash(lpStr + 1, uLen - 1, (uHash ^ uint8_t(*lpStr)) * 1099511628211ULL);
+        }
+    };
+
 protected:
     virtual ~IJsonObj() = default;
 
@@ -45,6 +97,10 @@ public:
     
     virtual int32_t OpenFromBuffer(const char *lpBuffer) = 0;
  
+    // lpKey is nullptr when adding to an array; strings of up to 14 bytes
+    // are stored inside their member, so unlike the nodes returned by
+    // AddArray and AddObject they may move when another member is added to
+    // the same parent
     virtual int32_t AddNull(const char *lpKey) = 0;
 
     virtual int32_t AddBool(const char *lpKey, bool bValue) = 0;
@@ -83,19 +139,158 @@ public:
 
     virtual ObjType GetType(uint32_t uIndex) = 0;
 
+    // members of arrays and objects keep the order they were added or
+    // parsed in
     virtual int32_t GetItem(uint32_t uIndex, KvItem *lpKvItem) = 0;
 
+    // the string is owned by the object and stays valid until the next
+    // GetJsonStr call on it or its deletion
     virtual const char *GetJsonStr(bool bPretty) = 0;
+
+    // The methods below came after the first release: new ones go at the
+    // end, so that the vtable slots of the older ones never move.
+
+    // parses uLen bytes without copying keys and strings: they are unescaped
+    // in place and the document refers to them, so lpBuffer is modified and
+    // must outlive the object
+    virtual int32_t OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen) = 0;
+
+    virtual bool GetNull(const Key &stKey) = 0;
+
+    virtual bool GetBool(const Key &stKey, bool bDefaultValue = false) = 0;
+
+    virtual int64_t GetInt(const Key &stKey, int64_t nDefaultValue = 0) = 0;
+
+    virtual double GetDouble(const Key &stKey, double dDefaultValue = 0.0) = 0;
+
+    virtual const char *GetString(const Key &stKey, const char *lpDefaultValue = nullptr) = 0;
+
+    virtual IJsonObj *GetArray(const Key &stKey) = 0;
+
+    virtual IJsonObj *GetObject(const Key &stKey) = 0;
+
+    virtual bool IsExist(const Key &stKey) = 0;
+
+    virtual ObjType GetType(const Key &stKey) = 0;
+
+    // the getter of the type T: bool, an integer, a floating point type or
+    // const char *, so that Get<int32_t>(JKEY("qty")) is GetInt cut down
+    template <typename T>
+    inline T Get(const Key &stKey, T defaultValue = T())
+    {
+        return GetAs(stKey, defaultValue);
+    }
+
+    // visit the members of an array or object in O(1) per step, in the
+    // order of GetItem: each call fills lpKvItem and returns true, or
+    // returns false once there is no member left
+    virtual bool First(Cursor *lpCursor, KvItem *lpKvItem) = 0;
+
+    virtual bool Next(Cursor *lpCursor, KvItem *lpKvItem) = 0;
+
+    // parses only the members named by uPathCount paths like "/order/price",
+    // with "~1" standing for '/' and "~0" for '~' in a key: the rest is
+    // skipped by matching brackets and quotes, unchecked and unconverted.
+    // Objects keep the members leading to a path, and everything under its
+    // end; arrays keep all their elements, their objects projected by the
+    // same path. The read-only documents return InvaliadCall
+    virtual int32_t OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount) = 0;
+
+    // drops every member but keeps the memory they took for the next ones:
+    // a document is then as good as new, its next Init or Open picking
+    // either type, while any other node stays an empty array or object.
+    // The nodes and strings read from it before are gone
+    virtual int32_t Clear() = 0;
+
+    // parses uLen bytes holding one MessagePack or CBOR map or array, the
+    // keys of every map being strings, as OpenFromBuffer parses text. The
+    // read-only documents return InvaliadCall
+    virtual int32_t OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat) = 0;
+
+    // the node in MessagePack or CBOR, *lpLen bytes long, in the buffer of
+    // GetJsonStr and valid as long as its string would be
+    virtual const char *GetBinary(BinaryFormat eFormat, uint64_t *lpLen) = 0;
+
+    // maps a file written by SaveSnapshot and reads it in place, with
+    // nothing parsed or copied. Only the documents of NewSnapshotJsonObject
+    // open snapshots, the others return InvaliadCall
+    virtual int32_t OpenSnapshot(const char *lpFile) = 0;
+
+    // writes the node as a snapshot for OpenSnapshot, a file only valid on
+    // hosts of the same byte order. lpFile is replaced in one step, so the
+    // processes still reading the previous one keep it whole
+    virtual int32_t SaveSnapshot(const char *lpFile) = 0;
+
+    // a frozen copy of the node and everything under it, for
+    // DeleteJsonObject, or nullptr when it fails: the snapshot layout in
+    // one block of memory, its objects searched by their sorted key hashes
+    // and every node made up front. Any number of threads may then read it
+    // at once without locks, bar GetJsonStr and GetBinary, which share one
+    // output buffer; its Open, Clear and Add calls return InvaliadCall
+    virtual IJsonObj *Freeze() = 0;
+
+private:
+    inline bool GetAs(const Key &stKey, bool bDefaultValue) { return GetBool(stKey, bDefaultValue); }
+
+    inline const char *GetAs(const Key &stKey, const char *lpDefaultValue)
+    {
+        return GetString(stKey, lpDefaultValue);
+    }
+
+    template <typename T>
+    inline typename std::enable_if<std::is_integral<T>::value, T>::type GetAs(const Key &stKey, T defaultValue)
+    {
+        return T(GetInt(stKey, int64_t(defaultValue)));
+    }
+
+    template <typename T>
+    inline typename std::enable_if<std::is_floating_point<T>::value, T>::type GetAs(const Key &stKey, T defaultValue)
+    {
+        return T(GetDouble(stKey, double(defaultValue)));
+    }
 };
 
 }
 
+// A Key for a string literal, its length and hash worked out by the
+// compiler: lpObj->GetInt(JKEY("price")) costs no strlen and no hashing.
+#define JKEY(str)                                                                                          \
+    ::cppbase::IJsonObj::Key(                                                                              \
+        str, sizeof(str) - 1,                                                                              \
+        std::integral_constant<uint64_t, ::cppbase::IJsonObj::Key::ConstHash(str, sizeof(str) - 1)>::value)
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
     EXPORT cppbase::IJsonObj *NewJsonObject();
+    // every node, key and string of the document is carved out of chunks of
+    // uChunkSize bytes (0 for the default) and released together on delete
+    EXPORT cppbase::IJsonObj *NewArenaJsonObject(uint64_t uChunkSize);
+    // a read-only document for parsing and reading only: one Open call lays
+    // it out in two allocations, after which Init and the Add calls fail;
+    // GetJsonStr of any of its nodes reuses one output string
+    EXPORT cppbase::IJsonObj *NewTapeJsonObject();
+    // a read-only document that Open only indexes and checks the structure
+    // of: a value is converted, and its bytes checked, the first time it is
+    // read. Keys are not compared, so unlike the other documents it opens
+    // objects repeating one: lookups find its first member, while GetItem,
+    // First/Next and GetJsonStr see them all
+    EXPORT cppbase::IJsonObj *NewLazyJsonObject();
+    // an arena document whose Open calls parse a large top-level array on
+    // uThreads threads, one per cpu when 0
+    EXPORT cppbase::IJsonObj *NewParallelJsonObject(uint32_t uThreads);
+    // a read-only document for OpenSnapshot: its getters read the mapped
+    // file, whose pages the processes opening it share, and only the nodes
+    // handed out take memory of their own
+    EXPORT cppbase::IJsonObj *NewSnapshotJsonObject();
     EXPORT void DeleteJsonObject(cppbase::IJsonObj *lpJsonObj);
+    // an arena document from the pool of the calling thread, or a new one
+    // when it is empty. Releasing one clears it into the pool of the
+    // releasing thread, unless the pool is full or the document holds more
+    // than 16 MB, and deletes any other document
+    EXPORT cppbase::IJsonObj *AcquireJsonObject();
+    EXPORT void ReleaseJsonObject(cppbase::IJsonObj *lpJsonObj);
 #ifdef __cplusplus
 }
 #endif
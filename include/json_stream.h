@@ -0,0 +1,53 @@
+#ifndef __JSON_STREAM_H_
+#define __JSON_STREAM_H_
+
+#include <os_common.h>
+#include <json_obj.h>
+
+namespace cppbase
+{
+
+/*
+ * Iterator over concatenated json documents, like {...}{...}[...], with or
+ * without whitespace between them. Every document is parsed into the same
+ * arena document, emptied for the next one, so once the arena has grown to
+ * the largest document a Next call allocates nothing.
+ */
+class IJsonDocStream
+{
+protected:
+    virtual ~IJsonDocStream() = default;
+
+public:
+    // the input replaces the previous one; a buffer must outlive the
+    // reading, a file is mapped until the next Open or the deletion
+    virtual int32_t OpenFile(const char *lpFile) = 0;
+
+    virtual int32_t OpenBuffer(const char *lpBuffer, uint64_t uLen) = 0;
+
+    // sets *lpDoc to the next document, valid until the next call, or to
+    // nullptr at the end of the input. A document that is not valid json
+    // fails alone and the next call goes on after it; a top-level value
+    // other than an object or array, or unbalanced brackets, fail the rest
+    // of the input
+    virtual int32_t Next(IJsonObj **lpDoc) = 0;
+
+    // where the document returned or failed by the last Next starts
+    virtual uint64_t GetOffset() = 0;
+};
+
+}
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    // the documents are carved out of chunks of uChunkSize bytes (0 for
+    // the default), the arena of NewArenaJsonObject
+    EXPORT cppbase::IJsonDocStream *NewJsonDocStream(uint64_t uChunkSize);
+    EXPORT void DeleteJsonDocStream(cppbase::IJsonDocStream *lpStream);
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__JSON_STREAM_H_
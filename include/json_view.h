@@ -0,0 +1,307 @@
+#ifndef __JSON_VIEW_H_
+#define __JSON_VIEW_H_
+
+#include <os_common.h>
+#include <json_obj.h>
+#include <type_traits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace cppbase
+{
+
+/*
+ * How a node of the NewJsonObject, NewArenaJsonObject, NewParallelJsonObject
+ * and pooled documents lays out its data, for CJsonView to read it without
+ * calling into the library. The library checks when it is built that its
+ * nodes match this; a node is only read, never written, through it.
+ */
+struct JsonNodeLayout
+{
+    // an array element or object member in 16 bytes: the scalar, or the
+    // pointer to a long string then its length, or to a node; a short
+    // string fills szData, its last byte holding ShortStrLen minus the
+    // length, which is also the NUL of a full one
+    struct Value
+    {
+        static constexpr uint8_t TypeMask = 0x0F;
+        static constexpr uint8_t ShortStr = 0x10;
+        static constexpr uint32_t ShortStrLen = 14;
+
+        alignas(8) char szData[15];
+        uint8_t uTag;
+    };
+
+    struct Str
+    {
+        const char *lpStr;
+        uint32_t uLen;
+        bool bInSitu;
+    };
+
+    struct Member
+    {
+        Str stKey;
+        Value stValue;
+    };
+
+    struct Array
+    {
+        const void *lpArena;
+        const Value *lpItems;
+        uint32_t uSize;
+        uint32_t uCapacity;
+    };
+
+    // the members in insertion order with the low half of their key hash
+    // in lpHashes, whose capacity is a multiple of 4; past 16 members
+    // lpIndex is an open addressing table of positions + 1, 0 when empty
+    struct Object
+    {
+        const void *lpArena;
+        const uint32_t *lpHashes;
+        const Member *lpEntries;
+        const uint32_t *lpIndex;
+        uint32_t uSize;
+        uint32_t uCapacity;
+        uint32_t uIndexMask;
+    };
+
+    const void *lpVtable;
+    IJsonObj::ObjType eType;
+    IJsonObj::ObjType eKept;
+    bool bChild;
+    const void *lpArena;
+    const void *lpWriter;
+    union
+    {
+        Array stArray;
+        Object stObject;
+    };
+};
+
+}
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    // the layout of lpJsonObj, or nullptr for the nodes laid out otherwise:
+    // those of the tape, lazy and snapshot documents
+    EXPORT const cppbase::JsonNodeLayout *GetJsonNodeLayout(cppbase::IJsonObj *lpJsonObj);
+#ifdef __cplusplus
+}
+#endif
+
+namespace cppbase
+{
+
+/*
+ * Reader of a node that inlines into the caller: no getter is a virtual
+ * call, and Get<T> and At<T> read the members where the node keeps them.
+ * Types follow the getters of IJsonObj: bool, integers, floating point
+ * types, const char * and CJsonView for the arrays and objects below, each
+ * only reading a value of its own type and giving the default otherwise.
+ *
+ * A view is one pointer, copied freely, and valid while its node is not
+ * modified. One made of a node without a JsonNodeLayout is empty, as if
+ * its node had no members.
+ */
+class CJsonView
+{
+public:
+    using ObjType = IJsonObj::ObjType;
+    using Key = IJsonObj::Key;
+
+    CJsonView() = default;
+    explicit CJsonView(IJsonObj *lpJsonObj) : m_lpNode(lpJsonObj != nullptr ? GetJsonNodeLayout(lpJsonObj) : nullptr)
+    {
+    }
+
+    inline bool IsValid() const { return m_lpNode != nullptr; }
+
+    inline ObjType GetType() const { return m_lpNode != nullptr ? m_lpNode->eType : ObjType::Unknow; }
+
+    inline uint32_t GetSize() const
+    {
+        switch (GetType())
+        {
+            case ObjType::Array:
+                return m_lpNode->stArray.uSize;
+
+            case ObjType::Object:
+                return m_lpNode->stObject.uSize;
+
+            default:
+                return 0;
+        }
+    }
+
+    inline bool IsExist(const Key &stKey) const { return FindValue(stKey) != nullptr; }
+
+    inline ObjType GetType(const Key &stKey) const { return TypeOf(FindValue(stKey)); }
+
+    inline ObjType GetType(uint32_t uIndex) const { return TypeOf(GetValue(uIndex)); }
+
+    template <typename T>
+    inline T Get(const Key &stKey, T defaultValue = T()) const
+    {
+        return Read(FindValue(stKey), defaultValue);
+    }
+
+    // member uIndex of an array or object, in the order of GetItem
+    template <typename T>
+    inline T At(uint32_t uIndex, T defaultValue = T()) const
+    {
+        return Read(GetValue(uIndex), defaultValue);
+    }
+
+    // the key of member uIndex of an object, nullptr for an array
+    inline const char *GetKey(uint32_t uIndex) const
+    {
+        return GetType() == ObjType::Object && uIndex < m_lpNode->stObject.uSize
+                   ? m_lpNode->stObject.lpEntries[uIndex].stKey.lpStr
+                   : nullptr;
+    }
+
+private:
+    using Value = JsonNodeLayout::Value;
+
+    static inline CJsonView OfNode(const JsonNodeLayout *lpNode)
+    {
+        CJsonView view;
+        view.m_lpNode = lpNode;
+        return view;
+    }
+
+    template <typename T>
+    static inline T Load(const Value *lpValue)
+    {
+        T value;
+        memcpy(&value, lpValue->szData, sizeof(T));
+        return value;
+    }
+
+    static inline ObjType TypeOf(const Value *lpValue)
+    {
+        return lpValue != nullptr ? ObjType(lpValue->uTag & Value::TypeMask) : ObjType::Unknow;
+    }
+
+    inline const Value *GetValue(uint32_t uIndex) const
+    {
+        switch (GetType())
+        {
+            case ObjType::Array:
+                return uIndex < m_lpNode->stArray.uSize ? &m_lpNode->stArray.lpItems[uIndex] : nullptr;
+
+            case ObjType::Object:
+                return uIndex < m_lpNode->stObject.uSize ? &m_lpNode->stObject.lpEntries[uIndex].stValue : nullptr;
+
+            default:
+                return nullptr;
+        }
+    }
+
+    static inline bool IsSameKey(const JsonNodeLayout::Member &stMember, const Key &stKey)
+    {
+        return stMember.stKey.uLen == stKey.uLen && memcmp(stMember.stKey.lpStr, stKey.lpKey, stKey.uLen) == 0;
+    }
+
+    // the search of the library's objects: tags first, then the key
+    inline const Value *FindValue(const Key &stKey) const
+    {
+        if (GetType() != ObjType::Object || stKey.lpKey == nullptr)
+        {
+            return nullptr;
+        }
+
+        auto &stObject = m_lpNode->stObject;
+        auto uTag = uint32_t(stKey.uHash);
+        if (stObject.lpIndex != nullptr)
+        {
+            for (auto uSlot = uTag & stObject.uIndexMask; stObject.lpIndex[uSlot] != 0;
+                 uSlot = (uSlot + 1) & stObject.uIndexMask)
+            {
+                auto uPos = stObject.lpIndex[uSlot] - 1;
+                if (stObject.lpHashes[uPos] == uTag && IsSameKey(stObject.lpEntries[uPos], stKey))
+                {
+                    return &stObject.lpEntries[uPos].stValue;
+                }
+            }
+            return nullptr;
+        }
+
+        uint32_t i = 0;
+#if defined(__SSE2__)
+        const __m128i stHash = _mm_set1_epi32(int32_t(uTag));
+        for (; i < stObject.uSize; i += 4)
+        {
+            auto stTags = _mm_loadu_si128(reinterpret_cast<const __m128i *>(stObject.lpHashes + i));
+            auto uMask = uint32_t(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(stTags, stHash))));
+            uMask &= stObject.uSize - i >= 4 ? 0xF : (1U << (stObject.uSize - i)) - 1;
+            while (uMask != 0)
+            {
+                auto uPos = i + uint32_t(__builtin_ctz(uMask));
+                if (likely(IsSameKey(stObject.lpEntries[uPos], stKey)))
+                {
+                    return &stObject.lpEntries[uPos].stValue;
+                }
+                uMask &= uMask - 1;
+            }
+        }
+#else
+        for (; i < stObject.uSize; i++)
+        {
+            if (stObject.lpHashes[i] == uTag && IsSameKey(stObject.lpEntries[i], stKey))
+            {
+                return &stObject.lpEntries[i].stValue;
+            }
+        }
+#endif
+        return nullptr;
+    }
+
+    static inline bool Read(const Value *lpValue, bool bDefaultValue)
+    {
+        return TypeOf(lpValue) == ObjType::Boolean ? Load<bool>(lpValue) : bDefaultValue;
+    }
+
+    static inline const char *Read(const Value *lpValue, const char *lpDefaultValue)
+    {
+        if (TypeOf(lpValue) != ObjType::String)
+        {
+            return lpDefaultValue;
+        }
+        return (lpValue->uTag & Value::ShortStr) != 0 ? lpValue->szData : Load<const char *>(lpValue);
+    }
+
+    static inline CJsonView Read(const Value *lpValue, CJsonView defaultValue)
+    {
+        auto eType = TypeOf(lpValue);
+        return eType == ObjType::Array || eType == ObjType::Object
+                   ? OfNode(Load<const JsonNodeLayout *>(lpValue))
+                   : defaultValue;
+    }
+
+    template <typename T>
+    static inline typename std::enable_if<std::is_integral<T>::value, T>::type Read(const Value *lpValue,
+                                                                                   T defaultValue)
+    {
+        return TypeOf(lpValue) == ObjType::Integer ? T(Load<int64_t>(lpValue)) : defaultValue;
+    }
+
+    template <typename T>
+    static inline typename std::enable_if<std::is_floating_point<T>::value, T>::type Read(const Value *lpValue,
+                                                                                         T defaultValue)
+    {
+        return TypeOf(lpValue) == ObjType::Double ? T(Load<double>(lpValue)) : defaultValue;
+    }
+
+private:
+    const JsonNodeLayout *m_lpNode{nullptr};
+};
+
+}
+
+#endif //__JSON_VIEW_H_
@@ -0,0 +1,1186 @@
+#include <json_obj.h>
+#include <json_handler.h>
+#include <json_lines.h>
+#include <json_stream.h>
+#include <json_scanner.h>
+#include <json_bind.h>
+#include <json_view.h>
+#include <malloc.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+double NowSeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// an array of order-like records: nested objects, short strings and numbers
+std::string MakeDocument(uint64_t uSize)
+{
+    std::string strJson = "[\n";
+    char szRecord[512];
+    for (uint64_t i = 0; strJson.size() < uSize; i++)
+    {
+        snprintf(szRecord, sizeof(szRecord),
+                 "  {\"id\": %lu, \"symbol\": \"SYM%04lu\", \"price\": %lu.%02lu, \"qty\": %lu, \"side\": \"%s\", "
+                 "\"active\": %s, \"note\": null, \"tags\": [\"a\\\"b\", \"venue-%lu\", \"\\u00e9t\\u00e9\"], "
+                 "\"book\": {\"bid\": [%lu, %lu, %lu], \"ask\": [%lu, %lu, %lu], \"ts\": %lu}},\n",
+                 i, i % 10000, 100 + i % 900, i % 100, (i * 7) % 1000, i % 2 ? "buy" : "sell",
+                 i % 3 ? "true" : "false", i % 16, i, i + 1, i + 2, i + 3, i + 4, i + 5, 1700000000000000 + i);
+        strJson += szRecord;
+    }
+    strJson += "  {}\n]\n";
+    return strJson;
+}
+
+// market-data ticks: timestamps, prices with a varying number of decimals,
+// sizes and the odd exponent
+std::string MakeNumberDocument(uint64_t uSize)
+{
+    std::string strJson = "[\n";
+    char szRecord[256];
+    for (uint64_t i = 0; strJson.size() < uSize; i++)
+    {
+        // 8^n stays below 10^n, so the fraction fits its n decimals
+        int iDecimals = int(1 + i % 8);
+        uint64_t uFraction = (i * 7919) % (uint64_t(1) << (3 * iDecimals));
+        snprintf(szRecord, sizeof(szRecord), "  [%lu, %lu.%0*lu, %lu, -%lu.%06lu, %lu.%lue-%lu],\n",
+                 1700000000000000000 + i * 977, 100 + i % 9000, iDecimals, uFraction, i % 5000, i % 300,
+                 (i * 104729) % 1000000, 1 + i % 9, i % 997, 1 + i % 20);
+        strJson += szRecord;
+    }
+    strJson += "  []\n]\n";
+    return strJson;
+}
+
+// the byte-at-a-time tokenizer the parser used before the structural index
+uint32_t ByteLoopScan(const char *lpContent, uint64_t uLen, std::vector<uint32_t> &vecIndex)
+{
+    vecIndex.clear();
+    bool bInString = false;
+    bool bScalar = false;
+    for (uint64_t i = 0; i < uLen; i++)
+    {
+        auto ch = lpContent[i];
+        if (bInString)
+        {
+            if (ch == '\\')
+            {
+                i++;
+            }
+            else if (ch == '"')
+            {
+                vecIndex.push_back(i);
+                bInString = false;
+            }
+            continue;
+        }
+
+        if (ch == ' ' || ch == '\r' || ch == '\n' || ch == '\t')
+        {
+            bScalar = false;
+        }
+        else if (ch == '{' || ch == '}' || ch == '[' || ch == ']' || ch == ':' || ch == ',' || ch == '"')
+        {
+            vecIndex.push_back(i);
+            bInString = ch == '"';
+            bScalar = false;
+        }
+        else if (!bScalar)
+        {
+            vecIndex.push_back(i);
+            bScalar = true;
+        }
+    }
+
+    return vecIndex.size();
+}
+
+void BenchScan(const std::string &strJson, int iRounds)
+{
+    double dBest = 0, dByteBest = 0;
+    cppbase::CJsonScanner scanner;
+    std::vector<uint32_t> vecIndex;
+    for (int i = 0; i < iRounds; i++)
+    {
+        auto dBegin = NowSeconds();
+        scanner.Scan(strJson.c_str(), strJson.size());
+        auto dElapsed = NowSeconds() - dBegin;
+        if (dBest == 0 || dElapsed < dBest)
+        {
+            dBest = dElapsed;
+        }
+
+        dBegin = NowSeconds();
+        ByteLoopScan(strJson.c_str(), strJson.size(), vecIndex);
+        dElapsed = NowSeconds() - dBegin;
+        if (dByteBest == 0 || dElapsed < dByteBest)
+        {
+            dByteBest = dElapsed;
+        }
+    }
+
+    if (vecIndex.size() != scanner.GetCount())
+    {
+        printf("token count mismatch: %u vs %zu\n", scanner.GetCount(), vecIndex.size());
+    }
+
+    printf("%-32s %10.1f MB/s\n", "structural index (byte loop)", strJson.size() / dByteBest / 1e6);
+    printf("%-32s %10.1f MB/s\n", "structural index (CJsonScanner)", strJson.size() / dBest / 1e6);
+}
+
+void BenchParse(const char *lpName, cppbase::IJsonObj *(*lpNewJsonObject)(), const std::string &strJson, int iRounds)
+{
+    double dBest = 0, dDeleteBest = 0;
+    for (int i = 0; i < iRounds; i++)
+    {
+        auto lpJsonObj = lpNewJsonObject();
+        auto dBegin = NowSeconds();
+        auto iErrorNo = lpJsonObj->OpenFromBuffer(strJson.c_str());
+        auto dElapsed = NowSeconds() - dBegin;
+
+        dBegin = NowSeconds();
+        DeleteJsonObject(lpJsonObj);
+        auto dDelete = NowSeconds() - dBegin;
+        if (iErrorNo != 0)
+        {
+            printf("parse failed: %d\n", iErrorNo);
+            return;
+        }
+        if (dBest == 0 || dElapsed < dBest)
+        {
+            dBest = dElapsed;
+        }
+        if (dDeleteBest == 0 || dDelete < dDeleteBest)
+        {
+            dDeleteBest = dDelete;
+        }
+    }
+
+    printf("%-32s %10.1f MB/s  (delete %.2f ms)\n", lpName, strJson.size() / dBest / 1e6, dDeleteBest * 1e3);
+}
+
+// the consumer the streaming parser is meant for: two fields of every record
+class CPriceHandler : public cppbase::IJsonHandler
+{
+public:
+    bool OnKey(const char *lpKey, uint32_t uLen) override
+    {
+        m_bPrice = uLen == 5 && memcmp(lpKey, "price", 5) == 0;
+        m_bQty = uLen == 3 && memcmp(lpKey, "qty", 3) == 0;
+        return true;
+    }
+
+    bool OnInt(int64_t nValue) override
+    {
+        m_nQty += m_bQty ? nValue : 0;
+        return true;
+    }
+
+    bool OnDouble(double dValue) override
+    {
+        m_dPrice += m_bPrice ? dValue : 0;
+        return true;
+    }
+
+    bool m_bPrice{false};
+    bool m_bQty{false};
+    int64_t m_nQty{0};
+    double m_dPrice{0};
+};
+
+void BenchSax(const std::string &strJson, int iRounds)
+{
+    double dBest = 0;
+    for (int i = 0; i < iRounds; i++)
+    {
+        CPriceHandler handler;
+        auto dBegin = NowSeconds();
+        auto iErrorNo = ParseJsonWithHandler(strJson.data(), strJson.size(), &handler);
+        auto dElapsed = NowSeconds() - dBegin;
+        if (iErrorNo != 0)
+        {
+            printf("parse failed: %d\n", iErrorNo);
+            return;
+        }
+        if (dBest == 0 || dElapsed < dBest)
+        {
+            dBest = dElapsed;
+        }
+    }
+
+    printf("%-32s %10.1f MB/s\n", "ParseJsonWithHandler", strJson.size() / dBest / 1e6);
+}
+
+class CSumHandler : public cppbase::IJsonHandler
+{
+public:
+    bool OnInt(int64_t nValue) override
+    {
+        m_nSum += nValue;
+        return true;
+    }
+
+    bool OnDouble(double dValue) override
+    {
+        m_dSum += dValue;
+        return true;
+    }
+
+    int64_t m_nSum{0};
+    double m_dSum{0};
+};
+
+void BenchNumbers(const std::string &strJson, int iRounds)
+{
+    double dBest = 0;
+    for (int i = 0; i < iRounds; i++)
+    {
+        CSumHandler handler;
+        auto dBegin = NowSeconds();
+        auto iErrorNo = ParseJsonWithHandler(strJson.data(), strJson.size(), &handler);
+        auto dElapsed = NowSeconds() - dBegin;
+        if (iErrorNo != 0)
+        {
+            printf("parse failed: %d\n", iErrorNo);
+            return;
+        }
+        if (dBest == 0 || dElapsed < dBest)
+        {
+            dBest = dElapsed;
+        }
+    }
+
+    printf("%-32s %10.1f MB/s\n", "ParseJsonWithHandler (numbers)", strJson.size() / dBest / 1e6);
+}
+
+// keep two fields of every record out of the ten
+void BenchProjection(const std::string &strJson, int iRounds)
+{
+    const char *szPaths[] = {"/price", "/book/ts"};
+    double dBest = 0;
+    for (int i = 0; i < iRounds; i++)
+    {
+        auto lpJsonObj = NewArenaJsonObject(0);
+        auto dBegin = NowSeconds();
+        auto iErrorNo = lpJsonObj->OpenFromBuffer(strJson.c_str(), szPaths, 2);
+        auto dElapsed = NowSeconds() - dBegin;
+        DeleteJsonObject(lpJsonObj);
+        if (iErrorNo != 0)
+        {
+            printf("parse failed: %d\n", iErrorNo);
+            return;
+        }
+        if (dBest == 0 || dElapsed < dBest)
+        {
+            dBest = dElapsed;
+        }
+    }
+
+    printf("%-32s %10.1f MB/s\n", "OpenFromBuffer (arena, 2 paths)", strJson.size() / dBest / 1e6);
+}
+
+// open a document and read a few fields of one record in the middle, the
+// case a lazy document is for
+void BenchPick(const char *lpName, cppbase::IJsonObj *(*lpNewJsonObject)(), const std::string &strJson, int iRounds)
+{
+    double dBest = 0;
+    int64_t nSum = 0;
+    for (int i = 0; i < iRounds; i++)
+    {
+        auto lpJsonObj = lpNewJsonObject();
+        auto dBegin = NowSeconds();
+        auto iErrorNo = lpJsonObj->OpenFromBuffer(strJson.c_str());
+        cppbase::IJsonObj::KvItem kvItem;
+        if (iErrorNo == 0 && (iErrorNo = lpJsonObj->GetItem(lpJsonObj->GetSize() / 2, &kvItem)) == 0)
+        {
+            nSum += kvItem.lpObj->GetInt("id") + kvItem.lpObj->GetObject("book")->GetInt("ts");
+        }
+        auto dElapsed = NowSeconds() - dBegin;
+        DeleteJsonObject(lpJsonObj);
+        if (iErrorNo != 0)
+        {
+            printf("pick failed: %d\n", iErrorNo);
+            return;
+        }
+        if (dBest == 0 || dElapsed < dBest)
+        {
+            dBest = dElapsed;
+        }
+    }
+
+    printf("%-32s %10.1f MB/s  (%ld)\n", lpName, strJson.size() / dBest / 1e6, nSum / iRounds);
+}
+
+class CLinesCounter : public cppbase::IJsonLinesConsumer
+{
+public:
+    bool OnBatch(uint64_t uOffset, cppbase::IJsonObj *const *lpRecords, uint32_t uCount) override
+    {
+        m_uRecords += uCount;
+        return true;
+    }
+
+    uint64_t m_uRecords{0};
+};
+
+// the records of the document one per line: parsed line by line with
+// OpenFromBuffer, the way callers split them by hand, and by the reader
+// the records of the document, one per line
+std::string MakeLines(const std::string &strJson)
+{
+    std::string strLines;
+    for (auto lpLine = strJson.c_str(); *lpLine != '\0';)
+    {
+        auto lpEnd = strchr(lpLine, '\n');
+        lpEnd = lpEnd != nullptr ? lpEnd : lpLine + strlen(lpLine);
+        auto lpBegin = strchr(lpLine, '{');
+        if (lpBegin != nullptr && lpBegin < lpEnd)
+        {
+            auto lpLast = lpEnd[-1] == ',' ? lpEnd - 1 : lpEnd;
+            strLines.append(lpBegin, lpLast - lpBegin).append(1, '\n');
+        }
+        lpLine = *lpEnd != '\0' ? lpEnd + 1 : lpEnd;
+    }
+
+    return strLines;
+}
+
+void BenchJsonLines(const std::string &strJson, int iRounds)
+{
+    auto strLines = MakeLines(strJson);
+    double dBest = 0;
+    std::string strLine;
+    for (int i = 0; i < iRounds; i++)
+    {
+        auto dBegin = NowSeconds();
+        for (uint64_t uPos = 0; uPos < strLines.size();)
+        {
+            auto uEnd = strLines.find('\n', uPos);
+            strLine.assign(strLines, uPos, uEnd - uPos);
+            auto lpJsonObj = NewJsonObject();
+            lpJsonObj->OpenFromBuffer(strLine.c_str());
+            DeleteJsonObject(lpJsonObj);
+            uPos = uEnd + 1;
+        }
+        auto dElapsed = NowSeconds() - dBegin;
+        if (dBest == 0 || dElapsed < dBest)
+        {
+            dBest = dElapsed;
+        }
+    }
+    printf("%-32s %10.1f MB/s\n", "JSON Lines (serial, per line)", strLines.size() / dBest / 1e6);
+
+    std::vector<uint32_t> vecThreads{1};
+    if (std::thread::hardware_concurrency() > 1)
+    {
+        vecThreads.push_back(std::thread::hardware_concurrency());
+    }
+    for (auto uThreads : vecThreads)
+    {
+        auto lpReader = NewJsonLinesReader(uThreads, -1, 0, true);
+        dBest = 0;
+        for (int i = 0; i < iRounds; i++)
+        {
+            CLinesCounter counter;
+            auto dBegin = NowSeconds();
+            lpReader->ReadBuffer(strLines.data(), strLines.size(), &counter);
+            auto dElapsed = NowSeconds() - dBegin;
+            if (dBest == 0 || dElapsed < dBest)
+            {
+                dBest = dElapsed;
+            }
+        }
+        DeleteJsonLinesReader(lpReader);
+
+        char szName[64];
+        snprintf(szName, sizeof(szName), "JSON Lines (reader, %u threads)", uThreads);
+        printf("%-32s %10.1f MB/s\n", szName, strLines.size() / dBest / 1e6);
+    }
+}
+
+// the same records back to back: an arena document per record against one
+// stream reusing its document
+void BenchDocStream(const std::string &strJson, int iRounds)
+{
+    auto strDocs = MakeLines(strJson);
+    double dBest = 0;
+    std::string strDoc;
+    for (int i = 0; i < iRounds; i++)
+    {
+        auto dBegin = NowSeconds();
+        for (uint64_t uPos = 0; uPos < strDocs.size();)
+        {
+            auto uEnd = strDocs.find('\n', uPos);
+            strDoc.assign(strDocs, uPos, uEnd - uPos);
+            auto lpJsonObj = NewArenaJsonObject(0);
+            lpJsonObj->OpenFromBuffer(strDoc.c_str());
+            DeleteJsonObject(lpJsonObj);
+            uPos = uEnd + 1;
+        }
+        auto dElapsed = NowSeconds() - dBegin;
+        if (dBest == 0 || dElapsed < dBest)
+        {
+            dBest = dElapsed;
+        }
+    }
+    printf("%-32s %10.1f MB/s\n", "Concatenated (arena per doc)", strDocs.size() / dBest / 1e6);
+
+    auto lpStream = NewJsonDocStream(0);
+    dBest = 0;
+    for (int i = 0; i < iRounds; i++)
+    {
+        auto dBegin = NowSeconds();
+        lpStream->OpenBuffer(strDocs.data(), strDocs.size());
+        cppbase::IJsonObj *lpDoc = nullptr;
+        while (lpStream->Next(&lpDoc) == 0 && lpDoc != nullptr)
+        {
+        }
+        auto dElapsed = NowSeconds() - dBegin;
+        if (dBest == 0 || dElapsed < dBest)
+        {
+            dBest = dElapsed;
+        }
+    }
+    DeleteJsonDocStream(lpStream);
+    printf("%-32s %10.1f MB/s\n", "Concatenated (doc stream)", strDocs.size() / dBest / 1e6);
+}
+
+// one document per record, as a request loop parses its messages: made and
+// deleted each time against cleared and reused
+void BenchReuse(const std::string &strJson, int iRounds)
+{
+    auto strDocs = MakeLines(strJson);
+    std::vector<std::string> vecDocs;
+    for (uint64_t uPos = 0; uPos < strDocs.size();)
+    {
+        auto uEnd = strDocs.find('\n', uPos);
+        vecDocs.emplace_back(strDocs, uPos, uEnd - uPos);
+        uPos = uEnd + 1;
+    }
+
+    struct
+    {
+        const char *lpName;
+        int iMode;
+    } szModes[] = {{"Per message (new/delete)", 0},
+                   {"Per message (arena new/delete)", 1},
+                   {"Per message (Clear)", 2},
+                   {"Per message (pool)", 3}};
+    for (auto &stMode : szModes)
+    {
+        double dBest = 0;
+        auto lpReused = NewJsonObject();
+        for (int i = 0; i < iRounds; i++)
+        {
+            auto dBegin = NowSeconds();
+            for (auto &strDoc : vecDocs)
+            {
+                switch (stMode.iMode)
+                {
+                    case 0:
+                    {
+                        auto lpJsonObj = NewJsonObject();
+                        lpJsonObj->OpenFromBuffer(strDoc.c_str());
+                        DeleteJsonObject(lpJsonObj);
+                        break;
+                    }
+
+                    case 1:
+                    {
+                        auto lpJsonObj = NewArenaJsonObject(0);
+                        lpJsonObj->OpenFromBuffer(strDoc.c_str());
+                        DeleteJsonObject(lpJsonObj);
+                        break;
+                    }
+
+                    case 2:
+                        lpReused->OpenFromBuffer(strDoc.c_str());
+                        lpReused->Clear();
+                        break;
+
+                    default:
+                    {
+                        auto lpJsonObj = AcquireJsonObject();
+                        lpJsonObj->OpenFromBuffer(strDoc.c_str());
+                        ReleaseJsonObject(lpJsonObj);
+                        break;
+                    }
+                }
+            }
+            auto dElapsed = NowSeconds() - dBegin;
+            if (dBest == 0 || dElapsed < dBest)
+            {
+                dBest = dElapsed;
+            }
+        }
+        DeleteJsonObject(lpReused);
+        printf("%-32s %10.1f MB/s\n", stMode.lpName, strDocs.size() / dBest / 1e6);
+    }
+}
+
+// what the parsed document holds on to, per byte of input
+void BenchMemory(const char *lpName, cppbase::IJsonObj *(*lpNewJsonObject)(), const std::string &strJson)
+{
+    auto stBefore = mallinfo2();
+    auto lpJsonObj = lpNewJsonObject();
+    auto iErrorNo = lpJsonObj->OpenFromBuffer(strJson.c_str());
+    auto stAfter = mallinfo2();
+    DeleteJsonObject(lpJsonObj);
+    if (iErrorNo != 0)
+    {
+        printf("parse failed: %d\n", iErrorNo);
+        return;
+    }
+
+    auto uBytes = (stAfter.uordblks + stAfter.hblkhd) - (stBefore.uordblks + stBefore.hblkhd);
+    printf("%-32s %10.1f MB    (%.2f x input)\n", lpName, uBytes / 1e6, double(uBytes) / strJson.size());
+}
+
+// network-sized pieces, as they come off a socket
+void BenchPush(const std::string &strJson, int iRounds)
+{
+    constexpr uint64_t PieceSize = 1460;
+    double dBest = 0, dDomBest = 0;
+    for (int i = 0; i < iRounds; i++)
+    {
+        CPriceHandler handler;
+        auto lpParser = NewJsonPushParser(&handler);
+        auto lpJsonObj = NewArenaJsonObject(0);
+        auto lpDomParser = NewJsonObjPushParser(lpJsonObj);
+        int32_t iErrorNo = 0;
+
+        auto dBegin = NowSeconds();
+        for (uint64_t uPos = 0; uPos < strJson.size() && iErrorNo == 0; uPos += PieceSize)
+        {
+            iErrorNo = lpParser->Feed(strJson.data() + uPos, std::min(PieceSize, strJson.size() - uPos));
+        }
+        iErrorNo = iErrorNo != 0 ? iErrorNo : lpParser->Finish();
+        auto dElapsed = NowSeconds() - dBegin;
+
+        dBegin = NowSeconds();
+        for (uint64_t uPos = 0; uPos < strJson.size() && iErrorNo == 0; uPos += PieceSize)
+        {
+            iErrorNo = lpDomParser->Feed(strJson.data() + uPos, std::min(PieceSize, strJson.size() - uPos));
+        }
+        iErrorNo = iErrorNo != 0 ? iErrorNo : lpDomParser->Finish();
+        auto dDomElapsed = NowSeconds() - dBegin;
+
+        DeleteJsonPushParser(lpDomParser);
+        DeleteJsonObject(lpJsonObj);
+        DeleteJsonPushParser(lpParser);
+        if (iErrorNo != 0)
+        {
+            printf("push parse failed: %d\n", iErrorNo);
+            return;
+        }
+        if (dBest == 0 || dElapsed < dBest)
+        {
+            dBest = dElapsed;
+        }
+        if (dDomBest == 0 || dDomElapsed < dDomBest)
+        {
+            dDomBest = dDomElapsed;
+        }
+    }
+
+    printf("%-32s %10.1f MB/s\n", "Feed 1460 B pieces (handler)", strJson.size() / dBest / 1e6);
+    printf("%-32s %10.1f MB/s\n", "Feed 1460 B pieces (arena DOM)", strJson.size() / dDomBest / 1e6);
+}
+
+void BenchParseInSitu(const std::string &strJson, int iRounds)
+{
+    std::vector<char> vecBuffer;
+    double dBest = 0;
+    for (int i = 0; i < iRounds; i++)
+    {
+        // the parse rewrites its input, every round starts from a fresh copy
+        vecBuffer.assign(strJson.begin(), strJson.end());
+        auto lpJsonObj = NewArenaJsonObject(0);
+        auto dBegin = NowSeconds();
+        auto iErrorNo = lpJsonObj->OpenFromBufferInSitu(vecBuffer.data(), vecBuffer.size());
+        auto dElapsed = NowSeconds() - dBegin;
+        DeleteJsonObject(lpJsonObj);
+        if (iErrorNo != 0)
+        {
+            printf("parse failed: %d\n", iErrorNo);
+            return;
+        }
+        if (dBest == 0 || dElapsed < dBest)
+        {
+            dBest = dElapsed;
+        }
+    }
+
+    printf("%-32s %10.1f MB/s\n", "OpenFromBufferInSitu (arena)", strJson.size() / dBest / 1e6);
+}
+
+void BenchOpenFile(const std::string &strJson, int iRounds)
+{
+    char szFile[] = "/tmp/json_obj_benchmark_XXXXXX";
+    auto iFd = mkstemp(szFile);
+    if (iFd < 0 || write(iFd, strJson.data(), strJson.size()) != ssize_t(strJson.size()))
+    {
+        printf("write temp file failed\n");
+        return;
+    }
+    close(iFd);
+
+    double dBest = 0;
+    for (int i = 0; i < iRounds; i++)
+    {
+        auto lpJsonObj = NewArenaJsonObject(0);
+        auto dBegin = NowSeconds();
+        auto iErrorNo = lpJsonObj->OpenFromFile(szFile);
+        auto dElapsed = NowSeconds() - dBegin;
+        DeleteJsonObject(lpJsonObj);
+        if (iErrorNo != 0)
+        {
+            printf("open failed: %d\n", iErrorNo);
+            break;
+        }
+        if (dBest == 0 || dElapsed < dBest)
+        {
+            dBest = dElapsed;
+        }
+    }
+
+    unlink(szFile);
+    printf("%-32s %10.1f MB/s\n", "OpenFromFile (arena, mmap)", strJson.size() / dBest / 1e6);
+}
+
+// the fields of a cache-resident set of records, by string and by prepared key
+void BenchSnapshot(const std::string &strJson, int iRounds)
+{
+    char szJsonFile[] = "/tmp/json_obj_benchmark_XXXXXX";
+    char szSnapshotFile[] = "/tmp/json_obj_benchmark_XXXXXX";
+    auto iFd = mkstemp(szJsonFile);
+    auto iSnapshotFd = mkstemp(szSnapshotFile);
+    if (iFd < 0 || iSnapshotFd < 0 || write(iFd, strJson.data(), strJson.size()) != ssize_t(strJson.size()))
+    {
+        printf("write temp file failed\n");
+        return;
+    }
+    close(iFd);
+    close(iSnapshotFd);
+
+    auto lpJsonObj = NewArenaJsonObject(0);
+    auto iErrorNo = lpJsonObj->OpenFromBuffer(strJson.c_str());
+    iErrorNo = iErrorNo == 0 ? lpJsonObj->SaveSnapshot(szSnapshotFile) : iErrorNo;
+    DeleteJsonObject(lpJsonObj);
+
+    // from the file to one record read, the pages being in the page cache
+    double szBest[2] = {0, 0};
+    int64_t nSum = 0;
+    for (int i = 0; i < iRounds && iErrorNo == 0; i++)
+    {
+        for (int j = 0; j < 2 && iErrorNo == 0; j++)
+        {
+            lpJsonObj = j == 0 ? NewArenaJsonObject(0) : NewSnapshotJsonObject();
+            auto dBegin = NowSeconds();
+            iErrorNo = j == 0 ? lpJsonObj->OpenFromFile(szJsonFile) : lpJsonObj->OpenSnapshot(szSnapshotFile);
+            cppbase::IJsonObj::KvItem kvItem;
+            if (iErrorNo == 0 && (iErrorNo = lpJsonObj->GetItem(lpJsonObj->GetSize() / 2, &kvItem)) == 0)
+            {
+                nSum += kvItem.lpObj->GetInt("id") + kvItem.lpObj->GetObject("book")->GetInt("ts");
+            }
+            auto dElapsed = NowSeconds() - dBegin;
+            DeleteJsonObject(lpJsonObj);
+            szBest[j] = szBest[j] == 0 || dElapsed < szBest[j] ? dElapsed : szBest[j];
+        }
+    }
+
+    struct stat stStat;
+    stat(szSnapshotFile, &stStat);
+    unlink(szJsonFile);
+    unlink(szSnapshotFile);
+    if (iErrorNo != 0)
+    {
+        printf("snapshot failed: %d\n", iErrorNo);
+        return;
+    }
+
+    printf("%-32s %10.3f ms\n", "OpenFromFile + pick (arena)", szBest[0] * 1e3);
+    printf("%-32s %10.3f ms  (%.1f MB file, %ld)\n", "OpenSnapshot + pick", szBest[1] * 1e3, stStat.st_size / 1e6,
+           nSum / iRounds / 2);
+}
+
+void BenchLookup(const std::string &strJson, int iRounds)
+{
+    auto lpJsonObj = NewArenaJsonObject(0);
+    if (lpJsonObj->OpenFromBuffer(strJson.c_str()) != 0)
+    {
+        printf("parse failed\n");
+        DeleteJsonObject(lpJsonObj);
+        return;
+    }
+
+    static const cppbase::IJsonObj::Key stId("id"), stSymbol("symbol"), stPrice("price"), stQty("qty"),
+        stSide("side"), stActive("active"), stBook("book"), stTs("ts");
+    constexpr uint32_t HotRecords = 1024;
+    auto uCount = lpJsonObj->GetSize();
+    uint32_t uHot = uCount < HotRecords ? uCount : HotRecords;
+    double dBest = 0, dKeyBest = 0, dLiteralBest = 0, dViewBest = 0;
+    int64_t nSum = 0, nKeySum = 0, nLiteralSum = 0, nViewSum = 0;
+    cppbase::CJsonView root(lpJsonObj);
+    for (int i = 0; i < iRounds; i++)
+    {
+        cppbase::IJsonObj::KvItem kvItem;
+        auto dBegin = NowSeconds();
+        for (uint32_t j = 0; j < uCount; j++)
+        {
+            lpJsonObj->GetItem(j % uHot, &kvItem);
+            auto lpRecord = kvItem.lpObj;
+            nSum += lpRecord->GetInt("id", 0) + lpRecord->GetInt("qty", 0) + int64_t(lpRecord->GetDouble("price", 0.0));
+            nSum += lpRecord->GetString("symbol", "")[0] + lpRecord->GetString("side", "")[0] + lpRecord->GetBool("active");
+            auto lpBook = lpRecord->GetObject("book");
+            nSum += lpBook != nullptr ? lpBook->GetInt("ts", 0) : 0;
+        }
+        auto dElapsed = NowSeconds() - dBegin;
+        dBest = dBest == 0 || dElapsed < dBest ? dElapsed : dBest;
+
+        dBegin = NowSeconds();
+        for (uint32_t j = 0; j < uCount; j++)
+        {
+            lpJsonObj->GetItem(j % uHot, &kvItem);
+            auto lpRecord = kvItem.lpObj;
+            nKeySum += lpRecord->GetInt(stId, 0) + lpRecord->GetInt(stQty, 0) + int64_t(lpRecord->GetDouble(stPrice, 0.0));
+            nKeySum += lpRecord->GetString(stSymbol, "")[0] + lpRecord->GetString(stSide, "")[0] + lpRecord->GetBool(stActive);
+            auto lpBook = lpRecord->GetObject(stBook);
+            nKeySum += lpBook != nullptr ? lpBook->GetInt(stTs, 0) : 0;
+        }
+        dElapsed = NowSeconds() - dBegin;
+        dKeyBest = dKeyBest == 0 || dElapsed < dKeyBest ? dElapsed : dKeyBest;
+
+        dBegin = NowSeconds();
+        for (uint32_t j = 0; j < uCount; j++)
+        {
+            lpJsonObj->GetItem(j % uHot, &kvItem);
+            auto lpRecord = kvItem.lpObj;
+            nLiteralSum += lpRecord->Get<int64_t>(JKEY("id")) + lpRecord->Get<int64_t>(JKEY("qty")) +
+                           int64_t(lpRecord->Get<double>(JKEY("price")));
+            nLiteralSum += lpRecord->Get(JKEY("symbol"), "")[0] + lpRecord->Get(JKEY("side"), "")[0] +
+                           lpRecord->Get<bool>(JKEY("active"));
+            auto lpBook = lpRecord->GetObject(JKEY("book"));
+            nLiteralSum += lpBook != nullptr ? lpBook->Get<int64_t>(JKEY("ts")) : 0;
+        }
+        dElapsed = NowSeconds() - dBegin;
+        dLiteralBest = dLiteralBest == 0 || dElapsed < dLiteralBest ? dElapsed : dLiteralBest;
+
+        dBegin = NowSeconds();
+        for (uint32_t j = 0; j < uCount; j++)
+        {
+            auto record = root.At<cppbase::CJsonView>(j % uHot);
+            nViewSum += record.Get<int64_t>(JKEY("id")) + record.Get<int64_t>(JKEY("qty")) +
+                        int64_t(record.Get<double>(JKEY("price")));
+            nViewSum += record.Get(JKEY("symbol"), "")[0] + record.Get(JKEY("side"), "")[0] +
+                        record.Get<bool>(JKEY("active"));
+            nViewSum += record.Get<cppbase::CJsonView>(JKEY("book")).Get<int64_t>(JKEY("ts"));
+        }
+        dElapsed = NowSeconds() - dBegin;
+        dViewBest = dViewBest == 0 || dElapsed < dViewBest ? dElapsed : dViewBest;
+    }
+
+    DeleteJsonObject(lpJsonObj);
+    auto uLookups = uint64_t(uCount) * 8;
+    printf("%-32s %10.1f ns/lookup\n", "Get (const char *)", dBest / uLookups * 1e9);
+    printf("%-32s %10.1f ns/lookup\n", "Get (Key)", dKeyBest / uLookups * 1e9);
+    printf("%-32s %10.1f ns/lookup\n", "Get<T> (JKEY)", dLiteralBest / uLookups * 1e9);
+    printf("%-32s %10.1f ns/lookup%s\n", "CJsonView Get<T> (JKEY)", dViewBest / uLookups * 1e9,
+           nKeySum != nSum || nLiteralSum != nSum || nViewSum != nSum ? "  (mismatch)" : "");
+}
+
+// records read by every cpu at once: a frozen copy read without locks,
+// against the document it was made of behind a mutex
+void BenchFreeze(const std::string &strJson, int iRounds)
+{
+    auto lpJsonObj = NewArenaJsonObject(0);
+    if (lpJsonObj->OpenFromBuffer(strJson.c_str()) != 0)
+    {
+        printf("parse failed\n");
+        DeleteJsonObject(lpJsonObj);
+        return;
+    }
+
+    auto dBegin = NowSeconds();
+    auto lpFrozen = lpJsonObj->Freeze();
+    auto dFreeze = NowSeconds() - dBegin;
+    if (lpFrozen == nullptr)
+    {
+        printf("freeze failed\n");
+        DeleteJsonObject(lpJsonObj);
+        return;
+    }
+
+    constexpr uint32_t HotRecords = 1024;
+    constexpr uint32_t ThreadRecords = 200000;
+    uint32_t uThreads = std::max(2u, std::thread::hardware_concurrency());
+    uint32_t uHot = std::min(lpJsonObj->GetSize(), HotRecords);
+    std::mutex mutex;
+    double szBest[2] = {0, 0};
+    int64_t szSum[2] = {0, 0};
+    for (int i = 0; i < iRounds; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            std::vector<int64_t> vecSums(uThreads, 0);
+            std::vector<std::thread> vecThreads;
+            dBegin = NowSeconds();
+            for (uint32_t t = 0; t < uThreads; t++)
+            {
+                vecThreads.emplace_back([&, j, t]() {
+                    auto lpDoc = j == 0 ? lpFrozen : lpJsonObj;
+                    cppbase::IJsonObj::KvItem kvItem;
+                    int64_t nSum = 0;
+                    for (uint32_t k = 0; k < ThreadRecords; k++)
+                    {
+                        std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+                        if (j == 1)
+                        {
+                            lock.lock();
+                        }
+                        lpDoc->GetItem((k + t) % uHot, &kvItem);
+                        auto lpRecord = kvItem.lpObj;
+                        nSum += lpRecord->Get<int64_t>(JKEY("id")) + lpRecord->Get<int64_t>(JKEY("qty"));
+                        nSum += lpRecord->GetObject(JKEY("book"))->Get<int64_t>(JKEY("ts"));
+                    }
+                    vecSums[t] = nSum;
+                });
+            }
+            for (auto &thread : vecThreads)
+            {
+                thread.join();
+            }
+            auto dElapsed = NowSeconds() - dBegin;
+            szBest[j] = szBest[j] == 0 || dElapsed < szBest[j] ? dElapsed : szBest[j];
+            for (auto nSum : vecSums)
+            {
+                szSum[j] += nSum;
+            }
+        }
+    }
+
+    DeleteJsonObject(lpFrozen);
+    DeleteJsonObject(lpJsonObj);
+    auto uRecords = uint64_t(uThreads) * ThreadRecords;
+    printf("%-32s %10.3f ms\n", "Freeze", dFreeze * 1e3);
+    printf("%-32s %10.1f ns/record  (%u threads)\n", "Frozen, no lock", szBest[0] / uRecords * 1e9, uThreads);
+    printf("%-32s %10.1f ns/record%s\n", "Arena, std::mutex", szBest[1] / uRecords * 1e9,
+           szSum[0] != szSum[1] ? "  (mismatch)" : "");
+}
+
+// every member of one wide object, by index and by cursor
+void BenchWalk(int iRounds)
+{
+    constexpr uint32_t Members = 20000;
+    std::string strJson = "{";
+    for (uint32_t i = 0; i < Members; i++)
+    {
+        strJson += (i == 0 ? "\"k" : ", \"k") + std::to_string(i) + "\": " + std::to_string(i);
+    }
+    strJson += "}";
+
+    auto lpJsonObj = NewJsonObject();
+    if (lpJsonObj->OpenFromBuffer(strJson.c_str()) != 0)
+    {
+        printf("parse failed\n");
+        DeleteJsonObject(lpJsonObj);
+        return;
+    }
+
+    double dBest = 0, dCursorBest = 0;
+    int64_t nSum = 0;
+    for (int i = 0; i < iRounds; i++)
+    {
+        cppbase::IJsonObj::KvItem kvItem;
+        auto dBegin = NowSeconds();
+        for (uint32_t j = 0; j < Members; j++)
+        {
+            lpJsonObj->GetItem(j, &kvItem);
+            nSum += kvItem.nValue;
+        }
+        auto dElapsed = NowSeconds() - dBegin;
+        dBest = dBest == 0 || dElapsed < dBest ? dElapsed : dBest;
+
+        cppbase::IJsonObj::Cursor stCursor;
+        dBegin = NowSeconds();
+        for (bool bHas = lpJsonObj->First(&stCursor, &kvItem); bHas; bHas = lpJsonObj->Next(&stCursor, &kvItem))
+        {
+            nSum -= kvItem.nValue;
+        }
+        dElapsed = NowSeconds() - dBegin;
+        dCursorBest = dCursorBest == 0 || dElapsed < dCursorBest ? dElapsed : dCursorBest;
+    }
+
+    DeleteJsonObject(lpJsonObj);
+    printf("%-32s %10.1f ns/member\n", "walk 20000 members (GetItem)", dBest / Members * 1e9);
+    printf("%-32s %10.1f ns/member%s\n", "walk 20000 members (cursor)", dCursorBest / Members * 1e9,
+           nSum != 0 ? "  (mismatch)" : "");
+}
+
+void BenchSerialize(const char *lpName, const std::string &strJson, bool bPretty, int iRounds)
+{
+    auto lpJsonObj = NewJsonObject();
+    if (lpJsonObj->OpenFromBuffer(strJson.c_str()) != 0)
+    {
+        printf("parse failed\n");
+        DeleteJsonObject(lpJsonObj);
+        return;
+    }
+
+    // the first call sizes the output buffer, the timed ones reuse it
+    auto lpOutput = lpJsonObj->GetJsonStr(bPretty);
+    auto uOutputLen = lpOutput != nullptr ? strlen(lpOutput) : 0;
+
+    double dBest = 0;
+    for (int i = 0; i < iRounds && lpOutput != nullptr; i++)
+    {
+        auto dBegin = NowSeconds();
+        lpOutput = lpJsonObj->GetJsonStr(bPretty);
+        auto dElapsed = NowSeconds() - dBegin;
+        if (dBest == 0 || dElapsed < dBest)
+        {
+            dBest = dElapsed;
+        }
+    }
+
+    if (lpOutput == nullptr)
+    {
+        printf("serialize failed\n");
+    }
+    else
+    {
+        printf("%-32s %10.1f MB/s  (%.1f MB out)\n", lpName, uOutputLen / dBest / 1e6, uOutputLen / 1e6);
+    }
+
+    DeleteJsonObject(lpJsonObj);
+}
+
+void BenchBinary(const char *lpName, cppbase::IJsonObj::BinaryFormat eFormat, const std::string &strJson, int iRounds)
+{
+    auto lpJsonObj = NewArenaJsonObject(0);
+    uint64_t uLen = 0;
+    auto lpBinary = lpJsonObj->OpenFromBuffer(strJson.c_str()) == 0 ? lpJsonObj->GetBinary(eFormat, &uLen) : nullptr;
+    if (lpBinary == nullptr)
+    {
+        printf("encode failed\n");
+        DeleteJsonObject(lpJsonObj);
+        return;
+    }
+    std::string strBinary(lpBinary, uLen);
+
+    // both rates are of the json text the binary form stands for, so that
+    // they compare with OpenFromBuffer and GetJsonStr
+    double dEncodeBest = 0;
+    double dDecodeBest = 0;
+    for (int i = 0; i < iRounds && lpBinary != nullptr; i++)
+    {
+        auto dBegin = NowSeconds();
+        lpBinary = lpJsonObj->GetBinary(eFormat, &uLen);
+        auto dElapsed = NowSeconds() - dBegin;
+        dEncodeBest = dEncodeBest == 0 || dElapsed < dEncodeBest ? dElapsed : dEncodeBest;
+
+        auto lpDecoded = NewArenaJsonObject(0);
+        dBegin = NowSeconds();
+        auto iErrorNo = lpDecoded->OpenFromBinary(strBinary.data(), strBinary.size(), eFormat);
+        dElapsed = NowSeconds() - dBegin;
+        DeleteJsonObject(lpDecoded);
+        dDecodeBest = dDecodeBest == 0 || dElapsed < dDecodeBest ? dElapsed : dDecodeBest;
+        lpBinary = iErrorNo == 0 ? lpBinary : nullptr;
+    }
+
+    if (lpBinary == nullptr)
+    {
+        printf("binary round trip failed\n");
+    }
+    else
+    {
+        printf("%-32s %10.1f MB/s encode %10.1f MB/s decode  (%.1f MB, %.0f%% of json)\n", lpName,
+               strJson.size() / dEncodeBest / 1e6, strJson.size() / dDecodeBest / 1e6, strBinary.size() / 1e6,
+               100.0 * strBinary.size() / strJson.size());
+    }
+
+    DeleteJsonObject(lpJsonObj);
+}
+
+struct Book
+{
+    std::vector<int64_t> bid;
+    std::vector<int64_t> ask;
+    int64_t ts{0};
+};
+
+struct Record
+{
+    int64_t id{0};
+    std::string symbol;
+    double price{0};
+    int64_t qty{0};
+    std::string side;
+    bool active{false};
+    std::vector<std::string> tags;
+    Book book;
+};
+
+CPPBASE_JSON_FIELDS(Book, bid, ask, ts)
+CPPBASE_JSON_FIELDS(Record, id, symbol, price, qty, side, active, tags, book)
+
+// what reading records into structs costs without the binding
+void CopyRecords(cppbase::IJsonObj *lpJsonObj, std::vector<Record> &vecRecords)
+{
+    static const cppbase::IJsonObj::Key keyId("id"), keySymbol("symbol"), keyPrice("price"), keyQty("qty"),
+        keySide("side"), keyActive("active"), keyTags("tags"), keyBook("book"), keyBid("bid"), keyAsk("ask"),
+        keyTs("ts");
+    cppbase::IJsonObj::Cursor cursor, itemCursor;
+    cppbase::IJsonObj::KvItem kvItem, kvValue;
+    vecRecords.clear();
+    for (auto bMore = lpJsonObj->First(&cursor, &kvItem); bMore; bMore = lpJsonObj->Next(&cursor, &kvItem))
+    {
+        vecRecords.emplace_back();
+        auto &record = vecRecords.back();
+        auto lpRecord = kvItem.lpObj;
+        record.id = lpRecord->GetInt(keyId);
+        record.symbol = lpRecord->GetString(keySymbol, "");
+        record.price = lpRecord->GetDouble(keyPrice);
+        record.qty = lpRecord->GetInt(keyQty);
+        record.side = lpRecord->GetString(keySide, "");
+        record.active = lpRecord->GetBool(keyActive);
+        auto lpTags = lpRecord->GetArray(keyTags);
+        for (auto bItem = lpTags != nullptr && lpTags->First(&itemCursor, &kvValue); bItem;
+             bItem = lpTags->Next(&itemCursor, &kvValue))
+        {
+            record.tags.emplace_back(kvValue.strValue);
+        }
+        auto lpBook = lpRecord->GetObject(keyBook);
+        if (lpBook == nullptr)
+        {
+            continue;
+        }
+        record.book.ts = lpBook->GetInt(keyTs);
+        auto lpSides = {std::make_pair(lpBook->GetArray(keyBid), &record.book.bid),
+                        std::make_pair(lpBook->GetArray(keyAsk), &record.book.ask)};
+        for (auto &side : lpSides)
+        {
+            for (auto bItem = side.first != nullptr && side.first->First(&itemCursor, &kvValue); bItem;
+                 bItem = side.first->Next(&itemCursor, &kvValue))
+            {
+                side.second->push_back(kvValue.nValue);
+            }
+        }
+    }
+}
+
+void BenchBinding(const std::string &strJson, int iRounds)
+{
+    std::vector<Record> vecRecords;
+    std::string strOutput;
+    double szBest[3] = {0, 0, 0};
+    int32_t iErrorNo = 0;
+    for (int i = 0; i < iRounds && iErrorNo == 0; i++)
+    {
+        auto lpJsonObj = NewArenaJsonObject(0);
+        auto dBegin = NowSeconds();
+        iErrorNo = lpJsonObj->OpenFromBuffer(strJson.c_str());
+        if (iErrorNo == 0)
+        {
+            CopyRecords(lpJsonObj, vecRecords);
+        }
+        DeleteJsonObject(lpJsonObj);
+        auto dElapsed = NowSeconds() - dBegin;
+        szBest[0] = szBest[0] == 0 || dElapsed < szBest[0] ? dElapsed : szBest[0];
+
+        dBegin = NowSeconds();
+        iErrorNo = iErrorNo == 0 ? cppbase::ParseJsonStruct(strJson.data(), strJson.size(), vecRecords) : iErrorNo;
+        dElapsed = NowSeconds() - dBegin;
+        szBest[1] = szBest[1] == 0 || dElapsed < szBest[1] ? dElapsed : szBest[1];
+
+        dBegin = NowSeconds();
+        cppbase::WriteJsonStruct(vecRecords, strOutput);
+        dElapsed = NowSeconds() - dBegin;
+        szBest[2] = szBest[2] == 0 || dElapsed < szBest[2] ? dElapsed : szBest[2];
+    }
+
+    if (iErrorNo != 0)
+    {
+        printf("struct binding failed: %d\n", iErrorNo);
+        return;
+    }
+
+    printf("%-32s %10.1f MB/s\n", "OpenFromBuffer + copy (arena)", strJson.size() / szBest[0] / 1e6);
+    printf("%-32s %10.1f MB/s  (%zu records)\n", "ParseJsonStruct", strJson.size() / szBest[1] / 1e6,
+           vecRecords.size());
+    printf("%-32s %10.1f MB/s  (%.1f MB out)\n", "WriteJsonStruct", strOutput.size() / szBest[2] / 1e6,
+           strOutput.size() / 1e6);
+}
+
+cppbase::IJsonObj *NewDefaultArenaJsonObject()
+{
+    return NewArenaJsonObject(0);
+}
+
+cppbase::IJsonObj *NewDefaultParallelJsonObject()
+{
+    return NewParallelJsonObject(0);
+}
+
+cppbase::IJsonObj *NewTwoThreadJsonObject()
+{
+    return NewParallelJsonObject(2);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t uSize = (argc > 1 ? strtoull(argv[1], nullptr, 10) : 64) << 20;
+    int iRounds = argc > 2 ? atoi(argv[2]) : 5;
+
+    auto strJson = MakeDocument(uSize);
+    printf("document: %.1f MB, %d rounds\n", strJson.size() / 1e6, iRounds);
+
+    BenchScan(strJson, iRounds);
+    BenchParse("OpenFromBuffer", NewJsonObject, strJson, iRounds);
+    BenchParse("OpenFromBuffer (arena)", NewDefaultArenaJsonObject, strJson, iRounds);
+    BenchParse("OpenFromBuffer (tape)", NewTapeJsonObject, strJson, iRounds);
+    BenchParse("OpenFromBuffer (lazy)", NewLazyJsonObject, strJson, iRounds);
+    BenchParse("OpenFromBuffer (parallel, 2)", NewTwoThreadJsonObject, strJson, iRounds);
+    BenchParse("OpenFromBuffer (parallel)", NewDefaultParallelJsonObject, strJson, iRounds);
+    BenchParseInSitu(strJson, iRounds);
+    BenchProjection(strJson, iRounds);
+    BenchSax(strJson, iRounds);
+    BenchPush(strJson, iRounds);
+    BenchJsonLines(strJson, iRounds);
+    BenchDocStream(strJson, iRounds);
+    BenchReuse(strJson, iRounds);
+    auto strNumbers = MakeNumberDocument(uSize);
+    BenchNumbers(strNumbers, iRounds);
+    BenchMemory("DOM memory", NewJsonObject, strJson);
+    BenchMemory("DOM memory (arena)", NewDefaultArenaJsonObject, strJson);
+    BenchMemory("DOM memory (tape)", NewTapeJsonObject, strJson);
+    BenchMemory("DOM memory (lazy)", NewLazyJsonObject, strJson);
+    BenchMemory("DOM memory (numbers)", NewJsonObject, strNumbers);
+    BenchMemory("DOM memory (numbers, arena)", NewDefaultArenaJsonObject, strNumbers);
+    BenchMemory("DOM memory (numbers, tape)", NewTapeJsonObject, strNumbers);
+    BenchOpenFile(strJson, iRounds);
+    BenchSnapshot(strJson, iRounds);
+    BenchLookup(strJson, iRounds);
+    BenchFreeze(strJson, iRounds);
+    BenchPick("Pick one record (arena)", NewDefaultArenaJsonObject, strJson, iRounds);
+    BenchPick("Pick one record (tape)", NewTapeJsonObject, strJson, iRounds);
+    BenchPick("Pick one record (lazy)", NewLazyJsonObject, strJson, iRounds);
+    BenchWalk(iRounds);
+    BenchSerialize("GetJsonStr (compact)", strJson, false, iRounds);
+    BenchSerialize("GetJsonStr (pretty)", strJson, true, iRounds);
+    BenchBinary("MessagePack", cppbase::IJsonObj::BinaryFormat::MessagePack, strJson, iRounds);
+    BenchBinary("CBOR", cppbase::IJsonObj::BinaryFormat::Cbor, strJson, iRounds);
+    BenchBinding(strJson, iRounds);
+    return 0;
+}
@@ -0,0 +1,18 @@
+#!/bin/bash
+
+benchmark_path=`pwd`
+test_target_path=$benchmark_path/../../
+
+# the library defaults to -O0, build it optimized for meaningful numbers
+cd $test_target_path && echo "complite in `pwd`" && make clean && make -j EXTRA_CFLAGS="-O2 -g -std=c++11 -fPIC -fvisibility=hidden"
+if [[ $? -ne 0 ]]; then
+    echo "complite failed"
+    exit -1
+fi
+
+cd $benchmark_path
+echo "exec benchmark in `pwd`"
+
+export LD_LIBRARY_PATH=../../../bin
+
+make clean && make && $PWD/benchmark.out "$@"
@@ -0,0 +1,166 @@
+#include "json_arena.h"
+#include <error_no.h>
+
+namespace cppbase
+{
+
+CJsonArena::CJsonArena(uint64_t uChunkSize)
+    : m_uChunkSize(uChunkSize < sizeof(Chunk) * 2 ? DefaultChunkSize : ALIGN8(uChunkSize))
+{
+}
+
+CJsonArena::~CJsonArena()
+{
+    RunCleanups();
+    FreeChunks(m_lpChunk);
+    FreeChunks(m_lpSpare);
+}
+
+void CJsonArena::FreeChunks(Chunk *lpChunk)
+{
+    while (lpChunk != nullptr)
+    {
+        auto lpNext = lpChunk->lpNext;
+        free(lpChunk);
+        lpChunk = lpNext;
+    }
+}
+
+void CJsonArena::RunCleanups()
+{
+    for (auto lpCleanup = m_lpCleanup; lpCleanup != nullptr; lpCleanup = lpCleanup->lpNext)
+    {
+        lpCleanup->lpFunc(lpCleanup->lpArg);
+    }
+    m_lpCleanup = nullptr;
+}
+
+void CJsonArena::Reset(bool bKeepFirst)
+{
+    RunCleanups();
+
+    // the regular chunks in use go back to the front of the spares in the
+    // order they were made, the first one excepted
+    auto lpChunk = m_lpChunk;
+    while (lpChunk != nullptr)
+    {
+        auto lpNext = lpChunk->lpNext;
+        if (lpChunk->bDedicated)
+        {
+            m_uChunkCount--;
+            m_uChunkBytes -= lpChunk->uSize;
+            free(lpChunk);
+        }
+        else if (lpChunk != m_lpFirst)
+        {
+            lpChunk->lpNext = m_lpSpare;
+            m_lpSpare = lpChunk;
+        }
+        lpChunk = lpNext;
+    }
+
+    m_lpChunk = m_lpFirst;
+    if (m_lpFirst == nullptr)
+    {
+        m_lpCur = m_lpEnd = nullptr;
+        return;
+    }
+
+    m_uFirstSize = bKeepFirst ? m_uFirstSize : 0;
+    m_lpFirst->lpNext = nullptr;
+    m_lpCur = reinterpret_cast<char *>(m_lpFirst + 1) + m_uFirstSize;
+    m_lpEnd = reinterpret_cast<char *>(m_lpFirst) + m_lpFirst->uSize;
+}
+
+void *CJsonArena::AllocSlow(uint64_t uSize)
+{
+    // big blocks (long strings, grown containers) get a chunk of their own
+    // so the space left in the current chunk keeps serving small nodes
+    bool bDedicated = uSize > m_uChunkSize / 4;
+    auto uChunkSize = bDedicated ? uSize + sizeof(Chunk) : m_uChunkSize;
+
+    // a chunk emptied by Reset is refilled before a new one is made; one
+    // too small for the block is dropped, so the spares only grow larger
+    Chunk *lpChunk = nullptr;
+    while (!bDedicated && lpChunk == nullptr && m_lpSpare != nullptr)
+    {
+        lpChunk = m_lpSpare;
+        m_lpSpare = lpChunk->lpNext;
+        if (lpChunk->uSize < uSize + sizeof(Chunk))
+        {
+            m_uChunkCount--;
+            m_uChunkBytes -= lpChunk->uSize;
+            free(lpChunk);
+            lpChunk = nullptr;
+        }
+    }
+
+    if (lpChunk == nullptr)
+    {
+        lpChunk = reinterpret_cast<Chunk *>(malloc(uChunkSize));
+        if (unlikely(lpChunk == nullptr))
+        {
+            return nullptr;
+        }
+
+        lpChunk->uSize = uChunkSize;
+        lpChunk->bDedicated = bDedicated;
+        m_uChunkCount++;
+        m_uChunkBytes += uChunkSize;
+
+        // documents that outgrow one chunk get geometrically larger ones
+        if (!bDedicated && m_uChunkSize < MaxChunkSize)
+        {
+            m_uChunkSize *= 2;
+        }
+    }
+
+    auto lpMem = reinterpret_cast<char *>(lpChunk + 1);
+    if (bDedicated && m_lpChunk != nullptr)
+    {
+        lpChunk->lpNext = m_lpChunk->lpNext;
+        m_lpChunk->lpNext = lpChunk;
+        return lpMem;
+    }
+
+    if (!bDedicated && m_lpFirst == nullptr)
+    {
+        m_lpFirst = lpChunk;
+        m_uFirstSize = m_lpChunk == nullptr ? uSize : 0;
+    }
+
+    lpChunk->lpNext = m_lpChunk;
+    m_lpChunk = lpChunk;
+    m_lpCur = lpMem + uSize;
+    m_lpEnd = reinterpret_cast<char *>(lpChunk) + lpChunk->uSize;
+    return lpMem;
+}
+
+char *CJsonArena::StrDup(const char *lpStr, uint64_t uLen)
+{
+    auto lpDup = reinterpret_cast<char *>(Alloc(uLen + 1));
+    if (likely(lpDup != nullptr))
+    {
+        memcpy(lpDup, lpStr, uLen);
+        lpDup[uLen] = '\0';
+    }
+
+    return lpDup;
+}
+
+int32_t CJsonArena::AddCleanup(void (*lpFunc)(void *), void *lpArg)
+{
+    auto lpCleanup = reinterpret_cast<Cleanup *>(Alloc(sizeof(Cleanup)));
+    if (unlikely(lpCleanup == nullptr))
+    {
+        return MallocFailed;
+    }
+
+    lpCleanup->lpNext = m_lpCleanup;
+    lpCleanup->lpFunc = lpFunc;
+    lpCleanup->lpArg = lpArg;
+    m_lpCleanup = lpCleanup;
+    return 0;
+}
+
+}
@@ -0,0 +1,94 @@
+#ifndef __JSON_ARENA_H_
+#define __JSON_ARENA_H_
+
+#include <os_common.h>
+#include <new>
+
+namespace cppbase
+{
+
+/*
+ * Bump allocator owning every node, key and string of one json document.
+ *
+ * Memory is carved out of chained chunks whose size doubles up to
+ * MaxChunkSize; nothing is freed individually, the whole document goes
+ * away with the arena, or with Reset, which keeps the chunks for the next.
+ */
+class CJsonArena
+{
+public:
+    static constexpr uint64_t DefaultChunkSize = 64 * 1024;
+    static constexpr uint64_t MaxChunkSize = 16 * 1024 * 1024;
+
+    explicit CJsonArena(uint64_t uChunkSize = DefaultChunkSize);
+    ~CJsonArena();
+
+    CJsonArena(const CJsonArena &) = delete;
+    CJsonArena &operator=(const CJsonArena &) = delete;
+
+    inline void *Alloc(uint64_t uSize)
+    {
+        uSize = ALIGN8(uSize);
+        if (likely(uint64_t(m_lpEnd - m_lpCur) >= uSize))
+        {
+            auto lpMem = m_lpCur;
+            m_lpCur += uSize;
+            return lpMem;
+        }
+
+        return AllocSlow(uSize);
+    }
+
+    char *StrDup(const char *lpStr, uint64_t uLen);
+
+    // lpFunc(lpArg) runs when the arena is destroyed, for the few objects
+    // of a document that hold memory outside of it
+    int32_t AddCleanup(void (*lpFunc)(void *), void *lpArg);
+
+    // runs the cleanups and empties the arena for the next document while
+    // keeping its chunks, so that refilling them allocates nothing; only the
+    // dedicated chunks of big blocks are freed. bKeepFirst leaves the first
+    // allocation, the root of an arena document, where it is
+    void Reset(bool bKeepFirst = false);
+
+    // the first allocation made in the arena, while it is still in place
+    inline const void *GetFirst() const { return m_uFirstSize > 0 ? m_lpFirst + 1 : nullptr; }
+
+    inline uint64_t GetChunkCount() const { return m_uChunkCount; }
+    inline uint64_t GetChunkBytes() const { return m_uChunkBytes; }
+
+private:
+    struct Chunk
+    {
+        Chunk *lpNext;
+        uint64_t uSize;
+        bool bDedicated;
+    };
+
+    struct Cleanup
+    {
+        Cleanup *lpNext;
+        void (*lpFunc)(void *);
+        void *lpArg;
+    };
+
+    void *AllocSlow(uint64_t uSize);
+    void RunCleanups();
+    static void FreeChunks(Chunk *lpChunk);
+
+private:
+    Chunk *m_lpChunk{nullptr}; // the chunks in use, the one being filled first
+    Chunk *m_lpSpare{nullptr}; // regular chunks emptied by Reset, oldest first
+    Chunk *m_lpFirst{nullptr}; // the first regular chunk, which Reset refills first
+    uint64_t m_uFirstSize{0};  // the first allocation at its front, 0 when there is none
+    Cleanup *m_lpCleanup{nullptr};
+    char *m_lpCur{nullptr};
+    char *m_lpEnd{nullptr};
+    uint64_t m_uChunkSize;
+    uint64_t m_uChunkCount{0};
+    uint64_t m_uChunkBytes{0};
+};
+
+}
+
+#endif //__JSON_ARENA_H_
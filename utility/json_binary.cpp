@@ -0,0 +1,918 @@
+#include "json_binary.h"
+#include <error_no.h>
+#include <math.h>
+
+namespace cppbase
+{
+
+namespace
+{
+
+// both formats store numbers and lengths most significant byte first
+inline uint8_t SwapBytes(uint8_t uValue)
+{
+    return uValue;
+}
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+inline uint16_t SwapBytes(uint16_t uValue)
+{
+    return __builtin_bswap16(uValue);
+}
+
+inline uint32_t SwapBytes(uint32_t uValue)
+{
+    return __builtin_bswap32(uValue);
+}
+
+inline uint64_t SwapBytes(uint64_t uValue)
+{
+    return __builtin_bswap64(uValue);
+}
+#else
+template <typename T>
+inline T SwapBytes(T uValue)
+{
+    return uValue;
+}
+#endif
+
+template <typename T, typename F>
+inline T BitCast(F value)
+{
+    T result;
+    memcpy(&result, &value, sizeof(T));
+    return result;
+}
+
+// IEEE 754 binary16, which only CBOR has
+double HalfToDouble(uint16_t uHalf)
+{
+    auto uExp = (uHalf >> 10) & 0x1F;
+    auto uMant = uHalf & 0x3FF;
+    double dValue = 0.0;
+    if (uExp == 0)
+    {
+        dValue = ldexp(uMant, -24);
+    }
+    else if (uExp != 31)
+    {
+        dValue = ldexp(uMant + 1024, int(uExp) - 25);
+    }
+    else
+    {
+        dValue = uMant == 0 ? INFINITY : NAN;
+    }
+
+    return (uHalf & 0x8000) != 0 ? -dValue : dValue;
+}
+
+}
+
+template <typename T>
+int32_t CJsonBinaryWriter::WriteBigEndian(uint8_t uType, T value)
+{
+    auto lpOut = m_writer.Extend(1 + sizeof(T));
+    if (unlikely(lpOut == nullptr))
+    {
+        return MallocFailed;
+    }
+
+    lpOut[0] = char(uType);
+    value = SwapBytes(value);
+    memcpy(lpOut + 1, &value, sizeof(T));
+    return 0;
+}
+
+int32_t CJsonBinaryWriter::WriteByte(uint8_t uByte)
+{
+    auto lpOut = m_writer.Extend(1);
+    if (unlikely(lpOut == nullptr))
+    {
+        return MallocFailed;
+    }
+
+    lpOut[0] = char(uByte);
+    return 0;
+}
+
+int32_t CJsonBinaryWriter::WriteCborHead(uint8_t uMajor, uint64_t uValue)
+{
+    uint8_t uType = uint8_t(uMajor << 5);
+    if (uValue < 24)
+    {
+        return WriteByte(uint8_t(uType | uValue));
+    }
+    else if (uValue <= UINT8_MAX)
+    {
+        return WriteBigEndian(uType | 24, uint8_t(uValue));
+    }
+    else if (uValue <= UINT16_MAX)
+    {
+        return WriteBigEndian(uType | 25, uint16_t(uValue));
+    }
+    else if (uValue <= UINT32_MAX)
+    {
+        return WriteBigEndian(uType | 26, uint32_t(uValue));
+    }
+
+    return WriteBigEndian(uType | 27, uValue);
+}
+
+int32_t CJsonBinaryWriter::WriteNull()
+{
+    return WriteByte(m_eFormat == BinaryFormat::MessagePack ? 0xC0 : 0xF6);
+}
+
+int32_t CJsonBinaryWriter::WriteBool(bool bValue)
+{
+    if (m_eFormat == BinaryFormat::MessagePack)
+    {
+        return WriteByte(bValue ? 0xC3 : 0xC2);
+    }
+
+    return WriteByte(bValue ? 0xF5 : 0xF4);
+}
+
+int32_t CJsonBinaryWriter::WriteInt(int64_t nValue)
+{
+    if (m_eFormat == BinaryFormat::Cbor)
+    {
+        // -1 - n, which is ~n, for negative values
+        return nValue >= 0 ? WriteCborHead(CborUnsigned, uint64_t(nValue))
+                           : WriteCborHead(CborNegative, ~uint64_t(nValue));
+    }
+
+    if (nValue >= 0)
+    {
+        if (nValue < 128)
+        {
+            return WriteByte(uint8_t(nValue));
+        }
+        else if (nValue <= UINT8_MAX)
+        {
+            return WriteBigEndian(0xCC, uint8_t(nValue));
+        }
+        else if (nValue <= UINT16_MAX)
+        {
+            return WriteBigEndian(0xCD, uint16_t(nValue));
+        }
+        else if (nValue <= UINT32_MAX)
+        {
+            return WriteBigEndian(0xCE, uint32_t(nValue));
+        }
+
+        return WriteBigEndian(0xCF, uint64_t(nValue));
+    }
+
+    if (nValue >= -32)
+    {
+        return WriteByte(uint8_t(nValue));
+    }
+    else if (nValue >= INT8_MIN)
+    {
+        return WriteBigEndian(0xD0, uint8_t(nValue));
+    }
+    else if (nValue >= INT16_MIN)
+    {
+        return WriteBigEndian(0xD1, uint16_t(nValue));
+    }
+    else if (nValue >= INT32_MIN)
+    {
+        return WriteBigEndian(0xD2, uint32_t(nValue));
+    }
+
+    return WriteBigEndian(0xD3, uint64_t(nValue));
+}
+
+int32_t CJsonBinaryWriter::WriteDouble(double dValue)
+{
+    return WriteBigEndian(m_eFormat == BinaryFormat::MessagePack ? 0xCB : 0xFB, BitCast<uint64_t>(dValue));
+}
+
+int32_t CJsonBinaryWriter::WriteString(const char *lpStr, uint64_t uLen)
+{
+    int32_t iErrorNo = 0;
+    if (m_eFormat == BinaryFormat::Cbor)
+    {
+        iErrorNo = WriteCborHead(CborText, uLen);
+    }
+    else if (uLen < 32)
+    {
+        iErrorNo = WriteByte(uint8_t(0xA0 | uLen));
+    }
+    else if (uLen <= UINT8_MAX)
+    {
+        iErrorNo = WriteBigEndian(0xD9, uint8_t(uLen));
+    }
+    else if (uLen <= UINT16_MAX)
+    {
+        iErrorNo = WriteBigEndian(0xDA, uint16_t(uLen));
+    }
+    else
+    {
+        iErrorNo = WriteBigEndian(0xDB, uint32_t(uLen));
+    }
+
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    // no escaping in either format: the bytes go out as they are
+    auto lpOut = m_writer.Extend(uLen);
+    if (unlikely(lpOut == nullptr))
+    {
+        return MallocFailed;
+    }
+
+    memcpy(lpOut, lpStr, uLen);
+    return 0;
+}
+
+int32_t CJsonBinaryWriter::WriteContainer(ObjType eType, uint32_t uCount)
+{
+    bool bObject = eType == ObjType::Object;
+    if (m_eFormat == BinaryFormat::Cbor)
+    {
+        return WriteCborHead(bObject ? CborMap : CborArray, uCount);
+    }
+
+    if (uCount < 16)
+    {
+        return WriteByte(uint8_t((bObject ? 0x80 : 0x90) | uCount));
+    }
+    else if (uCount <= UINT16_MAX)
+    {
+        return WriteBigEndian(bObject ? 0xDE : 0xDC, uint16_t(uCount));
+    }
+
+    return WriteBigEndian(bObject ? 0xDF : 0xDD, uCount);
+}
+
+int32_t CJsonBinaryWriter::WriteMember(const CJsonObjImpl::_ValueType &stValue)
+{
+    switch (stValue.GetType())
+    {
+        case ObjType::Null:
+            return WriteNull();
+
+        case ObjType::Boolean:
+            return WriteBool(stValue.Load<bool>());
+
+        case ObjType::Integer:
+            return WriteInt(stValue.Load<int64_t>());
+
+        case ObjType::Double:
+            return WriteDouble(stValue.Load<double>());
+
+        case ObjType::String:
+            return WriteString(stValue.GetStr(), stValue.GetStrLen());
+
+        case ObjType::Array:
+        case ObjType::Object:
+            return WriteNode(stValue.GetObj());
+
+        default:
+            return InvaliadCall;
+    }
+}
+
+int32_t CJsonBinaryWriter::WriteNode(const CJsonObjImpl *lpObj)
+{
+    int32_t iErrorNo = 0;
+    switch (lpObj->m_eType)
+    {
+        case ObjType::Array:
+        {
+            auto &arrValue = lpObj->m_unValue.arrValue;
+            iErrorNo = WriteContainer(ObjType::Array, uint32_t(arrValue.size()));
+            for (auto iter = arrValue.begin(); iErrorNo == 0 && iter != arrValue.end(); ++iter)
+            {
+                iErrorNo = WriteMember(*iter);
+            }
+            return iErrorNo;
+        }
+
+        case ObjType::Object:
+        {
+            auto &objValue = lpObj->m_unValue.objValue;
+            iErrorNo = WriteContainer(ObjType::Object, objValue.size());
+            for (auto iter = objValue.begin(); iErrorNo == 0 && iter != objValue.end(); ++iter)
+            {
+                iErrorNo = WriteString(iter->first.lpStr, iter->first.uLen);
+                if (iErrorNo == 0)
+                {
+                    iErrorNo = WriteMember(iter->second);
+                }
+            }
+            return iErrorNo;
+        }
+
+        default:
+            return InvaliadCall;
+    }
+}
+
+int32_t CJsonBinaryWriter::WriteItem(const IJsonObj::KvItem &stItem)
+{
+    switch (stItem.eType)
+    {
+        case ObjType::Null:
+            return WriteNull();
+
+        case ObjType::Boolean:
+            return WriteBool(stItem.bValue);
+
+        case ObjType::Integer:
+            return WriteInt(stItem.nValue);
+
+        case ObjType::Double:
+            return WriteDouble(stItem.dValue);
+
+        case ObjType::String:
+            return WriteString(stItem.strValue, strlen(stItem.strValue));
+
+        case ObjType::Array:
+            return WriteNode(stItem.lpArray);
+
+        case ObjType::Object:
+            return WriteNode(stItem.lpObj);
+
+        default:
+            return InvaliadCall;
+    }
+}
+
+int32_t CJsonBinaryWriter::WriteNode(IJsonObj *lpObj)
+{
+    auto eType = lpObj->GetType();
+    if (eType != ObjType::Array && eType != ObjType::Object)
+    {
+        return InvaliadCall;
+    }
+
+    auto uSize = lpObj->GetSize();
+    auto iErrorNo = WriteContainer(eType, uSize);
+
+    // the count is written first, so a member that cannot be read fails the
+    // whole node rather than leave it short
+    uint32_t uWritten = 0;
+    IJsonObj::Cursor stCursor;
+    IJsonObj::KvItem stItem;
+    for (bool bMore = iErrorNo == 0 && lpObj->First(&stCursor, &stItem); bMore; bMore = lpObj->Next(&stCursor, &stItem))
+    {
+        if (eType == ObjType::Object)
+        {
+            iErrorNo = WriteString(stItem.lpKey, strlen(stItem.lpKey));
+        }
+        if (iErrorNo == 0)
+        {
+            iErrorNo = WriteItem(stItem);
+        }
+        if (iErrorNo != 0)
+        {
+            return iErrorNo;
+        }
+        uWritten++;
+    }
+
+    if (iErrorNo == 0 && uWritten != uSize)
+    {
+        return ParseDataFialed;
+    }
+
+    return iErrorNo;
+}
+
+template <typename T>
+bool CJsonBinaryReader::LoadBigEndian(T &value)
+{
+    if (unlikely(uint64_t(m_lpEnd - m_lpCur) < sizeof(T)))
+    {
+        return false;
+    }
+
+    memcpy(&value, m_lpCur, sizeof(T));
+    value = SwapBytes(value);
+    m_lpCur += sizeof(T);
+    return true;
+}
+
+int32_t CJsonBinaryReader::ReadPackHead(Head &stHead)
+{
+    auto uByte = *m_lpCur++;
+    if (uByte <= 0x7F)
+    {
+        stHead.eType = ObjType::Integer;
+        stHead.nValue = uByte;
+        return 0;
+    }
+    else if (uByte >= 0xE0)
+    {
+        stHead.eType = ObjType::Integer;
+        stHead.nValue = int8_t(uByte);
+        return 0;
+    }
+    else if (uByte <= 0x9F)
+    {
+        stHead.eType = uByte <= 0x8F ? ObjType::Object : ObjType::Array;
+        stHead.uCount = uByte & 0x0F;
+        return 0;
+    }
+    else if (uByte <= 0xBF)
+    {
+        stHead.eType = ObjType::String;
+        stHead.uCount = uByte & 0x1F;
+    }
+    else
+    {
+        uint8_t u8 = 0;
+        uint16_t u16 = 0;
+        uint32_t u32 = 0;
+        uint64_t u64 = 0;
+        bool bLoaded = true;
+        switch (uByte)
+        {
+            case 0xC0:
+                stHead.eType = ObjType::Null;
+                return 0;
+
+            case 0xC2:
+            case 0xC3:
+                stHead.eType = ObjType::Boolean;
+                stHead.bValue = uByte == 0xC3;
+                return 0;
+
+            // bin is read as a string of the same bytes
+            case 0xC4:
+            case 0xD9:
+                bLoaded = LoadBigEndian(u8);
+                stHead.eType = ObjType::String;
+                stHead.uCount = u8;
+                break;
+
+            case 0xC5:
+            case 0xDA:
+                bLoaded = LoadBigEndian(u16);
+                stHead.eType = ObjType::String;
+                stHead.uCount = u16;
+                break;
+
+            case 0xC6:
+            case 0xDB:
+                bLoaded = LoadBigEndian(u32);
+                stHead.eType = ObjType::String;
+                stHead.uCount = u32;
+                break;
+
+            case 0xCA:
+                bLoaded = LoadBigEndian(u32);
+                stHead.eType = ObjType::Double;
+                stHead.dValue = BitCast<float>(u32);
+                return bLoaded ? 0 : ParseDataFialed;
+
+            case 0xCB:
+                bLoaded = LoadBigEndian(u64);
+                stHead.eType = ObjType::Double;
+                stHead.dValue = BitCast<double>(u64);
+                return bLoaded ? 0 : ParseDataFialed;
+
+            case 0xCC:
+            case 0xD0:
+                bLoaded = LoadBigEndian(u8);
+                stHead.eType = ObjType::Integer;
+                stHead.nValue = uByte == 0xCC ? int64_t(u8) : int64_t(int8_t(u8));
+                return bLoaded ? 0 : ParseDataFialed;
+
+            case 0xCD:
+            case 0xD1:
+                bLoaded = LoadBigEndian(u16);
+                stHead.eType = ObjType::Integer;
+                stHead.nValue = uByte == 0xCD ? int64_t(u16) : int64_t(int16_t(u16));
+                return bLoaded ? 0 : ParseDataFialed;
+
+            case 0xCE:
+            case 0xD2:
+                bLoaded = LoadBigEndian(u32);
+                stHead.eType = ObjType::Integer;
+                stHead.nValue = uByte == 0xCE ? int64_t(u32) : int64_t(int32_t(u32));
+                return bLoaded ? 0 : ParseDataFialed;
+
+            case 0xCF:
+            case 0xD3:
+                bLoaded = LoadBigEndian(u64);
+                stHead.eType = ObjType::Integer;
+                stHead.nValue = int64_t(u64);
+                // beyond int64_t an unsigned value is kept as a double
+                if (uByte == 0xCF && u64 > uint64_t(INT64_MAX))
+                {
+                    stHead.eType = ObjType::Double;
+                    stHead.dValue = double(u64);
+                }
+                return bLoaded ? 0 : ParseDataFialed;
+
+            case 0xDC:
+            case 0xDE:
+                bLoaded = LoadBigEndian(u16);
+                stHead.eType = uByte == 0xDE ? ObjType::Object : ObjType::Array;
+                stHead.uCount = u16;
+                return bLoaded ? 0 : ParseDataFialed;
+
+            case 0xDD:
+            case 0xDF:
+                bLoaded = LoadBigEndian(u32);
+                stHead.eType = uByte == 0xDF ? ObjType::Object : ObjType::Array;
+                stHead.uCount = u32;
+                return bLoaded ? 0 : ParseDataFialed;
+
+            // the extension types have no json counterpart
+            default:
+                return ParseDataFialed;
+        }
+
+        if (!bLoaded)
+        {
+            return ParseDataFialed;
+        }
+    }
+
+    if (uint64_t(m_lpEnd - m_lpCur) < stHead.uCount)
+    {
+        return ParseDataFialed;
+    }
+
+    stHead.lpStr = reinterpret_cast<const char *>(m_lpCur);
+    m_lpCur += stHead.uCount;
+    return 0;
+}
+
+int32_t CJsonBinaryReader::ReadCborHead(Head &stHead)
+{
+    uint8_t uMajor = 0;
+    uint64_t uValue = 0;
+    do
+    {
+        if (unlikely(m_lpCur == m_lpEnd))
+        {
+            return ParseDataFialed;
+        }
+
+        auto uByte = *m_lpCur++;
+        uMajor = uByte >> 5;
+        auto uInfo = uint8_t(uByte & 0x1F);
+
+        uint8_t u8 = 0;
+        uint16_t u16 = 0;
+        uint32_t u32 = 0;
+        bool bLoaded = true;
+        if (uMajor == 7)
+        {
+            switch (uInfo)
+            {
+                case 20:
+                case 21:
+                    stHead.eType = ObjType::Boolean;
+                    stHead.bValue = uInfo == 21;
+                    return 0;
+
+                // undefined as well as null
+                case 22:
+                case 23:
+                    stHead.eType = ObjType::Null;
+                    return 0;
+
+                case 25:
+                    bLoaded = LoadBigEndian(u16);
+                    stHead.eType = ObjType::Double;
+                    stHead.dValue = HalfToDouble(u16);
+                    return bLoaded ? 0 : ParseDataFialed;
+
+                case 26:
+                    bLoaded = LoadBigEndian(u32);
+                    stHead.eType = ObjType::Double;
+                    stHead.dValue = BitCast<float>(u32);
+                    return bLoaded ? 0 : ParseDataFialed;
+
+                case 27:
+                    bLoaded = LoadBigEndian(uValue);
+                    stHead.eType = ObjType::Double;
+                    stHead.dValue = BitCast<double>(uValue);
+                    return bLoaded ? 0 : ParseDataFialed;
+
+                // the break closing an indefinite container or string
+                case 31:
+                    stHead.eType = ObjType::Unknow;
+                    return 0;
+
+                default:
+                    return ParseDataFialed;
+            }
+        }
+
+        stHead.bIndefinite = false;
+        if (uInfo < 24)
+        {
+            uValue = uInfo;
+        }
+        else if (uInfo == 24)
+        {
+            bLoaded = LoadBigEndian(u8);
+            uValue = u8;
+        }
+        else if (uInfo == 25)
+        {
+            bLoaded = LoadBigEndian(u16);
+            uValue = u16;
+        }
+        else if (uInfo == 26)
+        {
+            bLoaded = LoadBigEndian(u32);
+            uValue = u32;
+        }
+        else if (uInfo == 27)
+        {
+            bLoaded = LoadBigEndian(uValue);
+        }
+        else if (uInfo == 31 && uMajor >= 2 && uMajor <= 5)
+        {
+            stHead.bIndefinite = true;
+        }
+        else
+        {
+            return ParseDataFialed;
+        }
+
+        if (!bLoaded)
+        {
+            return ParseDataFialed;
+        }
+    } while (uMajor == 6); // a tag only annotates the value after it
+
+    switch (uMajor)
+    {
+        case 0:
+        case 1:
+            // beyond int64_t an integer is kept as a double
+            if (uValue > uint64_t(INT64_MAX))
+            {
+                stHead.eType = ObjType::Double;
+                stHead.dValue = uMajor == 0 ? double(uValue) : -1.0 - double(uValue);
+            }
+            else
+            {
+                stHead.eType = ObjType::Integer;
+                stHead.nValue = uMajor == 0 ? int64_t(uValue) : -1 - int64_t(uValue);
+            }
+            return 0;
+
+        // byte strings are read as strings of the same bytes
+        case 2:
+        case 3:
+            stHead.eType = ObjType::String;
+            stHead.uCount = uValue;
+            if (stHead.bIndefinite)
+            {
+                return 0;
+            }
+            else if (uint64_t(m_lpEnd - m_lpCur) < uValue)
+            {
+                return ParseDataFialed;
+            }
+
+            stHead.lpStr = reinterpret_cast<const char *>(m_lpCur);
+            m_lpCur += uValue;
+            return 0;
+
+        default:
+            stHead.eType = uMajor == 4 ? ObjType::Array : ObjType::Object;
+            stHead.uCount = uValue;
+            return 0;
+    }
+}
+
+int32_t CJsonBinaryReader::ReadHead(Head &stHead)
+{
+    stHead.bIndefinite = false;
+    if (m_eFormat == BinaryFormat::Cbor)
+    {
+        return ReadCborHead(stHead);
+    }
+    else if (unlikely(m_lpCur == m_lpEnd))
+    {
+        return ParseDataFialed;
+    }
+
+    return ReadPackHead(stHead);
+}
+
+int32_t CJsonBinaryReader::ReadString(const Head &stHead, std::string &strBuffer, StrRef &stStr)
+{
+    if (!stHead.bIndefinite)
+    {
+        if (unlikely(stHead.uCount > UINT32_MAX))
+        {
+            return ParseDataFialed;
+        }
+
+        stStr = StrRef{stHead.lpStr, uint32_t(stHead.uCount), false};
+        return 0;
+    }
+
+    // the chunks of an indefinite string, up to its break
+    strBuffer.clear();
+    while (true)
+    {
+        Head stChunk;
+        auto iErrorNo = ReadHead(stChunk);
+        if (iErrorNo != 0)
+        {
+            return iErrorNo;
+        }
+        else if (stChunk.eType == ObjType::Unknow)
+        {
+            break;
+        }
+        else if (stChunk.eType != ObjType::String || stChunk.bIndefinite)
+        {
+            return ParseDataFialed;
+        }
+
+        strBuffer.append(stChunk.lpStr, stChunk.uCount);
+    }
+
+    if (unlikely(strBuffer.size() > UINT32_MAX))
+    {
+        return ParseDataFialed;
+    }
+
+    stStr = StrRef{strBuffer.data(), uint32_t(strBuffer.size()), false};
+    return 0;
+}
+
+int32_t CJsonBinaryReader::ReadValue(CJsonObjImpl *lpObj, const StrRef *lpKey, uint32_t uDepth)
+{
+    Head stHead;
+    auto iErrorNo = ReadHead(stHead);
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    CJsonObjImpl::_ValueType *lpMember = nullptr;
+    switch (stHead.eType)
+    {
+        case ObjType::Null:
+            lpMember = lpObj->AddValue(lpKey, ObjType::Null);
+            break;
+
+        case ObjType::Boolean:
+            lpMember = lpObj->AddValue(lpKey, ObjType::Boolean, &stHead.bValue);
+            break;
+
+        case ObjType::Integer:
+            lpMember = lpObj->AddValue(lpKey, ObjType::Integer, &stHead.nValue);
+            break;
+
+        case ObjType::Double:
+            lpMember = lpObj->AddValue(lpKey, ObjType::Double, &stHead.dValue);
+            break;
+
+        case ObjType::String:
+        {
+            StrRef stValue;
+            iErrorNo = ReadString(stHead, m_strValue, stValue);
+            if (iErrorNo != 0)
+            {
+                return iErrorNo;
+            }
+            lpMember = lpObj->AddValue(lpKey, ObjType::String, &stValue);
+            break;
+        }
+
+        case ObjType::Array:
+        case ObjType::Object:
+            lpMember = lpObj->AddValue(lpKey, stHead.eType);
+            if (lpMember != nullptr)
+            {
+                return ReadMembers(lpMember->GetObj(), stHead, uDepth + 1);
+            }
+            break;
+
+        default:
+            return ParseDataFialed;
+    }
+
+    return lpMember != nullptr ? 0 : MallocFailed;
+}
+
+int32_t CJsonBinaryReader::ReadMembers(CJsonObjImpl *lpObj, const Head &stHead, uint32_t uDepth)
+{
+    if (unlikely(uDepth > CJsonObjImpl::MaxParseDepth))
+    {
+        return ParseDataFialed;
+    }
+
+    // every member takes a byte at least, so a count beyond what is left
+    // cannot be trusted with the reservation
+    if (!stHead.bIndefinite)
+    {
+        uint64_t uLeft = m_lpEnd - m_lpCur;
+        auto uReserve = uint32_t(stHead.uCount < uLeft ? stHead.uCount : uLeft);
+        if (stHead.eType == ObjType::Object)
+        {
+            auto &objValue = lpObj->m_unValue.objValue;
+            objValue.reserve(objValue.size() + uReserve);
+        }
+        else
+        {
+            auto &arrValue = lpObj->m_unValue.arrValue;
+            arrValue.reserve(arrValue.size() + uReserve);
+        }
+    }
+
+    for (uint64_t i = 0; stHead.bIndefinite || i < stHead.uCount; i++)
+    {
+        if (stHead.bIndefinite && m_lpCur != m_lpEnd && *m_lpCur == 0xFF)
+        {
+            m_lpCur++;
+            break;
+        }
+
+        int32_t iErrorNo = 0;
+        if (stHead.eType == ObjType::Object)
+        {
+            Head stKeyHead;
+            StrRef stKey;
+            iErrorNo = ReadHead(stKeyHead);
+            if (iErrorNo == 0 && stKeyHead.eType != ObjType::String)
+            {
+                iErrorNo = ParseDataFialed;
+            }
+            if (iErrorNo == 0)
+            {
+                iErrorNo = ReadString(stKeyHead, m_strKey, stKey);
+            }
+            if (iErrorNo == 0)
+            {
+                iErrorNo = ReadValue(lpObj, &stKey, uDepth);
+            }
+        }
+        else
+        {
+            iErrorNo = ReadValue(lpObj, nullptr, uDepth);
+        }
+
+        if (iErrorNo != 0)
+        {
+            return iErrorNo;
+        }
+    }
+
+    return 0;
+}
+
+int32_t CJsonBinaryReader::Read(CJsonObjImpl *lpRoot)
+{
+    try
+    {
+        Head stHead;
+        auto iErrorNo = ReadHead(stHead);
+        if (iErrorNo != 0)
+        {
+            return iErrorNo;
+        }
+        else if (stHead.eType != ObjType::Array && stHead.eType != ObjType::Object)
+        {
+            return ParseDataFialed;
+        }
+
+        if (lpRoot->m_eType == ObjType::Unknow)
+        {
+            iErrorNo = lpRoot->Init(stHead.eType);
+            if (iErrorNo != 0)
+            {
+                return iErrorNo;
+            }
+        }
+        else if (lpRoot->m_eType != stHead.eType)
+        {
+            return InvaliadCall;
+        }
+
+        iErrorNo = ReadMembers(lpRoot, stHead, 1);
+        if (iErrorNo != 0)
+        {
+            return iErrorNo;
+        }
+    }
+    catch (...)
+    {
+        return MallocFailed;
+    }
+
+    // nothing may follow the root value
+    return m_lpCur == m_lpEnd ? 0 : ParseDataFialed;
+}
+
+}
@@ -0,0 +1,116 @@
+#ifndef __JSON_BINARY_H_
+#define __JSON_BINARY_H_
+
+#include <os_common.h>
+#include <json_obj.h>
+#include "json_writer.h"
+#include "json_obj_impl.h"
+#include <string>
+
+namespace cppbase
+{
+
+/*
+ * Serializer of documents to MessagePack or CBOR.
+ *
+ * Integers and lengths take their shortest encoding, doubles always take
+ * 8 bytes so that they read back unchanged, and strings are copied in one
+ * piece without any escaping. Arena and heap documents are walked
+ * directly, any other node through the IJsonObj cursors.
+ */
+class CJsonBinaryWriter
+{
+public:
+    using BinaryFormat = IJsonObj::BinaryFormat;
+
+    CJsonBinaryWriter(CJsonWriter &writer, BinaryFormat eFormat) : m_writer(writer), m_eFormat(eFormat) {}
+
+    int32_t WriteNode(const CJsonObjImpl *lpObj);
+    int32_t WriteNode(IJsonObj *lpObj);
+
+private:
+    using ObjType = IJsonObj::ObjType;
+
+    // the CBOR major types written
+    static constexpr uint8_t CborUnsigned = 0;
+    static constexpr uint8_t CborNegative = 1;
+    static constexpr uint8_t CborText = 3;
+    static constexpr uint8_t CborArray = 4;
+    static constexpr uint8_t CborMap = 5;
+
+    template <typename T>
+    int32_t WriteBigEndian(uint8_t uType, T value);
+    int32_t WriteByte(uint8_t uByte);
+    int32_t WriteCborHead(uint8_t uMajor, uint64_t uValue);
+    int32_t WriteNull();
+    int32_t WriteBool(bool bValue);
+    int32_t WriteInt(int64_t nValue);
+    int32_t WriteDouble(double dValue);
+    int32_t WriteString(const char *lpStr, uint64_t uLen);
+    int32_t WriteContainer(ObjType eType, uint32_t uCount);
+    int32_t WriteMember(const CJsonObjImpl::_ValueType &stValue);
+    int32_t WriteItem(const IJsonObj::KvItem &stItem);
+
+private:
+    CJsonWriter &m_writer;
+    BinaryFormat m_eFormat;
+};
+
+/*
+ * Builder of an arena or heap document from MessagePack or CBOR: every
+ * container is sized once from the count in its head, and strings are
+ * copied straight from the input. CBOR tags are skipped, undefined reads
+ * as null, and byte strings of either format as strings.
+ */
+class CJsonBinaryReader
+{
+public:
+    using BinaryFormat = IJsonObj::BinaryFormat;
+
+    CJsonBinaryReader(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat)
+        : m_lpCur(reinterpret_cast<const uint8_t *>(lpBuffer)),
+          m_lpEnd(reinterpret_cast<const uint8_t *>(lpBuffer) + uLen), m_eFormat(eFormat)
+    {
+    }
+
+    int32_t Read(CJsonObjImpl *lpRoot);
+
+private:
+    using ObjType = IJsonObj::ObjType;
+    using StrRef = CJsonObjImpl::StrRef;
+
+    // what the head of a value announces
+    struct Head
+    {
+        ObjType eType;      // Unknow for the break closing a CBOR container
+        bool bIndefinite;   // a CBOR container or string closed by a break
+        uint64_t uCount;    // the members of a container, the bytes of a string
+        const char *lpStr;  // the bytes of a string
+        union {
+            bool bValue;
+            int64_t nValue;
+            double dValue;
+        };
+    };
+
+    template <typename T>
+    bool LoadBigEndian(T &value);
+    int32_t ReadPackHead(Head &stHead);
+    int32_t ReadCborHead(Head &stHead);
+    int32_t ReadHead(Head &stHead);
+    int32_t ReadString(const Head &stHead, std::string &strBuffer, StrRef &stStr);
+    int32_t ReadValue(CJsonObjImpl *lpObj, const StrRef *lpKey, uint32_t uDepth);
+    int32_t ReadMembers(CJsonObjImpl *lpObj, const Head &stHead, uint32_t uDepth);
+
+private:
+    const uint8_t *m_lpCur;
+    const uint8_t *m_lpEnd;
+    BinaryFormat m_eFormat;
+    // CBOR strings sent in chunks are joined here, keys apart from values
+    std::string m_strKey;
+    std::string m_strValue;
+};
+
+}
+
+#endif //__JSON_BINARY_H_
@@ -0,0 +1,30 @@
+#include <json_bind.h>
+#include "json_number.h"
+#include "json_writer.h"
+#include <cmath>
+
+char *FormatJsonInt(int64_t nValue, char *lpOut)
+{
+    return cppbase::FormatInt64(nValue, lpOut);
+}
+
+char *FormatJsonUInt(uint64_t uValue, char *lpOut)
+{
+    return cppbase::FormatUInt64(uValue, lpOut);
+}
+
+char *FormatJsonDouble(double dValue, char *lpOut)
+{
+    if (unlikely(!std::isfinite(dValue)))
+    {
+        memcpy(lpOut, "null", 4);
+        return lpOut + 4;
+    }
+
+    return cppbase::FormatDouble(dValue, lpOut);
+}
+
+char *FormatJsonString(const char *lpStr, uint64_t uLen, char *lpOut)
+{
+    return cppbase::CJsonWriter::FormatString(lpStr, uLen, lpOut);
+}
@@ -0,0 +1,238 @@
+#include "json_doc_stream.h"
+#include <error_no.h>
+
+namespace cppbase
+{
+
+int32_t CJsonDocStream::Start(const char *lpContent, uint64_t uLen)
+{
+    m_lpContent = lpContent;
+    m_uLen = uLen;
+    m_uOffset = 0;
+    m_iErrorNo = 0;
+
+    auto iErrorNo = Restart(0);
+    if (unlikely(iErrorNo != 0))
+    {
+        m_lpContent = nullptr;
+    }
+
+    return iErrorNo;
+}
+
+int32_t CJsonDocStream::Restart(uint64_t uBase)
+{
+    m_uBase = uBase;
+    m_uWindow = m_uLen - uBase < MaxWindow ? m_uLen - uBase : MaxWindow;
+    m_uToken = 0;
+    return m_scanner.Begin(m_lpContent + uBase, m_uWindow);
+}
+
+int32_t CJsonDocStream::FindDocument(uint32_t &uClose)
+{
+    // every token at depth 0 has to open the next document
+    uint32_t uDepth = 0;
+    uint32_t i = m_uToken;
+    while (true)
+    {
+        auto lpIndex = m_scanner.GetIndex();
+        auto lpContent = m_lpContent + m_uBase;
+        for (auto uCount = m_scanner.GetCount(); i < uCount; i++)
+        {
+            switch (lpContent[lpIndex[i]])
+            {
+                case '{':
+                case '[':
+                    if (uDepth++ == 0)
+                    {
+                        m_uOffset = m_uBase + lpIndex[i];
+                    }
+                    break;
+
+                case '}':
+                case ']':
+                    if (uDepth == 0)
+                    {
+                        m_uOffset = m_uBase + lpIndex[i];
+                        return ParseDataFialed;
+                    }
+                    if (--uDepth == 0)
+                    {
+                        uClose = i;
+                        return 0;
+                    }
+                    break;
+
+                default:
+                    if (uDepth == 0)
+                    {
+                        m_uOffset = m_uBase + lpIndex[i];
+                        return ParseDataFialed;
+                    }
+                    break;
+            }
+        }
+
+        // the window ran out: drop the documents already returned and index
+        // the next one
+        int32_t iErrorNo = 0;
+        if (!m_scanner.IsFinished())
+        {
+            iErrorNo = m_scanner.ScanNext(m_uToken);
+            i -= m_uToken;
+            m_uToken = 0;
+            if (iErrorNo == 0)
+            {
+                continue;
+            }
+        }
+
+        // a string cut by the end of a window is only an error at the end
+        // of the input
+        bool bLast = m_uBase + m_uWindow == m_uLen;
+        if (iErrorNo != 0 && (bLast || iErrorNo != ParseDataFialed))
+        {
+            return iErrorNo;
+        }
+        if (bLast)
+        {
+            if (uDepth > 0)
+            {
+                return ParseDataFialed;
+            }
+            m_uOffset = m_uLen;
+            uClose = NoToken;
+            return 0;
+        }
+
+        // a document spanning the whole window cannot be indexed
+        if (uDepth > 0 && m_scanner.GetIndex()[m_uToken] == 0)
+        {
+            return ParseDataFialed;
+        }
+
+        iErrorNo = Restart(uDepth > 0 ? m_uBase + m_scanner.GetIndex()[m_uToken] : m_uBase + m_uWindow);
+        if (iErrorNo != 0)
+        {
+            return iErrorNo;
+        }
+        uDepth = 0;
+        i = 0;
+    }
+}
+
+int32_t CJsonDocStream::ParseDocument(uint32_t uClose)
+{
+    // the previous document goes, the arena chunks stay
+    if (m_lpDoc != nullptr)
+    {
+        m_lpDoc->Clear();
+    }
+    else
+    {
+        auto lpMem = m_arena.Alloc(sizeof(CJsonObjImpl));
+        if (unlikely(lpMem == nullptr))
+        {
+            return MallocFailed;
+        }
+        m_lpDoc = new(lpMem) CJsonObjImpl(&m_arena);
+    }
+
+    m_stCtx.lpContent = m_lpContent + m_uBase;
+    m_stCtx.lpInSitu = nullptr;
+    m_stCtx.uLen = m_uWindow;
+    m_stCtx.lpIndex = m_scanner.GetIndex() + m_uToken;
+    m_stCtx.uCount = uClose + 1 - m_uToken;
+    m_stCtx.uDepth = 0;
+    m_stCtx.vecMembers.clear();
+    m_stCtx.uContainer = 0;
+    m_stCtx.lpFields = nullptr;
+    m_stCtx.uField = CJsonObjImpl::AllFields;
+    return m_lpDoc->ParseTokens(m_stCtx);
+}
+
+int32_t CJsonDocStream::OpenFile(const char *lpFile)
+{
+    if (unlikely(lpFile == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    m_lpContent = nullptr;
+    auto iErrorNo = m_file.Open(lpFile);
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    return Start(m_file.GetContent(), m_file.GetLen());
+}
+
+int32_t CJsonDocStream::OpenBuffer(const char *lpBuffer, uint64_t uLen)
+{
+    if (unlikely(lpBuffer == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    m_file.Close();
+    return Start(lpBuffer, uLen);
+}
+
+int32_t CJsonDocStream::Next(IJsonObj **lpDoc)
+{
+    if (unlikely(lpDoc == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    *lpDoc = nullptr;
+    if (unlikely(m_lpContent == nullptr))
+    {
+        return InvaliadCall;
+    }
+    if (m_iErrorNo != 0)
+    {
+        return m_iErrorNo;
+    }
+
+    uint32_t uClose = NoToken;
+    auto iErrorNo = FindDocument(uClose);
+    if (iErrorNo != 0)
+    {
+        m_iErrorNo = iErrorNo;
+        return iErrorNo;
+    }
+    if (uClose == NoToken)
+    {
+        return 0;
+    }
+
+    // the brackets delimit the document whether or not it parses
+    iErrorNo = ParseDocument(uClose);
+    m_uToken = uClose + 1;
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    *lpDoc = m_lpDoc;
+    return 0;
+}
+
+uint64_t CJsonDocStream::GetOffset()
+{
+    return m_uOffset;
+}
+
+}
+
+cppbase::IJsonDocStream *NewJsonDocStream(uint64_t uChunkSize)
+{
+    return NEW cppbase::CJsonDocStream(uChunkSize);
+}
+
+void DeleteJsonDocStream(cppbase::IJsonDocStream *lpStream)
+{
+    delete static_cast<cppbase::CJsonDocStream *>(lpStream);
+}
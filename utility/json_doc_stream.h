@@ -0,0 +1,60 @@
+#ifndef __JSON_DOC_STREAM_H_
+#define __JSON_DOC_STREAM_H_
+
+#include <os_common.h>
+#include <json_stream.h>
+#include "json_arena.h"
+#include "json_scanner.h"
+#include "json_file.h"
+#include "json_obj_impl.h"
+
+namespace cppbase
+{
+
+/*
+ * The input is indexed a scanner window at a time. A document ends at the
+ * token closing its first bracket; the tokens in between are handed to the
+ * tree builder as they are, and dropped from the index once the following
+ * documents need the room. Token offsets are 32 bits, so the scanner is
+ * restarted at the pending document whenever the input goes on past
+ * MaxWindow bytes from where it last started.
+ */
+class CJsonDocStream : public IJsonDocStream
+{
+public:
+    static constexpr uint64_t MaxWindow = 1ULL << 31;
+    static constexpr uint32_t NoToken = UINT32_MAX;
+
+    explicit CJsonDocStream(uint64_t uChunkSize) : m_arena(uChunkSize) {}
+    ~CJsonDocStream() override = default;
+
+    int32_t OpenFile(const char *lpFile) override;
+    int32_t OpenBuffer(const char *lpBuffer, uint64_t uLen) override;
+    int32_t Next(IJsonObj **lpDoc) override;
+    uint64_t GetOffset() override;
+
+private:
+    int32_t Start(const char *lpContent, uint64_t uLen);
+    int32_t Restart(uint64_t uBase);
+    int32_t FindDocument(uint32_t &uClose);
+    int32_t ParseDocument(uint32_t uClose);
+
+private:
+    const char *m_lpContent{nullptr};
+    uint64_t m_uLen{0};
+    uint64_t m_uBase{0};   // where the scanner started, in the input
+    uint64_t m_uWindow{0}; // how far from m_uBase it goes
+    CJsonScanner m_scanner;
+    uint32_t m_uToken{0}; // first token of the next document
+    uint64_t m_uOffset{0};
+    int32_t m_iErrorNo{0}; // the input cannot be split any further
+    CJsonFileContent m_file;
+    CJsonArena m_arena;
+    CJsonObjImpl *m_lpDoc{nullptr};
+    // kept from one document to the next for the capacity of its buffers
+    CJsonObjImpl::ParseContext m_stCtx;
+};
+
+}
+
+#endif //__JSON_DOC_STREAM_H_
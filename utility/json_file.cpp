@@ -0,0 +1,134 @@
+#include "json_file.h"
+#include <error_no.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace cppbase
+{
+
+namespace
+{
+
+int32_t ReadFromFd(int iFd, uint64_t uSizeHint, char *&lpContent, uint64_t &uContentLen)
+{
+    // pipes and other files that cannot be mapped are read whole, growing
+    // the buffer geometrically when the size is not known up front
+    uint64_t uCapacity = uSizeHint > 0 ? uSizeHint + 1 : 64 * 1024;
+    auto lpBuffer = reinterpret_cast<char *>(malloc(uCapacity));
+    if (unlikely(lpBuffer == nullptr))
+    {
+        return MallocFailed;
+    }
+
+    uint64_t uLen = 0;
+    while (true)
+    {
+        if (uLen == uCapacity)
+        {
+            auto lpNewBuffer = reinterpret_cast<char *>(realloc(lpBuffer, uCapacity * 2));
+            if (unlikely(lpNewBuffer == nullptr))
+            {
+                free(lpBuffer);
+                return MallocFailed;
+            }
+            lpBuffer = lpNewBuffer;
+            uCapacity *= 2;
+        }
+
+        auto nRead = read(iFd, lpBuffer + uLen, uCapacity - uLen);
+        if (nRead == 0)
+        {
+            break;
+        }
+        if (nRead < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            free(lpBuffer);
+            return SysCallFailed;
+        }
+        uLen += uint64_t(nRead);
+    }
+
+    lpContent = lpBuffer;
+    uContentLen = uLen;
+    return 0;
+}
+
+}
+
+int32_t ParseJsonFile(const char *lpFile, JsonParseFunc lpParse, void *lpParam)
+{
+    CJsonFileContent content;
+    auto iErrorNo = content.Open(lpFile);
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    return lpParse(lpParam, content.GetContent(), content.GetLen());
+}
+
+int32_t CJsonFileContent::Open(const char *lpFile, bool bRandom)
+{
+    Close();
+
+    auto iFd = open(lpFile, O_RDONLY | O_CLOEXEC);
+    if (iFd < 0)
+    {
+        return OpenFileFailed;
+    }
+
+    struct stat stStat;
+    if (fstat(iFd, &stStat) != 0)
+    {
+        close(iFd);
+        return SysCallFailed;
+    }
+
+    int32_t iErrorNo = 0;
+    void *lpMap = MAP_FAILED;
+    auto uSize = uint64_t(stStat.st_size);
+    if (S_ISREG(stStat.st_mode) && uSize > 0)
+    {
+        // the whole document is parsed in one pass straight from the page
+        // cache; prefault it rather than taking a fault every 4 KB
+        lpMap = mmap(nullptr, uSize, PROT_READ, bRandom ? MAP_PRIVATE : MAP_PRIVATE | MAP_POPULATE, iFd, 0);
+    }
+
+    if (lpMap != MAP_FAILED)
+    {
+        madvise(lpMap, uSize, bRandom ? MADV_RANDOM : MADV_SEQUENTIAL);
+        m_lpContent = reinterpret_cast<char *>(lpMap);
+        m_uLen = uSize;
+        m_bMapped = true;
+    }
+    else
+    {
+        iErrorNo = ReadFromFd(iFd, S_ISREG(stStat.st_mode) ? uSize : 0, m_lpContent, m_uLen);
+    }
+
+    close(iFd);
+    return iErrorNo;
+}
+
+void CJsonFileContent::Close()
+{
+    if (m_bMapped)
+    {
+        munmap(m_lpContent, m_uLen);
+    }
+    else
+    {
+        free(m_lpContent);
+    }
+
+    m_lpContent = nullptr;
+    m_uLen = 0;
+    m_bMapped = false;
+}
+
+}
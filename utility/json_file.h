@@ -0,0 +1,44 @@
+#ifndef __JSON_FILE_H_
+#define __JSON_FILE_H_
+
+#include <os_common.h>
+
+namespace cppbase
+{
+
+// parses the uLen bytes of lpContent into lpParam
+using JsonParseFunc = int32_t (*)(void *lpParam, const char *lpContent, uint64_t uLen);
+
+// Hands the contents of lpFile to lpParse in one piece: regular files are
+// mapped, anything else is read into a buffer first. Returns the error of
+// lpParse, or of opening and reading the file.
+int32_t ParseJsonFile(const char *lpFile, JsonParseFunc lpParse, void *lpParam);
+
+// The contents of a file held for as long as the object lives, for readers
+// that come back to it after opening: mapped or read whole like above.
+// bRandom maps it for scattered reads, each page read in when first touched
+// instead of all of them up front.
+class CJsonFileContent
+{
+public:
+    CJsonFileContent() = default;
+    ~CJsonFileContent() { Close(); }
+
+    CJsonFileContent(const CJsonFileContent &) = delete;
+    CJsonFileContent &operator=(const CJsonFileContent &) = delete;
+
+    int32_t Open(const char *lpFile, bool bRandom = false);
+    void Close();
+
+    inline const char *GetContent() const { return m_lpContent; }
+    inline uint64_t GetLen() const { return m_uLen; }
+
+private:
+    char *m_lpContent{nullptr};
+    uint64_t m_uLen{0};
+    bool m_bMapped{false};
+};
+
+}
+
+#endif //__JSON_FILE_H_
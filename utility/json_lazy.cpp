@@ -0,0 +1,1152 @@
+#include "json_lazy.h"
+#include "json_string.h"
+#include "json_writer.h"
+#include "json_file.h"
+#include "json_binary.h"
+#include "json_snapshot.h"
+#include <error_no.h>
+
+namespace cppbase
+{
+
+int32_t CJsonLazyNode::Init(ObjType eType)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyNode::OpenFromFile(const char *lpFile)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyNode::OpenFromBuffer(const char *lpBuffer)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyNode::OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyNode::OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyNode::OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyNode::OpenSnapshot(const char *lpFile)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyNode::Clear()
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyNode::AddNull(const char *lpKey)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyNode::AddBool(const char *lpKey, bool bValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyNode::AddInt(const char *lpKey, int64_t nValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyNode::AddDouble(const char *lpKey, double dValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyNode::AddString(const char *lpKey, const char *lpValue)
+{
+    return InvaliadCall;
+}
+
+IJsonObj *CJsonLazyNode::AddArray(const char *lpKey)
+{
+    return nullptr;
+}
+
+IJsonObj *CJsonLazyNode::AddObject(const char *lpKey)
+{
+    return nullptr;
+}
+
+uint32_t CJsonLazyNode::FindValue(const Key &stKey)
+{
+    if (unlikely(stKey.lpKey == nullptr || m_lpDoc->PeekToken(m_uOpen) != '{'))
+    {
+        return NoToken;
+    }
+
+    for (auto uToken = m_lpDoc->FirstMember(m_uOpen); uToken != NoToken; uToken = m_lpDoc->NextMember(m_uOpen, uToken))
+    {
+        if (m_lpDoc->IsKey(uToken, stKey))
+        {
+            return m_lpDoc->GetValueToken(m_uOpen, uToken);
+        }
+    }
+
+    return NoToken;
+}
+
+uint32_t CJsonLazyNode::GetMember(uint32_t uIndex, uint32_t &uKey)
+{
+    // carry on from the member reached last when walking forward
+    uint32_t i = 0;
+    auto uToken = m_lpDoc->FirstMember(m_uOpen);
+    if (m_uLastToken != NoToken && uIndex >= m_uLastIndex)
+    {
+        i = m_uLastIndex;
+        uToken = m_uLastToken;
+    }
+
+    for (; i < uIndex && uToken != NoToken; i++)
+    {
+        uToken = m_lpDoc->NextMember(m_uOpen, uToken);
+    }
+
+    if (uToken == NoToken)
+    {
+        return NoToken;
+    }
+
+    m_uLastIndex = uIndex;
+    m_uLastToken = uToken;
+    uKey = m_lpDoc->PeekToken(m_uOpen) == '{' ? uToken : NoToken;
+    return m_lpDoc->GetValueToken(m_uOpen, uToken);
+}
+
+bool CJsonLazyNode::FillKvItem(uint32_t uToken, KvItem *lpKvItem)
+{
+    auto uValue = m_lpDoc->GetValueToken(m_uOpen, uToken);
+    lpKvItem->lpKey = nullptr;
+    if (m_lpDoc->PeekToken(m_uOpen) == '{' && (lpKvItem->lpKey = m_lpDoc->ReadString(uToken)) == nullptr)
+    {
+        return false;
+    }
+
+    return uValue != NoToken && m_lpDoc->ReadValue(uValue, lpKvItem);
+}
+
+bool CJsonLazyNode::GetNull(const char *lpKey)
+{
+    return CJsonLazyNode::GetNull(Key(lpKey));
+}
+
+bool CJsonLazyNode::GetBool(const char *lpKey, bool bDefaultValue)
+{
+    return CJsonLazyNode::GetBool(Key(lpKey), bDefaultValue);
+}
+
+int64_t CJsonLazyNode::GetInt(const char *lpKey, int64_t nDefaultValue)
+{
+    return CJsonLazyNode::GetInt(Key(lpKey), nDefaultValue);
+}
+
+double CJsonLazyNode::GetDouble(const char *lpKey, double dDefaultValue)
+{
+    return CJsonLazyNode::GetDouble(Key(lpKey), dDefaultValue);
+}
+
+const char *CJsonLazyNode::GetString(const char *lpKey, const char *lpDefaultValue)
+{
+    return CJsonLazyNode::GetString(Key(lpKey), lpDefaultValue);
+}
+
+IJsonObj *CJsonLazyNode::GetArray(const char *lpKey)
+{
+    return CJsonLazyNode::GetArray(Key(lpKey));
+}
+
+IJsonObj *CJsonLazyNode::GetObject(const char *lpKey)
+{
+    return CJsonLazyNode::GetObject(Key(lpKey));
+}
+
+bool CJsonLazyNode::IsExist(const char *lpKey)
+{
+    return CJsonLazyNode::IsExist(Key(lpKey));
+}
+
+bool CJsonLazyNode::GetNull(const Key &stKey)
+{
+    return m_lpDoc->ReadType(FindValue(stKey)) == ObjType::Null;
+}
+
+bool CJsonLazyNode::GetBool(const Key &stKey, bool bDefaultValue)
+{
+    KvItem kvItem;
+    if (likely(m_lpDoc->ReadValue(FindValue(stKey), &kvItem) && kvItem.eType == ObjType::Boolean))
+    {
+        return kvItem.bValue;
+    }
+
+    return bDefaultValue;
+}
+
+int64_t CJsonLazyNode::GetInt(const Key &stKey, int64_t nDefaultValue)
+{
+    KvItem kvItem;
+    if (likely(m_lpDoc->ReadValue(FindValue(stKey), &kvItem) && kvItem.eType == ObjType::Integer))
+    {
+        return kvItem.nValue;
+    }
+
+    return nDefaultValue;
+}
+
+double CJsonLazyNode::GetDouble(const Key &stKey, double dDefaultValue)
+{
+    KvItem kvItem;
+    if (likely(m_lpDoc->ReadValue(FindValue(stKey), &kvItem) && kvItem.eType == ObjType::Double))
+    {
+        return kvItem.dValue;
+    }
+
+    return dDefaultValue;
+}
+
+const char *CJsonLazyNode::GetString(const Key &stKey, const char *lpDefaultValue)
+{
+    auto uValue = FindValue(stKey);
+    if (likely(m_lpDoc->PeekToken(uValue) == '"'))
+    {
+        auto lpStr = m_lpDoc->ReadString(uValue);
+        return lpStr != nullptr ? lpStr : lpDefaultValue;
+    }
+
+    return lpDefaultValue;
+}
+
+IJsonObj *CJsonLazyNode::GetArray(const Key &stKey)
+{
+    auto uValue = FindValue(stKey);
+    return m_lpDoc->PeekToken(uValue) == '[' ? m_lpDoc->ReadNode(uValue) : nullptr;
+}
+
+IJsonObj *CJsonLazyNode::GetObject(const Key &stKey)
+{
+    auto uValue = FindValue(stKey);
+    return m_lpDoc->PeekToken(uValue) == '{' ? m_lpDoc->ReadNode(uValue) : nullptr;
+}
+
+bool CJsonLazyNode::IsExist(const Key &stKey)
+{
+    return FindValue(stKey) != NoToken;
+}
+
+IJsonObj::ObjType CJsonLazyNode::GetType()
+{
+    return m_lpDoc->ReadType(m_uOpen);
+}
+
+uint32_t CJsonLazyNode::GetSize()
+{
+    if (m_uSize == NoToken)
+    {
+        uint32_t uSize = 0;
+        for (auto uToken = m_lpDoc->FirstMember(m_uOpen); uToken != NoToken;
+             uToken = m_lpDoc->NextMember(m_uOpen, uToken))
+        {
+            uSize++;
+        }
+        m_uSize = uSize;
+    }
+
+    return m_uSize;
+}
+
+IJsonObj::ObjType CJsonLazyNode::GetType(const char *lpKey)
+{
+    return CJsonLazyNode::GetType(Key(lpKey));
+}
+
+IJsonObj::ObjType CJsonLazyNode::GetType(const Key &stKey)
+{
+    return m_lpDoc->ReadType(FindValue(stKey));
+}
+
+IJsonObj::ObjType CJsonLazyNode::GetType(uint32_t uIndex)
+{
+    uint32_t uKey = NoToken;
+    return m_lpDoc->ReadType(GetMember(uIndex, uKey));
+}
+
+int32_t CJsonLazyNode::GetItem(uint32_t uIndex, KvItem *lpKvItem)
+{
+    if (unlikely(lpKvItem == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    uint32_t uKey = NoToken;
+    auto uValue = GetMember(uIndex, uKey);
+    if (unlikely(uValue == NoToken))
+    {
+        return InvaliadParam;
+    }
+
+    lpKvItem->lpKey = uKey != NoToken ? m_lpDoc->ReadString(uKey) : nullptr;
+    if (unlikely((uKey != NoToken && lpKvItem->lpKey == nullptr) || !m_lpDoc->ReadValue(uValue, lpKvItem)))
+    {
+        return ParseDataFialed;
+    }
+
+    return 0;
+}
+
+bool CJsonLazyNode::First(Cursor *lpCursor, KvItem *lpKvItem)
+{
+    static_assert(sizeof(CursorState) <= sizeof(Cursor::Reserve), "Cursor too small for CursorState");
+
+    if (unlikely(lpCursor == nullptr || lpKvItem == nullptr))
+    {
+        return false;
+    }
+
+    auto lpState = new(lpCursor->Reserve) CursorState{m_lpDoc->FirstMember(m_uOpen)};
+    return lpState->uToken != NoToken && FillKvItem(lpState->uToken, lpKvItem);
+}
+
+bool CJsonLazyNode::Next(Cursor *lpCursor, KvItem *lpKvItem)
+{
+    if (unlikely(lpCursor == nullptr || lpKvItem == nullptr))
+    {
+        return false;
+    }
+
+    auto lpState = reinterpret_cast<CursorState *>(lpCursor->Reserve);
+    if (lpState->uToken == NoToken)
+    {
+        return false;
+    }
+
+    lpState->uToken = m_lpDoc->NextMember(m_uOpen, lpState->uToken);
+    return lpState->uToken != NoToken && FillKvItem(lpState->uToken, lpKvItem);
+}
+
+const char *CJsonLazyNode::GetJsonStr(bool bPretty)
+{
+    return m_lpDoc->WriteJsonStr(m_uOpen, bPretty);
+}
+
+const char *CJsonLazyNode::GetBinary(BinaryFormat eFormat, uint64_t *lpLen)
+{
+    return m_lpDoc->WriteBinary(this, eFormat, lpLen);
+}
+
+int32_t CJsonLazyNode::SaveSnapshot(const char *lpFile)
+{
+    return SaveJsonSnapshot(this, lpFile);
+}
+
+IJsonObj *CJsonLazyNode::Freeze()
+{
+    return FreezeJsonObject(this);
+}
+
+CJsonLazyDoc::~CJsonLazyDoc()
+{
+    delete m_lpWriter;
+    free(m_lpCopy);
+}
+
+uint32_t CJsonLazyDoc::SkipValue(uint32_t uIndex) const
+{
+    auto lpIndex = m_scanner.GetIndex();
+    auto uCount = m_scanner.GetCount();
+    switch (PeekToken(uIndex))
+    {
+        case '{':
+        case '[':
+            break;
+
+        case '"':
+            return uIndex + 2 <= uCount ? uIndex + 2 : NoToken;
+
+        case '\0':
+            return NoToken;
+
+        default:
+            return CJsonScanner::IsDelimiter(PeekToken(uIndex)) ? NoToken : uIndex + 1;
+    }
+
+    // strings only leave their quotes in the index, so the brackets left
+    // are exactly the nested containers
+    uint32_t uDepth = 0;
+    for (; uIndex < uCount; uIndex++)
+    {
+        switch (m_lpContent[lpIndex[uIndex]])
+        {
+            case '{':
+            case '[':
+                uDepth++;
+                break;
+
+            case '}':
+            case ']':
+                if (--uDepth == 0)
+                {
+                    return uIndex + 1;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return NoToken;
+}
+
+uint32_t CJsonLazyDoc::FirstMember(uint32_t uOpen) const
+{
+    auto ch = PeekToken(uOpen + 1);
+    return ch == '\0' || ch == (PeekToken(uOpen) == '{' ? '}' : ']') ? NoToken : uOpen + 1;
+}
+
+uint32_t CJsonLazyDoc::GetValueToken(uint32_t uOpen, uint32_t uToken) const
+{
+    // object members are "key" : value
+    if (PeekToken(uOpen) != '{')
+    {
+        return uToken;
+    }
+
+    return PeekToken(uToken) == '"' && PeekToken(uToken + 1) == '"' && PeekToken(uToken + 2) == ':' ? uToken + 3
+                                                                                                       : NoToken;
+}
+
+uint32_t CJsonLazyDoc::NextMember(uint32_t uOpen, uint32_t uToken) const
+{
+    auto uValue = GetValueToken(uOpen, uToken);
+    auto uEnd = uValue != NoToken ? SkipValue(uValue) : NoToken;
+    return PeekToken(uEnd) == ',' ? uEnd + 1 : NoToken;
+}
+
+bool CJsonLazyDoc::IsKey(uint32_t uIndex, const Key &stKey)
+{
+    if (unlikely(uint64_t(uIndex) + 1 >= m_scanner.GetCount()))
+    {
+        return false;
+    }
+
+    auto lpIndex = m_scanner.GetIndex();
+    auto lpBegin = m_lpContent + lpIndex[uIndex] + 1;
+    auto uLen = uint32_t(m_lpContent + lpIndex[uIndex + 1] - lpBegin);
+    if (uLen < stKey.uLen)
+    {
+        return false;
+    }
+
+    // keys without escapes are compared where they are
+    if (memchr(lpBegin, '\\', uLen) == nullptr)
+    {
+        return uLen == stKey.uLen && memcmp(lpBegin, stKey.lpKey, uLen) == 0;
+    }
+
+    auto lpKey = ReadString(uIndex, &uLen);
+    return lpKey != nullptr && uLen == stKey.uLen && memcmp(lpKey, stKey.lpKey, uLen) == 0;
+}
+
+bool CJsonLazyDoc::IsEnd(uint64_t uPos) const
+{
+    return uPos >= m_uLen || CJsonScanner::IsDelimiter(m_lpContent[uPos]);
+}
+
+IJsonObj::ObjType CJsonLazyDoc::ReadType(uint32_t uIndex) const
+{
+    // NoToken included
+    if (unlikely(uIndex >= m_scanner.GetCount()))
+    {
+        return ObjType::Unknow;
+    }
+
+    auto uPos = m_scanner.GetIndex()[uIndex];
+    auto lpToken = m_lpContent + uPos;
+    switch (*lpToken)
+    {
+        case '{':
+            return ObjType::Object;
+
+        case '[':
+            return ObjType::Array;
+
+        case '"':
+            return ObjType::String;
+
+        case 't':
+            return uPos + 4 <= m_uLen && memcmp(lpToken, "true", 4) == 0 && IsEnd(uPos + 4) ? ObjType::Boolean
+                                                                                               : ObjType::Unknow;
+
+        case 'f':
+            return uPos + 5 <= m_uLen && memcmp(lpToken, "false", 5) == 0 && IsEnd(uPos + 5) ? ObjType::Boolean
+                                                                                                : ObjType::Unknow;
+
+        case 'n':
+            return uPos + 4 <= m_uLen && memcmp(lpToken, "null", 4) == 0 && IsEnd(uPos + 4) ? ObjType::Null
+                                                                                               : ObjType::Unknow;
+
+        default:
+        {
+            JsonNumber stNumber;
+            auto lpNumEnd = ParseNumber(lpToken, m_lpContent + m_uLen, stNumber);
+            if (lpNumEnd == nullptr || !IsEnd(lpNumEnd - m_lpContent))
+            {
+                return ObjType::Unknow;
+            }
+            return stNumber.bDouble ? ObjType::Double : ObjType::Integer;
+        }
+    }
+}
+
+bool CJsonLazyDoc::ReadValue(uint32_t uIndex, KvItem *lpKvItem)
+{
+    lpKvItem->eType = ReadType(uIndex);
+    switch (lpKvItem->eType)
+    {
+        case ObjType::Null:
+            lpKvItem->IsNull = true;
+            return true;
+
+        case ObjType::Boolean:
+            lpKvItem->bValue = PeekToken(uIndex) == 't';
+            return true;
+
+        case ObjType::Integer:
+        case ObjType::Double:
+        {
+            // the type check has just parsed it, this is a hot cache line
+            JsonNumber stNumber;
+            ParseNumber(m_lpContent + m_scanner.GetIndex()[uIndex], m_lpContent + m_uLen, stNumber);
+            if (stNumber.bDouble)
+            {
+                lpKvItem->dValue = stNumber.dValue;
+            }
+            else
+            {
+                lpKvItem->nValue = stNumber.nValue;
+            }
+            return true;
+        }
+
+        case ObjType::String:
+            lpKvItem->strValue = ReadString(uIndex);
+            return lpKvItem->strValue != nullptr;
+
+        case ObjType::Array:
+        case ObjType::Object:
+            lpKvItem->lpObj = ReadNode(uIndex);
+            return lpKvItem->lpObj != nullptr;
+
+        default:
+            return false;
+    }
+}
+
+const char *CJsonLazyDoc::ReadString(uint32_t uIndex, uint32_t *lpLen)
+{
+    // the scanner records both quotes of a string
+    if (unlikely(PeekToken(uIndex) != '"' || PeekToken(uIndex + 1) != '"'))
+    {
+        return nullptr;
+    }
+
+    try
+    {
+        auto iter = m_mapCache.find(uIndex);
+        if (iter == m_mapCache.end())
+        {
+            auto lpIndex = m_scanner.GetIndex();
+            auto lpBegin = m_lpContent + lpIndex[uIndex] + 1;
+            auto lpEnd = m_lpContent + lpIndex[uIndex + 1];
+            auto lpOut = reinterpret_cast<char *>(m_arena.Alloc(lpEnd - lpBegin + 1));
+            if (unlikely(lpOut == nullptr))
+            {
+                return nullptr;
+            }
+
+            auto lpEscape = reinterpret_cast<const char *>(memchr(lpBegin, '\\', lpEnd - lpBegin));
+            auto uPlain = (lpEscape != nullptr ? lpEscape : lpEnd) - lpBegin;
+            memcpy(lpOut, lpBegin, uPlain);
+            auto lpOutEnd = lpEscape == nullptr ? lpOut + uPlain : UnescapeString(lpEscape, lpEnd, lpOut + uPlain);
+            if (unlikely(lpOutEnd == nullptr))
+            {
+                return nullptr;
+            }
+
+            *lpOutEnd = '\0';
+            iter = m_mapCache.emplace(uIndex, CacheEntry{lpOut, uint32_t(lpOutEnd - lpOut)}).first;
+        }
+
+        if (lpLen != nullptr)
+        {
+            *lpLen = iter->second.uLen;
+        }
+        return reinterpret_cast<const char *>(iter->second.lpValue);
+    }
+    catch (...)
+    {
+    }
+
+    return nullptr;
+}
+
+CJsonLazyNode *CJsonLazyDoc::ReadNode(uint32_t uIndex)
+{
+    try
+    {
+        auto iter = m_mapCache.find(uIndex);
+        if (iter == m_mapCache.end())
+        {
+            auto lpMem = m_arena.Alloc(sizeof(CJsonLazyNode));
+            if (unlikely(lpMem == nullptr))
+            {
+                return nullptr;
+            }
+            iter = m_mapCache.emplace(uIndex, CacheEntry{new(lpMem) CJsonLazyNode(this, uIndex), 0}).first;
+        }
+
+        return reinterpret_cast<CJsonLazyNode *>(const_cast<void *>(iter->second.lpValue));
+    }
+    catch (...)
+    {
+    }
+
+    return nullptr;
+}
+
+int32_t CJsonLazyDoc::WriteValue(CJsonWriter &writer, uint32_t uIndex, bool bPretty, uint32_t uDepth)
+{
+    KvItem kvItem;
+    auto ch = PeekToken(uIndex);
+    if (ch != '{' && ch != '[')
+    {
+        uint32_t uLen = 0;
+        if (!ReadValue(uIndex, &kvItem))
+        {
+            return ParseDataFialed;
+        }
+
+        switch (kvItem.eType)
+        {
+            case ObjType::Null:
+                return writer.WriteNull();
+
+            case ObjType::Boolean:
+                return writer.WriteBool(kvItem.bValue);
+
+            case ObjType::Integer:
+                return writer.WriteInt(kvItem.nValue);
+
+            case ObjType::Double:
+                return writer.WriteDouble(kvItem.dValue);
+
+            default:
+                ReadString(uIndex, &uLen);
+                return writer.WriteString(kvItem.strValue, uLen);
+        }
+    }
+
+    // containers are written from the index, without making their nodes
+    bool bObject = ch == '{';
+    auto iErrorNo = writer.WriteChar(ch);
+    bool bFirst = true;
+    auto uToken = FirstMember(uIndex);
+    for (; uToken != NoToken && iErrorNo == 0; uToken = NextMember(uIndex, uToken), bFirst = false)
+    {
+        if (!bFirst)
+        {
+            iErrorNo = writer.WriteChar(',');
+        }
+        if (iErrorNo == 0 && bPretty)
+        {
+            iErrorNo = writer.WriteIndent(uDepth + 1);
+        }
+        if (iErrorNo == 0 && bObject)
+        {
+            uint32_t uLen = 0;
+            auto lpKey = ReadString(uToken, &uLen);
+            iErrorNo = lpKey != nullptr ? writer.WriteString(lpKey, uLen) : ParseDataFialed;
+            if (iErrorNo == 0)
+            {
+                iErrorNo = bPretty ? writer.WriteRaw(": ", 2) : writer.WriteChar(':');
+            }
+        }
+        if (iErrorNo == 0)
+        {
+            auto uValue = GetValueToken(uIndex, uToken);
+            iErrorNo = uValue != NoToken ? WriteValue(writer, uValue, bPretty, uDepth + 1) : ParseDataFialed;
+        }
+    }
+
+    if (iErrorNo == 0 && bPretty && !bFirst)
+    {
+        iErrorNo = writer.WriteIndent(uDepth);
+    }
+
+    return iErrorNo == 0 ? writer.WriteChar(bObject ? '}' : ']') : iErrorNo;
+}
+
+CJsonWriter *CJsonLazyDoc::GetWriter()
+{
+    if (m_lpWriter == nullptr)
+    {
+        m_lpWriter = NEW CJsonWriter();
+        if (m_lpWriter == nullptr)
+        {
+            return nullptr;
+        }
+    }
+
+    m_lpWriter->Clear();
+    return m_lpWriter;
+}
+
+const char *CJsonLazyDoc::WriteJsonStr(uint32_t uIndex, bool bPretty)
+{
+    auto lpWriter = GetWriter();
+    if (lpWriter == nullptr || WriteValue(*lpWriter, uIndex, bPretty, 0) != 0)
+    {
+        return nullptr;
+    }
+
+    return lpWriter->GetStr();
+}
+
+const char *CJsonLazyDoc::WriteBinary(IJsonObj *lpNode, BinaryFormat eFormat, uint64_t *lpLen)
+{
+    // the members are read through the node, which converts them as usual
+    auto lpWriter = lpLen != nullptr ? GetWriter() : nullptr;
+    if (lpWriter == nullptr || CJsonBinaryWriter(*lpWriter, eFormat).WriteNode(lpNode) != 0)
+    {
+        return nullptr;
+    }
+
+    *lpLen = lpWriter->GetSize();
+    return lpWriter->GetData();
+}
+
+// One pass over the index at open: brackets that pair up, keys, colons and
+// commas where they belong, and nothing after the root. Scalars are only
+// told apart from the structure here, their bytes are checked when read.
+int32_t CJsonLazyDoc::CheckStructure() const
+{
+    enum class State : uint8_t
+    {
+        Value,
+        Key,
+        AfterValue
+    };
+
+    auto ch = PeekToken(0);
+    if (ch != '{' && ch != '[')
+    {
+        return ParseDataFialed;
+    }
+
+    // one bit per open container, set for objects
+    uint64_t szObjectBits[MaxParseDepth / 64] = {0};
+    uint32_t uDepth = 0;
+    auto eState = State::Value;
+    auto uCount = m_scanner.GetCount();
+    for (uint32_t i = 0; i < uCount;)
+    {
+        ch = PeekToken(i);
+        switch (eState)
+        {
+            case State::Value:
+            {
+                if (ch == '"')
+                {
+                    if (PeekToken(i + 1) != '"')
+                    {
+                        return ParseDataFialed;
+                    }
+                    i += 2;
+                    eState = State::AfterValue;
+                    break;
+                }
+
+                if (ch != '{' && ch != '[')
+                {
+                    if (CJsonScanner::IsDelimiter(ch))
+                    {
+                        return ParseDataFialed;
+                    }
+                    i++;
+                    eState = State::AfterValue;
+                    break;
+                }
+
+                if (uDepth == MaxParseDepth)
+                {
+                    return ParseDataFialed;
+                }
+
+                bool bObject = ch == '{';
+                auto &uBits = szObjectBits[uDepth / 64];
+                uBits = bObject ? uBits | (1ULL << (uDepth % 64)) : uBits & ~(1ULL << (uDepth % 64));
+                uDepth++;
+                if (PeekToken(++i) == (bObject ? '}' : ']'))
+                {
+                    i++;
+                    uDepth--;
+                    eState = State::AfterValue;
+                }
+                else
+                {
+                    eState = bObject ? State::Key : State::Value;
+                }
+                break;
+            }
+
+            case State::Key:
+            {
+                if (ch != '"' || PeekToken(i + 1) != '"' || PeekToken(i + 2) != ':')
+                {
+                    return ParseDataFialed;
+                }
+                i += 3;
+                eState = State::Value;
+                break;
+            }
+
+            case State::AfterValue:
+            {
+                // only whitespace may follow the root
+                if (uDepth == 0)
+                {
+                    return ParseDataFialed;
+                }
+
+                bool bObject = (szObjectBits[(uDepth - 1) / 64] >> ((uDepth - 1) % 64)) & 1;
+                i++;
+                if (ch == ',')
+                {
+                    eState = bObject ? State::Key : State::Value;
+                }
+                else if (ch == (bObject ? '}' : ']'))
+                {
+                    uDepth--;
+                }
+                else
+                {
+                    return ParseDataFialed;
+                }
+                break;
+            }
+        }
+    }
+
+    return uDepth == 0 && eState == State::AfterValue ? 0 : ParseDataFialed;
+}
+
+int32_t CJsonLazyDoc::Open(const char *lpContent, uint64_t uLen, bool bCopy)
+{
+    if (m_lpContent != nullptr)
+    {
+        return InvaliadCall;
+    }
+
+    // the document is read long after the call, so a borrowed buffer is
+    // copied once
+    if (bCopy)
+    {
+        if (uLen + 1 > m_uCopySize)
+        {
+            free(m_lpCopy);
+            m_lpCopy = reinterpret_cast<char *>(malloc(uLen + 1));
+            m_uCopySize = m_lpCopy != nullptr ? uLen + 1 : 0;
+        }
+        if (unlikely(m_lpCopy == nullptr))
+        {
+            return MallocFailed;
+        }
+        memcpy(m_lpCopy, lpContent, uLen);
+        lpContent = m_lpCopy;
+    }
+
+    auto iErrorNo = m_scanner.Scan(lpContent, uLen);
+    m_lpContent = lpContent;
+    m_uLen = uLen;
+    if (iErrorNo == 0)
+    {
+        iErrorNo = CheckStructure();
+    }
+    if (iErrorNo == 0)
+    {
+        m_lpRoot = ReadNode(0);
+        iErrorNo = m_lpRoot != nullptr ? 0 : MallocFailed;
+    }
+
+    if (iErrorNo != 0)
+    {
+        m_lpContent = nullptr;
+        m_uLen = 0;
+    }
+
+    return iErrorNo;
+}
+
+int32_t CJsonLazyDoc::OpenFileContent(void *lpParam, const char *lpContent, uint64_t uLen)
+{
+    return reinterpret_cast<CJsonLazyDoc *>(lpParam)->Open(lpContent, uLen, true);
+}
+
+int32_t CJsonLazyDoc::Init(ObjType eType)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyDoc::OpenFromFile(const char *lpFile)
+{
+    if (unlikely(lpFile == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    return m_lpContent == nullptr ? ParseJsonFile(lpFile, OpenFileContent, this) : InvaliadCall;
+}
+
+int32_t CJsonLazyDoc::OpenFromBuffer(const char *lpBuffer)
+{
+    if (unlikely(lpBuffer == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    return Open(lpBuffer, strlen(lpBuffer), true);
+}
+
+int32_t CJsonLazyDoc::OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen)
+{
+    if (unlikely(lpBuffer == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    return Open(lpBuffer, uLen, false);
+}
+
+int32_t CJsonLazyDoc::OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyDoc::OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyDoc::OpenSnapshot(const char *lpFile)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyDoc::Clear()
+{
+    // the index, the arena chunks, the cache buckets and the copy buffer
+    // stay for the next Open
+    m_lpContent = nullptr;
+    m_uLen = 0;
+    m_lpRoot = nullptr;
+    m_mapCache.clear();
+    m_arena.Reset();
+    return 0;
+}
+
+int32_t CJsonLazyDoc::AddNull(const char *lpKey)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyDoc::AddBool(const char *lpKey, bool bValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyDoc::AddInt(const char *lpKey, int64_t nValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyDoc::AddDouble(const char *lpKey, double dValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonLazyDoc::AddString(const char *lpKey, const char *lpValue)
+{
+    return InvaliadCall;
+}
+
+IJsonObj *CJsonLazyDoc::AddArray(const char *lpKey)
+{
+    return nullptr;
+}
+
+IJsonObj *CJsonLazyDoc::AddObject(const char *lpKey)
+{
+    return nullptr;
+}
+
+bool CJsonLazyDoc::GetNull(const char *lpKey)
+{
+    return m_lpRoot != nullptr && m_lpRoot->GetNull(lpKey);
+}
+
+bool CJsonLazyDoc::GetBool(const char *lpKey, bool bDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetBool(lpKey, bDefaultValue) : bDefaultValue;
+}
+
+int64_t CJsonLazyDoc::GetInt(const char *lpKey, int64_t nDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetInt(lpKey, nDefaultValue) : nDefaultValue;
+}
+
+double CJsonLazyDoc::GetDouble(const char *lpKey, double dDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetDouble(lpKey, dDefaultValue) : dDefaultValue;
+}
+
+const char *CJsonLazyDoc::GetString(const char *lpKey, const char *lpDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetString(lpKey, lpDefaultValue) : lpDefaultValue;
+}
+
+IJsonObj *CJsonLazyDoc::GetArray(const char *lpKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetArray(lpKey) : nullptr;
+}
+
+IJsonObj *CJsonLazyDoc::GetObject(const char *lpKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetObject(lpKey) : nullptr;
+}
+
+bool CJsonLazyDoc::IsExist(const char *lpKey)
+{
+    return m_lpRoot != nullptr && m_lpRoot->IsExist(lpKey);
+}
+
+bool CJsonLazyDoc::GetNull(const Key &stKey)
+{
+    return m_lpRoot != nullptr && m_lpRoot->GetNull(stKey);
+}
+
+bool CJsonLazyDoc::GetBool(const Key &stKey, bool bDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetBool(stKey, bDefaultValue) : bDefaultValue;
+}
+
+int64_t CJsonLazyDoc::GetInt(const Key &stKey, int64_t nDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetInt(stKey, nDefaultValue) : nDefaultValue;
+}
+
+double CJsonLazyDoc::GetDouble(const Key &stKey, double dDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetDouble(stKey, dDefaultValue) : dDefaultValue;
+}
+
+const char *CJsonLazyDoc::GetString(const Key &stKey, const char *lpDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetString(stKey, lpDefaultValue) : lpDefaultValue;
+}
+
+IJsonObj *CJsonLazyDoc::GetArray(const Key &stKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetArray(stKey) : nullptr;
+}
+
+IJsonObj *CJsonLazyDoc::GetObject(const Key &stKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetObject(stKey) : nullptr;
+}
+
+bool CJsonLazyDoc::IsExist(const Key &stKey)
+{
+    return m_lpRoot != nullptr && m_lpRoot->IsExist(stKey);
+}
+
+IJsonObj::ObjType CJsonLazyDoc::GetType()
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetType() : ObjType::Unknow;
+}
+
+uint32_t CJsonLazyDoc::GetSize()
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetSize() : 0;
+}
+
+IJsonObj::ObjType CJsonLazyDoc::GetType(const char *lpKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetType(lpKey) : ObjType::Unknow;
+}
+
+IJsonObj::ObjType CJsonLazyDoc::GetType(const Key &stKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetType(stKey) : ObjType::Unknow;
+}
+
+IJsonObj::ObjType CJsonLazyDoc::GetType(uint32_t uIndex)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetType(uIndex) : ObjType::Unknow;
+}
+
+int32_t CJsonLazyDoc::GetItem(uint32_t uIndex, KvItem *lpKvItem)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetItem(uIndex, lpKvItem) : InvaliadParam;
+}
+
+bool CJsonLazyDoc::First(Cursor *lpCursor, KvItem *lpKvItem)
+{
+    return m_lpRoot != nullptr && m_lpRoot->First(lpCursor, lpKvItem);
+}
+
+bool CJsonLazyDoc::Next(Cursor *lpCursor, KvItem *lpKvItem)
+{
+    return m_lpRoot != nullptr && m_lpRoot->Next(lpCursor, lpKvItem);
+}
+
+const char *CJsonLazyDoc::GetJsonStr(bool bPretty)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetJsonStr(bPretty) : nullptr;
+}
+
+const char *CJsonLazyDoc::GetBinary(BinaryFormat eFormat, uint64_t *lpLen)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetBinary(eFormat, lpLen) : nullptr;
+}
+
+int32_t CJsonLazyDoc::SaveSnapshot(const char *lpFile)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->SaveSnapshot(lpFile) : InvaliadCall;
+}
+
+IJsonObj *CJsonLazyDoc::Freeze()
+{
+    return m_lpRoot != nullptr ? m_lpRoot->Freeze() : nullptr;
+}
+
+}
+
+cppbase::IJsonObj *NewLazyJsonObject()
+{
+    return NEW cppbase::CJsonLazyDoc();
+}
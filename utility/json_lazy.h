@@ -0,0 +1,219 @@
+#ifndef __JSON_LAZY_H_
+#define __JSON_LAZY_H_
+
+#include <os_common.h>
+#include <json_obj.h>
+#include "json_arena.h"
+#include "json_scanner.h"
+#include "json_number.h"
+#include <unordered_map>
+
+namespace cppbase
+{
+
+class CJsonWriter;
+class CJsonLazyDoc;
+
+/*
+ * Container of a lazy document: a position in the structural index. Each
+ * lookup walks the members from the opening bracket, comparing keys in
+ * place and stepping over the other values by counting brackets, so only
+ * the values actually read are ever converted.
+ */
+class CJsonLazyNode : public IJsonObj
+{
+public:
+    static constexpr uint32_t NoToken = UINT32_MAX;
+
+    CJsonLazyNode(CJsonLazyDoc *lpDoc, uint32_t uOpen) : m_lpDoc(lpDoc), m_uOpen(uOpen) {}
+    ~CJsonLazyNode() override = default;
+
+    int32_t Init(ObjType eType) override;
+
+    int32_t OpenFromFile(const char *lpFile) override;
+    int32_t OpenFromBuffer(const char *lpBuffer) override;
+    int32_t OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen) override;
+    int32_t OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount) override;
+    int32_t OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat) override;
+    int32_t OpenSnapshot(const char *lpFile) override;
+    int32_t Clear() override;
+
+    int32_t AddNull(const char *lpKey) override;
+    int32_t AddBool(const char *lpKey, bool bValue) override;
+    int32_t AddInt(const char *lpKey, int64_t nValue) override;
+    int32_t AddDouble(const char *lpKey, double dValue) override;
+    int32_t AddString(const char *lpKey, const char *lpValue) override;
+    IJsonObj *AddArray(const char *lpKey) override;
+    IJsonObj *AddObject(const char *lpKey) override;
+
+    bool GetNull(const char *lpKey) override;
+    bool GetBool(const char *lpKey, bool bDefaultValue = false) override;
+    int64_t GetInt(const char *lpKey, int64_t nDefaultValue = 0) override;
+    double GetDouble(const char *lpKey, double dDefaultValue = 0.0) override;
+    const char *GetString(const char *lpKey, const char *lpDefaultValue = nullptr) override;
+    IJsonObj *GetArray(const char *lpKey) override;
+    IJsonObj *GetObject(const char *lpKey) override;
+    bool IsExist(const char *lpKey) override;
+
+    bool GetNull(const Key &stKey) override;
+    bool GetBool(const Key &stKey, bool bDefaultValue = false) override;
+    int64_t GetInt(const Key &stKey, int64_t nDefaultValue = 0) override;
+    double GetDouble(const Key &stKey, double dDefaultValue = 0.0) override;
+    const char *GetString(const Key &stKey, const char *lpDefaultValue = nullptr) override;
+    IJsonObj *GetArray(const Key &stKey) override;
+    IJsonObj *GetObject(const Key &stKey) override;
+    bool IsExist(const Key &stKey) override;
+
+    ObjType GetType() override;
+    uint32_t GetSize() override;
+    ObjType GetType(const char *lpKey) override;
+    ObjType GetType(const Key &stKey) override;
+    ObjType GetType(uint32_t uIndex) override;
+    int32_t GetItem(uint32_t uIndex, KvItem *lpKvItem) override;
+    bool First(Cursor *lpCursor, KvItem *lpKvItem) override;
+    bool Next(Cursor *lpCursor, KvItem *lpKvItem) override;
+
+    const char *GetJsonStr(bool bPretty) override;
+    const char *GetBinary(BinaryFormat eFormat, uint64_t *lpLen) override;
+    int32_t SaveSnapshot(const char *lpFile) override;
+    IJsonObj *Freeze() override;
+
+private:
+    // what a Cursor holds: the first token of the current member
+    struct CursorState
+    {
+        uint32_t uToken;
+    };
+
+    uint32_t FindValue(const Key &stKey);
+    uint32_t GetMember(uint32_t uIndex, uint32_t &uKey);
+    bool FillKvItem(uint32_t uToken, KvItem *lpKvItem);
+
+private:
+    CJsonLazyDoc *m_lpDoc;
+    uint32_t m_uOpen;
+    uint32_t m_uSize{NoToken};
+    // the member GetItem reached last, so that walking them in order stays
+    // linear
+    uint32_t m_uLastIndex{0};
+    uint32_t m_uLastToken{NoToken};
+};
+
+/*
+ * What NewLazyJsonObject returns: an Open call indexes the document and
+ * checks its structure, and the values are converted when they are read.
+ * Keys are never compared with each other, so a repeated one is kept.
+ * Nodes and decoded strings are made on first use and kept until the
+ * document is deleted.
+ */
+class CJsonLazyDoc : public IJsonObj
+{
+    friend class CJsonLazyNode;
+
+public:
+    CJsonLazyDoc() = default;
+    ~CJsonLazyDoc() override;
+
+    int32_t Init(ObjType eType) override;
+
+    int32_t OpenFromFile(const char *lpFile) override;
+    int32_t OpenFromBuffer(const char *lpBuffer) override;
+    int32_t OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen) override;
+    int32_t OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount) override;
+    int32_t OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat) override;
+    int32_t OpenSnapshot(const char *lpFile) override;
+    int32_t Clear() override;
+
+    int32_t AddNull(const char *lpKey) override;
+    int32_t AddBool(const char *lpKey, bool bValue) override;
+    int32_t AddInt(const char *lpKey, int64_t nValue) override;
+    int32_t AddDouble(const char *lpKey, double dValue) override;
+    int32_t AddString(const char *lpKey, const char *lpValue) override;
+    IJsonObj *AddArray(const char *lpKey) override;
+    IJsonObj *AddObject(const char *lpKey) override;
+
+    bool GetNull(const char *lpKey) override;
+    bool GetBool(const char *lpKey, bool bDefaultValue = false) override;
+    int64_t GetInt(const char *lpKey, int64_t nDefaultValue = 0) override;
+    double GetDouble(const char *lpKey, double dDefaultValue = 0.0) override;
+    const char *GetString(const char *lpKey, const char *lpDefaultValue = nullptr) override;
+    IJsonObj *GetArray(const char *lpKey) override;
+    IJsonObj *GetObject(const char *lpKey) override;
+    bool IsExist(const char *lpKey) override;
+
+    bool GetNull(const Key &stKey) override;
+    bool GetBool(const Key &stKey, bool bDefaultValue = false) override;
+    int64_t GetInt(const Key &stKey, int64_t nDefaultValue = 0) override;
+    double GetDouble(const Key &stKey, double dDefaultValue = 0.0) override;
+    const char *GetString(const Key &stKey, const char *lpDefaultValue = nullptr) override;
+    IJsonObj *GetArray(const Key &stKey) override;
+    IJsonObj *GetObject(const Key &stKey) override;
+    bool IsExist(const Key &stKey) override;
+
+    ObjType GetType() override;
+    uint32_t GetSize() override;
+    ObjType GetType(const char *lpKey) override;
+    ObjType GetType(const Key &stKey) override;
+    ObjType GetType(uint32_t uIndex) override;
+    int32_t GetItem(uint32_t uIndex, KvItem *lpKvItem) override;
+    bool First(Cursor *lpCursor, KvItem *lpKvItem) override;
+    bool Next(Cursor *lpCursor, KvItem *lpKvItem) override;
+
+    const char *GetJsonStr(bool bPretty) override;
+    const char *GetBinary(BinaryFormat eFormat, uint64_t *lpLen) override;
+    int32_t SaveSnapshot(const char *lpFile) override;
+    IJsonObj *Freeze() override;
+
+private:
+    static constexpr uint32_t NoToken = CJsonLazyNode::NoToken;
+    static constexpr uint32_t MaxParseDepth = 1024;
+
+    // a decoded string, or the node of a container, by its first token
+    struct CacheEntry
+    {
+        const void *lpValue;
+        uint32_t uLen;
+    };
+
+    inline char PeekToken(uint32_t uIndex) const
+    {
+        return likely(uIndex < m_scanner.GetCount()) ? m_lpContent[m_scanner.GetIndex()[uIndex]] : '\0';
+    }
+
+    // members are walked by their first token: the key of an object member,
+    // the value of an array element
+    uint32_t SkipValue(uint32_t uIndex) const;
+    uint32_t FirstMember(uint32_t uOpen) const;
+    uint32_t NextMember(uint32_t uOpen, uint32_t uToken) const;
+    uint32_t GetValueToken(uint32_t uOpen, uint32_t uToken) const;
+    bool IsKey(uint32_t uIndex, const Key &stKey);
+
+    bool IsEnd(uint64_t uPos) const;
+    ObjType ReadType(uint32_t uIndex) const;
+    bool ReadValue(uint32_t uIndex, KvItem *lpKvItem);
+    const char *ReadString(uint32_t uIndex, uint32_t *lpLen = nullptr);
+    CJsonLazyNode *ReadNode(uint32_t uIndex);
+    int32_t WriteValue(CJsonWriter &writer, uint32_t uIndex, bool bPretty, uint32_t uDepth);
+    CJsonWriter *GetWriter();
+    const char *WriteJsonStr(uint32_t uIndex, bool bPretty);
+    const char *WriteBinary(IJsonObj *lpNode, BinaryFormat eFormat, uint64_t *lpLen);
+
+    int32_t CheckStructure() const;
+    int32_t Open(const char *lpContent, uint64_t uLen, bool bCopy);
+    static int32_t OpenFileContent(void *lpParam, const char *lpContent, uint64_t uLen);
+
+private:
+    const char *m_lpContent{nullptr};
+    char *m_lpCopy{nullptr}; // where inputs are copied to, kept for the next Open
+    uint64_t m_uCopySize{0};
+    uint64_t m_uLen{0};
+    CJsonScanner m_scanner;
+    CJsonArena m_arena;
+    std::unordered_map<uint32_t, CacheEntry> m_mapCache;
+    CJsonLazyNode *m_lpRoot{nullptr};
+    CJsonWriter *m_lpWriter{nullptr};
+};
+
+}
+
+#endif //__JSON_LAZY_H_
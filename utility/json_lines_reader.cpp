@@ -0,0 +1,268 @@
+#include "json_lines_reader.h"
+#include "json_arena.h"
+#include "json_obj_impl.h"
+#include "json_file.h"
+#include <error_no.h>
+#include <pthread.h>
+#include <algorithm>
+
+namespace cppbase
+{
+
+CJsonLinesReader::CJsonLinesReader(uint32_t uThreads, int32_t iFirstCpu, uint64_t uBatchSize, bool bOrdered)
+    : m_uThreads(uThreads), m_iFirstCpu(iFirstCpu), m_uBatchSize(uBatchSize), m_bOrdered(bOrdered)
+{
+    if (m_uThreads == 0)
+    {
+        m_uThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    if (m_uBatchSize == 0)
+    {
+        m_uBatchSize = DefaultBatchSize;
+    }
+}
+
+CJsonLinesReader::~CJsonLinesReader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bExit = true;
+    }
+    m_cvWork.notify_all();
+
+    for (auto &thread : m_vecThreads)
+    {
+        thread.join();
+    }
+}
+
+int32_t CJsonLinesReader::Start()
+{
+    try
+    {
+        m_vecThreads.reserve(m_uThreads);
+        for (uint32_t i = 0; i < m_uThreads; i++)
+        {
+            m_vecThreads.emplace_back(&CJsonLinesReader::Run, this, i);
+        }
+    }
+    catch (...)
+    {
+        return SysCallFailed;
+    }
+
+    return 0;
+}
+
+void CJsonLinesReader::Run(uint32_t uWorker)
+{
+    if (m_iFirstCpu >= 0)
+    {
+        thread_bind_cpu(m_iFirstCpu + int32_t(uWorker));
+    }
+
+    uint64_t uRead = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cvWork.wait(lock, [&] { return m_bExit || m_uRead != uRead; });
+        if (m_bExit)
+        {
+            return;
+        }
+
+        uRead = m_uRead;
+        lock.unlock();
+        RunBatches();
+        lock.lock();
+
+        if (--m_uBusy == 0)
+        {
+            m_cvDone.notify_all();
+        }
+    }
+}
+
+uint64_t CJsonLinesReader::GetLineStart(uint64_t uPos) const
+{
+    // the first line starting at or after uPos
+    if (uPos == 0 || uPos >= m_uLen)
+    {
+        return std::min(uPos, m_uLen);
+    }
+
+    auto lpNewLine = reinterpret_cast<const char *>(memchr(m_lpContent + uPos - 1, '\n', m_uLen - uPos + 1));
+    return lpNewLine != nullptr ? lpNewLine - m_lpContent + 1 : m_uLen;
+}
+
+CJsonArena *CJsonLinesReader::ParseBatch(uint64_t uBegin, uint64_t uEnd, std::vector<IJsonObj *> &vecRecords)
+{
+    auto lpArena = NEW CJsonArena();
+    auto lpCopy = lpArena != nullptr ? reinterpret_cast<char *>(lpArena->Alloc(uEnd - uBegin)) : nullptr;
+    if (unlikely(lpCopy == nullptr))
+    {
+        delete lpArena;
+        return nullptr;
+    }
+    memcpy(lpCopy, m_lpContent + uBegin, uEnd - uBegin);
+
+    try
+    {
+        vecRecords.clear();
+        for (auto lpLine = lpCopy, lpCopyEnd = lpCopy + (uEnd - uBegin); lpLine < lpCopyEnd;)
+        {
+            auto lpLineEnd = reinterpret_cast<char *>(memchr(lpLine, '\n', lpCopyEnd - lpLine));
+            lpLineEnd = lpLineEnd != nullptr ? lpLineEnd : lpCopyEnd;
+            auto lpNext = lpLineEnd + 1;
+            while (lpLineEnd > lpLine && (lpLineEnd[-1] == ' ' || lpLineEnd[-1] == '\t' || lpLineEnd[-1] == '\r'))
+            {
+                lpLineEnd--;
+            }
+
+            if (lpLineEnd != lpLine)
+            {
+                auto lpMem = lpArena->Alloc(sizeof(CJsonObjImpl));
+                if (unlikely(lpMem == nullptr))
+                {
+                    delete lpArena;
+                    return nullptr;
+                }
+
+                auto lpRecord = new(lpMem) CJsonObjImpl(lpArena);
+                auto iErrorNo = lpRecord->OpenFromBufferInSitu(lpLine, lpLineEnd - lpLine);
+                vecRecords.push_back(iErrorNo == 0 ? lpRecord : nullptr);
+            }
+            lpLine = lpNext;
+        }
+    }
+    catch (...)
+    {
+        delete lpArena;
+        return nullptr;
+    }
+
+    return lpArena;
+}
+
+void CJsonLinesReader::SetError(int32_t iErrorNo)
+{
+    // the first error is the one reported
+    int32_t iNoError = 0;
+    m_iErrorNo.compare_exchange_strong(iNoError, iErrorNo);
+    std::lock_guard<std::mutex> lock(m_mutexDeliver);
+    m_cvTurn.notify_all();
+}
+
+void CJsonLinesReader::Deliver(uint64_t uBatch, uint64_t uOffset, const std::vector<IJsonObj *> &vecRecords)
+{
+    std::unique_lock<std::mutex> lock(m_mutexDeliver);
+    if (m_bOrdered)
+    {
+        m_cvTurn.wait(lock, [&] { return m_uNextDelivery == uBatch || m_iErrorNo != 0; });
+    }
+
+    if (m_iErrorNo == 0 && !vecRecords.empty()
+        && !m_lpConsumer->OnBatch(uOffset, vecRecords.data(), uint32_t(vecRecords.size())))
+    {
+        int32_t iNoError = 0;
+        m_iErrorNo.compare_exchange_strong(iNoError, ParseCanceled);
+    }
+
+    if (m_bOrdered)
+    {
+        m_uNextDelivery++;
+        m_cvTurn.notify_all();
+    }
+}
+
+void CJsonLinesReader::RunBatches()
+{
+    std::vector<IJsonObj *> vecRecords;
+    while (m_iErrorNo == 0)
+    {
+        auto uBatch = m_uNextBatch.fetch_add(1);
+        if (uBatch >= m_uBatches)
+        {
+            return;
+        }
+
+        // a line longer than a batch leaves the batches it spans empty
+        auto uBegin = GetLineStart(uBatch * m_uBatchSize);
+        auto uEnd = GetLineStart((uBatch + 1) * m_uBatchSize);
+        if (uBegin == uEnd)
+        {
+            vecRecords.clear();
+            Deliver(uBatch, uBegin, vecRecords);
+            continue;
+        }
+
+        auto lpArena = ParseBatch(uBegin, uEnd, vecRecords);
+        if (unlikely(lpArena == nullptr))
+        {
+            SetError(MallocFailed);
+            return;
+        }
+
+        Deliver(uBatch, uBegin, vecRecords);
+        delete lpArena;
+    }
+}
+
+int32_t CJsonLinesReader::ReadBuffer(const char *lpBuffer, uint64_t uLen, IJsonLinesConsumer *lpConsumer)
+{
+    if (unlikely((lpBuffer == nullptr && uLen > 0) || lpConsumer == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_lpContent = lpBuffer;
+    m_uLen = uLen;
+    m_uBatches = (uLen + m_uBatchSize - 1) / m_uBatchSize;
+    m_lpConsumer = lpConsumer;
+    m_uNextBatch = 0;
+    m_iErrorNo = 0;
+    m_uNextDelivery = 0;
+    m_uBusy = uint32_t(m_vecThreads.size());
+    m_uRead++;
+    m_cvWork.notify_all();
+
+    m_cvDone.wait(lock, [&] { return m_uBusy == 0; });
+    return m_iErrorNo;
+}
+
+int32_t CJsonLinesReader::ReadFileContent(void *lpParam, const char *lpContent, uint64_t uLen)
+{
+    auto lpRead = reinterpret_cast<FileRead *>(lpParam);
+    return lpRead->lpReader->ReadBuffer(lpContent, uLen, lpRead->lpConsumer);
+}
+
+int32_t CJsonLinesReader::ReadFile(const char *lpFile, IJsonLinesConsumer *lpConsumer)
+{
+    if (unlikely(lpFile == nullptr || lpConsumer == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    FileRead stRead{this, lpConsumer};
+    return ParseJsonFile(lpFile, ReadFileContent, &stRead);
+}
+
+}
+
+cppbase::IJsonLinesReader *NewJsonLinesReader(uint32_t uThreads, int32_t iFirstCpu, uint64_t uBatchSize, bool bOrdered)
+{
+    auto lpReader = NEW cppbase::CJsonLinesReader(uThreads, iFirstCpu, uBatchSize, bOrdered);
+    if (lpReader != nullptr && lpReader->Start() != 0)
+    {
+        delete lpReader;
+        return nullptr;
+    }
+
+    return lpReader;
+}
+
+void DeleteJsonLinesReader(cppbase::IJsonLinesReader *lpReader)
+{
+    delete static_cast<cppbase::CJsonLinesReader *>(lpReader);
+}
@@ -0,0 +1,86 @@
+#ifndef __JSON_LINES_READER_H_
+#define __JSON_LINES_READER_H_
+
+#include <os_common.h>
+#include <json_lines.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cppbase
+{
+
+class CJsonArena;
+
+/*
+ * Worker pool behind IJsonLinesReader.
+ *
+ * Batch k covers the lines starting in [k * uBatchSize, (k + 1) *
+ * uBatchSize), so workers find their own batch boundaries and only share
+ * the counter of the next batch to take. A batch is copied into an arena
+ * of its own and its records are parsed in situ into that arena, which is
+ * released as a whole once the batch is delivered.
+ */
+class CJsonLinesReader : public IJsonLinesReader
+{
+public:
+    static constexpr uint64_t DefaultBatchSize = 1024 * 1024;
+
+    CJsonLinesReader(uint32_t uThreads, int32_t iFirstCpu, uint64_t uBatchSize, bool bOrdered);
+    ~CJsonLinesReader() override;
+
+    CJsonLinesReader(const CJsonLinesReader &) = delete;
+    CJsonLinesReader &operator=(const CJsonLinesReader &) = delete;
+
+    int32_t Start();
+
+    int32_t ReadFile(const char *lpFile, IJsonLinesConsumer *lpConsumer) override;
+    int32_t ReadBuffer(const char *lpBuffer, uint64_t uLen, IJsonLinesConsumer *lpConsumer) override;
+
+private:
+    struct FileRead
+    {
+        CJsonLinesReader *lpReader;
+        IJsonLinesConsumer *lpConsumer;
+    };
+
+    static int32_t ReadFileContent(void *lpParam, const char *lpContent, uint64_t uLen);
+    void Run(uint32_t uWorker);
+    void RunBatches();
+    uint64_t GetLineStart(uint64_t uPos) const;
+    CJsonArena *ParseBatch(uint64_t uBegin, uint64_t uEnd, std::vector<IJsonObj *> &vecRecords);
+    void Deliver(uint64_t uBatch, uint64_t uOffset, const std::vector<IJsonObj *> &vecRecords);
+    void SetError(int32_t iErrorNo);
+
+private:
+    uint32_t m_uThreads;
+    int32_t m_iFirstCpu;
+    uint64_t m_uBatchSize;
+    bool m_bOrdered;
+    std::vector<std::thread> m_vecThreads;
+
+    // the read in progress, published under m_mutex by bumping m_uRead
+    std::mutex m_mutex;
+    std::condition_variable m_cvWork;
+    std::condition_variable m_cvDone;
+    uint64_t m_uRead{0};
+    uint32_t m_uBusy{0};
+    bool m_bExit{false};
+    const char *m_lpContent{nullptr};
+    uint64_t m_uLen{0};
+    uint64_t m_uBatches{0};
+    IJsonLinesConsumer *m_lpConsumer{nullptr};
+    std::atomic<uint64_t> m_uNextBatch{0};
+    std::atomic<int32_t> m_iErrorNo{0};
+
+    // OnBatch calls, and their order when m_bOrdered
+    std::mutex m_mutexDeliver;
+    std::condition_variable m_cvTurn;
+    uint64_t m_uNextDelivery{0};
+};
+
+}
+
+#endif //__JSON_LINES_READER_H_
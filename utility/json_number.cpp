@@ -0,0 +1,700 @@
+#include "json_number.h"
+#include "json_number_table.h"
+#include <locale.h>
+
+namespace cppbase
+{
+
+namespace
+{
+
+const char g_szDigitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+const uint64_t g_szPow10[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+    1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL, 10000000000000000000ULL
+};
+
+inline uint32_t DecimalLength(uint64_t uValue)
+{
+    // floor(log10(2) * bit length) is the digit count or one less;
+    // 10^k - 1 is odd, so or-ing in the low bit never changes the count
+    uValue |= 1;
+    uint32_t uGuess = uint32_t(((64 - __builtin_clzll(uValue)) * 1233) >> 12);
+    return uGuess + (uValue >= g_szPow10[uGuess]);
+}
+
+// writes exactly uLen digits of uValue ending at lpOut + uLen
+inline void WriteDigits(uint64_t uValue, char *lpOut, uint32_t uLen)
+{
+    auto lpCur = lpOut + uLen;
+    while (uValue >= 100)
+    {
+        auto uPair = uint32_t(uValue % 100);
+        uValue /= 100;
+        lpCur -= 2;
+        memcpy(lpCur, g_szDigitPairs + uPair * 2, 2);
+    }
+
+    if (uValue >= 10)
+    {
+        memcpy(lpCur - 2, g_szDigitPairs + uValue * 2, 2);
+    }
+    else
+    {
+        lpCur[-1] = char('0' + uValue);
+    }
+}
+
+/*
+ * Ryu (Ulf Adams, PLDI 2018): the shortest decimal in the rounding
+ * interval of a double, computed with 128-bit multiplications against
+ * precomputed powers of five.
+ */
+constexpr int32_t DoubleMantissaBits = 52;
+constexpr int32_t DoubleBias = 1023;
+
+inline uint32_t Pow5Bits(int32_t e)
+{
+    return uint32_t(((e * 1217359) >> 19) + 1);
+}
+
+inline uint32_t Log10Pow2(int32_t e)
+{
+    return uint32_t((e * 78913) >> 18);
+}
+
+inline uint32_t Log10Pow5(int32_t e)
+{
+    return uint32_t((e * 732923) >> 20);
+}
+
+inline uint32_t Pow5Factor(uint64_t uValue)
+{
+    uint32_t uCount = 0;
+    while (uValue % 5 == 0)
+    {
+        uValue /= 5;
+        uCount++;
+    }
+    return uCount;
+}
+
+inline bool MultipleOfPowerOf5(uint64_t uValue, uint32_t uPower)
+{
+    return Pow5Factor(uValue) >= uPower;
+}
+
+inline bool MultipleOfPowerOf2(uint64_t uValue, uint32_t uPower)
+{
+    return (uValue & ((1ULL << uPower) - 1)) == 0;
+}
+
+inline uint64_t MulShift64(uint64_t uValue, const uint64_t *lpMul, int32_t iShift)
+{
+    auto uLow = static_cast<unsigned __int128>(uValue) * lpMul[0];
+    auto uHigh = static_cast<unsigned __int128>(uValue) * lpMul[1];
+    return uint64_t(((uLow >> 64) + uHigh) >> (iShift - 64));
+}
+
+void RyuDecimal(uint64_t uIeeeMantissa, uint32_t uIeeeExponent, uint64_t &uOutput, int32_t &iExponent)
+{
+    int32_t e2;
+    uint64_t m2;
+    if (uIeeeExponent == 0)
+    {
+        e2 = 1 - DoubleBias - DoubleMantissaBits - 2;
+        m2 = uIeeeMantissa;
+    }
+    else
+    {
+        e2 = int32_t(uIeeeExponent) - DoubleBias - DoubleMantissaBits - 2;
+        m2 = (1ULL << DoubleMantissaBits) | uIeeeMantissa;
+    }
+
+    const bool bAcceptBounds = (m2 & 1) == 0;
+    const uint64_t mv = 4 * m2;
+    const uint32_t mmShift = uIeeeMantissa != 0 || uIeeeExponent <= 1;
+
+    // the interval [vm, vp] around vr, scaled by 10^-e10
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    bool bVmIsTrailingZeros = false;
+    bool bVrIsTrailingZeros = false;
+    if (e2 >= 0)
+    {
+        const uint32_t q = Log10Pow2(e2) - (e2 > 3);
+        e10 = int32_t(q);
+        const int32_t k = DoublePow5InvBitCount + int32_t(Pow5Bits(int32_t(q))) - 1;
+        const int32_t i = -e2 + int32_t(q) + k;
+        vr = MulShift64(4 * m2, g_szDoublePow5InvSplit[q], i);
+        vp = MulShift64(4 * m2 + 2, g_szDoublePow5InvSplit[q], i);
+        vm = MulShift64(4 * m2 - 1 - mmShift, g_szDoublePow5InvSplit[q], i);
+        if (q <= 21)
+        {
+            if (mv % 5 == 0)
+            {
+                bVrIsTrailingZeros = MultipleOfPowerOf5(mv, q);
+            }
+            else if (bAcceptBounds)
+            {
+                bVmIsTrailingZeros = MultipleOfPowerOf5(mv - 1 - mmShift, q);
+            }
+            else
+            {
+                vp -= MultipleOfPowerOf5(mv + 2, q);
+            }
+        }
+    }
+    else
+    {
+        const uint32_t q = Log10Pow5(-e2) - (-e2 > 1);
+        e10 = int32_t(q) + e2;
+        const int32_t i = -e2 - int32_t(q);
+        const int32_t k = int32_t(Pow5Bits(i)) - DoublePow5BitCount;
+        const int32_t j = int32_t(q) - k;
+        vr = MulShift64(4 * m2, g_szDoublePow5Split[i], j);
+        vp = MulShift64(4 * m2 + 2, g_szDoublePow5Split[i], j);
+        vm = MulShift64(4 * m2 - 1 - mmShift, g_szDoublePow5Split[i], j);
+        if (q <= 1)
+        {
+            bVrIsTrailingZeros = true;
+            if (bAcceptBounds)
+            {
+                bVmIsTrailingZeros = mmShift == 1;
+            }
+            else
+            {
+                --vp;
+            }
+        }
+        else if (q < 63)
+        {
+            bVrIsTrailingZeros = MultipleOfPowerOf2(mv, q);
+        }
+    }
+
+    // drop digits while the interval still holds a shorter representation
+    int32_t iRemoved = 0;
+    uint32_t uLastRemoved = 0;
+    if (bVmIsTrailingZeros || bVrIsTrailingZeros)
+    {
+        while (vp / 10 > vm / 10)
+        {
+            bVmIsTrailingZeros &= vm % 10 == 0;
+            bVrIsTrailingZeros &= uLastRemoved == 0;
+            uLastRemoved = uint32_t(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            iRemoved++;
+        }
+
+        if (bVmIsTrailingZeros)
+        {
+            while (vm % 10 == 0)
+            {
+                bVrIsTrailingZeros &= uLastRemoved == 0;
+                uLastRemoved = uint32_t(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                iRemoved++;
+            }
+        }
+
+        if (bVrIsTrailingZeros && uLastRemoved == 5 && vr % 2 == 0)
+        {
+            // exactly halfway: round to even
+            uLastRemoved = 4;
+        }
+
+        uOutput = vr + ((vr == vm && (!bAcceptBounds || !bVmIsTrailingZeros)) || uLastRemoved >= 5);
+    }
+    else
+    {
+        bool bRoundUp = false;
+        if (vp / 100 > vm / 100)
+        {
+            bRoundUp = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            iRemoved += 2;
+        }
+
+        while (vp / 10 > vm / 10)
+        {
+            bRoundUp = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            iRemoved++;
+        }
+
+        uOutput = vr + (vr == vm || bRoundUp);
+    }
+
+    iExponent = e10 + iRemoved;
+}
+
+}
+
+char *FormatUInt64(uint64_t uValue, char *lpOut)
+{
+    auto uLen = DecimalLength(uValue);
+    WriteDigits(uValue, lpOut, uLen);
+    return lpOut + uLen;
+}
+
+char *FormatInt64(int64_t nValue, char *lpOut)
+{
+    auto uValue = uint64_t(nValue);
+    if (nValue < 0)
+    {
+        *lpOut++ = '-';
+        uValue = 0 - uValue;
+    }
+
+    return FormatUInt64(uValue, lpOut);
+}
+
+char *FormatDouble(double dValue, char *lpOut)
+{
+    uint64_t uBits;
+    memcpy(&uBits, &dValue, sizeof(uBits));
+    auto uIeeeMantissa = uBits & ((1ULL << DoubleMantissaBits) - 1);
+    auto uIeeeExponent = uint32_t((uBits >> DoubleMantissaBits) & 0x7FF);
+
+    if (uBits >> 63)
+    {
+        *lpOut++ = '-';
+    }
+
+    if (uIeeeExponent == 0 && uIeeeMantissa == 0)
+    {
+        memcpy(lpOut, "0.0", 3);
+        return lpOut + 3;
+    }
+
+    uint64_t uDigits;
+    int32_t iExponent;
+    RyuDecimal(uIeeeMantissa, uIeeeExponent, uDigits, iExponent);
+
+    char szDigits[MaxIntegerChars];
+    auto uLen = DecimalLength(uDigits);
+    WriteDigits(uDigits, szDigits, uLen);
+
+    // value = 0.<digits> * 10^iPoint
+    int32_t iPoint = int32_t(uLen) + iExponent;
+    if (iPoint > 0 && iPoint <= 21)
+    {
+        if (uint32_t(iPoint) >= uLen)
+        {
+            // 1500 -> "1500.0"
+            memcpy(lpOut, szDigits, uLen);
+            memset(lpOut + uLen, '0', iPoint - uLen);
+            lpOut += iPoint;
+            memcpy(lpOut, ".0", 2);
+            return lpOut + 2;
+        }
+
+        // 12.5
+        memcpy(lpOut, szDigits, iPoint);
+        lpOut[iPoint] = '.';
+        memcpy(lpOut + iPoint + 1, szDigits + iPoint, uLen - iPoint);
+        return lpOut + uLen + 1;
+    }
+
+    if (iPoint <= 0 && iPoint > -6)
+    {
+        // 0.00125
+        memcpy(lpOut, "0.", 2);
+        memset(lpOut + 2, '0', -iPoint);
+        lpOut += 2 - iPoint;
+        memcpy(lpOut, szDigits, uLen);
+        return lpOut + uLen;
+    }
+
+    // 1.25e-7, 1e+300
+    *lpOut++ = szDigits[0];
+    if (uLen > 1)
+    {
+        *lpOut++ = '.';
+        memcpy(lpOut, szDigits + 1, uLen - 1);
+        lpOut += uLen - 1;
+    }
+
+    *lpOut++ = 'e';
+    int32_t iExp10 = iPoint - 1;
+    if (iExp10 < 0)
+    {
+        *lpOut++ = '-';
+        iExp10 = -iExp10;
+    }
+    else
+    {
+        *lpOut++ = '+';
+    }
+
+    return FormatUInt64(uint64_t(iExp10), lpOut);
+}
+
+namespace
+{
+
+constexpr uint32_t MaxMantissaDigits = 19;
+constexpr uint64_t DoubleInfinityBits = 0x7FFULL << DoubleMantissaBits;
+constexpr int64_t MaxExponent = 100000000;
+
+// inputs the fast paths cannot decide keep this many significant digits
+// plus a sticky one; a halfway point between two doubles needs 767
+constexpr uint32_t MaxSlowDigits = 768;
+
+const double g_szExactPow10[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline uint64_t LoadEight(const char *lpCur)
+{
+    uint64_t uValue;
+    memcpy(&uValue, lpCur, sizeof(uValue));
+    return uValue;
+}
+
+inline bool IsEightDigits(uint64_t uValue)
+{
+    // every byte 0x30..0x39: the high nibble is 3 and adding 6 keeps it 3
+    return ((uValue & 0xF0F0F0F0F0F0F0F0ULL) | (((uValue + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))
+        == 0x3333333333333333ULL;
+}
+
+inline uint32_t ParseEightDigits(uint64_t uValue)
+{
+    // the first digit is the lowest byte; combine pairs, then quads, then halves
+    uValue -= 0x3030303030303030ULL;
+    uValue = uValue * 10 + (uValue >> 8);
+    uValue = (((uValue & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+              + (((uValue >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return uint32_t(uValue);
+}
+
+inline bool CanParseEight(const char *lpCur, const char *lpEnd)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return lpEnd - lpCur >= 8 && IsEightDigits(LoadEight(lpCur));
+#else
+    (void)lpCur;
+    (void)lpEnd;
+    return false;
+#endif
+}
+
+// Appends the digits at lpCur to the mantissa while it holds fewer than
+// MaxMantissaDigits, and returns the end of the digit run. uDigits and
+// iDropped count the digits taken and left out, bTruncated records a
+// non-zero digit left out.
+const char *ParseDigits(const char *lpCur, const char *lpEnd, uint64_t &uMantissa, uint32_t &uDigits,
+                        int64_t &iDropped, bool &bTruncated)
+{
+    while (uDigits + 8 <= MaxMantissaDigits && CanParseEight(lpCur, lpEnd))
+    {
+        uMantissa = uMantissa * 100000000 + ParseEightDigits(LoadEight(lpCur));
+        uDigits += 8;
+        lpCur += 8;
+    }
+
+    for (; lpCur < lpEnd && uint8_t(*lpCur - '0') <= 9; lpCur++)
+    {
+        if (uDigits < MaxMantissaDigits)
+        {
+            uMantissa = uMantissa * 10 + uint64_t(*lpCur - '0');
+            uDigits++;
+        }
+        else
+        {
+            iDropped++;
+            bTruncated |= *lpCur != '0';
+        }
+    }
+
+    return lpCur;
+}
+
+inline uint64_t MultiplyHigh(uint64_t uLeft, uint64_t uRight, uint64_t &uLow)
+{
+    auto uProduct = static_cast<unsigned __int128>(uLeft) * uRight;
+    uLow = uint64_t(uProduct);
+    return uint64_t(uProduct >> 64);
+}
+
+// Eisel-Lemire: the bits of the double nearest to uMantissa * 10^iExp10,
+// or -1 when the 128-bit power of five is too coarse to tell
+int64_t ComputeDouble(uint64_t uMantissa, int64_t iExp10)
+{
+    if (uMantissa == 0 || iExp10 < DecimalPow5MinExp)
+    {
+        return 0;
+    }
+    if (iExp10 > DecimalPow5MaxExp)
+    {
+        return int64_t(DoubleInfinityBits);
+    }
+
+    auto uLeadingZeros = uint32_t(__builtin_clzll(uMantissa));
+    uMantissa <<= uLeadingZeros;
+
+    // the top 55 bits of the product decide the result; when they end in
+    // all ones, the next 64 bits of the power may still carry into them
+    auto lpPow5 = g_szDecimalPow5[iExp10 - DecimalPow5MinExp];
+    uint64_t uLow = 0;
+    auto uHigh = MultiplyHigh(uMantissa, lpPow5[1], uLow);
+    constexpr uint64_t uPrecisionMask = UINT64_MAX >> (DoubleMantissaBits + 3);
+    if ((uHigh & uPrecisionMask) == uPrecisionMask)
+    {
+        uint64_t uSecondLow = 0;
+        auto uSecondHigh = MultiplyHigh(uMantissa, lpPow5[0], uSecondLow);
+        uLow += uSecondHigh;
+        uHigh += uSecondHigh > uLow;
+        if (uLow == UINT64_MAX && (iExp10 < -27 || iExp10 > 55))
+        {
+            return -1;
+        }
+    }
+
+    auto uUpperBit = uint32_t(uHigh >> 63);
+    auto uShift = uUpperBit + 64 - DoubleMantissaBits - 3;
+    auto uResult = uHigh >> uShift;
+    // floor(log2(10^q)) + 63 - leading zeros + bias
+    auto iExp2 = int32_t(((int64_t(152170 + 65536) * iExp10) >> 16) + 63 + uUpperBit - uLeadingZeros + DoubleBias);
+
+    if (iExp2 <= 0)
+    {
+        // subnormal, which rounds up to the smallest normal at worst
+        if (-iExp2 + 1 >= 64)
+        {
+            return 0;
+        }
+        uResult >>= -iExp2 + 1;
+        uResult += uResult & 1;
+        uResult >>= 1;
+        return int64_t(uResult);
+    }
+
+    // an exact product sitting halfway between two doubles rounds to even
+    if (uLow <= 1 && iExp10 >= -4 && iExp10 <= 23 && (uResult & 3) == 1 && (uResult << uShift) == uHigh)
+    {
+        uResult &= ~1ULL;
+    }
+
+    uResult += uResult & 1;
+    uResult >>= 1;
+    if (uResult >= (2ULL << DoubleMantissaBits))
+    {
+        uResult = 1ULL << DoubleMantissaBits;
+        iExp2++;
+    }
+
+    if (iExp2 >= 0x7FF)
+    {
+        return int64_t(DoubleInfinityBits);
+    }
+
+    uResult &= ~(1ULL << DoubleMantissaBits);
+    return int64_t(uResult | (uint64_t(iExp2) << DoubleMantissaBits));
+}
+
+// Exact conversion of the rare inputs the fast paths cannot decide: the
+// significant digits between lpBegin and lpEnd are rewritten on the stack
+// as digits followed by an exponent and handed to strtod_l in the "C"
+// locale. Digits beyond MaxSlowDigits only matter through being non-zero,
+// so they collapse into one sticky digit.
+double ParseDoubleSlow(const char *lpBegin, const char *lpEnd, int64_t iExp10)
+{
+    char szBuffer[MaxSlowDigits + 32];
+    auto lpOut = szBuffer;
+    if (*lpBegin == '-')
+    {
+        *lpOut++ = *lpBegin++;
+    }
+
+    uint32_t uDigits = 0;
+    bool bFraction = false;
+    bool bSticky = false;
+    for (auto lpCur = lpBegin; lpCur < lpEnd; lpCur++)
+    {
+        if (*lpCur == '.')
+        {
+            bFraction = true;
+        }
+        else if (uDigits == 0 && *lpCur == '0')
+        {
+            iExp10 -= bFraction;
+        }
+        else if (uDigits < MaxSlowDigits)
+        {
+            *lpOut++ = *lpCur;
+            uDigits++;
+            iExp10 -= bFraction;
+        }
+        else
+        {
+            bSticky |= *lpCur != '0';
+            iExp10 += !bFraction;
+        }
+    }
+
+    if (bSticky)
+    {
+        *lpOut++ = '1';
+        iExp10--;
+    }
+    if (uDigits == 0)
+    {
+        *lpOut++ = '0';
+    }
+
+    iExp10 = iExp10 < -MaxExponent ? -MaxExponent : (iExp10 > MaxExponent ? MaxExponent : iExp10);
+    *lpOut++ = 'e';
+    if (iExp10 < 0)
+    {
+        *lpOut++ = '-';
+        iExp10 = -iExp10;
+    }
+    *FormatUInt64(uint64_t(iExp10), lpOut) = '\0';
+
+    static const locale_t stCLocale = newlocale(LC_ALL_MASK, "C", locale_t(0));
+    return stCLocale != locale_t(0) ? strtod_l(szBuffer, nullptr, stCLocale) : strtod(szBuffer, nullptr);
+}
+
+}
+
+const char *ParseNumber(const char *lpBegin, const char *lpEnd, JsonNumber &stNumber)
+{
+    // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    auto lpCur = lpBegin;
+    bool bNegative = lpCur < lpEnd && *lpCur == '-';
+    lpCur += bNegative;
+
+    if (lpCur >= lpEnd || uint8_t(*lpCur - '0') > 9)
+    {
+        return nullptr;
+    }
+
+    // the first MaxMantissaDigits significant digits, and the power of ten
+    // that scales them back to the value written
+    uint64_t uMantissa = 0;
+    uint32_t uDigits = 0;
+    int64_t iExp10 = 0;
+    bool bTruncated = false;
+    if (*lpCur == '0')
+    {
+        lpCur++;
+    }
+    else
+    {
+        lpCur = ParseDigits(lpCur, lpEnd, uMantissa, uDigits, iExp10, bTruncated);
+    }
+
+    bool bDouble = false;
+    if (lpCur < lpEnd && *lpCur == '.')
+    {
+        bDouble = true;
+        if (++lpCur >= lpEnd || uint8_t(*lpCur - '0') > 9)
+        {
+            return nullptr;
+        }
+
+        auto lpFraction = lpCur;
+        if (uMantissa == 0)
+        {
+            while (lpCur < lpEnd && *lpCur == '0')
+            {
+                lpCur++;
+            }
+        }
+
+        int64_t iDropped = 0;
+        lpCur = ParseDigits(lpCur, lpEnd, uMantissa, uDigits, iDropped, bTruncated);
+        iExp10 -= (lpCur - lpFraction) - iDropped;
+    }
+
+    auto lpMantissaEnd = lpCur;
+    int64_t iExplicitExp = 0;
+    if (lpCur < lpEnd && (*lpCur | 0x20) == 'e')
+    {
+        bDouble = true;
+        bool bNegativeExp = false;
+        if (++lpCur < lpEnd && (*lpCur == '+' || *lpCur == '-'))
+        {
+            bNegativeExp = *lpCur++ == '-';
+        }
+        if (lpCur >= lpEnd || uint8_t(*lpCur - '0') > 9)
+        {
+            return nullptr;
+        }
+
+        // far beyond the double range the exact value no longer matters
+        for (; lpCur < lpEnd && uint8_t(*lpCur - '0') <= 9; lpCur++)
+        {
+            if (iExplicitExp < MaxExponent)
+            {
+                iExplicitExp = iExplicitExp * 10 + (*lpCur - '0');
+            }
+        }
+        iExplicitExp = bNegativeExp ? -iExplicitExp : iExplicitExp;
+    }
+
+    // at most MaxMantissaDigits digits and nothing dropped always fits 64 bits
+    uint64_t uLimit = bNegative ? uint64_t(INT64_MAX) + 1 : uint64_t(INT64_MAX);
+    if (!bDouble && iExp10 == 0 && uMantissa <= uLimit)
+    {
+        stNumber.bDouble = false;
+        stNumber.nValue = bNegative ? int64_t(0 - uMantissa) : int64_t(uMantissa);
+        return lpCur;
+    }
+
+    stNumber.bDouble = true;
+    iExp10 += iExplicitExp;
+
+    // Clinger: both operands and so the one rounding are exact
+    if (!bTruncated && uMantissa <= (1ULL << (DoubleMantissaBits + 1)) && iExp10 >= -22 && iExp10 <= 22)
+    {
+        auto dValue = double(uMantissa);
+        dValue = iExp10 < 0 ? dValue / g_szExactPow10[-iExp10] : dValue * g_szExactPow10[iExp10];
+        stNumber.dValue = bNegative ? -dValue : dValue;
+        return lpCur;
+    }
+
+    // a truncated mantissa is decided when its two bounds round alike
+    auto iBits = ComputeDouble(uMantissa, iExp10);
+    if (bTruncated && iBits >= 0 && iBits != ComputeDouble(uMantissa + 1, iExp10))
+    {
+        iBits = -1;
+    }
+
+    if (unlikely(iBits < 0))
+    {
+        stNumber.dValue = ParseDoubleSlow(lpBegin, lpMantissaEnd, iExplicitExp);
+        return lpCur;
+    }
+
+    auto uBits = uint64_t(iBits) | (uint64_t(bNegative) << 63);
+    memcpy(&stNumber.dValue, &uBits, sizeof(uBits));
+    return lpCur;
+}
+
+}
@@ -0,0 +1,41 @@
+#ifndef __JSON_NUMBER_H_
+#define __JSON_NUMBER_H_
+
+#include <os_common.h>
+
+namespace cppbase
+{
+
+// longest output of the formatters below, without a terminating NUL
+constexpr uint32_t MaxIntegerChars = 20;
+constexpr uint32_t MaxDoubleChars = 25;
+
+// Writes the decimal form of the value and returns the end of the output.
+char *FormatUInt64(uint64_t uValue, char *lpOut);
+char *FormatInt64(int64_t nValue, char *lpOut);
+
+// Writes the shortest decimal string that parses back to the same finite
+// double (Ryu), always with a '.' or an exponent so it reads back as a
+// double. Returns the end of the output.
+char *FormatDouble(double dValue, char *lpOut);
+
+struct JsonNumber
+{
+    bool bDouble;
+    union
+    {
+        int64_t nValue;
+        double dValue;
+    };
+};
+
+// Parses the json number at lpBegin, reading no further than lpEnd, and
+// returns the end of the number, or nullptr when it breaks the json
+// grammar. Integers outside of int64_t come back as doubles. Doubles are
+// correctly rounded; the input needs no terminator and is never copied to
+// the heap, and the current locale is not consulted.
+const char *ParseNumber(const char *lpBegin, const char *lpEnd, JsonNumber &stNumber);
+
+}
+
+#endif //__JSON_NUMBER_H_
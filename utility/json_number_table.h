@@ -0,0 +1,27 @@
+#ifndef __JSON_NUMBER_TABLE_H_
+#define __JSON_NUMBER_TABLE_H_
+
+#include <stdint.h>
+
+namespace cppbase
+{
+
+// power-of-five tables of the Ryu shortest double formatter
+constexpr int32_t DoublePow5BitCount = 125;
+constexpr int32_t DoublePow5InvBitCount = 125;
+constexpr int32_t DoublePow5TableSize = 326;
+constexpr int32_t DoublePow5InvTableSize = 342;
+
+extern const uint64_t g_szDoublePow5Split[DoublePow5TableSize][2];
+extern const uint64_t g_szDoublePow5InvSplit[DoublePow5InvTableSize][2];
+
+// power-of-five table of the Eisel-Lemire decimal to double parser
+constexpr int32_t DecimalPow5MinExp = -342;
+constexpr int32_t DecimalPow5MaxExp = 308;
+constexpr int32_t DecimalPow5TableSize = DecimalPow5MaxExp - DecimalPow5MinExp + 1;
+
+extern const uint64_t g_szDecimalPow5[DecimalPow5TableSize][2];
+
+}
+
+#endif //__JSON_NUMBER_TABLE_H_
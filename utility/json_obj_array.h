@@ -0,0 +1,125 @@
+#ifndef __JSON_OBJ_ARRAY_H_
+#define __JSON_OBJ_ARRAY_H_
+
+#include <os_common.h>
+#include "json_arena.h"
+#include <new>
+#include <type_traits>
+
+namespace cppbase
+{
+
+/*
+ * Elements of a json array in one block. Unlike std::vector the members
+ * are laid out by this class, so that CJsonView can read them from outside
+ * the library: the block, then the size and the capacity in elements.
+ *
+ * V must be trivially copyable, since the block is carved again out of the
+ * arena, or grown with realloc without one, when it is full. Elements do
+ * not keep their address across an append.
+ */
+template <typename V>
+class CJsonObjArray
+{
+    friend struct JsonNodeLayoutCheck;
+
+public:
+    static constexpr uint32_t MinCapacity = 4;
+
+    using iterator = V *;
+
+    explicit CJsonObjArray(CJsonArena *lpArena) : m_lpArena(lpArena) {}
+
+    // the elements are raw storage whose owner releases what they refer to
+    ~CJsonObjArray()
+    {
+        if (m_lpArena == nullptr)
+        {
+            free(m_lpItems);
+        }
+    }
+
+    CJsonObjArray(const CJsonObjArray &) = delete;
+    CJsonObjArray &operator=(const CJsonObjArray &) = delete;
+
+    inline iterator begin() const { return m_lpItems; }
+    inline iterator end() const { return m_lpItems + m_uSize; }
+    inline uint32_t size() const { return m_uSize; }
+    inline V &operator[](uint32_t uIndex) const { return m_lpItems[uIndex]; }
+    inline V &back() const { return m_lpItems[m_uSize - 1]; }
+
+    inline void clear() { m_uSize = 0; }
+    inline void pop_back() { m_uSize--; }
+
+    // throws std::bad_alloc, as do the appends
+    void reserve(uint64_t uCapacity)
+    {
+        if (uCapacity > m_uCapacity)
+        {
+            Resize(uCapacity);
+        }
+    }
+
+    // appends a default-constructed element
+    void emplace_back()
+    {
+        if (unlikely(m_uSize == m_uCapacity))
+        {
+            Resize(m_uCapacity < MinCapacity ? MinCapacity : uint64_t(m_uCapacity) * 2);
+        }
+        new(m_lpItems + m_uSize) V();
+        m_uSize++;
+    }
+
+    void append(const V *lpBegin, const V *lpEnd)
+    {
+        auto uCount = uint64_t(lpEnd - lpBegin);
+        reserve(m_uSize + uCount);
+        memcpy(static_cast<void *>(m_lpItems + m_uSize), lpBegin, uCount * sizeof(V));
+        m_uSize += uint32_t(uCount);
+    }
+
+private:
+    void Resize(uint64_t uCapacity)
+    {
+        static_assert(std::is_trivially_copyable<V>::value, "elements are moved with memcpy");
+        static_assert(alignof(V) <= 8, "arena memory is 8-byte aligned");
+
+        if (unlikely(uCapacity > UINT32_MAX))
+        {
+            throw std::bad_alloc();
+        }
+
+        V *lpItems = nullptr;
+        if (m_lpArena != nullptr)
+        {
+            lpItems = reinterpret_cast<V *>(m_lpArena->Alloc(uCapacity * sizeof(V)));
+            if (likely(lpItems != nullptr) && m_uSize > 0)
+            {
+                memcpy(static_cast<void *>(lpItems), m_lpItems, uint64_t(m_uSize) * sizeof(V));
+            }
+        }
+        else
+        {
+            lpItems = reinterpret_cast<V *>(realloc(m_lpItems, uCapacity * sizeof(V)));
+        }
+
+        if (unlikely(lpItems == nullptr))
+        {
+            throw std::bad_alloc();
+        }
+
+        m_lpItems = lpItems;
+        m_uCapacity = uint32_t(uCapacity);
+    }
+
+private:
+    CJsonArena *m_lpArena;
+    V *m_lpItems{nullptr};
+    uint32_t m_uSize{0};
+    uint32_t m_uCapacity{0};
+};
+
+}
+
+#endif //__JSON_OBJ_ARRAY_H_
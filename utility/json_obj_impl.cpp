@@ -1,7 +1,19 @@
 #include "json_obj_impl.h"
+#include "json_scanner.h"
+#include "json_number.h"
+#include "json_string.h"
+#include "json_writer.h"
+#include "json_file.h"
+#include "json_binary.h"
+#include "json_snapshot.h"
+#include "json_tape.h"
+#include "json_lazy.h"
 #include <error_no.h>
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+#include <typeinfo>
 
-#define __JSON_DEBUG__
 #ifndef __JSON_DEBUG__
 #define RETURN(iErrorNo) \
     do                   \
@@ -17,75 +29,154 @@
     } while (0)
 #endif
 
-    namespace cppbase
+namespace cppbase
 {
 
-CJsonObjImpl::CJsonObjImpl()
+CJsonObjImpl::CJsonObjImpl(CJsonArena *lpArena) : m_lpArena(lpArena)
 {
 }
 
-CJsonObjImpl::CJsonObjImpl(ObjType eType, const void *lpValue)
+CJsonObjImpl::~CJsonObjImpl()
+{
+    // arena nodes own nothing outside the arena, which is released as a whole
+    if (m_lpArena != nullptr)
+    {
+        return;
+    }
+
+    delete m_lpWriter;
+
+    switch (m_eType != ObjType::Unknow ? m_eType : m_eKept)
+    {
+        case ObjType::Array:
+            for (auto &item : m_unValue.arrValue)
+            {
+                FreeValue(item);
+            }
+            m_unValue.arrValue.~ArrayValueType();
+            break;
+        
+        case ObjType::Object:
+            for (auto &item : m_unValue.objValue)
+            {
+                FreeValue(item.second);
+                FreeString(item.first);
+            }
+            m_unValue.objValue.~ObjValueType();
+            break;
+
+        default:
+            break;
+    }
+}
+
+void CJsonObjImpl::InitValue(ObjType eType)
+{
+    switch (eType)
+    {
+        case ObjType::Array:
+            new(&m_unValue) ArrayValueType(m_lpArena);
+            break;
+
+        case ObjType::Object:
+            new(&m_unValue) ObjValueType(m_lpArena);
+            break;
+
+        default:
+            throw std::runtime_error("invalid type");
+    }
+
+    m_eType = eType;
+}
+
+CJsonObjImpl *CJsonObjImpl::NewNode(ObjType eType)
+{
+    CJsonObjImpl *lpObj = nullptr;
+    if (m_lpArena != nullptr)
+    {
+        auto lpMem = m_lpArena->Alloc(sizeof(CJsonObjImpl));
+        lpObj = lpMem != nullptr ? new(lpMem) CJsonObjImpl(m_lpArena) : nullptr;
+    }
+    else
+    {
+        lpObj = NEW CJsonObjImpl();
+    }
+
+    if (unlikely(lpObj == nullptr))
+    {
+        throw std::bad_alloc();
+    }
+
+    lpObj->m_bChild = true;
+    lpObj->InitValue(eType);
+    return lpObj;
+}
+
+void CJsonObjImpl::SetValue(_ValueType &stValue, ObjType eType, const void *lpValue)
 {
+    // stValue is only written once nothing can throw any more
     switch (eType)
     {
         case ObjType::Null:
             break;
 
         case ObjType::Boolean:
-            m_unValue.bValue = *reinterpret_cast<const bool *>(lpValue);
+            stValue.Store(*reinterpret_cast<const bool *>(lpValue));
             break;
 
         case ObjType::Integer:
-            m_unValue.nValue = *reinterpret_cast<const int64_t *>(lpValue);
+            stValue.Store(*reinterpret_cast<const int64_t *>(lpValue));
             break;
 
         case ObjType::Double:
-            m_unValue.dValue = *reinterpret_cast<const double *>(lpValue);
+            stValue.Store(*reinterpret_cast<const double *>(lpValue));
             break;
 
         case ObjType::String:
-            new(&m_unValue) StringValueType(reinterpret_cast<const char *>(lpValue));
-            break;
+        {
+            // in-situ strings keep referring to the parsed buffer
+            auto lpStr = reinterpret_cast<const StrRef *>(lpValue);
+            if (lpStr->uLen <= _ValueType::ShortStrLen && !lpStr->bInSitu)
+            {
+                memcpy(stValue.szData, lpStr->lpStr, lpStr->uLen);
+                stValue.szData[lpStr->uLen] = '\0';
+                stValue.szData[_ValueType::ShortStrLen] = char(_ValueType::ShortStrLen - lpStr->uLen);
+                stValue.uTag = uint8_t(eType) | _ValueType::ShortStr;
+                return;
+            }
 
-        case ObjType::Array:
-            new(&m_unValue) ArrayValueType;
-            break;
+            stValue.Store(lpStr->bInSitu ? lpStr->lpStr : CopyString(lpStr->lpStr, lpStr->uLen));
+            stValue.Store(lpStr->uLen, 8);
+            stValue.uTag = uint8_t(eType) | (lpStr->bInSitu ? _ValueType::InSitu : 0);
+            return;
+        }
 
+        case ObjType::Array:
         case ObjType::Object:
-            new(&m_unValue) ObjValueType;
+            stValue.Store(NewNode(eType));
             break;
 
         default:
             throw std::runtime_error("invalid type");
     }
 
-    m_eType = eType;
+    stValue.uTag = uint8_t(eType);
 }
 
-CJsonObjImpl::~CJsonObjImpl()
+void CJsonObjImpl::FreeValue(const _ValueType &stValue)
 {
-    switch (m_eType)
+    switch (stValue.GetType())
     {
         case ObjType::String:
-            m_unValue.strValue.~basic_string();
-            break;
-
-        case ObjType::Array:
-            for (auto &item : m_unValue.arrValue)
+            if ((stValue.uTag & (_ValueType::ShortStr | _ValueType::InSitu)) == 0)
             {
-                auto lpObj = reinterpret_cast<CJsonObjImpl *>(&item);
-                lpObj->~CJsonObjImpl();
+                free(const_cast<char *>(stValue.GetStr()));
             }
-            m_unValue.arrValue.~vector();
             break;
-        
+
+        case ObjType::Array:
         case ObjType::Object:
-            for (auto &item : m_unValue.objValue)
-            {
-                auto lpObj = reinterpret_cast<CJsonObjImpl *>(&item.second);
-                lpObj->~CJsonObjImpl();
-            }
-            m_unValue.objValue.~unordered_map();
+            delete stValue.GetObj();
             break;
 
         default:
@@ -93,6 +184,35 @@ CJsonObjImpl::~CJsonObjImpl()
     }
 }
 
+const char *CJsonObjImpl::CopyString(const char *lpStr, uint32_t uLen)
+{
+    char *lpCopy = nullptr;
+    if (m_lpArena != nullptr)
+    {
+        lpCopy = m_lpArena->StrDup(lpStr, uLen);
+    }
+    else if ((lpCopy = reinterpret_cast<char *>(malloc(uLen + 1))) != nullptr)
+    {
+        memcpy(lpCopy, lpStr, uLen);
+        lpCopy[uLen] = '\0';
+    }
+
+    if (unlikely(lpCopy == nullptr))
+    {
+        throw std::bad_alloc();
+    }
+
+    return lpCopy;
+}
+
+void CJsonObjImpl::FreeString(const StrRef &stStr)
+{
+    if (m_lpArena == nullptr && !stStr.bInSitu)
+    {
+        free(const_cast<char *>(stStr.lpStr));
+    }
+}
+
 int32_t CJsonObjImpl::Init(ObjType eType)
 {
     if (m_eType != ObjType::Unknow)
@@ -100,42 +220,142 @@ int32_t CJsonObjImpl::Init(ObjType eType)
         RETURN(InvaliadCall);
     }
 
-    switch (eType)
+    if (eType != ObjType::Array && eType != ObjType::Object)
+    {
+        RETURN(InvaliadParam);
+    }
+
+    // a cleared document takes its container back when the type matches
+    if (m_eKept == eType)
+    {
+        m_eType = eType;
+        m_eKept = ObjType::Unknow;
+        return 0;
+    }
+    else if (m_eKept == ObjType::Array)
+    {
+        m_unValue.arrValue.~ArrayValueType();
+    }
+    else if (m_eKept == ObjType::Object)
+    {
+        m_unValue.objValue.~ObjValueType();
+    }
+
+    m_eKept = ObjType::Unknow;
+    InitValue(eType);
+    return 0;
+}
+
+int32_t CJsonObjImpl::Clear()
+{
+    // the root of an arena document empties the arena around itself, and
+    // the cleanups take the writers with them
+    if (m_lpArena != nullptr && m_lpArena->GetFirst() == this)
+    {
+        m_lpArena->Reset(true);
+        m_lpWriter = nullptr;
+        m_eType = ObjType::Unknow;
+        m_eKept = ObjType::Unknow;
+        return 0;
+    }
+
+    // what an arena node holds stays in the arena until it is reset
+    switch (m_eType)
     {
         case ObjType::Array:
-            new(&m_unValue) ArrayValueType;
+            if (m_lpArena == nullptr)
+            {
+                for (auto &item : m_unValue.arrValue)
+                {
+                    FreeValue(item);
+                }
+            }
+            m_unValue.arrValue.clear();
             break;
-        
+
         case ObjType::Object:
-            new(&m_unValue) ObjValueType;
+            if (m_lpArena == nullptr)
+            {
+                for (auto &item : m_unValue.objValue)
+                {
+                    FreeValue(item.second);
+                    FreeString(item.first);
+                }
+            }
+            m_unValue.objValue.clear();
             break;
 
         default:
-            RETURN(InvaliadParam);
+            return 0;
+    }
+
+    // a node stays what its parent has it as
+    if (!m_bChild)
+    {
+        m_eKept = m_eType;
+        m_eType = ObjType::Unknow;
     }
 
-    m_eType = eType;
     return 0;
 }
 
-IJsonObj *CJsonObjImpl::AddValue(const char *lpKey, ObjType eType, const void *lpValue)
+CJsonObjImpl::_ValueType *CJsonObjImpl::AddValue(const char *lpKey, ObjType eType, const void *lpValue)
+{
+    if (lpKey == nullptr)
+    {
+        return AddValue(static_cast<const StrRef *>(nullptr), eType, lpValue);
+    }
+
+    auto stKey = MakeStrRef(lpKey);
+    return AddValue(&stKey, eType, lpValue);
+}
+
+CJsonObjImpl::_ValueType *CJsonObjImpl::AddValue(const StrRef *lpKey, ObjType eType, const void *lpValue)
 {
     try
     {
         if (m_eType == ObjType::Object && lpKey != nullptr)
         {
-            auto pair = m_unValue.objValue.emplace(lpKey, _ValueType());
+            auto pair = m_unValue.objValue.emplace(*lpKey, HashTag(Key::Hash(lpKey->lpStr, lpKey->uLen)));
             if (unlikely(!pair.second))
             {
                 return nullptr;
             }
 
-            return new(&pair.first->second) CJsonObjImpl(eType, lpValue);
+            // the map holds the caller's key until the copy is in place
+            auto &stKey = pair.first->first;
+            try
+            {
+                if (!lpKey->bInSitu)
+                {
+                    stKey.lpStr = CopyString(lpKey->lpStr, lpKey->uLen);
+                }
+                SetValue(pair.first->second, eType, lpValue);
+                return &pair.first->second;
+            }
+            catch (...)
+            {
+                if (stKey.lpStr != lpKey->lpStr)
+                {
+                    FreeString(stKey);
+                }
+                m_unValue.objValue.pop_back();
+                throw;
+            }
         }
         else if (m_eType == ObjType::Array && lpKey == nullptr)
         {
-            m_unValue.arrValue.push_back(_ValueType());
-            return new(&m_unValue.arrValue.back()) CJsonObjImpl(eType, lpValue);
+            m_unValue.arrValue.emplace_back();
+            try
+            {
+                SetValue(m_unValue.arrValue.back(), eType, lpValue);
+                return &m_unValue.arrValue.back();
+            }
+            catch (...)
+            {
+                m_unValue.arrValue.pop_back();
+                throw;
+            }
         }
         else
         {
@@ -191,7 +411,13 @@ int32_t CJsonObjImpl::AddDouble(const char *lpKey, double dValue)
 
 int32_t CJsonObjImpl::AddString(const char *lpKey, const char *lpValue)
 {
-    if (likely(AddValue(lpKey, ObjType::String, lpValue) != nullptr))
+    if (unlikely(lpValue == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    auto stValue = MakeStrRef(lpValue);
+    if (likely(AddValue(lpKey, ObjType::String, &stValue) != nullptr))
     {
         return 0;
     }
@@ -201,171 +427,147 @@ int32_t CJsonObjImpl::AddString(const char *lpKey, const char *lpValue)
 
 IJsonObj *CJsonObjImpl::AddArray(const char *lpKey)
 {
-    return AddValue(lpKey, ObjType::Array);
+    auto lpValue = AddValue(lpKey, ObjType::Array);
+    return lpValue != nullptr ? lpValue->GetObj() : nullptr;
 }
 
 IJsonObj *CJsonObjImpl::AddObject(const char *lpKey)
 {
-    return AddValue(lpKey, ObjType::Object);
+    auto lpValue = AddValue(lpKey, ObjType::Object);
+    return lpValue != nullptr ? lpValue->GetObj() : nullptr;
 }
 
-bool CJsonObjImpl::GetNull(const char *lpKey)
+CJsonObjImpl::_ValueType *CJsonObjImpl::FindValue(const Key &stKey)
 {
-    if (unlikely(lpKey == nullptr || m_eType != ObjType::Object))
+    if (unlikely(stKey.lpKey == nullptr || m_eType != ObjType::Object))
     {
-        return false;
+        return nullptr;
     }
 
-    auto iter = m_unValue.objValue.find(lpKey);
-    if (likely(iter == m_unValue.objValue.end()))
+    auto iter = m_unValue.objValue.find(MakeStrRef(stKey), HashTag(stKey.uHash));
+    if (unlikely(iter == m_unValue.objValue.end()))
     {
-        return false;
+        return nullptr;
     }
 
-    auto lpJsonObj = reinterpret_cast<CJsonObjImpl *>(&iter->second);
-    return lpJsonObj->m_eType == ObjType::Null;
+    return &iter->second;
 }
 
-bool CJsonObjImpl::GetBool(const char *lpKey, bool bDefaultValue)
+bool CJsonObjImpl::GetNull(const char *lpKey)
 {
-    if (unlikely(lpKey == nullptr || m_eType != ObjType::Object))
-    {
-        return bDefaultValue;
-    }
-
-    auto iter = m_unValue.objValue.find(lpKey);
-    if (likely(iter == m_unValue.objValue.end()))
-    {
-        return bDefaultValue;
-    }
+    return CJsonObjImpl::GetNull(Key(lpKey));
+}
 
-    auto lpJsonObj = reinterpret_cast<CJsonObjImpl *>(&iter->second);
-    if (likely(lpJsonObj->m_eType == ObjType::Boolean))
-    {
-        return lpJsonObj->m_unValue.bValue;
-    }
-    
-    return bDefaultValue;
+bool CJsonObjImpl::GetBool(const char *lpKey, bool bDefaultValue)
+{
+    return CJsonObjImpl::GetBool(Key(lpKey), bDefaultValue);
 }
 
 int64_t CJsonObjImpl::GetInt(const char *lpKey, int64_t nDefaultValue)
 {
-    if (unlikely(lpKey == nullptr || m_eType != ObjType::Object))
-    {
-        return nDefaultValue;
-    }
+    return CJsonObjImpl::GetInt(Key(lpKey), nDefaultValue);
+}
 
-    auto iter = m_unValue.objValue.find(lpKey);
-    if (likely(iter == m_unValue.objValue.end()))
-    {
-        return nDefaultValue;
-    }
+double CJsonObjImpl::GetDouble(const char *lpKey, double dDefaultValue)
+{
+    return CJsonObjImpl::GetDouble(Key(lpKey), dDefaultValue);
+}
 
-    auto lpJsonObj = reinterpret_cast<CJsonObjImpl *>(&iter->second);
-    if (likely(lpJsonObj->m_eType == ObjType::Integer))
-    {
-        return lpJsonObj->m_unValue.nValue;
-    }
-    
-    return nDefaultValue;
+const char *CJsonObjImpl::GetString(const char *lpKey, const char *lpDefaultValue)
+{
+    return CJsonObjImpl::GetString(Key(lpKey), lpDefaultValue);
 }
 
-double CJsonObjImpl::GetDouble(const char *lpKey, double dDefaultValue)
+IJsonObj *CJsonObjImpl::GetArray(const char *lpKey)
 {
-    if (unlikely(lpKey == nullptr || m_eType != ObjType::Object))
-    {
-        return dDefaultValue;
-    }
+    return CJsonObjImpl::GetArray(Key(lpKey));
+}
 
-    auto iter = m_unValue.objValue.find(lpKey);
-    if (likely(iter == m_unValue.objValue.end()))
-    {
-        return dDefaultValue;
-    }
+IJsonObj *CJsonObjImpl::GetObject(const char *lpKey)
+{
+    return CJsonObjImpl::GetObject(Key(lpKey));
+}
 
-    auto lpJsonObj = reinterpret_cast<CJsonObjImpl *>(&iter->second);
-    if (likely(lpJsonObj->m_eType == ObjType::Double))
-    {
-        return lpJsonObj->m_unValue.dValue;
-    }
-    
-    return dDefaultValue;
+bool CJsonObjImpl::IsExist(const char *lpKey)
+{
+    return CJsonObjImpl::IsExist(Key(lpKey));
 }
 
-const char *CJsonObjImpl::GetString(const char *lpKey, const char *lpDefaultValue)
+bool CJsonObjImpl::GetNull(const Key &stKey)
 {
-    if (unlikely(lpKey == nullptr || m_eType != ObjType::Object))
-    {
-        return lpDefaultValue;
-    }
+    auto lpValue = FindValue(stKey);
+    return lpValue != nullptr && lpValue->GetType() == ObjType::Null;
+}
 
-    auto iter = m_unValue.objValue.find(lpKey);
-    if (likely(iter == m_unValue.objValue.end()))
+bool CJsonObjImpl::GetBool(const Key &stKey, bool bDefaultValue)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && lpValue->GetType() == ObjType::Boolean))
     {
-        return lpDefaultValue;
+        return lpValue->Load<bool>();
     }
 
-    auto lpJsonObj = reinterpret_cast<CJsonObjImpl *>(&iter->second);
-    if (likely(lpJsonObj->m_eType == ObjType::String))
-    {
-        return lpJsonObj->m_unValue.strValue.c_str();
-    }
-    
-    return lpDefaultValue;
+    return bDefaultValue;
 }
 
-IJsonObj *CJsonObjImpl::GetArray(const char *lpKey)
+int64_t CJsonObjImpl::GetInt(const Key &stKey, int64_t nDefaultValue)
 {
-    if (unlikely(lpKey == nullptr || m_eType != ObjType::Object))
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && lpValue->GetType() == ObjType::Integer))
     {
-        return nullptr;
+        return lpValue->Load<int64_t>();
     }
 
-    auto iter = m_unValue.objValue.find(lpKey);
-    if (likely(iter == m_unValue.objValue.end()))
-    {
-        return nullptr;
-    }
+    return nDefaultValue;
+}
 
-    auto lpJsonObj = reinterpret_cast<CJsonObjImpl *>(&iter->second);
-    if (likely(lpJsonObj->m_eType == ObjType::Array))
+double CJsonObjImpl::GetDouble(const Key &stKey, double dDefaultValue)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && lpValue->GetType() == ObjType::Double))
     {
-        return reinterpret_cast<CJsonObjImpl *>(&lpJsonObj->m_unValue.objValue);
+        return lpValue->Load<double>();
     }
-    
-    return nullptr;
+
+    return dDefaultValue;
 }
 
-IJsonObj *CJsonObjImpl::GetObject(const char *lpKey)
+const char *CJsonObjImpl::GetString(const Key &stKey, const char *lpDefaultValue)
 {
-    if (unlikely(lpKey == nullptr || m_eType != ObjType::Object))
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && lpValue->GetType() == ObjType::String))
     {
-        return nullptr;
+        return lpValue->GetStr();
     }
 
-    auto iter = m_unValue.objValue.find(lpKey);
-    if (likely(iter == m_unValue.objValue.end()))
-    {
-        return nullptr;
-    }
+    return lpDefaultValue;
+}
 
-    auto lpJsonObj = reinterpret_cast<CJsonObjImpl *>(&iter->second);
-    if (likely(lpJsonObj->m_eType == ObjType::Object))
+IJsonObj *CJsonObjImpl::GetArray(const Key &stKey)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && lpValue->GetType() == ObjType::Array))
     {
-        return reinterpret_cast<CJsonObjImpl *>(&lpJsonObj->m_unValue.objValue);
+        return lpValue->GetObj();
     }
-    
+
     return nullptr;
 }
 
-bool CJsonObjImpl::IsExist(const char *lpKey)
+IJsonObj *CJsonObjImpl::GetObject(const Key &stKey)
 {
-    if (unlikely(lpKey == nullptr || m_eType != ObjType::Object))
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && lpValue->GetType() == ObjType::Object))
     {
-        return false;
+        return lpValue->GetObj();
     }
 
-    return m_unValue.objValue.count(lpKey) == 1;
+    return nullptr;
+}
+
+bool CJsonObjImpl::IsExist(const Key &stKey)
+{
+    return FindValue(stKey) != nullptr;
 }
 
 IJsonObj::ObjType CJsonObjImpl::GetType()
@@ -395,449 +597,695 @@ uint32_t CJsonObjImpl::GetSize()
 
 IJsonObj::ObjType CJsonObjImpl::GetType(const char *lpKey)
 {
-    if (unlikely(lpKey == nullptr || m_eType != ObjType::Object))
+    return CJsonObjImpl::GetType(Key(lpKey));
+}
+
+IJsonObj::ObjType CJsonObjImpl::GetType(const Key &stKey)
+{
+    auto lpValue = FindValue(stKey);
+    return lpValue != nullptr ? lpValue->GetType() : ObjType::Unknow;
+}
+
+IJsonObj::ObjType CJsonObjImpl::GetType(uint32_t uIndex)
+{
+    const char *lpKey = nullptr;
+    auto lpValue = GetMember(uIndex, lpKey);
+    return lpValue != nullptr ? lpValue->GetType() : ObjType::Unknow;
+}
+
+CJsonObjImpl::_ValueType *CJsonObjImpl::GetMember(uint32_t uIndex, const char *&lpKey)
+{
+    if (m_eType == ObjType::Array && uIndex < m_unValue.arrValue.size())
     {
-        return ObjType::Unknow;
+        lpKey = nullptr;
+        return &m_unValue.arrValue[uIndex];
     }
 
-    auto iter = m_unValue.objValue.find(lpKey);
-    if (likely(iter == m_unValue.objValue.end()))
+    if (m_eType == ObjType::Object && uIndex < m_unValue.objValue.size())
     {
-        return ObjType::Unknow;
+        auto &item = m_unValue.objValue[uIndex];
+        lpKey = item.first.lpStr;
+        return &item.second;
     }
 
-    auto lpJsonObj = reinterpret_cast<CJsonObjImpl *>(&iter->second);
-    return lpJsonObj->m_eType;
+    return nullptr;
 }
 
-IJsonObj::ObjType CJsonObjImpl::GetType(uint32_t uIndex)
+int32_t CJsonObjImpl::FillKvItem(const char *lpKey, const _ValueType &stValue, KvItem *lpKvItem)
 {
-    uint32_t begin = 0;
-    switch (m_eType)
+    lpKvItem->eType = stValue.GetType();
+    lpKvItem->lpKey = lpKey;
+    switch (lpKvItem->eType)
     {
-        case ObjType::Array:
-            if (likely(uIndex < m_unValue.arrValue.size()))
-            {
-                return reinterpret_cast<CJsonObjImpl *>(&m_unValue.arrValue[uIndex])->m_eType;
-            }
+        case ObjType::Null:
+            lpKvItem->IsNull = true;
             break;
 
-        case ObjType::Object:
-            if (uIndex < m_unValue.objValue.size())
-            {
-                for (auto &item : m_unValue.objValue)
-                {
-                    if (begin == uIndex)
-                    {
-                        return reinterpret_cast<CJsonObjImpl *>(&item.second)->m_eType;
-                    }
-                    begin++;
-                }
-            }
+        case ObjType::Boolean:
+            lpKvItem->bValue = stValue.Load<bool>();
             break;
 
-        case ObjType::Boolean:
         case ObjType::Integer:
-        case ObjType::String:
-        default:
+            lpKvItem->nValue = stValue.Load<int64_t>();
             break;
+
+        case ObjType::Double:
+            lpKvItem->dValue = stValue.Load<double>();
+            break;
+
+        case ObjType::String:
+            lpKvItem->strValue = stValue.GetStr();
+            break;
+
+        case ObjType::Array:
+        case ObjType::Object:
+            lpKvItem->lpArray = stValue.GetObj();
+            break;
+
+        default:
+            RETURN(InvaliadCall);
     }
 
-    return ObjType::Unknow;
+    return 0;
 }
 
 int32_t CJsonObjImpl::GetItem(uint32_t uIndex, KvItem *lpKvItem)
 {
-    if (unlikely(m_eType != ObjType::Object || uIndex >= m_unValue.objValue.size()))
+    if (unlikely(lpKvItem == nullptr))
     {
         RETURN(InvaliadParam);
     }
 
-    uint32_t begin = 0;
-    for (auto &item : m_unValue.objValue)
+    const char *lpKey = nullptr;
+    auto lpValue = GetMember(uIndex, lpKey);
+    if (unlikely(lpValue == nullptr))
     {
-        if (begin == uIndex)
-        {
-            auto lpObj = reinterpret_cast<CJsonObjImpl *>(&item.second);
-            lpKvItem->eType = lpObj->m_eType;
-            lpKvItem->lpKey = item.first.c_str();
-            switch (lpObj->m_eType)
-            {
-                case ObjType::Null:
-                    lpKvItem->IsNull = true;
-                    break;
-                
-                case ObjType::Boolean:
-                    lpKvItem->bValue = lpObj->m_unValue.bValue;
-                    break;
-
-                case ObjType::Integer:
-                    lpKvItem->nValue = lpObj->m_unValue.nValue;
-                    break;
-
-                case ObjType::String:
-                    lpKvItem->strValue = lpObj->m_unValue.strValue.c_str();
-                    break;
-
-                case ObjType::Array:
-                case ObjType::Object:
-                    lpKvItem->lpArray = lpObj;
-
-                default:
-                    RETURN(InvaliadCall);
-            }
+        RETURN(InvaliadParam);
+    }
 
-            return 0;
-        }
-        begin++;
+    return FillKvItem(lpKey, *lpValue, lpKvItem);
+}
+
+bool CJsonObjImpl::First(Cursor *lpCursor, KvItem *lpKvItem)
+{
+    static_assert(sizeof(CursorState) <= sizeof(Cursor::Reserve), "Cursor too small for CursorState");
+
+    if (unlikely(lpCursor == nullptr || lpKvItem == nullptr))
+    {
+        return false;
     }
 
-    RETURN(InvaliadParam);
+    auto lpState = new(lpCursor->Reserve) CursorState();
+    const char *lpKey = nullptr;
+    auto lpValue = GetMember(lpState->uIndex, lpKey);
+    return lpValue != nullptr && FillKvItem(lpKey, *lpValue, lpKvItem) == 0;
 }
 
-bool CJsonObjImpl::IsNullChar(char ch)
+bool CJsonObjImpl::Next(Cursor *lpCursor, KvItem *lpKvItem)
 {
-    return (ch == ' ' || ch == '\r' || ch == '\n' || ch == '\t');
+    if (unlikely(lpCursor == nullptr || lpKvItem == nullptr))
+    {
+        return false;
+    }
+
+    // the position stops one past the last member
+    auto lpState = reinterpret_cast<CursorState *>(lpCursor->Reserve);
+    lpState->uIndex += lpState->uIndex < GetSize();
+    const char *lpKey = nullptr;
+    auto lpValue = GetMember(lpState->uIndex, lpKey);
+    return lpValue != nullptr && FillKvItem(lpKey, *lpValue, lpKvItem) == 0;
 }
 
 bool CJsonObjImpl::IsNumChar(char ch)
 {
-    return (ch >= '0' && ch <= '9') || ch == '-' || ch == '.';
+    return (ch >= '0' && ch <= '9') || ch == '-';
 }
 
-bool CJsonObjImpl::IsCharZero2Nine(char ch)
+bool CJsonObjImpl::IsDelimiter(const ParseContext &stCtx, uint64_t uPos)
 {
-    return (ch >= '0' && ch <= '9');
+    return uPos >= stCtx.uLen || CJsonScanner::IsDelimiter(stCtx.lpContent[uPos]);
 }
 
-const char  *CJsonObjImpl::ParseString(const char *lpContent, uint64_t &uIndex)
+char CJsonObjImpl::PeekToken(const ParseContext &stCtx, uint32_t uIndex)
 {
-    uIndex++; // '"'
-    char pre = '\0';
-    for (; lpContent[uIndex] != '\0'; uIndex++)
-    {
-        if (lpContent[uIndex] == '"' && pre != '\\')
+    return likely(uIndex < stCtx.uCount) ? stCtx.lpContent[stCtx.lpIndex[uIndex]] : '\0';
+}
+
+void CJsonObjImpl::CountMembers(ParseContext &stCtx)
+{
+    // a container holds one member more than it has commas at its own
+    // level; malformed input only makes the counts wrong, the parse itself
+    // still rejects it
+    uint32_t szOpen[MaxParseDepth];
+    uint32_t uDepth = 0;
+    for (uint32_t i = 0; i < stCtx.uCount; i++)
+    {
+        switch (stCtx.lpContent[stCtx.lpIndex[i]])
         {
-            return &lpContent[uIndex++];
+            case '{':
+            case '[':
+            {
+                if (uDepth == MaxParseDepth)
+                {
+                    return;
+                }
+                auto ch = PeekToken(stCtx, i + 1);
+                szOpen[uDepth++] = uint32_t(stCtx.vecMembers.size());
+                stCtx.vecMembers.push_back(ch == '}' || ch == ']' ? 0 : 1);
+                break;
+            }
+
+            case ',':
+                if (uDepth > 0)
+                {
+                    stCtx.vecMembers[szOpen[uDepth - 1]]++;
+                }
+                break;
+
+            case '}':
+            case ']':
+                uDepth -= uDepth > 0;
+                break;
+
+            default:
+                break;
         }
     }
-
-    return nullptr;
 }
 
-const char *CJsonObjImpl::ParseNumber(const char *lpContent, uint64_t &uIndex, bool &bDouble)
+uint32_t CJsonObjImpl::TakeMemberCount(ParseContext &stCtx, uint32_t uIndex)
 {
-    if (unlikely(lpContent[uIndex] == '.'))
+    // every member takes at least two tokens, which bounds a wrong count
+    if (stCtx.uContainer >= stCtx.vecMembers.size())
     {
-        return nullptr;
+        return 0;
     }
+    auto uCount = stCtx.vecMembers[stCtx.uContainer++];
+    return uCount <= (stCtx.uCount - uIndex) / 2 ? uCount : 0;
+}
 
-    if (lpContent[uIndex] == '-')
+int32_t CJsonObjImpl::ParseString(const ParseContext &stCtx, uint32_t &uIndex, std::string &strBuffer, StrRef &stValue)
+{
+    // the scanner records both quotes of a string
+    if (unlikely(uIndex + 1 >= stCtx.uCount || PeekToken(stCtx, uIndex + 1) != '"'))
     {
-        uIndex++;
+        RETURN(ParseDataFialed);
     }
 
-    bDouble = false;
-    for (; lpContent[uIndex] != '\0'; uIndex++)
+    auto uBegin = stCtx.lpIndex[uIndex] + 1;
+    auto uEnd = stCtx.lpIndex[uIndex + 1];
+    auto lpBegin = stCtx.lpContent + uBegin;
+    auto lpEnd = stCtx.lpContent + uEnd;
+    uIndex += 2;
+
+    // without escapes the value is the input itself: the node copies it,
+    // or, in situ, keeps pointing at it with the closing quote as its NUL
+    auto lpEscape = reinterpret_cast<const char *>(memchr(lpBegin, '\\', lpEnd - lpBegin));
+    char *lpOutEnd = nullptr;
+    if (stCtx.lpInSitu != nullptr)
     {
-        if (lpContent[uIndex] == '.' && IsCharZero2Nine(lpContent[uIndex + 1]))
+        lpOutEnd = lpEscape == nullptr ? stCtx.lpInSitu + uEnd
+                                       : UnescapeString(lpEscape, lpEnd, stCtx.lpInSitu + (lpEscape - stCtx.lpContent));
+        if (unlikely(lpOutEnd == nullptr))
         {
-            bDouble = true;
-            continue;
+            RETURN(ParseDataFialed);
         }
+        *lpOutEnd = '\0';
+        stValue = StrRef{lpBegin, uint32_t(lpOutEnd - lpBegin), true};
+        return 0;
+    }
 
-        if (!IsCharZero2Nine(lpContent[uIndex]))
-        {
-            return &lpContent[uIndex++];
-        }
+    if (likely(lpEscape == nullptr))
+    {
+        stValue = StrRef{lpBegin, uint32_t(lpEnd - lpBegin), false};
+        return 0;
     }
 
-    return nullptr;
+    strBuffer.resize(lpEnd - lpBegin);
+    auto lpOut = &strBuffer[0];
+    memcpy(lpOut, lpBegin, lpEscape - lpBegin);
+    lpOutEnd = UnescapeString(lpEscape, lpEnd, lpOut + (lpEscape - lpBegin));
+    if (unlikely(lpOutEnd == nullptr))
+    {
+        RETURN(ParseDataFialed);
+    }
+
+    stValue = StrRef{lpOut, uint32_t(lpOutEnd - lpOut), false};
+    return 0;
 }
 
-int32_t CJsonObjImpl::ParseKeyValue(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj)
+int32_t CJsonObjImpl::MakeProjection(const char *const *lpPaths, uint32_t uPathCount, std::vector<ProjectField> &vecFields)
 {
-    try
+    vecFields.assign(1, ProjectField{std::string(), AllFields, 0, false});
+    for (uint32_t i = 0; i < uPathCount; i++)
     {
-        // "xxx": xxxx ,
+        // "" is the whole document, "/" the member with an empty key
+        auto lpPath = lpPaths[i];
+        if (unlikely(lpPath == nullptr || (*lpPath != '\0' && *lpPath != '/')))
+        {
+            RETURN(InvaliadParam);
+        }
 
-        // parse key
-        auto lpKeyBeing = &lpContent[uIndex + 1];
-        auto lpKeyEnd = ParseString(lpContent, uIndex);
-        if (lpKeyEnd == nullptr)
+        uint32_t uField = 0;
+        while (*lpPath == '/')
         {
-            RETURN(ParseDataFialed);
+            std::string strKey;
+            for (lpPath++; *lpPath != '\0' && *lpPath != '/'; lpPath++)
+            {
+                if (*lpPath != '~')
+                {
+                    strKey += *lpPath;
+                    continue;
+                }
+                if (*++lpPath != '0' && *lpPath != '1')
+                {
+                    RETURN(InvaliadParam);
+                }
+                strKey += *lpPath == '0' ? '~' : '/';
+            }
+
+            uint32_t uChild = uField + 1;
+            while (uChild < vecFields.size()
+                   && (vecFields[uChild].uParent != uField || vecFields[uChild].strKey != strKey))
+            {
+                uChild++;
+            }
+            if (uChild == vecFields.size())
+            {
+                vecFields.push_back(ProjectField{std::move(strKey), uField, 0, false});
+                vecFields[uField].uChildren++;
+            }
+            uField = uChild;
         }
-        std::string strKey(lpKeyBeing, lpKeyEnd);
+        vecFields[uField].bWhole = true;
+    }
+
+    return 0;
+}
 
-        while (IsNullChar(lpContent[uIndex++]));
-        if (lpContent[uIndex] != ':')
+bool CJsonObjImpl::IsProjected(ParseContext &stCtx, const StrRef &stKey, uint32_t uIndex)
+{
+    // moves stCtx.uField to the member's entry: a value taken whole is
+    // parsed as usual, a container on the way is projected further and a
+    // scalar on the way has nothing to keep
+    auto &vecFields = *stCtx.lpFields;
+    for (auto i = stCtx.uField + 1; i < vecFields.size(); i++)
+    {
+        auto &stField = vecFields[i];
+        if (stField.uParent != stCtx.uField || stField.strKey.size() != stKey.uLen
+            || memcmp(stField.strKey.data(), stKey.lpStr, stKey.uLen) != 0)
         {
-            RETURN(ParseDataFialed);
+            continue;
         }
 
-        // parse value
-        while (IsNullChar(lpContent[uIndex++]));
-        auto ch = lpContent[uIndex];
-        if (ch == '{')
+        if (stField.bWhole)
         {
-            auto lpObj = lpJsonObj->AddObject(strKey.c_str());
-            if (lpObj == nullptr)
+            stCtx.uField = AllFields;
+            return true;
+        }
+
+        auto ch = PeekToken(stCtx, uIndex);
+        stCtx.uField = i;
+        return ch == '{' || ch == '[';
+    }
+
+    return false;
+}
+
+int32_t CJsonObjImpl::SkipValue(ParseContext &stCtx, uint32_t &uIndex)
+{
+    switch (PeekToken(stCtx, uIndex))
+    {
+        case '{':
+        case '[':
+            break;
+
+        case '"':
+            if (unlikely(PeekToken(stCtx, uIndex + 1) != '"'))
             {
-                RETURN(MallocFailed);
+                RETURN(ParseDataFialed);
             }
-            if (ParseObject(lpContent, uIndex, lpObj) != 0)
+            uIndex += 2;
+            return 0;
+
+        case '\0':
+        case ',':
+        case ':':
+        case '}':
+        case ']':
+            RETURN(ParseDataFialed);
+
+        default:
+            uIndex++;
+            return 0;
+    }
+
+    // only the brackets are matched, a bit per level telling which one
+    // closes it; the containers skipped still use up their member counts
+    uint64_t szIsObject[MaxParseDepth / 64];
+    uint32_t uDepth = 0;
+    for (; uIndex < stCtx.uCount; uIndex++)
+    {
+        auto ch = stCtx.lpContent[stCtx.lpIndex[uIndex]];
+        if (ch == '{' || ch == '[')
+        {
+            if (unlikely(stCtx.uDepth + uDepth >= MaxParseDepth))
             {
                 RETURN(ParseDataFialed);
             }
+            auto uBit = uint64_t(1) << (uDepth % 64);
+            szIsObject[uDepth / 64] = ch == '{' ? szIsObject[uDepth / 64] | uBit : szIsObject[uDepth / 64] & ~uBit;
+            uDepth++;
+            stCtx.uContainer++;
         }
-        else if (ch == '[')
+        else if (ch == '}' || ch == ']')
         {
-            auto lpObj = lpJsonObj->AddArray(strKey.c_str());
-            if (lpObj == nullptr)
+            uDepth--;
+            if (((szIsObject[uDepth / 64] >> (uDepth % 64)) & 1) != (ch == '}'))
             {
-                RETURN(MallocFailed);
+                RETURN(ParseDataFialed);
             }
-            if (ParseArray(lpContent, uIndex, lpObj) != 0)
+            if (uDepth == 0)
             {
-                RETURN(ParseDataFialed);
+                uIndex++;
+                return 0;
             }
         }
-        else if (ch == '"')
+    }
+
+    RETURN(ParseDataFialed);
+}
+
+int32_t CJsonObjImpl::ParseValue(ParseContext &stCtx, uint32_t &uIndex, const StrRef *lpKey, CJsonObjImpl *lpJsonObj)
+{
+    if (unlikely(uIndex >= stCtx.uCount))
+    {
+        RETURN(ParseDataFialed);
+    }
+
+    auto uPos = stCtx.lpIndex[uIndex];
+    auto lpToken = &stCtx.lpContent[uPos];
+    switch (*lpToken)
+    {
+        case '{':
         {
-            auto lpStrValueBegin = &lpContent[uIndex + 1];
-            auto lpStrValueEnd = ParseString(lpContent, uIndex);
-            std::string strValue(lpStrValueBegin, lpStrValueEnd);
-            if (lpJsonObj->AddString(strKey.c_str(), strValue.c_str()) != 0)
+            auto lpValue = lpJsonObj->AddValue(lpKey, ObjType::Object);
+            if (lpValue == nullptr)
             {
                 RETURN(MallocFailed);
             }
+            return ParseObject(stCtx, uIndex, lpValue->GetObj());
         }
-        else if (IsNumChar(ch))
+
+        case '[':
         {
-            bool bDouble = false;
-            auto lpNumBegin = &lpContent[uIndex];
-            auto lpNumEnd = ParseNumber(lpContent, uIndex, bDouble);
-            if (lpNumEnd == nullptr)
+            auto lpValue = lpJsonObj->AddValue(lpKey, ObjType::Array);
+            if (lpValue == nullptr)
             {
-                RETURN(ParseDataFialed);
+                RETURN(MallocFailed);
             }
-            std::string strNum(lpNumBegin, lpNumEnd);
-            if (bDouble)
+            return ParseArray(stCtx, uIndex, lpValue->GetObj());
+        }
+
+        case '"':
+        {
+            try
             {
-                auto dValue = std::atof(strNum.c_str());
-                if (lpJsonObj->AddDouble(strKey.c_str(), dValue) != 0)
+                StrRef stValue;
+                if (ParseString(stCtx, uIndex, stCtx.strBuffer, stValue) != 0)
                 {
-                    RETURN(MallocFailed);
+                    RETURN(ParseDataFialed);
                 }
-            }
-            else
-            {
-                int64_t nValue = std::atoll(strNum.c_str());
-                if (lpJsonObj->AddInt(strKey.c_str(), nValue) != 0)
+                if (lpJsonObj->AddValue(lpKey, ObjType::String, &stValue) == nullptr)
                 {
                     RETURN(MallocFailed);
                 }
             }
-        }
-        else if (ch == 't' || ch == 'f') // true or false
-        {
-            if (lpContent[uIndex] == '\0' || lpContent[uIndex + 1] != '\0'
-                || lpContent[uIndex + 2] == '\0' || lpContent[uIndex + 3] == '\0')
+            catch (...)
             {
-                RETURN(ParseDataFialed);
+                RETURN(MallocFailed);
             }
+            return 0;
+        }
 
-            auto bValue = true;
-            if (*(uint32_t *)&lpContent[uIndex] == *(const uint32_t *)"true")
+        case 't':
+        case 'f':
+        {
+            bool bValue = *lpToken == 't';
+            uint64_t uWordLen = bValue ? 4 : 5;
+            if (uPos + uWordLen > stCtx.uLen || memcmp(lpToken, bValue ? "true" : "false", uWordLen) != 0
+                || !IsDelimiter(stCtx, uPos + uWordLen))
             {
-                if (lpJsonObj->AddBool(strKey.c_str(), true) != 0)
-                {
-                    RETURN(MallocFailed);
-                }
+                RETURN(ParseDataFialed);
             }
-            else if (strncmp(&lpContent[uIndex], "false", 5) == 0)
+            if (lpJsonObj->AddValue(lpKey, ObjType::Boolean, &bValue) == nullptr)
             {
-                if (lpJsonObj->AddBool(strKey.c_str(), false) != 0)
-                {
-                    RETURN(MallocFailed);
-                }
+                RETURN(MallocFailed);
             }
-            else
+            uIndex++;
+            return 0;
+        }
+
+        case 'n':
+        {
+            if (uPos + 4 > stCtx.uLen || memcmp(lpToken, "null", 4) != 0 || !IsDelimiter(stCtx, uPos + 4))
             {
                 RETURN(ParseDataFialed);
             }
-        }
-        else if (ch == 'n') // null
-        {
-            if (*(uint32_t *)&lpContent[uIndex] == *(const uint32_t *)"null")
+            if (lpJsonObj->AddValue(lpKey, ObjType::Null) == nullptr)
             {
-                if (lpJsonObj->AddNull(strKey.c_str()) != 0)
-                {
-                    RETURN(MallocFailed);
-                }
+                RETURN(MallocFailed);
             }
+            uIndex++;
+            return 0;
         }
-        else
-        {
-            RETURN(ParseDataFialed);
-        }
-    }
-    catch(...)
-    {
-        RETURN(MallocFailed);
+
+        default:
+            break;
     }
 
-    while (IsNullChar(lpContent[uIndex++]));
-    if (lpContent[uIndex] == ',')
+    if (!IsNumChar(*lpToken))
     {
-        uIndex++;
+        RETURN(ParseDataFialed);
     }
-    while (IsNullChar(lpContent[uIndex++]));
 
-    if (lpContent[uIndex] != '}' || lpContent[uIndex] != ']')
+    JsonNumber stNumber;
+    auto lpNumEnd = ParseNumber(lpToken, stCtx.lpContent + stCtx.uLen, stNumber);
+    if (lpNumEnd == nullptr || !IsDelimiter(stCtx, lpNumEnd - stCtx.lpContent))
     {
         RETURN(ParseDataFialed);
     }
 
-    return 0;
-}
-
-int32_t CJsonObjImpl::ParseArrNull(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj)
-{
-    if (*(uint32_t *)&lpContent[uIndex] == *(const uint32_t *)"null")
+    if (stNumber.bDouble)
     {
-        if (lpJsonObj->AddNull(nullptr) != 0)
+        if (lpJsonObj->AddValue(lpKey, ObjType::Double, &stNumber.dValue) == nullptr)
         {
             RETURN(MallocFailed);
         }
     }
-
-    while (IsNullChar(lpContent[uIndex++]));
-    if (lpContent[uIndex] == ',')
-    {
-        uIndex++;
-    }
-    while (IsNullChar(lpContent[uIndex++]));
-
-    if (lpContent[uIndex] != ']')
+    else if (lpJsonObj->AddValue(lpKey, ObjType::Integer, &stNumber.nValue) == nullptr)
     {
-        RETURN(ParseDataFialed);
+        RETURN(MallocFailed);
     }
 
+    uIndex++;
     return 0;
 }
 
-int32_t CJsonObjImpl::ParseArrBool(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj)
+int32_t CJsonObjImpl::ParseObject(ParseContext &stCtx, uint32_t &uIndex, CJsonObjImpl *lpJsonObj)
 {
-    if (lpContent[uIndex] == '\0' || lpContent[uIndex + 1] != '\0'
-        || lpContent[uIndex + 2] == '\0' || lpContent[uIndex + 3] == '\0')
+    // { "key" : value , ... }
+    if (unlikely(++stCtx.uDepth > MaxParseDepth))
     {
         RETURN(ParseDataFialed);
     }
 
-    auto bValue = true;
-    if (*(uint32_t *)&lpContent[uIndex] == *(const uint32_t *)"true")
+    auto uMembers = TakeMemberCount(stCtx, uIndex);
+    uIndex++; // '{'
+    if (PeekToken(stCtx, uIndex) == '}')
     {
-        if (lpJsonObj->AddBool(nullptr, true) != 0)
-        {
-            RETURN(MallocFailed);
-        }
+        uIndex++;
+        stCtx.uDepth--;
+        return 0;
     }
-    else if (strncmp(&lpContent[uIndex], "false", 5) == 0)
+
+    try
     {
-        if (lpJsonObj->AddBool(nullptr, false) != 0)
+        auto &objValue = lpJsonObj->m_unValue.objValue;
+        if (stCtx.uField != AllFields)
         {
-            RETURN(MallocFailed);
+            uMembers = std::min(uMembers, (*stCtx.lpFields)[stCtx.uField].uChildren);
         }
-    }
-    else
-    {
-        RETURN(ParseDataFialed);
-    }
+        objValue.reserve(objValue.size() + uMembers);
 
-    while (IsNullChar(lpContent[uIndex++]));
-    if (lpContent[uIndex] == ',')
-    {
-        uIndex++;
-    }
-    while (IsNullChar(lpContent[uIndex++]));
+        std::string strKey;
+        StrRef stKey;
+        while (true)
+        {
+            if (PeekToken(stCtx, uIndex) != '"' || ParseString(stCtx, uIndex, strKey, stKey) != 0)
+            {
+                RETURN(ParseDataFialed);
+            }
+
+            if (PeekToken(stCtx, uIndex++) != ':')
+            {
+                RETURN(ParseDataFialed);
+            }
+
+            // members outside the projection are stepped over unconverted
+            auto uField = stCtx.uField;
+            auto iErrorNo = uField == AllFields || IsProjected(stCtx, stKey, uIndex)
+                                ? ParseValue(stCtx, uIndex, &stKey, lpJsonObj)
+                                : SkipValue(stCtx, uIndex);
+            stCtx.uField = uField;
+            if (iErrorNo != 0)
+            {
+                RETURN(ParseDataFialed);
+            }
 
-    if (lpContent[uIndex] != ']')
+            auto ch = PeekToken(stCtx, uIndex++);
+            if (ch == '}')
+            {
+                break;
+            }
+            else if (ch != ',')
+            {
+                RETURN(ParseDataFialed);
+            }
+        }
+    }
+    catch (...)
     {
-        RETURN(ParseDataFialed);
+        RETURN(MallocFailed);
     }
 
+    stCtx.uDepth--;
     return 0;
 }
 
-int32_t CJsonObjImpl::ParseArrNumber(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj)
+int32_t CJsonObjImpl::ParseArray(ParseContext &stCtx, uint32_t &uIndex, CJsonObjImpl *lpJsonObj)
 {
-    bool bDouble = false;
-    auto lpNumBegin = &lpContent[uIndex];
-    auto lpNumEnd = ParseNumber(lpContent, uIndex, bDouble);
-    if (lpNumEnd == nullptr)
+    // [ value , ... ]
+    if (unlikely(++stCtx.uDepth > MaxParseDepth))
     {
         RETURN(ParseDataFialed);
     }
-    std::string strNum(lpNumBegin, lpNumEnd);
-    if (bDouble)
+
+    auto uMembers = TakeMemberCount(stCtx, uIndex);
+    uIndex++; // '['
+    if (PeekToken(stCtx, uIndex) == ']')
     {
-        auto dValue = std::atof(strNum.c_str());
-        if (lpJsonObj->AddDouble(nullptr, dValue) != 0)
-        {
-            RETURN(MallocFailed);
-        }
+        uIndex++;
+        stCtx.uDepth--;
+        return 0;
     }
-    else
+
+    try
     {
-        int64_t nValue = std::atoll(strNum.c_str());
-        if (lpJsonObj->AddInt(nullptr, nValue) != 0)
-        {
-            RETURN(MallocFailed);
-        }
+        auto &arrValue = lpJsonObj->m_unValue.arrValue;
+        arrValue.reserve(arrValue.size() + uMembers);
     }
-
-    while (IsNullChar(lpContent[uIndex++]));
-    if (lpContent[uIndex] == ',')
+    catch (...)
     {
-        uIndex++;
+        RETURN(MallocFailed);
     }
-    while (IsNullChar(lpContent[uIndex++]));
 
-    if (lpContent[uIndex] != ']')
+    while (true)
     {
-        RETURN(ParseDataFialed);
+        if (ParseValue(stCtx, uIndex, nullptr, lpJsonObj) != 0)
+        {
+            RETURN(ParseDataFialed);
+        }
+
+        auto ch = PeekToken(stCtx, uIndex++);
+        if (ch == ']')
+        {
+            break;
+        }
+        else if (ch != ',')
+        {
+            RETURN(ParseDataFialed);
+        }
     }
 
+    stCtx.uDepth--;
     return 0;
 }
 
-int32_t CJsonObjImpl::ParseArrString(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj)
+int32_t CJsonObjImpl::ParseContent(const char *lpContent, uint64_t uLen, bool bInSitu,
+                                   const std::vector<ProjectField> *lpFields)
+{
+    CJsonScanner scanner;
+    auto iErrorNo = scanner.Scan(lpContent, uLen);
+    if (iErrorNo != 0)
+    {
+        RETURN(iErrorNo);
+    }
+
+    ParseContext stCtx;
+    stCtx.lpContent = lpContent;
+    stCtx.lpInSitu = bInSitu ? const_cast<char *>(lpContent) : nullptr;
+    stCtx.uLen = uLen;
+    stCtx.lpIndex = scanner.GetIndex();
+    stCtx.uCount = scanner.GetCount();
+    stCtx.uDepth = 0;
+    stCtx.uContainer = 0;
+    stCtx.lpFields = lpFields;
+    stCtx.uField = lpFields == nullptr || (*lpFields)[0].bWhole ? AllFields : 0;
+    return ParseTokens(stCtx);
+}
+
+int32_t CJsonObjImpl::ParseTokens(ParseContext &stCtx)
 {
+    // size each container once up front instead of growing it member by
+    // member
     try
     {
-        auto lpStrValueBegin = &lpContent[uIndex + 1];
-        auto lpStrValueEnd = ParseString(lpContent, uIndex);
-        std::string strValue(lpStrValueBegin, lpStrValueEnd);
-        if (lpJsonObj->AddString(nullptr, strValue.c_str()) != 0)
-        {
-            RETURN(MallocFailed);
-        }
+        CountMembers(stCtx);
     }
-    catch(...)
+    catch (...)
     {
         RETURN(MallocFailed);
     }
 
-    while (IsNullChar(lpContent[uIndex++]));
-    if (lpContent[uIndex] == ',')
+    int32_t iErrorNo = 0;
+    ObjType eType = ObjType::Unknow;
+    switch (PeekToken(stCtx, 0))
     {
-        uIndex++;
+        case '{':
+            eType = ObjType::Object;
+            break;
+
+        case '[':
+            eType = ObjType::Array;
+            break;
+
+        default:
+            RETURN(ParseDataFialed);
     }
-    while (IsNullChar(lpContent[uIndex++]));
 
-    if (lpContent[uIndex] != ']')
+    if (m_eType == ObjType::Unknow)
+    {
+        iErrorNo = Init(eType);
+        if (iErrorNo != 0)
+        {
+            RETURN(iErrorNo);
+        }
+    }
+    else if (m_eType != eType)
+    {
+        RETURN(InvaliadCall);
+    }
+
+    uint32_t uIndex = 0;
+    iErrorNo = eType == ObjType::Object ? ParseObject(stCtx, uIndex, this) : ParseArray(stCtx, uIndex, this);
+    if (iErrorNo != 0)
+    {
+        RETURN(iErrorNo);
+    }
+
+    // only whitespace may follow the root value
+    if (uIndex != stCtx.uCount)
     {
         RETURN(ParseDataFialed);
     }
@@ -845,181 +1293,431 @@ int32_t CJsonObjImpl::ParseArrString(const char *lpContent, uint64_t &uIndex, IJ
     return 0;
 }
 
-int32_t CJsonObjImpl::ParseArray(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj)
+int32_t CJsonObjImpl::ParseFileContent(void *lpParam, const char *lpContent, uint64_t uLen)
 {
-    // "[......]"
-    uIndex++; // '['
-    for (;lpContent[uIndex] != '\0'; uIndex++)
+    return reinterpret_cast<CJsonObjImpl *>(lpParam)->ParseContent(lpContent, uLen);
+}
+
+int32_t CJsonObjImpl::OpenFromFile(const char *lpFile)
+{
+    if (unlikely(lpFile == nullptr))
+    {
+        RETURN(InvaliadParam);
+    }
+
+    auto iErrorNo = ParseJsonFile(lpFile, ParseFileContent, this);
+    if (iErrorNo != 0)
+    {
+        RETURN(iErrorNo);
+    }
+
+    return 0;
+}
+
+int32_t CJsonObjImpl::OpenFromBuffer(const char *lpBuffer)
+{
+    if (unlikely(lpBuffer == nullptr))
     {
-        auto ch = lpContent[uIndex];
-        if (IsNullChar(ch))
+        RETURN(InvaliadParam);
+    }
+
+    return ParseContent(lpBuffer, strlen(lpBuffer));
+}
+
+int32_t CJsonObjImpl::OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen)
+{
+    if (unlikely(lpBuffer == nullptr))
+    {
+        RETURN(InvaliadParam);
+    }
+
+    return ParseContent(lpBuffer, uLen, true);
+}
+
+int32_t CJsonObjImpl::OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount)
+{
+    if (unlikely(lpBuffer == nullptr || (lpPaths == nullptr && uPathCount > 0)))
+    {
+        RETURN(InvaliadParam);
+    }
+
+    std::vector<ProjectField> vecFields;
+    try
+    {
+        auto iErrorNo = MakeProjection(lpPaths, uPathCount, vecFields);
+        if (iErrorNo != 0)
         {
-            continue;
+            RETURN(iErrorNo);
         }
-        else if (ch == 'n') // null
+    }
+    catch (...)
+    {
+        RETURN(MallocFailed);
+    }
+
+    return ParseContent(lpBuffer, strlen(lpBuffer), false, &vecFields);
+}
+
+int32_t CJsonObjImpl::OpenSnapshot(const char *lpFile)
+{
+    RETURN(InvaliadCall);
+}
+
+int32_t CJsonObjImpl::OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat)
+{
+    if (unlikely(lpBuffer == nullptr || (eFormat != BinaryFormat::MessagePack && eFormat != BinaryFormat::Cbor)))
+    {
+        RETURN(InvaliadParam);
+    }
+
+    auto iErrorNo = CJsonBinaryReader(lpBuffer, uLen, eFormat).Read(this);
+    if (iErrorNo != 0)
+    {
+        RETURN(iErrorNo);
+    }
+
+    return 0;
+}
+
+void CJsonObjImpl::DeleteWriter(void *lpWriter)
+{
+    delete reinterpret_cast<CJsonWriter *>(lpWriter);
+}
+
+int32_t CJsonObjImpl::WriteValue(CJsonWriter &writer, bool bPretty, uint32_t uDepth)
+{
+    int32_t iErrorNo = 0;
+    switch (m_eType)
+    {
+        case ObjType::Array:
         {
-            if (ParseArrNull(lpContent, uIndex, lpJsonObj) != 0)
+            iErrorNo = writer.WriteChar('[');
+            if (iErrorNo != 0)
             {
-                RETURN(ParseDataFialed);
+                RETURN(iErrorNo);
             }
-        }
-        else if (ch == 't' || ch == 'f') // true or false
-        {
-            if (ParseArrBool(lpContent, uIndex, lpJsonObj) != 0)
+
+            bool bFirst = true;
+            for (auto &item : m_unValue.arrValue)
             {
-                RETURN(ParseDataFialed);
+                if (!bFirst)
+                {
+                    iErrorNo = writer.WriteChar(',');
+                }
+                if (iErrorNo == 0 && bPretty)
+                {
+                    iErrorNo = writer.WriteIndent(uDepth + 1);
+                }
+                if (iErrorNo == 0)
+                {
+                    iErrorNo = WriteMember(writer, item, bPretty, uDepth + 1);
+                }
+                if (iErrorNo != 0)
+                {
+                    RETURN(iErrorNo);
+                }
+                bFirst = false;
             }
-        }
-        else if (ch == '"')
-        {
-            if (ParseArrString(lpContent, uIndex, lpJsonObj) != 0)
+
+            if (bPretty && !bFirst)
             {
-                RETURN(ParseDataFialed);
+                iErrorNo = writer.WriteIndent(uDepth);
+                if (iErrorNo != 0)
+                {
+                    RETURN(iErrorNo);
+                }
             }
+
+            return writer.WriteChar(']');
         }
-        else if (IsNumChar(ch))
+
+        case ObjType::Object:
         {
-            if (ParseArrNumber(lpContent, uIndex, lpJsonObj) != 0)
+            iErrorNo = writer.WriteChar('{');
+            if (iErrorNo != 0)
             {
-                RETURN(ParseDataFialed);
+                RETURN(iErrorNo);
             }
-        }
-        else if (ch == '[')
-        {
-            auto lpArray = lpJsonObj->AddArray(nullptr);
-            if (ParseArray(lpContent, uIndex, lpArray) != 0)
+
+            bool bFirst = true;
+            for (auto &item : m_unValue.objValue)
             {
-                RETURN(ParseDataFialed);
+                if (!bFirst)
+                {
+                    iErrorNo = writer.WriteChar(',');
+                }
+                if (iErrorNo == 0 && bPretty)
+                {
+                    iErrorNo = writer.WriteIndent(uDepth + 1);
+                }
+                if (iErrorNo == 0)
+                {
+                    iErrorNo = writer.WriteString(item.first.lpStr, item.first.uLen);
+                }
+                if (iErrorNo == 0)
+                {
+                    iErrorNo = bPretty ? writer.WriteRaw(": ", 2) : writer.WriteChar(':');
+                }
+                if (iErrorNo == 0)
+                {
+                    iErrorNo = WriteMember(writer, item.second, bPretty, uDepth + 1);
+                }
+                if (iErrorNo != 0)
+                {
+                    RETURN(iErrorNo);
+                }
+                bFirst = false;
             }
-        }
-        else if (ch == '{')
-        {
-            auto lpObj = lpJsonObj->AddObject(nullptr);
-            if (ParseObject(lpContent, uIndex, lpObj) != 0)
+
+            if (bPretty && !bFirst)
             {
-                RETURN(ParseDataFialed);
+                iErrorNo = writer.WriteIndent(uDepth);
+                if (iErrorNo != 0)
+                {
+                    RETURN(iErrorNo);
+                }
             }
+
+            return writer.WriteChar('}');
         }
-        else if (ch == ']')
-        {
-            uIndex++;
-            break;
-        }
-        else
-        {
-            RETURN(ParseDataFialed);
-        }
+
+        default:
+            RETURN(InvaliadCall);
     }
+}
 
-    return 0;
+int32_t CJsonObjImpl::WriteMember(CJsonWriter &writer, const _ValueType &stValue, bool bPretty, uint32_t uDepth)
+{
+    switch (stValue.GetType())
+    {
+        case ObjType::Null:
+            return writer.WriteNull();
+
+        case ObjType::Boolean:
+            return writer.WriteBool(stValue.Load<bool>());
+
+        case ObjType::Integer:
+            return writer.WriteInt(stValue.Load<int64_t>());
+
+        case ObjType::Double:
+            return writer.WriteDouble(stValue.Load<double>());
+
+        case ObjType::String:
+            return writer.WriteString(stValue.GetStr(), stValue.GetStrLen());
+
+        case ObjType::Array:
+        case ObjType::Object:
+            return stValue.GetObj()->WriteValue(writer, bPretty, uDepth);
+
+        default:
+            RETURN(InvaliadCall);
+    }
 }
 
-int32_t CJsonObjImpl::ParseObject(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj)
+CJsonWriter *CJsonObjImpl::GetWriter()
 {
-    // "{......}"
-    uIndex++; // '{'
-    for (;lpContent[uIndex] != '\0'; uIndex++)
+    if (m_lpWriter == nullptr)
     {
-        auto ch = lpContent[uIndex];
-        if (IsNullChar(ch))
-        {
-            continue;
-        }
-        else if (ch == '"')
-        {
-            if (ParseKeyValue(lpContent, uIndex, lpJsonObj) != 0)
-            {
-                RETURN(ParseDataFialed);
-            }
-        }
-        else if (ch == '}')
+        m_lpWriter = NEW CJsonWriter();
+        if (m_lpWriter == nullptr)
         {
-            uIndex++;
-            break;
+            return nullptr;
         }
-        else
+
+        // arena nodes are never destroyed one by one, the arena frees the writer
+        if (m_lpArena != nullptr && m_lpArena->AddCleanup(DeleteWriter, m_lpWriter) != 0)
         {
-            RETURN(ParseDataFialed);
+            delete m_lpWriter;
+            m_lpWriter = nullptr;
+            return nullptr;
         }
     }
 
-    return 0;
+    m_lpWriter->Clear();
+    return m_lpWriter;
 }
 
-int32_t CJsonObjImpl::ParseContent(const char *lpContent)
+const char *CJsonObjImpl::GetJsonStr(bool bPretty)
 {
-    uint64_t uIndex = 0;
-    int32_t iErrorNo = 0;
-    while (lpContent[uIndex] != '\0')
+    if (unlikely(m_eType == ObjType::Unknow))
     {
-        if (IsNullChar(lpContent[uIndex]))
-        {
-            continue;
-        }
-        else if (lpContent[uIndex] == '{' )
-        {
-            if (ParseObject(lpContent, uIndex, this) != 0)
-            {
-                RETURN(ParseDataFialed);
-            }
-        }
-        else if (lpContent[uIndex] == '[')
-        {
-            if (ParseArray(lpContent, uIndex, this) != 0)
-            {
-                RETURN(ParseDataFialed);
-            }
-        }
-        else
-        {
-            RETURN(ParseDataFialed);
-        }
+        return nullptr;
+    }
+
+    auto lpWriter = GetWriter();
+    if (lpWriter == nullptr || WriteValue(*lpWriter, bPretty, 0) != 0)
+    {
+        return nullptr;
+    }
+
+    return lpWriter->GetStr();
+}
+
+const char *CJsonObjImpl::GetBinary(BinaryFormat eFormat, uint64_t *lpLen)
+{
+    if (unlikely(m_eType == ObjType::Unknow || lpLen == nullptr))
+    {
+        return nullptr;
+    }
+
+    auto lpWriter = GetWriter();
+    if (lpWriter == nullptr || CJsonBinaryWriter(*lpWriter, eFormat).WriteNode(this) != 0)
+    {
+        return nullptr;
+    }
+
+    *lpLen = lpWriter->GetSize();
+    return lpWriter->GetData();
+}
+
+int32_t CJsonObjImpl::SaveSnapshot(const char *lpFile)
+{
+    auto iErrorNo = SaveJsonSnapshot(this, lpFile);
+    if (iErrorNo != 0)
+    {
+        RETURN(iErrorNo);
     }
 
     return 0;
 }
 
-int32_t CJsonObjImpl::OpenFromFile(const char *lpFile)
+IJsonObj *CJsonObjImpl::Freeze()
 {
-    if (unlikely(lpFile == nullptr))
+    return FreezeJsonObject(this);
+}
+
+CJsonDomBuilder::CJsonDomBuilder(CJsonObjImpl *lpRoot) : m_lpRoot(lpRoot)
+{
+}
+
+void CJsonDomBuilder::Reset()
+{
+    m_vecStack.clear();
+    m_strKey.clear();
+    m_iErrorNo = 0;
+}
+
+CJsonObjImpl::_ValueType *CJsonDomBuilder::AddValue(ObjType eType, const void *lpValue)
+{
+    // values outside of a container have nowhere to go
+    if (m_vecStack.empty())
     {
-        RETURN(InvaliadParam);
+        m_iErrorNo = ParseDataFialed;
+        return nullptr;
     }
 
-    auto lpHandler = fopen(lpFile, "r");
-    if (lpHandler == nullptr)
+    auto lpParent = m_vecStack.back();
+    CJsonObjImpl::StrRef stKey{m_strKey.data(), uint32_t(m_strKey.size()), false};
+    auto lpKey = lpParent->m_eType == ObjType::Object ? &stKey : nullptr;
+    auto lpMember = lpParent->AddValue(lpKey, eType, lpValue);
+    if (lpMember == nullptr)
     {
-        RETURN(OpenFileFailed);
+        m_iErrorNo = MallocFailed;
     }
 
-    int32_t iErrorNo = 0;
-    char szLine[4096];
-    while (fgets(szLine, sizeof(szLine), lpHandler) != nullptr)
+    return lpMember;
+}
+
+bool CJsonDomBuilder::StartContainer(ObjType eType)
+{
+    CJsonObjImpl *lpObj = m_lpRoot;
+    if (!m_vecStack.empty())
     {
-        iErrorNo = ParseContent(szLine);
-        if (iErrorNo != 0)
-        {
-            break;
-        }
+        auto lpValue = AddValue(eType);
+        lpObj = lpValue != nullptr ? lpValue->GetObj() : nullptr;
+    }
+    else if (m_lpRoot->m_eType == ObjType::Unknow)
+    {
+        m_iErrorNo = m_lpRoot->Init(eType);
+    }
+    else if (m_lpRoot->m_eType != eType)
+    {
+        m_iErrorNo = InvaliadCall;
+    }
+
+    if (lpObj == nullptr || m_iErrorNo != 0)
+    {
+        return false;
     }
 
-    fclose(lpHandler);
-    RETURN(iErrorNo);
+    try
+    {
+        m_vecStack.push_back(lpObj);
+    }
+    catch (...)
+    {
+        m_iErrorNo = MallocFailed;
+        return false;
+    }
+
+    return true;
 }
 
-int32_t CJsonObjImpl::OpenFromBuffer(const char *lpBuffer)
+bool CJsonDomBuilder::EndContainer()
 {
-    if (unlikely(lpBuffer == nullptr))
+    m_vecStack.pop_back();
+    return true;
+}
+
+bool CJsonDomBuilder::OnNull()
+{
+    return AddValue(ObjType::Null) != nullptr;
+}
+
+bool CJsonDomBuilder::OnBool(bool bValue)
+{
+    return AddValue(ObjType::Boolean, &bValue) != nullptr;
+}
+
+bool CJsonDomBuilder::OnInt(int64_t nValue)
+{
+    return AddValue(ObjType::Integer, &nValue) != nullptr;
+}
+
+bool CJsonDomBuilder::OnDouble(double dValue)
+{
+    return AddValue(ObjType::Double, &dValue) != nullptr;
+}
+
+bool CJsonDomBuilder::OnString(const char *lpStr, uint32_t uLen)
+{
+    CJsonObjImpl::StrRef stValue{lpStr, uLen, false};
+    return AddValue(ObjType::String, &stValue) != nullptr;
+}
+
+bool CJsonDomBuilder::OnKey(const char *lpKey, uint32_t uLen)
+{
+    try
     {
-        RETURN(InvaliadParam);
+        m_strKey.assign(lpKey, uLen);
+    }
+    catch (...)
+    {
+        m_iErrorNo = MallocFailed;
+        return false;
     }
 
-    return ParseContent(lpBuffer);
+    return true;
 }
 
-const char *CJsonObjImpl::GetJsonStr(bool bPretty)
+bool CJsonDomBuilder::OnStartObject()
 {
-    return nullptr;
+    return StartContainer(ObjType::Object);
+}
+
+bool CJsonDomBuilder::OnEndObject()
+{
+    return EndContainer();
+}
+
+bool CJsonDomBuilder::OnStartArray()
+{
+    return StartContainer(ObjType::Array);
+}
+
+bool CJsonDomBuilder::OnEndArray()
+{
+    return EndContainer();
 }
 
 }
@@ -1029,7 +1727,120 @@ cppbase::IJsonObj *NewJsonObject()
     return NEW cppbase::CJsonObjImpl();
 }
 
+cppbase::IJsonObj *NewArenaJsonObject(uint64_t uChunkSize)
+{
+    auto lpArena = NEW cppbase::CJsonArena(uChunkSize);
+    if (lpArena == nullptr)
+    {
+        return nullptr;
+    }
+
+    // the root lives in the arena with the rest of the document
+    auto lpMem = lpArena->Alloc(sizeof(cppbase::CJsonObjImpl));
+    if (lpMem == nullptr)
+    {
+        delete lpArena;
+        return nullptr;
+    }
+
+    return new(lpMem) cppbase::CJsonObjImpl(lpArena);
+}
+
 void DeleteJsonObject(cppbase::IJsonObj *lpJsonObj)
 {
-    delete (cppbase::CJsonObjImpl *)lpJsonObj;
-}
\ No newline at end of file
+    auto lpTapeDoc = dynamic_cast<cppbase::CJsonTapeDoc *>(lpJsonObj);
+    if (lpTapeDoc != nullptr)
+    {
+        delete lpTapeDoc;
+        return;
+    }
+
+    auto lpLazyDoc = dynamic_cast<cppbase::CJsonLazyDoc *>(lpJsonObj);
+    if (lpLazyDoc != nullptr)
+    {
+        delete lpLazyDoc;
+        return;
+    }
+
+    auto lpSnapshotDoc = dynamic_cast<cppbase::CJsonSnapshotDoc *>(lpJsonObj);
+    if (lpSnapshotDoc != nullptr)
+    {
+        delete lpSnapshotDoc;
+        return;
+    }
+
+    auto lpObj = static_cast<cppbase::CJsonObjImpl *>(lpJsonObj);
+    if (lpObj != nullptr && lpObj->GetArena() != nullptr)
+    {
+        delete lpObj->GetArena();
+        return;
+    }
+
+    delete lpObj;
+}
+
+namespace
+{
+
+// the documents released on a thread, waiting for the next it acquires
+class CJsonObjPool
+{
+public:
+    static constexpr uint32_t MaxDocuments = 16;
+    static constexpr uint64_t MaxDocumentBytes = 16 * 1024 * 1024;
+
+    ~CJsonObjPool()
+    {
+        for (auto lpJsonObj : m_vecDocs)
+        {
+            DeleteJsonObject(lpJsonObj);
+        }
+    }
+
+    std::vector<cppbase::IJsonObj *> m_vecDocs;
+};
+
+thread_local CJsonObjPool g_pool;
+
+}
+
+cppbase::IJsonObj *AcquireJsonObject()
+{
+    auto &vecDocs = g_pool.m_vecDocs;
+    if (vecDocs.empty())
+    {
+        return NewArenaJsonObject(0);
+    }
+
+    auto lpJsonObj = vecDocs.back();
+    vecDocs.pop_back();
+    return lpJsonObj;
+}
+
+void ReleaseJsonObject(cppbase::IJsonObj *lpJsonObj)
+{
+    // only documents like those AcquireJsonObject makes go to the pool
+    auto lpObj = dynamic_cast<cppbase::CJsonObjImpl *>(lpJsonObj);
+    if (lpObj == nullptr || typeid(*lpObj) != typeid(cppbase::CJsonObjImpl) || lpObj->GetArena() == nullptr
+        || lpObj->GetArena()->GetFirst() != lpObj || g_pool.m_vecDocs.size() >= CJsonObjPool::MaxDocuments)
+    {
+        DeleteJsonObject(lpJsonObj);
+        return;
+    }
+
+    lpObj->Clear();
+    if (lpObj->GetArena()->GetChunkBytes() > CJsonObjPool::MaxDocumentBytes)
+    {
+        DeleteJsonObject(lpJsonObj);
+        return;
+    }
+
+    try
+    {
+        g_pool.m_vecDocs.push_back(lpObj);
+    }
+    catch (...)
+    {
+        DeleteJsonObject(lpJsonObj);
+    }
+}
@@ -3,30 +3,88 @@
 
 #include <os_common.h>
 #include <json_obj.h>
+#include <json_handler.h>
+#include "json_arena.h"
+#include "json_obj_map.h"
+#include "json_obj_array.h"
+#include <string>
 #include <vector>
-#include <unordered_map>
 
 namespace cppbase
 {
 
+class CJsonWriter;
+
 class CJsonObjImpl : public IJsonObj
 {
+    friend class CJsonDomBuilder;
+    friend class CJsonParallelDoc;
+    friend class CJsonDocStream;
+    friend class CJsonBinaryWriter;
+    friend class CJsonBinaryReader;
+    friend struct JsonNodeLayoutCheck;
+
+    // keys and long string values are NUL-terminated copies owned by the
+    // document arena, or by the node itself when there is no arena;
+    // in-situ strings point into the caller's buffer and are never copied
+    struct StrRef
+    {
+        const char *lpStr;
+        uint32_t uLen;
+        bool bInSitu;
+    };
+
+    // an array element or object member in 16 bytes: scalars and strings
+    // of up to ShortStrLen bytes are stored inline, longer strings and
+    // arrays and objects behind a pointer
     struct _ValueType
     {
-        uint8_t Reserve[72];
+        static constexpr uint32_t ShortStrLen = 14;
+        static constexpr uint8_t TypeMask = 0x0F;
+        static constexpr uint8_t ShortStr = 0x10; // the string is in szData
+        static constexpr uint8_t InSitu = 0x20;   // the string is in the parsed buffer
+
+        // the scalar or pointer, then the length of a long string; a short
+        // string fills szData instead, its last byte holding ShortStrLen
+        // minus the length, which is also the NUL of a full one
+        alignas(8) char szData[15];
+        uint8_t uTag{uint8_t(ObjType::Null)};
+
+        inline ObjType GetType() const { return ObjType(uTag & TypeMask); }
+
+        template <typename T>
+        inline T Load(uint32_t uOffset = 0) const
+        {
+            T value;
+            memcpy(&value, szData + uOffset, sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        inline void Store(T value, uint32_t uOffset = 0)
+        {
+            memcpy(szData + uOffset, &value, sizeof(T));
+        }
+
+        inline const char *GetStr() const
+        {
+            return (uTag & ShortStr) != 0 ? szData : Load<const char *>();
+        }
+
+        inline uint32_t GetStrLen() const
+        {
+            return (uTag & ShortStr) != 0 ? ShortStrLen - uint8_t(szData[ShortStrLen]) : Load<uint32_t>(8);
+        }
+
+        inline CJsonObjImpl *GetObj() const { return Load<CJsonObjImpl *>(); }
     };
 
-    using KeyType = std::string;
-    using StringValueType = std::string;
-    using ArrayValueType = std::vector<_ValueType>;
-    using ObjValueType = std::unordered_map<KeyType, _ValueType>;
+    using KeyType = StrRef;
+    using ArrayValueType = CJsonObjArray<_ValueType>;
+    using ObjValueType = CJsonObjMap<KeyType, _ValueType>;
 
     union ValueType
     {
-        bool bValue;
-        int64_t nValue;
-        double dValue;
-        std::string strValue;
         ArrayValueType arrValue;
         ObjValueType objValue;
 
@@ -35,14 +93,18 @@ class CJsonObjImpl : public IJsonObj
     };
 
 public:
-    CJsonObjImpl();
-    CJsonObjImpl(ObjType eType, const void *lpValue = nullptr);
+    explicit CJsonObjImpl(CJsonArena *lpArena = nullptr);
     ~CJsonObjImpl() override;
 
     int32_t Init(ObjType eType) override;
 
     int32_t OpenFromFile(const char *lpFile) override;
     int32_t OpenFromBuffer(const char *lpBuffer) override;
+    int32_t OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen) override;
+    int32_t OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount) override;
+    int32_t OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat) override;
+    int32_t OpenSnapshot(const char *lpFile) override;
+    int32_t Clear() override;
 
     int32_t AddNull(const char *lpKey) override;
     int32_t AddBool(const char *lpKey, bool bValue) override;
@@ -61,37 +123,173 @@ public:
     IJsonObj *GetObject(const char *lpKey) override;
 
     bool IsExist(const char *lpKey) override;
+
+    bool GetNull(const Key &stKey) override;
+    bool GetBool(const Key &stKey, bool bDefaultValue = false) override;
+    int64_t GetInt(const Key &stKey, int64_t nDefaultValue = 0) override;
+    double GetDouble(const Key &stKey, double dDefaultValue = 0.0) override;
+    const char *GetString(const Key &stKey, const char *lpDefaultValue = nullptr) override;
+    IJsonObj *GetArray(const Key &stKey) override;
+    IJsonObj *GetObject(const Key &stKey) override;
+    bool IsExist(const Key &stKey) override;
     
     ObjType GetType() override;
     uint32_t GetSize() override;
     ObjType GetType(const char *lpKey) override;
+    ObjType GetType(const Key &stKey) override;
     ObjType GetType(uint32_t uIndex) override;
     int32_t GetItem(uint32_t uIndex, KvItem *lpKvItem) override;
+    bool First(Cursor *lpCursor, KvItem *lpKvItem) override;
+    bool Next(Cursor *lpCursor, KvItem *lpKvItem) override;
 
     const char *GetJsonStr(bool bPretty) override;
+    const char *GetBinary(BinaryFormat eFormat, uint64_t *lpLen) override;
+    int32_t SaveSnapshot(const char *lpFile) override;
+    IJsonObj *Freeze() override;
+
+    inline CJsonArena *GetArena() const { return m_lpArena; }
 
 private:
-    IJsonObj *AddValue(const char *lpKey, ObjType eType, const void *lpValue = nullptr);
-
-    bool IsNullChar(char ch);
-    bool IsNumChar(char ch);
-    bool IsCharZero2Nine(char ch);
-    const char *ParseString(const char *lpContent, uint64_t &uIndex);
-    const char *ParseNumber(const char *lpContent, uint64_t &uIndex, bool &bDouble);
-    int32_t ParseArrNull(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj);
-    int32_t ParseArrBool(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj);
-    int32_t ParseArrNumber(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj);
-    int32_t ParseArrString(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj);
-    int32_t ParseKeyValue(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj);
-    int32_t ParseObject(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj);
-    int32_t ParseArray(const char *lpContent, uint64_t &uIndex, IJsonObj *lpJsonObj);
-    int32_t ParseContent(const char *lpContent);
+    static constexpr uint32_t MaxParseDepth = 1024;
+
+    // what a Cursor holds: the position of the next member
+    struct CursorState
+    {
+        uint32_t uIndex;
+    };
+
+    // uField of a container kept whole
+    static constexpr uint32_t AllFields = UINT32_MAX;
+
+    // one key of the projection paths, entry 0 being the root; an entry
+    // always follows its parent
+    struct ProjectField
+    {
+        std::string strKey;
+        uint32_t uParent;
+        uint32_t uChildren;
+        bool bWhole; // a path ends here and keeps all of the value
+    };
+
+    // the tree builder walks the token offsets produced by CJsonScanner
+    struct ParseContext
+    {
+        const char *lpContent;
+        char *lpInSitu; // lpContent when strings are decoded in place, else nullptr
+        uint64_t uLen;
+        const uint32_t *lpIndex;
+        uint32_t uCount;
+        uint32_t uDepth;
+        std::string strBuffer; // unescaped string values
+        std::vector<uint32_t> vecMembers; // member counts, in the order containers open
+        uint32_t uContainer;              // next entry of vecMembers
+        const std::vector<ProjectField> *lpFields; // nullptr when nothing is projected
+        uint32_t uField;                           // the entry of the container being parsed
+    };
+
+    static inline StrRef MakeStrRef(const char *lpStr)
+    {
+        return StrRef{lpStr, uint32_t(strlen(lpStr)), false};
+    }
+
+    static inline StrRef MakeStrRef(const Key &stKey)
+    {
+        return StrRef{stKey.lpKey, stKey.uLen, false};
+    }
+
+    // objects tag their members with the low half of the key hash
+    static inline uint32_t HashTag(uint64_t uHash)
+    {
+        return uint32_t(uHash);
+    }
+
+    void InitValue(ObjType eType);
+    CJsonObjImpl *NewNode(ObjType eType);
+    void SetValue(_ValueType &stValue, ObjType eType, const void *lpValue);
+    void FreeValue(const _ValueType &stValue);
+    const char *CopyString(const char *lpStr, uint32_t uLen);
+    void FreeString(const StrRef &stStr);
+    _ValueType *AddValue(const char *lpKey, ObjType eType, const void *lpValue = nullptr);
+    _ValueType *AddValue(const StrRef *lpKey, ObjType eType, const void *lpValue = nullptr);
+    _ValueType *FindValue(const Key &stKey);
+    _ValueType *GetMember(uint32_t uIndex, const char *&lpKey);
+    static int32_t FillKvItem(const char *lpKey, const _ValueType &stValue, KvItem *lpKvItem);
+
+    static bool IsNumChar(char ch);
+    static bool IsDelimiter(const ParseContext &stCtx, uint64_t uPos);
+    static char PeekToken(const ParseContext &stCtx, uint32_t uIndex);
+    static void CountMembers(ParseContext &stCtx);
+    static uint32_t TakeMemberCount(ParseContext &stCtx, uint32_t uIndex);
+    static int32_t ParseString(const ParseContext &stCtx, uint32_t &uIndex, std::string &strBuffer, StrRef &stValue);
+    static int32_t MakeProjection(const char *const *lpPaths, uint32_t uPathCount, std::vector<ProjectField> &vecFields);
+    static bool IsProjected(ParseContext &stCtx, const StrRef &stKey, uint32_t uIndex);
+    static int32_t SkipValue(ParseContext &stCtx, uint32_t &uIndex);
+    int32_t ParseValue(ParseContext &stCtx, uint32_t &uIndex, const StrRef *lpKey, CJsonObjImpl *lpJsonObj);
+    int32_t ParseObject(ParseContext &stCtx, uint32_t &uIndex, CJsonObjImpl *lpJsonObj);
+    int32_t ParseArray(ParseContext &stCtx, uint32_t &uIndex, CJsonObjImpl *lpJsonObj);
+    // builds the document from the tokens of stCtx, which must hold exactly
+    // one object or array
+    int32_t ParseTokens(ParseContext &stCtx);
+    int32_t ParseContent(const char *lpContent, uint64_t uLen, bool bInSitu = false,
+                         const std::vector<ProjectField> *lpFields = nullptr);
+    static int32_t ParseFileContent(void *lpParam, const char *lpContent, uint64_t uLen);
+
+    static void DeleteWriter(void *lpWriter);
+    CJsonWriter *GetWriter();
+    int32_t WriteValue(CJsonWriter &writer, bool bPretty, uint32_t uDepth);
+    static int32_t WriteMember(CJsonWriter &writer, const _ValueType &stValue, bool bPretty, uint32_t uDepth);
 
 private:
     ObjType m_eType{ObjType::Unknow};
+    ObjType m_eKept{ObjType::Unknow}; // the empty container Clear left to the next Init
+    bool m_bChild{false};
+    CJsonArena *m_lpArena{nullptr};
+    // created by the first GetJsonStr or GetBinary and reused by the
+    // following ones
+    CJsonWriter *m_lpWriter{nullptr};
     ValueType m_unValue;
 };
 
+/*
+ * Handler turning parse events into nodes under a root, for the parsers
+ * that report events instead of walking the structural index themselves.
+ * The root has to be an object or an array, or not initialized yet.
+ */
+class CJsonDomBuilder : public IJsonHandler
+{
+public:
+    explicit CJsonDomBuilder(CJsonObjImpl *lpRoot);
+    ~CJsonDomBuilder() override = default;
+
+    // why the last callback returned false, 0 if none did
+    inline int32_t GetError() const { return m_iErrorNo; }
+    void Reset();
+
+    bool OnNull() override;
+    bool OnBool(bool bValue) override;
+    bool OnInt(int64_t nValue) override;
+    bool OnDouble(double dValue) override;
+    bool OnString(const char *lpStr, uint32_t uLen) override;
+    bool OnKey(const char *lpKey, uint32_t uLen) override;
+    bool OnStartObject() override;
+    bool OnEndObject() override;
+    bool OnStartArray() override;
+    bool OnEndArray() override;
+
+private:
+    using ObjType = IJsonObj::ObjType;
+
+    CJsonObjImpl::_ValueType *AddValue(ObjType eType, const void *lpValue = nullptr);
+    bool StartContainer(ObjType eType);
+    bool EndContainer();
+
+private:
+    CJsonObjImpl *m_lpRoot;
+    std::vector<CJsonObjImpl *> m_vecStack;
+    std::string m_strKey;
+    int32_t m_iErrorNo{0};
+};
+
 }
 
 #endif //__JSON_OBJ_IMPL_H_
@@ -0,0 +1,316 @@
+#ifndef __JSON_OBJ_MAP_H_
+#define __JSON_OBJ_MAP_H_
+
+#include <os_common.h>
+#include "json_arena.h"
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace cppbase
+{
+
+/*
+ * Members of a json object, kept in insertion order in one block:
+ *
+ *   [uint32_t hash tags ... capacity][Entry{key, value} ... capacity]
+ *
+ * Objects with up to MaxLinearSize members are searched by comparing the
+ * hash tags four at a time, then the key. Larger ones add an open
+ * addressing index of entry positions over the same block.
+ *
+ * K needs lpStr and uLen members and must be trivially copyable; V is
+ * relocated with its move constructor when the block grows, so entries
+ * do not keep their address across an insert.
+ */
+template <typename K, typename V>
+class CJsonObjMap
+{
+    friend struct JsonNodeLayoutCheck;
+
+public:
+    static constexpr uint32_t MaxLinearSize = 16;
+
+    struct Entry
+    {
+        K first;
+        V second;
+    };
+
+    using iterator = Entry *;
+
+    explicit CJsonObjMap(CJsonArena *lpArena) : m_lpArena(lpArena) {}
+
+    CJsonObjMap(CJsonObjMap &&other) noexcept
+        : m_lpArena(other.m_lpArena), m_lpHashes(other.m_lpHashes), m_lpEntries(other.m_lpEntries),
+          m_lpIndex(other.m_lpIndex), m_uSize(other.m_uSize), m_uCapacity(other.m_uCapacity),
+          m_uIndexMask(other.m_uIndexMask)
+    {
+        other.m_lpHashes = nullptr;
+        other.m_lpEntries = nullptr;
+        other.m_lpIndex = nullptr;
+        other.m_uSize = other.m_uCapacity = other.m_uIndexMask = 0;
+    }
+
+    // the entries are raw storage whose owner destroys them first
+    ~CJsonObjMap()
+    {
+        Free(m_lpHashes);
+        Free(m_lpIndex);
+    }
+
+    CJsonObjMap(const CJsonObjMap &) = delete;
+    CJsonObjMap &operator=(const CJsonObjMap &) = delete;
+
+    inline iterator begin() const { return m_lpEntries; }
+    inline iterator end() const { return m_lpEntries + m_uSize; }
+    inline uint32_t size() const { return m_uSize; }
+    inline Entry &operator[](uint32_t uIndex) const { return m_lpEntries[uIndex]; }
+
+    iterator find(const K &stKey, uint32_t uHash) const
+    {
+        return m_lpIndex == nullptr ? FindLinear(stKey, uHash) : FindIndexed(stKey, uHash);
+    }
+
+    // appends stKey with an unconstructed value, or returns the entry that
+    // already holds it; throws std::bad_alloc
+    std::pair<iterator, bool> emplace(const K &stKey, uint32_t uHash)
+    {
+        auto iter = find(stKey, uHash);
+        if (iter != end())
+        {
+            return std::make_pair(iter, false);
+        }
+
+        if (m_uSize == m_uCapacity)
+        {
+            Resize(m_uCapacity == 0 ? 4 : m_uCapacity * 2);
+        }
+
+        iter = m_lpEntries + m_uSize;
+        new(&iter->first) K(stKey);
+        new(&iter->second) V();
+        m_lpHashes[m_uSize++] = uHash;
+        if (m_lpIndex != nullptr)
+        {
+            Insert(m_uSize - 1);
+        }
+        else if (m_uSize > MaxLinearSize)
+        {
+            try
+            {
+                Rebuild();
+            }
+            catch (...)
+            {
+                m_uSize--;
+                throw;
+            }
+        }
+
+        return std::make_pair(iter, true);
+    }
+
+    // makes room for uCapacity members at once, rounded up to a multiple of
+    // 4; throws std::bad_alloc
+    void reserve(uint32_t uCapacity)
+    {
+        if (uCapacity > m_uCapacity)
+        {
+            Resize((uCapacity + 3) & ~3U);
+        }
+    }
+
+    // drops every entry, whose values must already be destroyed, keeping
+    // the block and the index for the next ones
+    void clear()
+    {
+        if (m_lpIndex != nullptr)
+        {
+            memset(m_lpIndex, 0, uint64_t(m_uIndexMask + 1) * sizeof(uint32_t));
+        }
+        m_uSize = 0;
+    }
+
+    // drops the last entry, whose value must already be destroyed
+    void pop_back()
+    {
+        if (m_lpIndex != nullptr)
+        {
+            Remove(m_uSize - 1);
+        }
+        m_uSize--;
+    }
+
+private:
+    inline static bool IsSameKey(const K &stLeft, const K &stRight)
+    {
+        return stLeft.uLen == stRight.uLen && memcmp(stLeft.lpStr, stRight.lpStr, stLeft.uLen) == 0;
+    }
+
+    iterator FindLinear(const K &stKey, uint32_t uHash) const
+    {
+        uint32_t i = 0;
+#if defined(__SSE2__)
+        // the capacity is a multiple of 4, tags past the size are masked off
+        const __m128i stHash = _mm_set1_epi32(int32_t(uHash));
+        for (; i < m_uSize; i += 4)
+        {
+            auto stTags = _mm_loadu_si128(reinterpret_cast<const __m128i *>(m_lpHashes + i));
+            auto uMask = uint32_t(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(stTags, stHash))));
+            uMask &= m_uSize - i >= 4 ? 0xF : (1U << (m_uSize - i)) - 1;
+            while (uMask != 0)
+            {
+                auto uPos = i + uint32_t(__builtin_ctz(uMask));
+                if (likely(IsSameKey(m_lpEntries[uPos].first, stKey)))
+                {
+                    return m_lpEntries + uPos;
+                }
+                uMask &= uMask - 1;
+            }
+        }
+#else
+        for (; i < m_uSize; i++)
+        {
+            if (m_lpHashes[i] == uHash && IsSameKey(m_lpEntries[i].first, stKey))
+            {
+                return m_lpEntries + i;
+            }
+        }
+#endif
+        return end();
+    }
+
+    iterator FindIndexed(const K &stKey, uint32_t uHash) const
+    {
+        // slots hold entry position + 1, 0 marks an empty slot
+        for (auto uSlot = uHash & m_uIndexMask; m_lpIndex[uSlot] != 0; uSlot = (uSlot + 1) & m_uIndexMask)
+        {
+            auto uPos = m_lpIndex[uSlot] - 1;
+            if (m_lpHashes[uPos] == uHash && IsSameKey(m_lpEntries[uPos].first, stKey))
+            {
+                return m_lpEntries + uPos;
+            }
+        }
+
+        return end();
+    }
+
+    void Insert(uint32_t uPos)
+    {
+        auto uSlot = m_lpHashes[uPos] & m_uIndexMask;
+        while (m_lpIndex[uSlot] != 0)
+        {
+            uSlot = (uSlot + 1) & m_uIndexMask;
+        }
+        m_lpIndex[uSlot] = uPos + 1;
+    }
+
+    void Remove(uint32_t uPos)
+    {
+        auto uSlot = m_lpHashes[uPos] & m_uIndexMask;
+        while (m_lpIndex[uSlot] != uPos + 1)
+        {
+            uSlot = (uSlot + 1) & m_uIndexMask;
+        }
+        m_lpIndex[uSlot] = 0;
+
+        // the rest of the probe run may have passed over the freed slot
+        for (uSlot = (uSlot + 1) & m_uIndexMask; m_lpIndex[uSlot] != 0; uSlot = (uSlot + 1) & m_uIndexMask)
+        {
+            auto uMoved = m_lpIndex[uSlot] - 1;
+            m_lpIndex[uSlot] = 0;
+            Insert(uMoved);
+        }
+    }
+
+    // sizes the index to a power of two of at least twice the capacity, so
+    // it is at most half full
+    void Rebuild()
+    {
+        if (m_uSize <= MaxLinearSize)
+        {
+            Free(m_lpIndex);
+            m_lpIndex = nullptr;
+            m_uIndexMask = 0;
+            return;
+        }
+
+        uint32_t uSlots = 1U << (32 - __builtin_clz(2 * m_uCapacity - 1));
+        auto lpIndex = reinterpret_cast<uint32_t *>(Alloc(uint64_t(uSlots) * sizeof(uint32_t)));
+        memset(lpIndex, 0, uint64_t(uSlots) * sizeof(uint32_t));
+        Free(m_lpIndex);
+        m_lpIndex = lpIndex;
+        m_uIndexMask = uSlots - 1;
+        for (uint32_t i = 0; i < m_uSize; i++)
+        {
+            Insert(i);
+        }
+    }
+
+    void Resize(uint32_t uCapacity)
+    {
+        static_assert(alignof(Entry) <= 8, "arena memory is 8-byte aligned");
+
+        auto lpBlock = reinterpret_cast<char *>(Alloc(EntryOffset(uCapacity) + uint64_t(uCapacity) * sizeof(Entry)));
+        auto lpHashes = reinterpret_cast<uint32_t *>(lpBlock);
+        auto lpEntries = reinterpret_cast<Entry *>(lpBlock + EntryOffset(uCapacity));
+        if (m_uSize > 0)
+        {
+            memcpy(lpHashes, m_lpHashes, uint64_t(m_uSize) * sizeof(uint32_t));
+        }
+        for (uint32_t i = 0; i < m_uSize; i++)
+        {
+            new(&lpEntries[i].first) K(m_lpEntries[i].first);
+            new(&lpEntries[i].second) V(std::move(m_lpEntries[i].second));
+        }
+
+        Free(m_lpHashes);
+        m_lpHashes = lpHashes;
+        m_lpEntries = lpEntries;
+        m_uCapacity = uCapacity;
+
+        // positions are unchanged, but the index is sized by the capacity
+        if (m_lpIndex != nullptr || m_uSize > MaxLinearSize)
+        {
+            Rebuild();
+        }
+    }
+
+    inline static uint64_t EntryOffset(uint32_t uCapacity)
+    {
+        return ALIGN8(uint64_t(uCapacity) * sizeof(uint32_t));
+    }
+
+    void *Alloc(uint64_t uSize)
+    {
+        auto lpMem = m_lpArena != nullptr ? m_lpArena->Alloc(uSize) : malloc(uSize);
+        if (unlikely(lpMem == nullptr))
+        {
+            throw std::bad_alloc();
+        }
+        return lpMem;
+    }
+
+    inline void Free(void *lpMem)
+    {
+        if (m_lpArena == nullptr)
+        {
+            free(lpMem);
+        }
+    }
+
+private:
+    CJsonArena *m_lpArena;
+    uint32_t *m_lpHashes{nullptr};
+    Entry *m_lpEntries{nullptr};
+    uint32_t *m_lpIndex{nullptr};
+    uint32_t m_uSize{0};
+    uint32_t m_uCapacity{0};
+    uint32_t m_uIndexMask{0};
+};
+
+}
+
+#endif //__JSON_OBJ_MAP_H_
@@ -0,0 +1,298 @@
+#include "json_parallel.h"
+#include "json_scanner.h"
+#include "json_file.h"
+#include <error_no.h>
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace cppbase
+{
+
+int32_t CJsonParallelDoc::SplitArray(const ParseContext &stCtx, uint32_t uShards, std::vector<Shard> &vecShards)
+{
+    // the root '[' is token 0; a shard ends at the first top-level comma
+    // past its share of the bytes
+    uint64_t uTarget = stCtx.uLen / uShards;
+    uint32_t uBegin = 1;
+    uint32_t uElements = 1;
+    uint32_t uDepth = 0;
+    for (uint32_t i = 0; i < stCtx.uCount; i++)
+    {
+        auto uPos = stCtx.lpIndex[i];
+        switch (stCtx.lpContent[uPos])
+        {
+            case '{':
+            case '[':
+                uDepth++;
+                break;
+
+            case '}':
+            case ']':
+                if (--uDepth > 0)
+                {
+                    break;
+                }
+                // the brackets inside the elements are matched by their
+                // parsers, the root's here, and only whitespace may follow
+                if (stCtx.lpContent[uPos] != ']' || i + 1 != stCtx.uCount)
+                {
+                    return ParseDataFialed;
+                }
+                vecShards.push_back(Shard{uBegin, i, uElements, nullptr, nullptr, 0});
+                return 0;
+
+            case ',':
+                if (uDepth != 1)
+                {
+                    break;
+                }
+                if (uPos >= uTarget && vecShards.size() + 1 < uShards)
+                {
+                    vecShards.push_back(Shard{uBegin, i, uElements, nullptr, nullptr, 0});
+                    uBegin = i + 1;
+                    uElements = 0;
+                    uTarget = stCtx.uLen * (vecShards.size() + 1) / uShards;
+                }
+                uElements++;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return ParseDataFialed;
+}
+
+void CJsonParallelDoc::ParseShard(const ParseContext &stRoot, Shard &stShard)
+{
+    // the shard's tokens are indexed from 0, as if they were a document
+    ParseContext stCtx;
+    stCtx.lpContent = stRoot.lpContent;
+    stCtx.lpInSitu = stRoot.lpInSitu;
+    stCtx.uLen = stRoot.uLen;
+    stCtx.lpIndex = stRoot.lpIndex + stShard.uBegin;
+    stCtx.uCount = stShard.uEnd - stShard.uBegin;
+    stCtx.uDepth = 1;
+    stCtx.uContainer = 0;
+    stCtx.lpFields = nullptr;
+    stCtx.uField = AllFields;
+
+    stShard.lpArena = NEW CJsonArena();
+    auto lpMem = stShard.lpArena != nullptr ? stShard.lpArena->Alloc(sizeof(CJsonObjImpl)) : nullptr;
+    if (unlikely(lpMem == nullptr))
+    {
+        stShard.iErrorNo = MallocFailed;
+        return;
+    }
+
+    auto lpArray = new(lpMem) CJsonObjImpl(stShard.lpArena);
+    stShard.lpArray = lpArray;
+    stShard.iErrorNo = lpArray->Init(ObjType::Array);
+    if (stShard.iErrorNo != 0)
+    {
+        return;
+    }
+
+    try
+    {
+        CountMembers(stCtx);
+        lpArray->m_unValue.arrValue.reserve(stShard.uElements);
+    }
+    catch (...)
+    {
+        stShard.iErrorNo = MallocFailed;
+        return;
+    }
+
+    uint32_t uIndex = 0;
+    while (true)
+    {
+        stShard.iErrorNo = lpArray->ParseValue(stCtx, uIndex, nullptr, lpArray);
+        if (stShard.iErrorNo != 0 || uIndex == stCtx.uCount)
+        {
+            return;
+        }
+        if (PeekToken(stCtx, uIndex++) != ',')
+        {
+            stShard.iErrorNo = ParseDataFialed;
+            return;
+        }
+    }
+}
+
+void CJsonParallelDoc::DeleteArena(void *lpArena)
+{
+    delete reinterpret_cast<CJsonArena *>(lpArena);
+}
+
+int32_t CJsonParallelDoc::ParseParallel(const char *lpContent, uint64_t uLen, bool bInSitu)
+{
+    uint64_t uFirst = 0;
+    while (uFirst < uLen && CJsonScanner::IsDelimiter(lpContent[uFirst]))
+    {
+        uFirst++;
+    }
+
+    auto uShards = uint32_t(std::min<uint64_t>(m_uThreads, uLen / MinBytesPerThread));
+    if (uShards < 2 || uFirst == uLen || lpContent[uFirst] != '[' || m_eType == ObjType::Object)
+    {
+        return ParseContent(lpContent, uLen, bInSitu);
+    }
+
+    CJsonScanner scanner;
+    auto iErrorNo = scanner.Scan(lpContent, uLen);
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    ParseContext stCtx;
+    stCtx.lpContent = lpContent;
+    stCtx.lpInSitu = bInSitu ? const_cast<char *>(lpContent) : nullptr;
+    stCtx.uLen = uLen;
+    stCtx.lpIndex = scanner.GetIndex();
+    stCtx.uCount = scanner.GetCount();
+
+    std::vector<Shard> vecShards;
+    try
+    {
+        vecShards.reserve(uShards);
+        iErrorNo = SplitArray(stCtx, uShards, vecShards);
+    }
+    catch (...)
+    {
+        return MallocFailed;
+    }
+    if (iErrorNo == 0 && m_eType == ObjType::Unknow)
+    {
+        iErrorNo = Init(ObjType::Array);
+    }
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    // the calling thread takes the first shard, and any other one no thread
+    // could be started for
+    std::vector<std::thread> vecThreads;
+    size_t uStarted = 1;
+    try
+    {
+        vecThreads.reserve(vecShards.size() - 1);
+        for (; uStarted < vecShards.size(); uStarted++)
+        {
+            vecThreads.emplace_back(&CJsonParallelDoc::ParseShard, std::cref(stCtx), std::ref(vecShards[uStarted]));
+        }
+    }
+    catch (...)
+    {
+    }
+
+    ParseShard(stCtx, vecShards[0]);
+    for (auto i = uStarted; i < vecShards.size(); i++)
+    {
+        ParseShard(stCtx, vecShards[i]);
+    }
+    for (auto &thread : vecThreads)
+    {
+        thread.join();
+    }
+
+    for (auto &stShard : vecShards)
+    {
+        iErrorNo = iErrorNo != 0 ? iErrorNo : stShard.iErrorNo;
+    }
+
+    // from here the document owns the shard arenas, whatever happens next
+    size_t uTotal = m_unValue.arrValue.size();
+    for (auto &stShard : vecShards)
+    {
+        if (iErrorNo == 0 && m_lpArena->AddCleanup(DeleteArena, stShard.lpArena) == 0)
+        {
+            uTotal += stShard.lpArray->m_unValue.arrValue.size();
+            continue;
+        }
+        iErrorNo = iErrorNo != 0 ? iErrorNo : MallocFailed;
+        delete stShard.lpArena;
+        stShard.lpArena = nullptr;
+    }
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    try
+    {
+        auto &arrValue = m_unValue.arrValue;
+        arrValue.reserve(uTotal);
+        for (auto &stShard : vecShards)
+        {
+            auto &arrShard = stShard.lpArray->m_unValue.arrValue;
+            arrValue.append(arrShard.begin(), arrShard.end());
+        }
+    }
+    catch (...)
+    {
+        return MallocFailed;
+    }
+
+    return 0;
+}
+
+int32_t CJsonParallelDoc::OpenFileContent(void *lpParam, const char *lpContent, uint64_t uLen)
+{
+    return reinterpret_cast<CJsonParallelDoc *>(lpParam)->ParseParallel(lpContent, uLen, false);
+}
+
+int32_t CJsonParallelDoc::OpenFromFile(const char *lpFile)
+{
+    if (unlikely(lpFile == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    return ParseJsonFile(lpFile, OpenFileContent, this);
+}
+
+int32_t CJsonParallelDoc::OpenFromBuffer(const char *lpBuffer)
+{
+    if (unlikely(lpBuffer == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    return ParseParallel(lpBuffer, strlen(lpBuffer), false);
+}
+
+int32_t CJsonParallelDoc::OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen)
+{
+    if (unlikely(lpBuffer == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    return ParseParallel(lpBuffer, uLen, true);
+}
+
+}
+
+cppbase::IJsonObj *NewParallelJsonObject(uint32_t uThreads)
+{
+    auto lpArena = NEW cppbase::CJsonArena();
+    if (lpArena == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto lpMem = lpArena->Alloc(sizeof(cppbase::CJsonParallelDoc));
+    if (lpMem == nullptr)
+    {
+        delete lpArena;
+        return nullptr;
+    }
+
+    uThreads = uThreads != 0 ? uThreads : std::max(std::thread::hardware_concurrency(), 1U);
+    return new(lpMem) cppbase::CJsonParallelDoc(lpArena, uThreads);
+}
@@ -0,0 +1,60 @@
+#ifndef __JSON_PARALLEL_H_
+#define __JSON_PARALLEL_H_
+
+#include <os_common.h>
+#include "json_obj_impl.h"
+#include <vector>
+
+namespace cppbase
+{
+
+/*
+ * Arena document whose Open calls split a large top-level array between
+ * threads.
+ *
+ * One pass over the structural index cuts the array at top-level commas
+ * into ranges of about the same size. Each thread parses its range into an
+ * array node of its own arena, and the elements, 16 bytes each, are then
+ * appended to the root in order. The thread arenas are released with the
+ * document arena. Objects, and arrays too small to be worth the threads,
+ * are parsed as by any arena document.
+ */
+class CJsonParallelDoc : public CJsonObjImpl
+{
+public:
+    // below this many bytes per thread the threads cost more than they save
+    static constexpr uint64_t MinBytesPerThread = 256 * 1024;
+
+    CJsonParallelDoc(CJsonArena *lpArena, uint32_t uThreads) : CJsonObjImpl(lpArena), m_uThreads(uThreads) {}
+    ~CJsonParallelDoc() override = default;
+
+    using CJsonObjImpl::OpenFromBuffer;
+    int32_t OpenFromFile(const char *lpFile) override;
+    int32_t OpenFromBuffer(const char *lpBuffer) override;
+    int32_t OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen) override;
+
+private:
+    // the elements parsed by one thread
+    struct Shard
+    {
+        uint32_t uBegin; // first token of the first element
+        uint32_t uEnd;   // the comma or bracket after the last element
+        uint32_t uElements;
+        CJsonArena *lpArena;
+        CJsonObjImpl *lpArray;
+        int32_t iErrorNo;
+    };
+
+    static int32_t SplitArray(const ParseContext &stCtx, uint32_t uShards, std::vector<Shard> &vecShards);
+    static void ParseShard(const ParseContext &stRoot, Shard &stShard);
+    static void DeleteArena(void *lpArena);
+    int32_t ParseParallel(const char *lpContent, uint64_t uLen, bool bInSitu);
+    static int32_t OpenFileContent(void *lpParam, const char *lpContent, uint64_t uLen);
+
+private:
+    uint32_t m_uThreads;
+};
+
+}
+
+#endif //__JSON_PARALLEL_H_
@@ -0,0 +1,467 @@
+#include "json_push_parser.h"
+#include "json_number.h"
+#include "json_string.h"
+#include <error_no.h>
+
+namespace cppbase
+{
+
+namespace
+{
+
+inline bool IsSpace(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+inline bool IsNumberChar(char ch)
+{
+    return uint8_t(ch - '0') <= 9 || ch == '-' || ch == '+' || ch == '.' || (ch | 0x20) == 'e';
+}
+
+}
+
+CJsonPushParser::CJsonPushParser(IJsonHandler *lpHandler) : m_lpHandler(lpHandler)
+{
+}
+
+void CJsonPushParser::Reset()
+{
+    m_eState = State::Value;
+    m_eToken = Token::None;
+    m_bHasEscape = false;
+    m_bEscapePending = false;
+    m_uDepth = 0;
+    m_iErrorNo = 0;
+    m_strToken.clear();
+}
+
+int32_t CJsonPushParser::Append(const char *lpBegin, const char *lpEnd)
+{
+    try
+    {
+        m_strToken.append(lpBegin, lpEnd);
+    }
+    catch (...)
+    {
+        return MallocFailed;
+    }
+
+    return 0;
+}
+
+void CJsonPushParser::EndValue()
+{
+    m_eState = m_uDepth == 0 ? State::Done : State::CommaOrEnd;
+}
+
+int32_t CJsonPushParser::ScanString(const char *&lpCur, const char *lpEnd)
+{
+    // lpCur is inside the string; a backslash cut from its escaped byte by
+    // the previous piece still hides the first byte of this one
+    auto lpBegin = lpCur;
+    if (m_bEscapePending && lpCur < lpEnd)
+    {
+        m_bEscapePending = false;
+        lpCur++;
+    }
+
+    while (true)
+    {
+        lpCur = FindStringStop(lpCur, lpEnd);
+        if (lpCur == lpEnd || (*lpCur == '\\' && lpCur + 1 == lpEnd))
+        {
+            m_bHasEscape |= lpCur != lpEnd;
+            m_bEscapePending = lpCur != lpEnd;
+            m_eToken = Token::String;
+            lpCur = lpEnd;
+            return Append(lpBegin, lpEnd);
+        }
+
+        if (*lpCur == '"')
+        {
+            break;
+        }
+        if (uint8_t(*lpCur) < 0x20)
+        {
+            return ParseDataFialed;
+        }
+
+        m_bHasEscape = true;
+        lpCur += 2;
+    }
+
+    auto lpStr = lpBegin;
+    auto lpStrEnd = lpCur++;
+    if (m_eToken == Token::String || m_bHasEscape)
+    {
+        auto iErrorNo = Append(lpStr, lpStrEnd);
+        if (iErrorNo != 0)
+        {
+            return iErrorNo;
+        }
+        lpStr = m_strToken.data();
+        lpStrEnd = lpStr + m_strToken.size();
+    }
+
+    if (m_bHasEscape)
+    {
+        auto lpOut = const_cast<char *>(lpStr);
+        lpStrEnd = UnescapeString(lpStr, lpStrEnd, lpOut);
+        if (lpStrEnd == nullptr)
+        {
+            return ParseDataFialed;
+        }
+    }
+
+    auto uLen = uint32_t(lpStrEnd - lpStr);
+    bool bContinue = m_bKey ? m_lpHandler->OnKey(lpStr, uLen) : m_lpHandler->OnString(lpStr, uLen);
+    m_eToken = Token::None;
+    m_bHasEscape = false;
+    m_strToken.clear();
+    if (!bContinue)
+    {
+        return ParseCanceled;
+    }
+
+    if (m_bKey)
+    {
+        m_eState = State::Colon;
+    }
+    else
+    {
+        EndValue();
+    }
+
+    return 0;
+}
+
+int32_t CJsonPushParser::ScanNumber(const char *&lpCur, const char *lpEnd, bool bFinish)
+{
+    // collect the candidate bytes, the grammar is checked once it is whole
+    auto lpBegin = lpCur;
+    while (lpCur < lpEnd && IsNumberChar(*lpCur))
+    {
+        lpCur++;
+    }
+
+    if (lpCur == lpEnd && !bFinish)
+    {
+        m_eToken = Token::Number;
+        return Append(lpBegin, lpEnd);
+    }
+
+    auto lpNum = lpBegin;
+    auto lpNumEnd = lpCur;
+    if (m_eToken == Token::Number)
+    {
+        auto iErrorNo = Append(lpBegin, lpCur);
+        if (iErrorNo != 0)
+        {
+            return iErrorNo;
+        }
+        lpNum = m_strToken.data();
+        lpNumEnd = lpNum + m_strToken.size();
+    }
+
+    JsonNumber stNumber;
+    if (ParseNumber(lpNum, lpNumEnd, stNumber) != lpNumEnd)
+    {
+        return ParseDataFialed;
+    }
+
+    m_eToken = Token::None;
+    m_strToken.clear();
+    bool bContinue = stNumber.bDouble ? m_lpHandler->OnDouble(stNumber.dValue) : m_lpHandler->OnInt(stNumber.nValue);
+    if (!bContinue)
+    {
+        return ParseCanceled;
+    }
+
+    EndValue();
+    return 0;
+}
+
+int32_t CJsonPushParser::ScanLiteral(const char *&lpCur, const char *lpEnd)
+{
+    auto uLen = uint32_t(strlen(m_lpLiteral));
+    for (; m_uLiteralPos < uLen && lpCur < lpEnd; m_uLiteralPos++, lpCur++)
+    {
+        if (*lpCur != m_lpLiteral[m_uLiteralPos])
+        {
+            return ParseDataFialed;
+        }
+    }
+
+    if (m_uLiteralPos < uLen)
+    {
+        m_eToken = Token::Literal;
+        return 0;
+    }
+
+    // the byte after the literal is checked by the state it leads to
+    m_eToken = Token::None;
+    bool bContinue = m_lpLiteral[0] == 'n' ? m_lpHandler->OnNull() : m_lpHandler->OnBool(m_lpLiteral[0] == 't');
+    if (!bContinue)
+    {
+        return ParseCanceled;
+    }
+
+    EndValue();
+    return 0;
+}
+
+int32_t CJsonPushParser::StartContainer(bool bObject)
+{
+    if (m_uDepth == MaxParseDepth)
+    {
+        return ParseDataFialed;
+    }
+
+    auto &uBits = m_szObjectBits[m_uDepth / 64];
+    uBits = bObject ? uBits | (1ULL << (m_uDepth % 64)) : uBits & ~(1ULL << (m_uDepth % 64));
+    m_uDepth++;
+    m_eState = bObject ? State::KeyOrEnd : State::ValueOrEnd;
+    return (bObject ? m_lpHandler->OnStartObject() : m_lpHandler->OnStartArray()) ? 0 : ParseCanceled;
+}
+
+int32_t CJsonPushParser::EndContainer(bool bObject)
+{
+    if (m_uDepth == 0 || IsInObject() != bObject)
+    {
+        return ParseDataFialed;
+    }
+
+    m_uDepth--;
+    EndValue();
+    return (bObject ? m_lpHandler->OnEndObject() : m_lpHandler->OnEndArray()) ? 0 : ParseCanceled;
+}
+
+int32_t CJsonPushParser::StartValue(const char *&lpCur, const char *lpEnd)
+{
+    // the root is an array or object, as for ParseJsonWithHandler
+    auto ch = *lpCur++;
+    if (m_uDepth == 0 && ch != '{' && ch != '[')
+    {
+        return ParseDataFialed;
+    }
+
+    switch (ch)
+    {
+        case '{':
+            return StartContainer(true);
+
+        case '[':
+            return StartContainer(false);
+
+        case '"':
+            m_bKey = false;
+            return ScanString(lpCur, lpEnd);
+
+        case 't':
+            m_lpLiteral = "true";
+            break;
+
+        case 'f':
+            m_lpLiteral = "false";
+            break;
+
+        case 'n':
+            m_lpLiteral = "null";
+            break;
+
+        default:
+            if (ch != '-' && uint8_t(ch - '0') > 9)
+            {
+                return ParseDataFialed;
+            }
+            return ScanNumber(--lpCur, lpEnd, false);
+    }
+
+    m_uLiteralPos = 1;
+    return ScanLiteral(lpCur, lpEnd);
+}
+
+int32_t CJsonPushParser::Feed(const char *lpData, uint64_t uLen)
+{
+    if (m_iErrorNo != 0)
+    {
+        return m_iErrorNo;
+    }
+    if (unlikely(lpData == nullptr && uLen > 0))
+    {
+        return InvaliadParam;
+    }
+
+    auto lpCur = lpData;
+    auto lpEnd = lpData + uLen;
+    int32_t iErrorNo = 0;
+
+    // first complete the token the previous piece ended in
+    if (lpCur < lpEnd)
+    {
+        switch (m_eToken)
+        {
+            case Token::String:
+                iErrorNo = ScanString(lpCur, lpEnd);
+                break;
+
+            case Token::Number:
+                iErrorNo = ScanNumber(lpCur, lpEnd, false);
+                break;
+
+            case Token::Literal:
+                iErrorNo = ScanLiteral(lpCur, lpEnd);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    while (iErrorNo == 0 && lpCur < lpEnd)
+    {
+        auto ch = *lpCur;
+        if (IsSpace(ch))
+        {
+            lpCur++;
+            continue;
+        }
+
+        switch (m_eState)
+        {
+            case State::ValueOrEnd:
+                if (ch == ']')
+                {
+                    lpCur++;
+                    iErrorNo = EndContainer(false);
+                    break;
+                }
+                iErrorNo = StartValue(lpCur, lpEnd);
+                break;
+
+            case State::Value:
+                iErrorNo = StartValue(lpCur, lpEnd);
+                break;
+
+            case State::KeyOrEnd:
+            case State::Key:
+                lpCur++;
+                if (ch == '}' && m_eState == State::KeyOrEnd)
+                {
+                    iErrorNo = EndContainer(true);
+                }
+                else if (ch == '"')
+                {
+                    m_bKey = true;
+                    iErrorNo = ScanString(lpCur, lpEnd);
+                }
+                else
+                {
+                    iErrorNo = ParseDataFialed;
+                }
+                break;
+
+            case State::Colon:
+                lpCur++;
+                m_eState = State::Value;
+                iErrorNo = ch == ':' ? 0 : ParseDataFialed;
+                break;
+
+            case State::CommaOrEnd:
+                lpCur++;
+                if (ch == ',')
+                {
+                    m_eState = IsInObject() ? State::Key : State::Value;
+                }
+                else
+                {
+                    iErrorNo = ch == '}' || ch == ']' ? EndContainer(ch == '}') : ParseDataFialed;
+                }
+                break;
+
+            case State::Done:
+                // only whitespace may follow the root value
+                iErrorNo = ParseDataFialed;
+                break;
+        }
+    }
+
+    m_iErrorNo = iErrorNo;
+    return iErrorNo;
+}
+
+int32_t CJsonPushParser::Finish()
+{
+    if (m_iErrorNo != 0)
+    {
+        return m_iErrorNo;
+    }
+
+    // a number only ends at the next byte, or at the end of the document
+    if (m_eToken == Token::Number)
+    {
+        const char *lpCur = nullptr;
+        m_iErrorNo = ScanNumber(lpCur, lpCur, true);
+        if (m_iErrorNo != 0)
+        {
+            return m_iErrorNo;
+        }
+    }
+
+    if (m_eToken != Token::None || m_eState != State::Done)
+    {
+        m_iErrorNo = ParseDataFialed;
+    }
+
+    return m_iErrorNo;
+}
+
+CJsonObjPushParser::CJsonObjPushParser(CJsonObjImpl *lpRoot) : CJsonPushParser(&m_builder), m_builder(lpRoot)
+{
+}
+
+int32_t CJsonObjPushParser::Feed(const char *lpData, uint64_t uLen)
+{
+    auto iErrorNo = CJsonPushParser::Feed(lpData, uLen);
+    return iErrorNo == ParseCanceled ? m_builder.GetError() : iErrorNo;
+}
+
+int32_t CJsonObjPushParser::Finish()
+{
+    auto iErrorNo = CJsonPushParser::Finish();
+    return iErrorNo == ParseCanceled ? m_builder.GetError() : iErrorNo;
+}
+
+void CJsonObjPushParser::Reset()
+{
+    CJsonPushParser::Reset();
+    m_builder.Reset();
+}
+
+}
+
+cppbase::IJsonPushParser *NewJsonPushParser(cppbase::IJsonHandler *lpHandler)
+{
+    if (lpHandler == nullptr)
+    {
+        return nullptr;
+    }
+
+    return NEW cppbase::CJsonPushParser(lpHandler);
+}
+
+cppbase::IJsonPushParser *NewJsonObjPushParser(cppbase::IJsonObj *lpJsonObj)
+{
+    if (lpJsonObj == nullptr)
+    {
+        return nullptr;
+    }
+
+    return NEW cppbase::CJsonObjPushParser(static_cast<cppbase::CJsonObjImpl *>(lpJsonObj));
+}
+
+void DeleteJsonPushParser(cppbase::IJsonPushParser *lpParser)
+{
+    delete static_cast<cppbase::CJsonPushParser *>(lpParser);
+}
@@ -0,0 +1,101 @@
+#ifndef __JSON_PUSH_PARSER_H_
+#define __JSON_PUSH_PARSER_H_
+
+#include <os_common.h>
+#include <json_handler.h>
+#include "json_obj_impl.h"
+#include <string>
+
+namespace cppbase
+{
+
+/*
+ * Byte-level state machine behind IJsonPushParser.
+ *
+ * Tokens that fit in one piece are reported straight from it; only a
+ * string, number or literal cut by the end of a piece is carried over in
+ * m_strToken until the next Feed completes it.
+ */
+class CJsonPushParser : public IJsonPushParser
+{
+public:
+    explicit CJsonPushParser(IJsonHandler *lpHandler);
+    ~CJsonPushParser() override = default;
+
+    CJsonPushParser(const CJsonPushParser &) = delete;
+    CJsonPushParser &operator=(const CJsonPushParser &) = delete;
+
+    int32_t Feed(const char *lpData, uint64_t uLen) override;
+    int32_t Finish() override;
+    void Reset() override;
+
+private:
+    static constexpr uint32_t MaxParseDepth = 1024;
+
+    // what the next significant byte may be
+    enum class State : uint8_t
+    {
+        Value,
+        ValueOrEnd,
+        Key,
+        KeyOrEnd,
+        Colon,
+        CommaOrEnd,
+        Done
+    };
+
+    // the token left unfinished by the previous piece
+    enum class Token : uint8_t
+    {
+        None,
+        String,
+        Number,
+        Literal
+    };
+
+    int32_t Append(const char *lpBegin, const char *lpEnd);
+    int32_t ScanString(const char *&lpCur, const char *lpEnd);
+    int32_t ScanNumber(const char *&lpCur, const char *lpEnd, bool bFinish);
+    int32_t ScanLiteral(const char *&lpCur, const char *lpEnd);
+    int32_t StartValue(const char *&lpCur, const char *lpEnd);
+    int32_t StartContainer(bool bObject);
+    int32_t EndContainer(bool bObject);
+    void EndValue();
+    inline bool IsInObject() const
+    {
+        return (m_szObjectBits[(m_uDepth - 1) / 64] >> ((m_uDepth - 1) % 64)) & 1;
+    }
+
+private:
+    IJsonHandler *m_lpHandler;
+    State m_eState{State::Value};
+    Token m_eToken{Token::None};
+    bool m_bKey{false};
+    bool m_bHasEscape{false};
+    bool m_bEscapePending{false};
+    const char *m_lpLiteral{nullptr};
+    uint32_t m_uLiteralPos{0};
+    uint32_t m_uDepth{0};
+    int32_t m_iErrorNo{0};
+    uint64_t m_szObjectBits[MaxParseDepth / 64]{};
+    std::string m_strToken;
+};
+
+// push parser building into an IJsonObj through a CJsonDomBuilder
+class CJsonObjPushParser : public CJsonPushParser
+{
+public:
+    explicit CJsonObjPushParser(CJsonObjImpl *lpRoot);
+    ~CJsonObjPushParser() override = default;
+
+    int32_t Feed(const char *lpData, uint64_t uLen) override;
+    int32_t Finish() override;
+    void Reset() override;
+
+private:
+    CJsonDomBuilder m_builder;
+};
+
+}
+
+#endif //__JSON_PUSH_PARSER_H_
@@ -0,0 +1,277 @@
+#include "json_sax.h"
+#include "json_number.h"
+#include "json_string.h"
+#include <error_no.h>
+
+namespace cppbase
+{
+
+int32_t CJsonSaxParser::PeekToken(uint32_t uAhead, char &ch)
+{
+    // pull in windows until the token exists, dropping the consumed ones
+    while (m_uIndex + uAhead >= m_scanner.GetCount() && !m_scanner.IsFinished())
+    {
+        auto iErrorNo = m_scanner.ScanNext(m_uIndex);
+        if (iErrorNo != 0)
+        {
+            return iErrorNo;
+        }
+        m_uIndex = 0;
+    }
+
+    ch = m_uIndex + uAhead < m_scanner.GetCount() ? m_lpContent[m_scanner.GetIndex()[m_uIndex + uAhead]] : '\0';
+    return 0;
+}
+
+int32_t CJsonSaxParser::ParseString(bool bKey)
+{
+    // the scanner records both quotes of a string
+    char ch = '\0';
+    auto iErrorNo = PeekToken(1, ch);
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+    if (ch != '"')
+    {
+        return ParseDataFialed;
+    }
+
+    auto lpIndex = m_scanner.GetIndex() + m_uIndex;
+    auto lpBegin = m_lpContent + lpIndex[0] + 1;
+    auto lpEnd = m_lpContent + lpIndex[1];
+    m_uIndex += 2;
+
+    auto lpEscape = reinterpret_cast<const char *>(memchr(lpBegin, '\\', lpEnd - lpBegin));
+    if (lpEscape != nullptr)
+    {
+        try
+        {
+            m_strBuffer.resize(lpEnd - lpBegin);
+        }
+        catch (...)
+        {
+            return MallocFailed;
+        }
+
+        auto lpOut = &m_strBuffer[0];
+        memcpy(lpOut, lpBegin, lpEscape - lpBegin);
+        auto lpOutEnd = UnescapeString(lpEscape, lpEnd, lpOut + (lpEscape - lpBegin));
+        if (lpOutEnd == nullptr)
+        {
+            return ParseDataFialed;
+        }
+        lpBegin = lpOut;
+        lpEnd = lpOutEnd;
+    }
+
+    auto uLen = uint32_t(lpEnd - lpBegin);
+    bool bContinue = bKey ? m_lpHandler->OnKey(lpBegin, uLen) : m_lpHandler->OnString(lpBegin, uLen);
+    return bContinue ? 0 : ParseCanceled;
+}
+
+int32_t CJsonSaxParser::ParseScalar()
+{
+    auto uPos = m_scanner.GetIndex()[m_uIndex++];
+    auto lpToken = m_lpContent + uPos;
+    auto IsEnd = [this](uint64_t uEnd) {
+        return uEnd >= m_uLen || CJsonScanner::IsDelimiter(m_lpContent[uEnd]);
+    };
+
+    bool bContinue = true;
+    switch (*lpToken)
+    {
+        case 't':
+        case 'f':
+        {
+            bool bValue = *lpToken == 't';
+            uint64_t uWordLen = bValue ? 4 : 5;
+            if (uPos + uWordLen > m_uLen || memcmp(lpToken, bValue ? "true" : "false", uWordLen) != 0
+                || !IsEnd(uPos + uWordLen))
+            {
+                return ParseDataFialed;
+            }
+            bContinue = m_lpHandler->OnBool(bValue);
+            break;
+        }
+
+        case 'n':
+        {
+            if (uPos + 4 > m_uLen || memcmp(lpToken, "null", 4) != 0 || !IsEnd(uPos + 4))
+            {
+                return ParseDataFialed;
+            }
+            bContinue = m_lpHandler->OnNull();
+            break;
+        }
+
+        default:
+        {
+            JsonNumber stNumber;
+            auto lpNumEnd = ParseNumber(lpToken, m_lpContent + m_uLen, stNumber);
+            if (lpNumEnd == nullptr || !IsEnd(lpNumEnd - m_lpContent))
+            {
+                return ParseDataFialed;
+            }
+            bContinue = stNumber.bDouble ? m_lpHandler->OnDouble(stNumber.dValue)
+                                         : m_lpHandler->OnInt(stNumber.nValue);
+            break;
+        }
+    }
+
+    return bContinue ? 0 : ParseCanceled;
+}
+
+int32_t CJsonSaxParser::Parse(const char *lpContent, uint64_t uLen, IJsonHandler *lpHandler)
+{
+    if (unlikely(lpContent == nullptr || lpHandler == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    auto iErrorNo = m_scanner.Begin(lpContent, uLen);
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    m_lpContent = lpContent;
+    m_uLen = uLen;
+    m_uIndex = 0;
+    m_lpHandler = lpHandler;
+
+    // one bit per open container, set for objects
+    uint64_t szObjectBits[MaxParseDepth / 64] = {0};
+    uint32_t uDepth = 0;
+    auto IsInObject = [&]() {
+        return (szObjectBits[(uDepth - 1) / 64] >> ((uDepth - 1) % 64)) & 1;
+    };
+
+    auto eState = State::Value;
+    char ch = '\0';
+    while (true)
+    {
+        iErrorNo = PeekToken(0, ch);
+        if (iErrorNo != 0)
+        {
+            return iErrorNo;
+        }
+
+        switch (eState)
+        {
+            case State::Value:
+            {
+                // the root is an array or object, as for the documents
+                if (uDepth == 0 && ch != '{' && ch != '[')
+                {
+                    return ParseDataFialed;
+                }
+
+                if (ch == '"')
+                {
+                    iErrorNo = ParseString(false);
+                    eState = State::AfterValue;
+                    break;
+                }
+
+                if (ch != '{' && ch != '[')
+                {
+                    // a structural character or the end of the input where a value belongs
+                    bool bScalar = ch != '\0' && !CJsonScanner::IsDelimiter(ch);
+                    iErrorNo = bScalar ? ParseScalar() : ParseDataFialed;
+                    eState = State::AfterValue;
+                    break;
+                }
+
+                if (uDepth == MaxParseDepth)
+                {
+                    return ParseDataFialed;
+                }
+
+                bool bObject = ch == '{';
+                auto &uBits = szObjectBits[uDepth / 64];
+                uBits = bObject ? uBits | (1ULL << (uDepth % 64)) : uBits & ~(1ULL << (uDepth % 64));
+                uDepth++;
+                m_uIndex++;
+                if (!(bObject ? lpHandler->OnStartObject() : lpHandler->OnStartArray()))
+                {
+                    return ParseCanceled;
+                }
+
+                iErrorNo = PeekToken(0, ch);
+                if (iErrorNo == 0 && ch == (bObject ? '}' : ']'))
+                {
+                    m_uIndex++;
+                    uDepth--;
+                    iErrorNo = (bObject ? lpHandler->OnEndObject() : lpHandler->OnEndArray()) ? 0 : ParseCanceled;
+                    eState = State::AfterValue;
+                }
+                else
+                {
+                    eState = bObject ? State::Key : State::Value;
+                }
+                break;
+            }
+
+            case State::Key:
+            {
+                if (ch != '"')
+                {
+                    return ParseDataFialed;
+                }
+
+                iErrorNo = ParseString(true);
+                if (iErrorNo == 0)
+                {
+                    iErrorNo = PeekToken(0, ch);
+                }
+                if (iErrorNo == 0 && ch != ':')
+                {
+                    iErrorNo = ParseDataFialed;
+                }
+                m_uIndex++;
+                eState = State::Value;
+                break;
+            }
+
+            case State::AfterValue:
+            {
+                if (uDepth == 0)
+                {
+                    // only whitespace may follow the root value
+                    return ch == '\0' ? 0 : ParseDataFialed;
+                }
+
+                bool bObject = IsInObject();
+                m_uIndex++;
+                if (ch == ',')
+                {
+                    eState = bObject ? State::Key : State::Value;
+                }
+                else if (ch == (bObject ? '}' : ']'))
+                {
+                    uDepth--;
+                    iErrorNo = (bObject ? lpHandler->OnEndObject() : lpHandler->OnEndArray()) ? 0 : ParseCanceled;
+                }
+                else
+                {
+                    return ParseDataFialed;
+                }
+                break;
+            }
+        }
+
+        if (iErrorNo != 0)
+        {
+            return iErrorNo;
+        }
+    }
+}
+
+}
+
+int32_t ParseJsonWithHandler(const char *lpContent, uint64_t uLen, cppbase::IJsonHandler *lpHandler)
+{
+    cppbase::CJsonSaxParser parser;
+    return parser.Parse(lpContent, uLen, lpHandler);
+}
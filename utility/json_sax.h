@@ -0,0 +1,56 @@
+#ifndef __JSON_SAX_H_
+#define __JSON_SAX_H_
+
+#include <os_common.h>
+#include <json_handler.h>
+#include "json_scanner.h"
+#include <string>
+
+namespace cppbase
+{
+
+/*
+ * Streaming parser reporting values to an IJsonHandler.
+ *
+ * It walks the same structural index as the tree builder, but asks the
+ * scanner for one window at a time and drops the tokens it has consumed,
+ * and keeps the open containers as a bit stack instead of recursing, so
+ * its memory does not grow with the document.
+ */
+class CJsonSaxParser
+{
+public:
+    CJsonSaxParser() = default;
+    ~CJsonSaxParser() = default;
+
+    CJsonSaxParser(const CJsonSaxParser &) = delete;
+    CJsonSaxParser &operator=(const CJsonSaxParser &) = delete;
+
+    int32_t Parse(const char *lpContent, uint64_t uLen, IJsonHandler *lpHandler);
+
+private:
+    static constexpr uint32_t MaxParseDepth = 1024;
+
+    enum class State : uint8_t
+    {
+        Value,
+        Key,
+        AfterValue
+    };
+
+    int32_t PeekToken(uint32_t uAhead, char &ch);
+    int32_t ParseString(bool bKey);
+    int32_t ParseScalar();
+
+private:
+    CJsonScanner m_scanner;
+    const char *m_lpContent{nullptr};
+    uint64_t m_uLen{0};
+    uint32_t m_uIndex{0};
+    IJsonHandler *m_lpHandler{nullptr};
+    std::string m_strBuffer;
+};
+
+}
+
+#endif //__JSON_SAX_H_
@@ -0,0 +1,413 @@
+#include "json_scanner.h"
+#include <error_no.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define __JSON_SCANNER_X86__
+#endif
+
+namespace cppbase
+{
+
+namespace
+{
+
+constexpr uint64_t BlockSize = 64;
+constexpr uint64_t ScanWindow = BlockSize * 1024;
+constexpr uint64_t EvenBits = 0x5555555555555555ULL;
+constexpr uint64_t OddBits = ~EvenBits;
+
+struct BlockMasks
+{
+    uint64_t uQuote;
+    uint64_t uBackslash;
+    uint64_t uSpace;
+    uint64_t uOperator;
+    uint64_t uControl;
+};
+
+using ScanState = CJsonScanner::ScanState;
+
+using ScanFunc = uint32_t *(*)(const uint8_t *lpBlock, uint64_t uBlocks, uint32_t uOffset,
+                               uint32_t *lpIndex, ScanState &stState);
+
+enum CharClass : uint8_t
+{
+    ClassQuote = 0x01,
+    ClassBackslash = 0x02,
+    ClassSpace = 0x04,
+    ClassOperator = 0x08,
+    ClassControl = 0x10
+};
+
+struct CharClassTable
+{
+    uint8_t szClass[256];
+
+    CharClassTable() : szClass()
+    {
+        for (int i = 0; i < 0x20; i++)
+        {
+            szClass[i] = ClassControl;
+        }
+        szClass[uint8_t('"')] = ClassQuote;
+        szClass[uint8_t('\\')] = ClassBackslash;
+        szClass[uint8_t(' ')] = ClassSpace;
+        szClass[uint8_t('\t')] = ClassSpace | ClassControl;
+        szClass[uint8_t('\n')] = ClassSpace | ClassControl;
+        szClass[uint8_t('\r')] = ClassSpace | ClassControl;
+        szClass[uint8_t('{')] = ClassOperator;
+        szClass[uint8_t('}')] = ClassOperator;
+        szClass[uint8_t('[')] = ClassOperator;
+        szClass[uint8_t(']')] = ClassOperator;
+        szClass[uint8_t(':')] = ClassOperator;
+        szClass[uint8_t(',')] = ClassOperator;
+    }
+};
+
+const CharClassTable g_stCharClass;
+
+inline void ClassifyScalar(const uint8_t *lpBlock, BlockMasks &stMasks)
+{
+    uint64_t uQuote = 0, uBackslash = 0, uSpace = 0, uOperator = 0, uControl = 0;
+    for (uint64_t i = 0; i < BlockSize; i++)
+    {
+        uint64_t uClass = g_stCharClass.szClass[lpBlock[i]];
+        uQuote |= (uClass & 1) << i;
+        uBackslash |= ((uClass >> 1) & 1) << i;
+        uSpace |= ((uClass >> 2) & 1) << i;
+        uOperator |= ((uClass >> 3) & 1) << i;
+        uControl |= ((uClass >> 4) & 1) << i;
+    }
+
+    stMasks.uQuote = uQuote;
+    stMasks.uBackslash = uBackslash;
+    stMasks.uSpace = uSpace;
+    stMasks.uOperator = uOperator;
+    stMasks.uControl = uControl;
+}
+
+#ifdef __JSON_SCANNER_X86__
+__attribute__((target("avx2"), always_inline))
+inline void ClassifyAvx2(const uint8_t *lpBlock, BlockMasks &stMasks)
+{
+    const __m256i vQuote = _mm256_set1_epi8('"');
+    const __m256i vBackslash = _mm256_set1_epi8('\\');
+    const __m256i vSpace = _mm256_set1_epi8(' ');
+    const __m256i vTab = _mm256_set1_epi8('\t');
+    const __m256i vLf = _mm256_set1_epi8('\n');
+    const __m256i vCr = _mm256_set1_epi8('\r');
+    const __m256i vCase = _mm256_set1_epi8(0x20);
+    const __m256i vOpenBrace = _mm256_set1_epi8('{');  // '[' | 0x20
+    const __m256i vCloseBrace = _mm256_set1_epi8('}'); // ']' | 0x20
+    const __m256i vColon = _mm256_set1_epi8(':');
+    const __m256i vComma = _mm256_set1_epi8(',');
+    const __m256i vControl = _mm256_set1_epi8(0x1F);
+
+    uint64_t szMasks[5][2];
+    for (int i = 0; i < 2; i++)
+    {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lpBlock + i * 32));
+        auto vFolded = _mm256_or_si256(v, vCase);
+        auto vWs = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, vSpace), _mm256_cmpeq_epi8(v, vTab)),
+                                   _mm256_or_si256(_mm256_cmpeq_epi8(v, vLf), _mm256_cmpeq_epi8(v, vCr)));
+        auto vOp = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(vFolded, vOpenBrace), _mm256_cmpeq_epi8(vFolded, vCloseBrace)),
+                                   _mm256_or_si256(_mm256_cmpeq_epi8(v, vColon), _mm256_cmpeq_epi8(v, vComma)));
+        szMasks[0][i] = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, vQuote)));
+        szMasks[1][i] = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, vBackslash)));
+        szMasks[2][i] = uint32_t(_mm256_movemask_epi8(vWs));
+        szMasks[3][i] = uint32_t(_mm256_movemask_epi8(vOp));
+        // v <= 0x1F, unsigned
+        szMasks[4][i] = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(v, vControl), v)));
+    }
+
+    stMasks.uQuote = szMasks[0][0] | (szMasks[0][1] << 32);
+    stMasks.uBackslash = szMasks[1][0] | (szMasks[1][1] << 32);
+    stMasks.uSpace = szMasks[2][0] | (szMasks[2][1] << 32);
+    stMasks.uOperator = szMasks[3][0] | (szMasks[3][1] << 32);
+    stMasks.uControl = szMasks[4][0] | (szMasks[4][1] << 32);
+}
+
+__attribute__((target("sse4.2"), always_inline))
+inline void ClassifySse42(const uint8_t *lpBlock, BlockMasks &stMasks)
+{
+    const __m128i vQuote = _mm_set1_epi8('"');
+    const __m128i vBackslash = _mm_set1_epi8('\\');
+    const __m128i vSpace = _mm_set1_epi8(' ');
+    const __m128i vTab = _mm_set1_epi8('\t');
+    const __m128i vLf = _mm_set1_epi8('\n');
+    const __m128i vCr = _mm_set1_epi8('\r');
+    const __m128i vCase = _mm_set1_epi8(0x20);
+    const __m128i vOpenBrace = _mm_set1_epi8('{');
+    const __m128i vCloseBrace = _mm_set1_epi8('}');
+    const __m128i vColon = _mm_set1_epi8(':');
+    const __m128i vComma = _mm_set1_epi8(',');
+    const __m128i vControl = _mm_set1_epi8(0x1F);
+
+    uint64_t uQuote = 0, uBackslash = 0, uSpace = 0, uOperator = 0, uControl = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lpBlock + i * 16));
+        auto vFolded = _mm_or_si128(v, vCase);
+        auto vWs = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, vSpace), _mm_cmpeq_epi8(v, vTab)),
+                                _mm_or_si128(_mm_cmpeq_epi8(v, vLf), _mm_cmpeq_epi8(v, vCr)));
+        auto vOp = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(vFolded, vOpenBrace), _mm_cmpeq_epi8(vFolded, vCloseBrace)),
+                                _mm_or_si128(_mm_cmpeq_epi8(v, vColon), _mm_cmpeq_epi8(v, vComma)));
+        uQuote |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vQuote)))) << (i * 16);
+        uBackslash |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vBackslash)))) << (i * 16);
+        uSpace |= uint64_t(uint16_t(_mm_movemask_epi8(vWs))) << (i * 16);
+        uOperator |= uint64_t(uint16_t(_mm_movemask_epi8(vOp))) << (i * 16);
+        uControl |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(v, vControl), v)))) << (i * 16);
+    }
+
+    stMasks.uQuote = uQuote;
+    stMasks.uBackslash = uBackslash;
+    stMasks.uSpace = uSpace;
+    stMasks.uOperator = uOperator;
+    stMasks.uControl = uControl;
+}
+#endif
+
+inline uint64_t PrefixXor(uint64_t uBits)
+{
+    uBits ^= uBits << 1;
+    uBits ^= uBits << 2;
+    uBits ^= uBits << 4;
+    uBits ^= uBits << 8;
+    uBits ^= uBits << 16;
+    uBits ^= uBits << 32;
+    return uBits;
+}
+
+// Marks the characters preceded by an odd-length run of backslashes,
+// carrying an unfinished run over to the next block.
+inline uint64_t FindEscaped(uint64_t uBackslash, uint64_t &uPrevOddRun)
+{
+    uint64_t uStartEdges = uBackslash & ~(uBackslash << 1);
+    uint64_t uEvenStartMask = EvenBits ^ uPrevOddRun;
+    uint64_t uEvenStarts = uStartEdges & uEvenStartMask;
+    uint64_t uOddStarts = uStartEdges & ~uEvenStartMask;
+    uint64_t uEvenCarries = uBackslash + uEvenStarts;
+
+    uint64_t uOddCarries = uBackslash + uOddStarts;
+    bool bOddOverflow = uOddCarries < uBackslash;
+    uOddCarries |= uPrevOddRun;
+    uPrevOddRun = bOddOverflow ? 1 : 0;
+
+    uint64_t uEvenCarryEnds = uEvenCarries & ~uBackslash;
+    uint64_t uOddCarryEnds = uOddCarries & ~uBackslash;
+    return (uEvenCarryEnds & OddBits) | (uOddCarryEnds & EvenBits);
+}
+
+__attribute__((always_inline))
+inline uint64_t FindTokens(const BlockMasks &stMasks, ScanState &stState)
+{
+    uint64_t uEscaped = stMasks.uBackslash == 0 && stState.uPrevOddRun == 0
+                        ? 0 : FindEscaped(stMasks.uBackslash, stState.uPrevOddRun);
+    uint64_t uQuote = stMasks.uQuote & ~uEscaped;
+    uint64_t uInString = PrefixXor(uQuote) ^ stState.uPrevInString;
+    stState.uPrevInString = uint64_t(int64_t(uInString) >> 63);
+    stState.uControl |= stMasks.uControl & uInString;
+
+    uint64_t uScalar = ~(stMasks.uOperator | stMasks.uSpace | uQuote | uInString);
+    uint64_t uScalarStart = uScalar & ~((uScalar << 1) | stState.uPrevScalar);
+    stState.uPrevScalar = uScalar >> 63;
+
+    return (stMasks.uOperator & ~uInString) | uQuote | uScalarStart;
+}
+
+// Writes the offsets of the set bits four at a time instead of branching on
+// every bit; slots past the popcount are scratch and get overwritten later.
+__attribute__((always_inline))
+inline uint32_t *Flatten(uint32_t *lpIndex, uint32_t uOffset, uint64_t uBits)
+{
+    auto lpEnd = lpIndex + __builtin_popcountll(uBits);
+    while (uBits != 0)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            lpIndex[i] = uOffset + (uBits != 0 ? __builtin_ctzll(uBits) : 0);
+            uBits &= uBits - 1;
+        }
+        lpIndex += 4;
+    }
+
+    return lpEnd;
+}
+
+uint32_t *ScanScalar(const uint8_t *lpBlock, uint64_t uBlocks, uint32_t uOffset,
+                     uint32_t *lpIndex, ScanState &stState)
+{
+    BlockMasks stMasks;
+    for (uint64_t i = 0; i < uBlocks; i++, lpBlock += BlockSize, uOffset += BlockSize)
+    {
+        ClassifyScalar(lpBlock, stMasks);
+        lpIndex = Flatten(lpIndex, uOffset, FindTokens(stMasks, stState));
+    }
+
+    return lpIndex;
+}
+
+#ifdef __JSON_SCANNER_X86__
+__attribute__((target("avx2,bmi,popcnt")))
+uint32_t *ScanAvx2(const uint8_t *lpBlock, uint64_t uBlocks, uint32_t uOffset,
+                   uint32_t *lpIndex, ScanState &stState)
+{
+    BlockMasks stMasks;
+    for (uint64_t i = 0; i < uBlocks; i++, lpBlock += BlockSize, uOffset += BlockSize)
+    {
+        ClassifyAvx2(lpBlock, stMasks);
+        lpIndex = Flatten(lpIndex, uOffset, FindTokens(stMasks, stState));
+    }
+
+    return lpIndex;
+}
+
+__attribute__((target("sse4.2,popcnt")))
+uint32_t *ScanSse42(const uint8_t *lpBlock, uint64_t uBlocks, uint32_t uOffset,
+                    uint32_t *lpIndex, ScanState &stState)
+{
+    BlockMasks stMasks;
+    for (uint64_t i = 0; i < uBlocks; i++, lpBlock += BlockSize, uOffset += BlockSize)
+    {
+        ClassifySse42(lpBlock, stMasks);
+        lpIndex = Flatten(lpIndex, uOffset, FindTokens(stMasks, stState));
+    }
+
+    return lpIndex;
+}
+#endif
+
+ScanFunc SelectKernel()
+{
+#ifdef __JSON_SCANNER_X86__
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi"))
+    {
+        return ScanAvx2;
+    }
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt"))
+    {
+        return ScanSse42;
+    }
+#endif
+    return ScanScalar;
+}
+
+const ScanFunc g_lpScanKernel = SelectKernel();
+
+}
+
+CJsonScanner::~CJsonScanner()
+{
+    free(m_lpIndex);
+}
+
+int32_t CJsonScanner::Reserve(uint64_t uCount)
+{
+    if (likely(uCount <= m_uCapacity))
+    {
+        return 0;
+    }
+
+    uint64_t uCapacity = m_uCapacity == 0 ? 1024 : m_uCapacity;
+    while (uCapacity < uCount)
+    {
+        uCapacity *= 2;
+    }
+
+    auto lpIndex = reinterpret_cast<uint32_t *>(realloc(m_lpIndex, uCapacity * sizeof(uint32_t)));
+    if (unlikely(lpIndex == nullptr))
+    {
+        return MallocFailed;
+    }
+
+    m_lpIndex = lpIndex;
+    m_uCapacity = uCapacity;
+    return 0;
+}
+
+int32_t CJsonScanner::Scan(const char *lpContent, uint64_t uLen)
+{
+    auto iErrorNo = Begin(lpContent, uLen);
+    while (iErrorNo == 0 && !IsFinished())
+    {
+        iErrorNo = ScanNext(0);
+    }
+
+    return iErrorNo;
+}
+
+int32_t CJsonScanner::Begin(const char *lpContent, uint64_t uLen)
+{
+    m_uCount = 0;
+    m_lpContent = lpContent;
+    m_uLen = 0;
+    m_uOffset = 0;
+    m_stState = ScanState{0, 0, 0, 0};
+    if (unlikely(lpContent == nullptr || uLen >= UINT32_MAX))
+    {
+        return InvaliadParam;
+    }
+
+    m_uLen = uLen;
+    return 0;
+}
+
+int32_t CJsonScanner::ScanNext(uint32_t uConsumed)
+{
+    if (uConsumed > 0)
+    {
+        uConsumed = uConsumed < m_uCount ? uConsumed : m_uCount;
+        memmove(m_lpIndex, m_lpIndex + uConsumed, (m_uCount - uConsumed) * sizeof(uint32_t));
+        m_uCount -= uConsumed;
+    }
+
+    if (IsFinished())
+    {
+        return 0;
+    }
+
+    auto lpContentBytes = reinterpret_cast<const uint8_t *>(m_lpContent);
+    uint64_t uFullLen = m_uLen & ~(BlockSize - 1);
+
+    // the index is grown a window at a time: a block never yields more
+    // tokens than bytes, plus the scratch slots Flatten writes past the end
+    if (m_uOffset < uFullLen)
+    {
+        uint64_t uWindow = uFullLen - m_uOffset < ScanWindow ? uFullLen - m_uOffset : ScanWindow;
+        if (unlikely(Reserve(m_uCount + uWindow + 4) != 0))
+        {
+            return MallocFailed;
+        }
+
+        auto lpEnd = g_lpScanKernel(lpContentBytes + m_uOffset, uWindow / BlockSize, uint32_t(m_uOffset),
+                                    m_lpIndex + m_uCount, m_stState);
+        m_uCount = uint32_t(lpEnd - m_lpIndex);
+        m_uOffset += uWindow;
+    }
+    else
+    {
+        uint8_t szTail[BlockSize];
+        memset(szTail, ' ', sizeof(szTail));
+        memcpy(szTail, lpContentBytes + uFullLen, m_uLen - uFullLen);
+        if (unlikely(Reserve(m_uCount + BlockSize + 4) != 0))
+        {
+            return MallocFailed;
+        }
+
+        auto lpEnd = g_lpScanKernel(szTail, 1, uint32_t(uFullLen), m_lpIndex + m_uCount, m_stState);
+        m_uCount = uint32_t(lpEnd - m_lpIndex);
+        m_uOffset = m_uLen;
+    }
+
+    // a control byte in a string, or an unterminated string that
+    // swallowed the rest of the input
+    if (unlikely(m_stState.uControl != 0 || (IsFinished() && m_stState.uPrevInString != 0)))
+    {
+        return ParseDataFialed;
+    }
+
+    return 0;
+}
+
+}
@@ -0,0 +1,75 @@
+#ifndef __JSON_SCANNER_H_
+#define __JSON_SCANNER_H_
+
+#include <os_common.h>
+
+namespace cppbase
+{
+
+/*
+ * Stage one of the json parser.
+ *
+ * The scanner classifies the input 64 bytes at a time (AVX2, SSE4.2 or
+ * scalar, selected at runtime) and records the offset of every token the
+ * tree builder has to visit: the structural characters {}[]:, outside of
+ * strings, both quotes of every string and the first byte of every
+ * number/true/false/null. Whitespace and string contents are never
+ * touched again by the tree builder, so the scanner also rejects the
+ * control bytes below 0x20 that json does not allow unescaped in strings.
+ * It is exported from the library only for the benchmark.
+ */
+class EXPORT CJsonScanner
+{
+public:
+    // what the block kernels carry from one 64-byte block to the next
+    struct ScanState
+    {
+        uint64_t uPrevInString;
+        uint64_t uPrevOddRun;
+        uint64_t uPrevScalar;
+        uint64_t uControl; // control bytes seen inside strings
+    };
+
+    CJsonScanner() = default;
+    ~CJsonScanner();
+
+    CJsonScanner(const CJsonScanner &) = delete;
+    CJsonScanner &operator=(const CJsonScanner &) = delete;
+
+    // indexes the whole input at once
+    int32_t Scan(const char *lpContent, uint64_t uLen);
+
+    // Incremental use keeps the index to about one window of tokens: after
+    // Begin, every ScanNext drops the first uConsumed tokens and appends
+    // those of the next window. Offsets stay relative to lpContent.
+    int32_t Begin(const char *lpContent, uint64_t uLen);
+    int32_t ScanNext(uint32_t uConsumed);
+    inline bool IsFinished() const { return m_uOffset >= m_uLen; }
+
+    inline const uint32_t *GetIndex() const { return m_lpIndex; }
+    inline uint32_t GetCount() const { return m_uCount; }
+
+    // the bytes that end a number or a literal
+    static inline bool IsDelimiter(char ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == ',' || ch == ':' || ch == '"'
+               || ch == '{' || ch == '}' || ch == '[' || ch == ']';
+    }
+
+private:
+    int32_t Reserve(uint64_t uCount);
+
+private:
+    uint32_t *m_lpIndex{nullptr};
+    uint32_t m_uCount{0};
+    uint64_t m_uCapacity{0};
+
+    const char *m_lpContent{nullptr};
+    uint64_t m_uLen{0};
+    uint64_t m_uOffset{0};
+    ScanState m_stState{0, 0, 0, 0};
+};
+
+}
+
+#endif //__JSON_SCANNER_H_
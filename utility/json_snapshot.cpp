@@ -0,0 +1,1232 @@
+#include "json_snapshot.h"
+#include "json_writer.h"
+#include "json_binary.h"
+#include <error_no.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cppbase
+{
+
+namespace
+{
+
+const char SnapshotMagic[8] = {'C', 'B', 'J', 'S', 'N', 'A', 'P', '\0'};
+
+inline uint64_t MakeWord(IJsonObj::ObjType eType, uint64_t uPayload)
+{
+    return (uint64_t(eType) << CJsonSnapshotNode::TypeShift) | uPayload;
+}
+
+inline double GetDouble(const uint64_t *lpValue)
+{
+    double dValue;
+    memcpy(&dValue, lpValue + 1, sizeof(dValue));
+    return dValue;
+}
+
+// objects tag their members with the low half of the key hash, as the
+// parsed documents do
+inline uint32_t HashTag(uint64_t uHash)
+{
+    return uint32_t(uHash);
+}
+
+int32_t WriteAll(int iFd, const void *lpData, uint64_t uLen, off_t nOffset = -1)
+{
+    auto lpCur = reinterpret_cast<const char *>(lpData);
+    while (uLen > 0)
+    {
+        auto nWritten = nOffset < 0 ? write(iFd, lpCur, uLen) : pwrite(iFd, lpCur, uLen, nOffset);
+        if (nWritten < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return SysCallFailed;
+        }
+
+        lpCur += nWritten;
+        uLen -= uint64_t(nWritten);
+        nOffset = nOffset < 0 ? nOffset : nOffset + nWritten;
+    }
+
+    return 0;
+}
+
+// streams the values to the file as they are produced, keeping the index
+// and the strings, which follow them, in memory until the end; without a
+// file the values are kept too, for Layout
+class CJsonSnapshotWriter
+{
+public:
+    using ObjType = IJsonObj::ObjType;
+
+    // the values are written out in pieces of this many words
+    static constexpr uint64_t FlushWords = 64 * 1024;
+
+    explicit CJsonSnapshotWriter(int iFd = -1) : m_iFd(iFd) {}
+
+    int32_t Write(IJsonObj *lpRoot);
+
+    // what Write would put in the file, in *lpBlock of *lpLen bytes
+    // allocated with malloc
+    int32_t Layout(IJsonObj *lpRoot, char **lpBlock, uint64_t *lpLen);
+
+private:
+    void FillHeader(JsonSnapshotHeader &stHeader) const;
+    int32_t AddWords(uint64_t uFirst, uint64_t uSecond, uint32_t uCount);
+    int32_t AddString(const char *lpStr, uint32_t uLen, bool bKey);
+    int32_t AddValue(const IJsonObj::KvItem &stItem);
+    int32_t AddContainer(IJsonObj *lpObj);
+
+private:
+    int m_iFd;
+    std::vector<uint64_t> m_vecValues; // not written out yet
+    uint64_t m_uValueWords{0};
+    std::vector<uint64_t> m_vecIndex;
+    std::string m_strStrings;
+    std::unordered_map<std::string, uint64_t> m_mapKeys;
+    uint64_t m_uContainers{0};
+};
+
+int32_t CJsonSnapshotWriter::AddWords(uint64_t uFirst, uint64_t uSecond, uint32_t uCount)
+{
+    m_vecValues.push_back(uFirst);
+    if (uCount > 1)
+    {
+        m_vecValues.push_back(uSecond);
+    }
+    m_uValueWords += uCount;
+
+    if (m_iFd < 0 || m_vecValues.size() < FlushWords)
+    {
+        return 0;
+    }
+
+    auto iErrorNo = WriteAll(m_iFd, m_vecValues.data(), m_vecValues.size() * sizeof(uint64_t));
+    m_vecValues.clear();
+    return iErrorNo;
+}
+
+int32_t CJsonSnapshotWriter::AddString(const char *lpStr, uint32_t uLen, bool bKey)
+{
+    // the same few keys come back in every record of a large document
+    uint64_t uOffset = m_strStrings.size();
+    bool bStored = false;
+    if (bKey)
+    {
+        auto pair = m_mapKeys.emplace(std::string(lpStr, uLen), uOffset);
+        uOffset = pair.first->second;
+        bStored = !pair.second;
+    }
+    if (!bStored)
+    {
+        m_strStrings.append(lpStr, uLen);
+        m_strStrings.push_back('\0');
+    }
+
+    return AddWords(MakeWord(ObjType::String, uLen), uOffset, 2);
+}
+
+int32_t CJsonSnapshotWriter::AddValue(const IJsonObj::KvItem &stItem)
+{
+    uint64_t uBits = 0;
+    switch (stItem.eType)
+    {
+        case ObjType::Null:
+            return AddWords(MakeWord(ObjType::Null, 0), 0, 1);
+
+        case ObjType::Boolean:
+            return AddWords(MakeWord(ObjType::Boolean, stItem.bValue ? 1 : 0), 0, 1);
+
+        case ObjType::Integer:
+            return AddWords(MakeWord(ObjType::Integer, 0), uint64_t(stItem.nValue), 2);
+
+        case ObjType::Double:
+            memcpy(&uBits, &stItem.dValue, sizeof(uBits));
+            return AddWords(MakeWord(ObjType::Double, 0), uBits, 2);
+
+        case ObjType::String:
+            return AddString(stItem.strValue, uint32_t(strlen(stItem.strValue)), false);
+
+        case ObjType::Array:
+            return AddContainer(stItem.lpArray);
+
+        case ObjType::Object:
+            return AddContainer(stItem.lpObj);
+
+        default:
+            return InvaliadCall;
+    }
+}
+
+int32_t CJsonSnapshotWriter::AddContainer(IJsonObj *lpObj)
+{
+    auto eType = lpObj->GetType();
+    if (eType != ObjType::Array && eType != ObjType::Object)
+    {
+        return InvaliadCall;
+    }
+
+    // the table is placed before the members are written, so the container
+    // word can point at it
+    bool bObject = eType == ObjType::Object;
+    uint32_t uCount = lpObj->GetSize();
+    uint64_t uTable = m_vecIndex.size();
+    m_vecIndex.resize(uTable + uint64_t(uCount) * (bObject ? 2 : 1));
+    auto iErrorNo = AddWords(MakeWord(eType, uCount), uTable, 2);
+    if (iErrorNo == 0)
+    {
+        iErrorNo = AddWords(m_uContainers++, 0, 1);
+    }
+
+    uint32_t uWritten = 0;
+    IJsonObj::Cursor stCursor;
+    IJsonObj::KvItem stItem;
+    for (bool bMore = iErrorNo == 0 && lpObj->First(&stCursor, &stItem); bMore; bMore = lpObj->Next(&stCursor, &stItem))
+    {
+        if (uWritten == uCount)
+        {
+            return ParseDataFialed;
+        }
+
+        m_vecIndex[uTable + uWritten] = m_uValueWords;
+        if (bObject)
+        {
+            auto uKeyLen = uint32_t(strlen(stItem.lpKey));
+            auto uTag = HashTag(IJsonObj::Key::Hash(stItem.lpKey, uKeyLen));
+            m_vecIndex[uTable + uCount + uWritten] = (uint64_t(uTag) << 32) | uWritten;
+            iErrorNo = AddString(stItem.lpKey, uKeyLen, true);
+        }
+        if (iErrorNo == 0)
+        {
+            iErrorNo = AddValue(stItem);
+        }
+        if (iErrorNo != 0)
+        {
+            return iErrorNo;
+        }
+        uWritten++;
+    }
+
+    if (iErrorNo == 0 && uWritten != uCount)
+    {
+        return ParseDataFialed;
+    }
+
+    // by tag, then by number, so that the first of equal keys is found first
+    if (bObject)
+    {
+        auto itBegin = m_vecIndex.begin() + (uTable + uCount);
+        std::sort(itBegin, itBegin + uCount);
+    }
+
+    return iErrorNo;
+}
+
+int32_t CJsonSnapshotWriter::Write(IJsonObj *lpRoot)
+{
+    JsonSnapshotHeader stHeader;
+    memset(&stHeader, 0, sizeof(stHeader));
+    auto iErrorNo = WriteAll(m_iFd, &stHeader, sizeof(stHeader));
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    try
+    {
+        m_vecValues.reserve(FlushWords);
+        iErrorNo = AddContainer(lpRoot);
+    }
+    catch (...)
+    {
+        return MallocFailed;
+    }
+
+    if (iErrorNo == 0)
+    {
+        iErrorNo = WriteAll(m_iFd, m_vecValues.data(), m_vecValues.size() * sizeof(uint64_t));
+    }
+    if (iErrorNo == 0)
+    {
+        iErrorNo = WriteAll(m_iFd, m_vecIndex.data(), m_vecIndex.size() * sizeof(uint64_t));
+    }
+    if (iErrorNo == 0)
+    {
+        iErrorNo = WriteAll(m_iFd, m_strStrings.data(), m_strStrings.size());
+    }
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    // the header goes last, so that a file cut short never looks complete
+    FillHeader(stHeader);
+    return WriteAll(m_iFd, &stHeader, sizeof(stHeader), 0);
+}
+
+int32_t CJsonSnapshotWriter::Layout(IJsonObj *lpRoot, char **lpBlock, uint64_t *lpLen)
+{
+    int32_t iErrorNo = 0;
+    try
+    {
+        iErrorNo = AddContainer(lpRoot);
+    }
+    catch (...)
+    {
+        return MallocFailed;
+    }
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    JsonSnapshotHeader stHeader;
+    FillHeader(stHeader);
+    auto uValueBytes = m_vecValues.size() * sizeof(uint64_t);
+    auto uIndexBytes = m_vecIndex.size() * sizeof(uint64_t);
+    auto uLen = sizeof(stHeader) + uValueBytes + uIndexBytes + m_strStrings.size();
+    auto lpCur = reinterpret_cast<char *>(malloc(uLen));
+    if (unlikely(lpCur == nullptr))
+    {
+        return MallocFailed;
+    }
+
+    *lpBlock = lpCur;
+    *lpLen = uLen;
+    memcpy(lpCur, &stHeader, sizeof(stHeader));
+    lpCur += sizeof(stHeader);
+    memcpy(lpCur, m_vecValues.data(), uValueBytes);
+    lpCur += uValueBytes;
+    memcpy(lpCur, m_vecIndex.data(), uIndexBytes);
+    lpCur += uIndexBytes;
+    memcpy(lpCur, m_strStrings.data(), m_strStrings.size());
+    return 0;
+}
+
+void CJsonSnapshotWriter::FillHeader(JsonSnapshotHeader &stHeader) const
+{
+    memset(&stHeader, 0, sizeof(stHeader));
+    memcpy(stHeader.szMagic, SnapshotMagic, sizeof(stHeader.szMagic));
+    stHeader.uByteOrder = JsonSnapshotHeader::ByteOrderMark;
+    stHeader.uVersion = JsonSnapshotHeader::CurrentVersion;
+    stHeader.uValueWords = m_uValueWords;
+    stHeader.uIndexWords = m_vecIndex.size();
+    stHeader.uStrBytes = m_strStrings.size();
+    stHeader.uContainers = m_uContainers;
+}
+
+}
+
+int32_t SaveJsonSnapshot(IJsonObj *lpObj, const char *lpFile)
+{
+    if (unlikely(lpFile == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    // written next to lpFile and renamed over it once complete
+    std::string strTemp;
+    try
+    {
+        strTemp = std::string(lpFile) + ".XXXXXX";
+    }
+    catch (...)
+    {
+        return MallocFailed;
+    }
+
+    auto iFd = mkstemp(&strTemp[0]);
+    if (iFd < 0)
+    {
+        return OpenFileFailed;
+    }
+
+    auto iErrorNo = CJsonSnapshotWriter(iFd).Write(lpObj);
+    if (iErrorNo == 0 && (fchmod(iFd, 0644) != 0 || fsync(iFd) != 0))
+    {
+        iErrorNo = SysCallFailed;
+    }
+    close(iFd);
+
+    if (iErrorNo == 0 && rename(strTemp.c_str(), lpFile) != 0)
+    {
+        iErrorNo = SysCallFailed;
+    }
+    if (iErrorNo != 0)
+    {
+        unlink(strTemp.c_str());
+    }
+
+    return iErrorNo;
+}
+
+IJsonObj *FreezeJsonObject(IJsonObj *lpObj)
+{
+    auto lpDoc = NEW CJsonSnapshotDoc();
+    if (lpDoc != nullptr && lpDoc->OpenFrozen(lpObj) != 0)
+    {
+        delete lpDoc;
+        lpDoc = nullptr;
+    }
+
+    return lpDoc;
+}
+
+int32_t CJsonSnapshotNode::Init(ObjType eType)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotNode::OpenFromFile(const char *lpFile)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotNode::OpenFromBuffer(const char *lpBuffer)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotNode::OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotNode::OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotNode::OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotNode::OpenSnapshot(const char *lpFile)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotNode::Clear()
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotNode::AddNull(const char *lpKey)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotNode::AddBool(const char *lpKey, bool bValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotNode::AddInt(const char *lpKey, int64_t nValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotNode::AddDouble(const char *lpKey, double dValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotNode::AddString(const char *lpKey, const char *lpValue)
+{
+    return InvaliadCall;
+}
+
+IJsonObj *CJsonSnapshotNode::AddArray(const char *lpKey)
+{
+    return nullptr;
+}
+
+IJsonObj *CJsonSnapshotNode::AddObject(const char *lpKey)
+{
+    return nullptr;
+}
+
+const uint64_t *CJsonSnapshotNode::FindValue(const Key &stKey) const
+{
+    if (unlikely(stKey.lpKey == nullptr || GetType(m_lpValue) != ObjType::Object))
+    {
+        return nullptr;
+    }
+
+    // the first entry of the tag, then the keys of every entry sharing it
+    auto uCount = GetCount();
+    auto lpTable = m_lpDoc->GetTable(m_lpValue);
+    auto lpTags = lpTable + uCount;
+    auto uTag = uint64_t(HashTag(stKey.uHash)) << 32;
+    auto lpEntry = std::lower_bound(lpTags, lpTags + uCount, uTag);
+    for (; lpEntry != lpTags + uCount && (*lpEntry & ~uint64_t(UINT32_MAX)) == uTag; lpEntry++)
+    {
+        auto lpKey = m_lpDoc->m_lpValues + lpTable[uint32_t(*lpEntry)];
+        if (m_lpDoc->GetStrLen(lpKey) == stKey.uLen && memcmp(m_lpDoc->GetStr(lpKey), stKey.lpKey, stKey.uLen) == 0)
+        {
+            return lpKey + 2;
+        }
+    }
+
+    return nullptr;
+}
+
+const uint64_t *CJsonSnapshotNode::GetMember(uint32_t uIndex, const uint64_t *&lpKey) const
+{
+    if (uIndex >= GetCount())
+    {
+        return nullptr;
+    }
+
+    auto lpMember = m_lpDoc->m_lpValues + m_lpDoc->GetTable(m_lpValue)[uIndex];
+    bool bObject = GetType(m_lpValue) == ObjType::Object;
+    lpKey = bObject ? lpMember : nullptr;
+    return lpMember + (bObject ? 2 : 0);
+}
+
+bool CJsonSnapshotNode::GetNull(const char *lpKey)
+{
+    return CJsonSnapshotNode::GetNull(Key(lpKey));
+}
+
+bool CJsonSnapshotNode::GetBool(const char *lpKey, bool bDefaultValue)
+{
+    return CJsonSnapshotNode::GetBool(Key(lpKey), bDefaultValue);
+}
+
+int64_t CJsonSnapshotNode::GetInt(const char *lpKey, int64_t nDefaultValue)
+{
+    return CJsonSnapshotNode::GetInt(Key(lpKey), nDefaultValue);
+}
+
+double CJsonSnapshotNode::GetDouble(const char *lpKey, double dDefaultValue)
+{
+    return CJsonSnapshotNode::GetDouble(Key(lpKey), dDefaultValue);
+}
+
+const char *CJsonSnapshotNode::GetString(const char *lpKey, const char *lpDefaultValue)
+{
+    return CJsonSnapshotNode::GetString(Key(lpKey), lpDefaultValue);
+}
+
+IJsonObj *CJsonSnapshotNode::GetArray(const char *lpKey)
+{
+    return CJsonSnapshotNode::GetArray(Key(lpKey));
+}
+
+IJsonObj *CJsonSnapshotNode::GetObject(const char *lpKey)
+{
+    return CJsonSnapshotNode::GetObject(Key(lpKey));
+}
+
+bool CJsonSnapshotNode::IsExist(const char *lpKey)
+{
+    return CJsonSnapshotNode::IsExist(Key(lpKey));
+}
+
+bool CJsonSnapshotNode::GetNull(const Key &stKey)
+{
+    auto lpValue = FindValue(stKey);
+    return lpValue != nullptr && GetType(lpValue) == ObjType::Null;
+}
+
+bool CJsonSnapshotNode::GetBool(const Key &stKey, bool bDefaultValue)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && GetType(lpValue) == ObjType::Boolean))
+    {
+        return (*lpValue & 1) != 0;
+    }
+
+    return bDefaultValue;
+}
+
+int64_t CJsonSnapshotNode::GetInt(const Key &stKey, int64_t nDefaultValue)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && GetType(lpValue) == ObjType::Integer))
+    {
+        return int64_t(lpValue[1]);
+    }
+
+    return nDefaultValue;
+}
+
+double CJsonSnapshotNode::GetDouble(const Key &stKey, double dDefaultValue)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && GetType(lpValue) == ObjType::Double))
+    {
+        return cppbase::GetDouble(lpValue);
+    }
+
+    return dDefaultValue;
+}
+
+const char *CJsonSnapshotNode::GetString(const Key &stKey, const char *lpDefaultValue)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && GetType(lpValue) == ObjType::String))
+    {
+        return m_lpDoc->GetStr(lpValue);
+    }
+
+    return lpDefaultValue;
+}
+
+IJsonObj *CJsonSnapshotNode::GetArray(const Key &stKey)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && GetType(lpValue) == ObjType::Array))
+    {
+        return m_lpDoc->GetNode(lpValue);
+    }
+
+    return nullptr;
+}
+
+IJsonObj *CJsonSnapshotNode::GetObject(const Key &stKey)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && GetType(lpValue) == ObjType::Object))
+    {
+        return m_lpDoc->GetNode(lpValue);
+    }
+
+    return nullptr;
+}
+
+bool CJsonSnapshotNode::IsExist(const Key &stKey)
+{
+    return FindValue(stKey) != nullptr;
+}
+
+IJsonObj::ObjType CJsonSnapshotNode::GetType()
+{
+    return GetType(m_lpValue);
+}
+
+uint32_t CJsonSnapshotNode::GetSize()
+{
+    return GetCount();
+}
+
+IJsonObj::ObjType CJsonSnapshotNode::GetType(const char *lpKey)
+{
+    return CJsonSnapshotNode::GetType(Key(lpKey));
+}
+
+IJsonObj::ObjType CJsonSnapshotNode::GetType(const Key &stKey)
+{
+    auto lpValue = FindValue(stKey);
+    return lpValue != nullptr ? GetType(lpValue) : ObjType::Unknow;
+}
+
+IJsonObj::ObjType CJsonSnapshotNode::GetType(uint32_t uIndex)
+{
+    const uint64_t *lpKey = nullptr;
+    auto lpValue = GetMember(uIndex, lpKey);
+    return lpValue != nullptr ? GetType(lpValue) : ObjType::Unknow;
+}
+
+bool CJsonSnapshotNode::FillKvItem(const uint64_t *lpKey, const uint64_t *lpValue, KvItem *lpKvItem) const
+{
+    lpKvItem->eType = GetType(lpValue);
+    lpKvItem->lpKey = lpKey != nullptr ? m_lpDoc->GetStr(lpKey) : nullptr;
+    switch (lpKvItem->eType)
+    {
+        case ObjType::Null:
+            lpKvItem->IsNull = true;
+            return true;
+
+        case ObjType::Boolean:
+            lpKvItem->bValue = (*lpValue & 1) != 0;
+            return true;
+
+        case ObjType::Integer:
+            lpKvItem->nValue = int64_t(lpValue[1]);
+            return true;
+
+        case ObjType::Double:
+            lpKvItem->dValue = cppbase::GetDouble(lpValue);
+            return true;
+
+        case ObjType::String:
+            lpKvItem->strValue = m_lpDoc->GetStr(lpValue);
+            return true;
+
+        default:
+            lpKvItem->lpArray = m_lpDoc->GetNode(lpValue);
+            return lpKvItem->lpArray != nullptr;
+    }
+}
+
+int32_t CJsonSnapshotNode::GetItem(uint32_t uIndex, KvItem *lpKvItem)
+{
+    if (unlikely(lpKvItem == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    const uint64_t *lpKey = nullptr;
+    auto lpValue = GetMember(uIndex, lpKey);
+    if (unlikely(lpValue == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    return FillKvItem(lpKey, lpValue, lpKvItem) ? 0 : MallocFailed;
+}
+
+bool CJsonSnapshotNode::First(Cursor *lpCursor, KvItem *lpKvItem)
+{
+    static_assert(sizeof(CursorState) <= sizeof(Cursor::Reserve), "Cursor too small for CursorState");
+
+    if (unlikely(lpCursor == nullptr || lpKvItem == nullptr))
+    {
+        return false;
+    }
+
+    auto lpState = new(lpCursor->Reserve) CursorState{0};
+    const uint64_t *lpKey = nullptr;
+    auto lpValue = GetMember(lpState->uIndex, lpKey);
+    return lpValue != nullptr && FillKvItem(lpKey, lpValue, lpKvItem);
+}
+
+bool CJsonSnapshotNode::Next(Cursor *lpCursor, KvItem *lpKvItem)
+{
+    if (unlikely(lpCursor == nullptr || lpKvItem == nullptr))
+    {
+        return false;
+    }
+
+    auto lpState = reinterpret_cast<CursorState *>(lpCursor->Reserve);
+    if (lpState->uIndex >= GetCount())
+    {
+        return false;
+    }
+
+    const uint64_t *lpKey = nullptr;
+    auto lpValue = GetMember(++lpState->uIndex, lpKey);
+    return lpValue != nullptr && FillKvItem(lpKey, lpValue, lpKvItem);
+}
+
+const char *CJsonSnapshotNode::GetJsonStr(bool bPretty)
+{
+    return m_lpDoc->WriteJsonStr(m_lpValue, bPretty);
+}
+
+const char *CJsonSnapshotNode::GetBinary(BinaryFormat eFormat, uint64_t *lpLen)
+{
+    return m_lpDoc->WriteBinary(this, eFormat, lpLen);
+}
+
+int32_t CJsonSnapshotNode::SaveSnapshot(const char *lpFile)
+{
+    return SaveJsonSnapshot(this, lpFile);
+}
+
+IJsonObj *CJsonSnapshotNode::Freeze()
+{
+    return FreezeJsonObject(this);
+}
+
+CJsonSnapshotDoc::~CJsonSnapshotDoc()
+{
+    delete m_lpWriter;
+    free(m_lpNodes);
+    free(m_lpFrozen);
+}
+
+int32_t CJsonSnapshotDoc::Load(const char *lpContent, uint64_t uLen)
+{
+    // only the header is checked: the rest is trusted to be what
+    // SaveSnapshot wrote, or reading it would cost what mapping saves
+    JsonSnapshotHeader stHeader;
+    if (uLen < sizeof(stHeader))
+    {
+        return ParseDataFialed;
+    }
+
+    memcpy(&stHeader, lpContent, sizeof(stHeader));
+    uint64_t uWords = (uLen - sizeof(stHeader)) / sizeof(uint64_t);
+    if (memcmp(stHeader.szMagic, SnapshotMagic, sizeof(SnapshotMagic)) != 0
+        || stHeader.uByteOrder != JsonSnapshotHeader::ByteOrderMark
+        || stHeader.uVersion != JsonSnapshotHeader::CurrentVersion
+        || stHeader.uValueWords < CJsonSnapshotNode::ContainerWords || stHeader.uValueWords > uWords
+        || stHeader.uIndexWords > uWords - stHeader.uValueWords
+        || stHeader.uStrBytes != uLen - sizeof(stHeader) - (stHeader.uValueWords + stHeader.uIndexWords) * sizeof(uint64_t)
+        || stHeader.uContainers == 0)
+    {
+        return ParseDataFialed;
+    }
+
+    m_lpValues = reinterpret_cast<const uint64_t *>(lpContent + sizeof(stHeader));
+    m_lpIndex = m_lpValues + stHeader.uValueWords;
+    m_lpStrings = reinterpret_cast<const char *>(m_lpIndex + stHeader.uIndexWords);
+    auto eType = CJsonSnapshotNode::GetType(m_lpValues);
+    if (eType != ObjType::Array && eType != ObjType::Object)
+    {
+        return ParseDataFialed;
+    }
+
+    // large enough to come from fresh pages, which cost nothing until used
+    m_lpNodes = reinterpret_cast<CJsonSnapshotNode **>(calloc(stHeader.uContainers, sizeof(CJsonSnapshotNode *)));
+    m_uContainers = m_lpNodes != nullptr ? stHeader.uContainers : 0;
+    m_lpRoot = m_lpNodes != nullptr ? GetNode(m_lpValues) : nullptr;
+    return m_lpRoot != nullptr ? 0 : MallocFailed;
+}
+
+// the values are walked word by word: a key takes the two words of a
+// string, so members need no telling apart from the keys before them
+int32_t CJsonSnapshotDoc::MakeNodes()
+{
+    for (auto lpValue = m_lpValues; lpValue < m_lpIndex;)
+    {
+        switch (CJsonSnapshotNode::GetType(lpValue))
+        {
+            case ObjType::Null:
+            case ObjType::Boolean:
+                lpValue++;
+                break;
+
+            case ObjType::Integer:
+            case ObjType::Double:
+            case ObjType::String:
+                lpValue += 2;
+                break;
+
+            case ObjType::Array:
+            case ObjType::Object:
+                if (unlikely(GetNode(lpValue) == nullptr))
+                {
+                    return MallocFailed;
+                }
+                lpValue += CJsonSnapshotNode::ContainerWords;
+                break;
+
+            default:
+                return ParseDataFialed;
+        }
+    }
+
+    return 0;
+}
+
+void CJsonSnapshotDoc::Reset()
+{
+    m_file.Close();
+    free(m_lpFrozen);
+    m_lpFrozen = nullptr;
+    free(m_lpNodes);
+    m_lpNodes = nullptr;
+    m_uContainers = 0;
+    m_arena.Reset();
+    m_lpRoot = nullptr;
+}
+
+CJsonSnapshotNode *CJsonSnapshotDoc::GetNode(const uint64_t *lpValue)
+{
+    auto uId = lpValue[2];
+    if (unlikely(uId >= m_uContainers))
+    {
+        return nullptr;
+    }
+
+    if (m_lpNodes[uId] == nullptr)
+    {
+        auto lpMem = m_arena.Alloc(sizeof(CJsonSnapshotNode));
+        m_lpNodes[uId] = lpMem != nullptr ? new(lpMem) CJsonSnapshotNode(this, lpValue) : nullptr;
+    }
+
+    return m_lpNodes[uId];
+}
+
+int32_t CJsonSnapshotDoc::WriteValue(CJsonWriter &writer, const uint64_t *lpValue, bool bPretty, uint32_t uDepth)
+{
+    auto eType = CJsonSnapshotNode::GetType(lpValue);
+    switch (eType)
+    {
+        case ObjType::Null:
+            return writer.WriteNull();
+
+        case ObjType::Boolean:
+            return writer.WriteBool((*lpValue & 1) != 0);
+
+        case ObjType::Integer:
+            return writer.WriteInt(int64_t(lpValue[1]));
+
+        case ObjType::Double:
+            return writer.WriteDouble(cppbase::GetDouble(lpValue));
+
+        case ObjType::String:
+            return writer.WriteString(GetStr(lpValue), GetStrLen(lpValue));
+
+        default:
+            break;
+    }
+
+    bool bObject = eType == ObjType::Object;
+    auto uCount = uint32_t(*lpValue & CJsonSnapshotNode::PayloadMask);
+    auto lpTable = GetTable(lpValue);
+    auto iErrorNo = writer.WriteChar(bObject ? '{' : '[');
+    for (uint32_t i = 0; i < uCount && iErrorNo == 0; i++)
+    {
+        auto lpMember = m_lpValues + lpTable[i];
+        if (i > 0)
+        {
+            iErrorNo = writer.WriteChar(',');
+        }
+        if (iErrorNo == 0 && bPretty)
+        {
+            iErrorNo = writer.WriteIndent(uDepth + 1);
+        }
+        if (iErrorNo == 0 && bObject)
+        {
+            iErrorNo = writer.WriteString(GetStr(lpMember), GetStrLen(lpMember));
+            if (iErrorNo == 0)
+            {
+                iErrorNo = bPretty ? writer.WriteRaw(": ", 2) : writer.WriteChar(':');
+            }
+            lpMember += 2;
+        }
+        if (iErrorNo == 0)
+        {
+            iErrorNo = WriteValue(writer, lpMember, bPretty, uDepth + 1);
+        }
+    }
+
+    if (iErrorNo == 0 && bPretty && uCount > 0)
+    {
+        iErrorNo = writer.WriteIndent(uDepth);
+    }
+
+    return iErrorNo == 0 ? writer.WriteChar(bObject ? '}' : ']') : iErrorNo;
+}
+
+CJsonWriter *CJsonSnapshotDoc::GetWriter()
+{
+    if (m_lpWriter == nullptr)
+    {
+        m_lpWriter = NEW CJsonWriter();
+        if (m_lpWriter == nullptr)
+        {
+            return nullptr;
+        }
+    }
+
+    m_lpWriter->Clear();
+    return m_lpWriter;
+}
+
+const char *CJsonSnapshotDoc::WriteJsonStr(const uint64_t *lpValue, bool bPretty)
+{
+    auto lpWriter = GetWriter();
+    if (lpWriter == nullptr || WriteValue(*lpWriter, lpValue, bPretty, 0) != 0)
+    {
+        return nullptr;
+    }
+
+    return lpWriter->GetStr();
+}
+
+const char *CJsonSnapshotDoc::WriteBinary(IJsonObj *lpNode, BinaryFormat eFormat, uint64_t *lpLen)
+{
+    auto lpWriter = lpLen != nullptr ? GetWriter() : nullptr;
+    if (lpWriter == nullptr || CJsonBinaryWriter(*lpWriter, eFormat).WriteNode(lpNode) != 0)
+    {
+        return nullptr;
+    }
+
+    *lpLen = lpWriter->GetSize();
+    return lpWriter->GetData();
+}
+
+int32_t CJsonSnapshotDoc::Init(ObjType eType)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotDoc::OpenFromFile(const char *lpFile)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotDoc::OpenFromBuffer(const char *lpBuffer)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotDoc::OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotDoc::OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotDoc::OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotDoc::OpenSnapshot(const char *lpFile)
+{
+    if (unlikely(lpFile == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    if (m_lpRoot != nullptr)
+    {
+        return InvaliadCall;
+    }
+
+    auto iErrorNo = m_file.Open(lpFile, true);
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    iErrorNo = Load(m_file.GetContent(), m_file.GetLen());
+    if (iErrorNo != 0)
+    {
+        Reset();
+    }
+
+    return iErrorNo;
+}
+
+int32_t CJsonSnapshotDoc::OpenFrozen(IJsonObj *lpObj)
+{
+    if (unlikely(lpObj == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    if (m_lpRoot != nullptr)
+    {
+        return InvaliadCall;
+    }
+
+    uint64_t uLen = 0;
+    auto iErrorNo = CJsonSnapshotWriter().Layout(lpObj, &m_lpFrozen, &uLen);
+    if (iErrorNo == 0)
+    {
+        iErrorNo = Load(m_lpFrozen, uLen);
+    }
+    if (iErrorNo == 0)
+    {
+        iErrorNo = MakeNodes();
+    }
+    if (iErrorNo != 0)
+    {
+        Reset();
+    }
+
+    return iErrorNo;
+}
+
+int32_t CJsonSnapshotDoc::Clear()
+{
+    if (m_lpFrozen != nullptr)
+    {
+        return InvaliadCall;
+    }
+
+    Reset();
+    return 0;
+}
+
+int32_t CJsonSnapshotDoc::AddNull(const char *lpKey)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotDoc::AddBool(const char *lpKey, bool bValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotDoc::AddInt(const char *lpKey, int64_t nValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotDoc::AddDouble(const char *lpKey, double dValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonSnapshotDoc::AddString(const char *lpKey, const char *lpValue)
+{
+    return InvaliadCall;
+}
+
+IJsonObj *CJsonSnapshotDoc::AddArray(const char *lpKey)
+{
+    return nullptr;
+}
+
+IJsonObj *CJsonSnapshotDoc::AddObject(const char *lpKey)
+{
+    return nullptr;
+}
+
+bool CJsonSnapshotDoc::GetNull(const char *lpKey)
+{
+    return m_lpRoot != nullptr && m_lpRoot->GetNull(lpKey);
+}
+
+bool CJsonSnapshotDoc::GetBool(const char *lpKey, bool bDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetBool(lpKey, bDefaultValue) : bDefaultValue;
+}
+
+int64_t CJsonSnapshotDoc::GetInt(const char *lpKey, int64_t nDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetInt(lpKey, nDefaultValue) : nDefaultValue;
+}
+
+double CJsonSnapshotDoc::GetDouble(const char *lpKey, double dDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetDouble(lpKey, dDefaultValue) : dDefaultValue;
+}
+
+const char *CJsonSnapshotDoc::GetString(const char *lpKey, const char *lpDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetString(lpKey, lpDefaultValue) : lpDefaultValue;
+}
+
+IJsonObj *CJsonSnapshotDoc::GetArray(const char *lpKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetArray(lpKey) : nullptr;
+}
+
+IJsonObj *CJsonSnapshotDoc::GetObject(const char *lpKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetObject(lpKey) : nullptr;
+}
+
+bool CJsonSnapshotDoc::IsExist(const char *lpKey)
+{
+    return m_lpRoot != nullptr && m_lpRoot->IsExist(lpKey);
+}
+
+bool CJsonSnapshotDoc::GetNull(const Key &stKey)
+{
+    return m_lpRoot != nullptr && m_lpRoot->GetNull(stKey);
+}
+
+bool CJsonSnapshotDoc::GetBool(const Key &stKey, bool bDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetBool(stKey, bDefaultValue) : bDefaultValue;
+}
+
+int64_t CJsonSnapshotDoc::GetInt(const Key &stKey, int64_t nDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetInt(stKey, nDefaultValue) : nDefaultValue;
+}
+
+double CJsonSnapshotDoc::GetDouble(const Key &stKey, double dDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetDouble(stKey, dDefaultValue) : dDefaultValue;
+}
+
+const char *CJsonSnapshotDoc::GetString(const Key &stKey, const char *lpDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetString(stKey, lpDefaultValue) : lpDefaultValue;
+}
+
+IJsonObj *CJsonSnapshotDoc::GetArray(const Key &stKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetArray(stKey) : nullptr;
+}
+
+IJsonObj *CJsonSnapshotDoc::GetObject(const Key &stKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetObject(stKey) : nullptr;
+}
+
+bool CJsonSnapshotDoc::IsExist(const Key &stKey)
+{
+    return m_lpRoot != nullptr && m_lpRoot->IsExist(stKey);
+}
+
+IJsonObj::ObjType CJsonSnapshotDoc::GetType()
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetType() : ObjType::Unknow;
+}
+
+uint32_t CJsonSnapshotDoc::GetSize()
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetSize() : 0;
+}
+
+IJsonObj::ObjType CJsonSnapshotDoc::GetType(const char *lpKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetType(lpKey) : ObjType::Unknow;
+}
+
+IJsonObj::ObjType CJsonSnapshotDoc::GetType(const Key &stKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetType(stKey) : ObjType::Unknow;
+}
+
+IJsonObj::ObjType CJsonSnapshotDoc::GetType(uint32_t uIndex)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetType(uIndex) : ObjType::Unknow;
+}
+
+int32_t CJsonSnapshotDoc::GetItem(uint32_t uIndex, KvItem *lpKvItem)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetItem(uIndex, lpKvItem) : InvaliadParam;
+}
+
+bool CJsonSnapshotDoc::First(Cursor *lpCursor, KvItem *lpKvItem)
+{
+    return m_lpRoot != nullptr && m_lpRoot->First(lpCursor, lpKvItem);
+}
+
+bool CJsonSnapshotDoc::Next(Cursor *lpCursor, KvItem *lpKvItem)
+{
+    return m_lpRoot != nullptr && m_lpRoot->Next(lpCursor, lpKvItem);
+}
+
+const char *CJsonSnapshotDoc::GetJsonStr(bool bPretty)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetJsonStr(bPretty) : nullptr;
+}
+
+const char *CJsonSnapshotDoc::GetBinary(BinaryFormat eFormat, uint64_t *lpLen)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetBinary(eFormat, lpLen) : nullptr;
+}
+
+int32_t CJsonSnapshotDoc::SaveSnapshot(const char *lpFile)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->SaveSnapshot(lpFile) : InvaliadCall;
+}
+
+IJsonObj *CJsonSnapshotDoc::Freeze()
+{
+    return m_lpRoot != nullptr ? m_lpRoot->Freeze() : nullptr;
+}
+
+}
+
+cppbase::IJsonObj *NewSnapshotJsonObject()
+{
+    return NEW cppbase::CJsonSnapshotDoc();
+}
@@ -0,0 +1,246 @@
+#ifndef __JSON_SNAPSHOT_H_
+#define __JSON_SNAPSHOT_H_
+
+#include <os_common.h>
+#include <json_obj.h>
+#include "json_arena.h"
+#include "json_file.h"
+
+namespace cppbase
+{
+
+class CJsonWriter;
+class CJsonSnapshotDoc;
+
+/*
+ * What SaveSnapshot writes: the header, then three areas end to end. Every
+ * position is an offset from the start of its area, so the file reads the
+ * same wherever it is mapped.
+ *
+ *   values    64-bit words in document order, as on the tape:
+ *               null, bool      [type | value]
+ *               int, double     [type] [64-bit value]
+ *               string          [type | length] [offset in strings]
+ *               array, object   [type | count] [offset in index] [id]
+ *                               members...
+ *   index     for each container the value offset of every member, the
+ *             key for an object member; objects follow it with their
+ *             members as [hash tag | number], sorted for binary search
+ *   strings   NUL-terminated bytes, each distinct key stored once
+ */
+struct JsonSnapshotHeader
+{
+    static constexpr uint32_t ByteOrderMark = 0x01020304;
+    static constexpr uint32_t CurrentVersion = 1;
+
+    char szMagic[8];
+    uint32_t uByteOrder; // ByteOrderMark as the writing host stored it
+    uint32_t uVersion;
+    uint64_t uValueWords;
+    uint64_t uIndexWords;
+    uint64_t uStrBytes;
+    uint64_t uContainers; // the ids run from 0, the root's, to this
+    uint64_t uReserve[2];
+};
+
+// writes the node lpObj and everything under it to lpFile, through a
+// temporary file renamed over it once complete
+int32_t SaveJsonSnapshot(IJsonObj *lpObj, const char *lpFile);
+
+// the same layout built in memory, behind a snapshot document with every
+// node already made; see IJsonObj::Freeze
+IJsonObj *FreezeJsonObject(IJsonObj *lpObj);
+
+/*
+ * Container of a snapshot: a position in the mapped values. Lookups binary
+ * search the sorted hash tags of the object, and members are reached by
+ * number through the index, so both take no walk over the values.
+ */
+class CJsonSnapshotNode : public IJsonObj
+{
+public:
+    static constexpr uint32_t TypeShift = 56;
+    static constexpr uint64_t PayloadMask = (uint64_t(1) << TypeShift) - 1;
+    static constexpr uint32_t ContainerWords = 3;
+
+    CJsonSnapshotNode(CJsonSnapshotDoc *lpDoc, const uint64_t *lpValue) : m_lpDoc(lpDoc), m_lpValue(lpValue) {}
+    ~CJsonSnapshotNode() override = default;
+
+    int32_t Init(ObjType eType) override;
+
+    int32_t OpenFromFile(const char *lpFile) override;
+    int32_t OpenFromBuffer(const char *lpBuffer) override;
+    int32_t OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen) override;
+    int32_t OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount) override;
+    int32_t OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat) override;
+    int32_t OpenSnapshot(const char *lpFile) override;
+    int32_t Clear() override;
+
+    int32_t AddNull(const char *lpKey) override;
+    int32_t AddBool(const char *lpKey, bool bValue) override;
+    int32_t AddInt(const char *lpKey, int64_t nValue) override;
+    int32_t AddDouble(const char *lpKey, double dValue) override;
+    int32_t AddString(const char *lpKey, const char *lpValue) override;
+    IJsonObj *AddArray(const char *lpKey) override;
+    IJsonObj *AddObject(const char *lpKey) override;
+
+    bool GetNull(const char *lpKey) override;
+    bool GetBool(const char *lpKey, bool bDefaultValue = false) override;
+    int64_t GetInt(const char *lpKey, int64_t nDefaultValue = 0) override;
+    double GetDouble(const char *lpKey, double dDefaultValue = 0.0) override;
+    const char *GetString(const char *lpKey, const char *lpDefaultValue = nullptr) override;
+    IJsonObj *GetArray(const char *lpKey) override;
+    IJsonObj *GetObject(const char *lpKey) override;
+    bool IsExist(const char *lpKey) override;
+
+    bool GetNull(const Key &stKey) override;
+    bool GetBool(const Key &stKey, bool bDefaultValue = false) override;
+    int64_t GetInt(const Key &stKey, int64_t nDefaultValue = 0) override;
+    double GetDouble(const Key &stKey, double dDefaultValue = 0.0) override;
+    const char *GetString(const Key &stKey, const char *lpDefaultValue = nullptr) override;
+    IJsonObj *GetArray(const Key &stKey) override;
+    IJsonObj *GetObject(const Key &stKey) override;
+    bool IsExist(const Key &stKey) override;
+
+    ObjType GetType() override;
+    uint32_t GetSize() override;
+    ObjType GetType(const char *lpKey) override;
+    ObjType GetType(const Key &stKey) override;
+    ObjType GetType(uint32_t uIndex) override;
+    int32_t GetItem(uint32_t uIndex, KvItem *lpKvItem) override;
+    bool First(Cursor *lpCursor, KvItem *lpKvItem) override;
+    bool Next(Cursor *lpCursor, KvItem *lpKvItem) override;
+
+    const char *GetJsonStr(bool bPretty) override;
+    const char *GetBinary(BinaryFormat eFormat, uint64_t *lpLen) override;
+    int32_t SaveSnapshot(const char *lpFile) override;
+    IJsonObj *Freeze() override;
+
+    static inline ObjType GetType(const uint64_t *lpValue)
+    {
+        return ObjType(*lpValue >> TypeShift);
+    }
+
+private:
+    // what a Cursor holds: the number of the current member
+    struct CursorState
+    {
+        uint32_t uIndex;
+    };
+
+    inline uint32_t GetCount() const { return uint32_t(*m_lpValue & PayloadMask); }
+
+    const uint64_t *FindValue(const Key &stKey) const;
+    const uint64_t *GetMember(uint32_t uIndex, const uint64_t *&lpKey) const;
+    bool FillKvItem(const uint64_t *lpKey, const uint64_t *lpValue, KvItem *lpKvItem) const;
+
+private:
+    CJsonSnapshotDoc *m_lpDoc;
+    const uint64_t *m_lpValue;
+};
+
+/*
+ * What NewSnapshotJsonObject returns: OpenSnapshot maps the file and checks
+ * its header, and every getter then reads the mapped pages. A node is made
+ * the first time its container is handed out and kept until the document
+ * is cleared or deleted.
+ *
+ * OpenFrozen lays a node out in a block of memory instead and makes all of
+ * the nodes there and then, so that the getters only read: nothing of a
+ * frozen document changes until it is deleted.
+ */
+class CJsonSnapshotDoc : public IJsonObj
+{
+    friend class CJsonSnapshotNode;
+
+public:
+    CJsonSnapshotDoc() = default;
+    ~CJsonSnapshotDoc() override;
+
+    int32_t Init(ObjType eType) override;
+
+    int32_t OpenFromFile(const char *lpFile) override;
+    int32_t OpenFromBuffer(const char *lpBuffer) override;
+    int32_t OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen) override;
+    int32_t OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount) override;
+    int32_t OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat) override;
+    int32_t OpenSnapshot(const char *lpFile) override;
+    int32_t Clear() override;
+
+    int32_t AddNull(const char *lpKey) override;
+    int32_t AddBool(const char *lpKey, bool bValue) override;
+    int32_t AddInt(const char *lpKey, int64_t nValue) override;
+    int32_t AddDouble(const char *lpKey, double dValue) override;
+    int32_t AddString(const char *lpKey, const char *lpValue) override;
+    IJsonObj *AddArray(const char *lpKey) override;
+    IJsonObj *AddObject(const char *lpKey) override;
+
+    bool GetNull(const char *lpKey) override;
+    bool GetBool(const char *lpKey, bool bDefaultValue = false) override;
+    int64_t GetInt(const char *lpKey, int64_t nDefaultValue = 0) override;
+    double GetDouble(const char *lpKey, double dDefaultValue = 0.0) override;
+    const char *GetString(const char *lpKey, const char *lpDefaultValue = nullptr) override;
+    IJsonObj *GetArray(const char *lpKey) override;
+    IJsonObj *GetObject(const char *lpKey) override;
+    bool IsExist(const char *lpKey) override;
+
+    bool GetNull(const Key &stKey) override;
+    bool GetBool(const Key &stKey, bool bDefaultValue = false) override;
+    int64_t GetInt(const Key &stKey, int64_t nDefaultValue = 0) override;
+    double GetDouble(const Key &stKey, double dDefaultValue = 0.0) override;
+    const char *GetString(const Key &stKey, const char *lpDefaultValue = nullptr) override;
+    IJsonObj *GetArray(const Key &stKey) override;
+    IJsonObj *GetObject(const Key &stKey) override;
+    bool IsExist(const Key &stKey) override;
+
+    ObjType GetType() override;
+    uint32_t GetSize() override;
+    ObjType GetType(const char *lpKey) override;
+    ObjType GetType(const Key &stKey) override;
+    ObjType GetType(uint32_t uIndex) override;
+    int32_t GetItem(uint32_t uIndex, KvItem *lpKvItem) override;
+    bool First(Cursor *lpCursor, KvItem *lpKvItem) override;
+    bool Next(Cursor *lpCursor, KvItem *lpKvItem) override;
+
+    const char *GetJsonStr(bool bPretty) override;
+    const char *GetBinary(BinaryFormat eFormat, uint64_t *lpLen) override;
+    int32_t SaveSnapshot(const char *lpFile) override;
+    IJsonObj *Freeze() override;
+
+    int32_t OpenFrozen(IJsonObj *lpObj);
+
+private:
+    inline const char *GetStr(const uint64_t *lpValue) const { return m_lpStrings + lpValue[1]; }
+    inline uint32_t GetStrLen(const uint64_t *lpValue) const
+    {
+        return uint32_t(*lpValue & CJsonSnapshotNode::PayloadMask);
+    }
+    inline const uint64_t *GetTable(const uint64_t *lpValue) const { return m_lpIndex + lpValue[1]; }
+
+    int32_t Load(const char *lpContent, uint64_t uLen);
+    int32_t MakeNodes();
+    void Reset();
+    CJsonSnapshotNode *GetNode(const uint64_t *lpValue);
+    int32_t WriteValue(CJsonWriter &writer, const uint64_t *lpValue, bool bPretty, uint32_t uDepth);
+    CJsonWriter *GetWriter();
+    const char *WriteJsonStr(const uint64_t *lpValue, bool bPretty);
+    const char *WriteBinary(IJsonObj *lpNode, BinaryFormat eFormat, uint64_t *lpLen);
+
+private:
+    CJsonFileContent m_file;
+    char *m_lpFrozen{nullptr}; // the block of a frozen document
+    const uint64_t *m_lpValues{nullptr};
+    const uint64_t *m_lpIndex{nullptr};
+    const char *m_lpStrings{nullptr};
+    uint64_t m_uContainers{0};
+    // the node of each container id; the pages of ids never handed out are
+    // never touched
+    CJsonSnapshotNode **m_lpNodes{nullptr};
+    CJsonArena m_arena;
+    CJsonSnapshotNode *m_lpRoot{nullptr};
+    CJsonWriter *m_lpWriter{nullptr};
+};
+
+}
+
+#endif //__JSON_SNAPSHOT_H_
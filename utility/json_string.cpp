@@ -0,0 +1,146 @@
+#include "json_string.h"
+#include <error_no.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace cppbase
+{
+
+namespace
+{
+
+inline int32_t ParseHex4(const char *lpHex, uint32_t &uCode)
+{
+    uCode = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        auto ch = lpHex[i];
+        uCode <<= 4;
+        if (ch >= '0' && ch <= '9')
+        {
+            uCode |= ch - '0';
+        }
+        else if ((ch | 0x20) >= 'a' && (ch | 0x20) <= 'f')
+        {
+            uCode |= (ch | 0x20) - 'a' + 10;
+        }
+        else
+        {
+            return ParseDataFialed;
+        }
+    }
+
+    return 0;
+}
+
+}
+
+char *UnescapeString(const char *lpCur, const char *lpEnd, char *lpOut)
+{
+    // the output never outgrows the input, so lpOut may alias lpCur
+    for (; lpCur < lpEnd; lpCur++)
+    {
+        if (*lpCur != '\\')
+        {
+            *lpOut++ = *lpCur;
+            continue;
+        }
+
+        // a backslash is never the last byte before the closing quote
+        switch (*++lpCur)
+        {
+            case '"': *lpOut++ = '"'; break;
+            case '\\': *lpOut++ = '\\'; break;
+            case '/': *lpOut++ = '/'; break;
+            case 'b': *lpOut++ = '\b'; break;
+            case 'f': *lpOut++ = '\f'; break;
+            case 'n': *lpOut++ = '\n'; break;
+            case 'r': *lpOut++ = '\r'; break;
+            case 't': *lpOut++ = '\t'; break;
+            case 'u':
+            {
+                uint32_t uCode = 0;
+                if (lpEnd - lpCur < 5 || ParseHex4(lpCur + 1, uCode) != 0)
+                {
+                    return nullptr;
+                }
+                lpCur += 4;
+
+                if (uCode >= 0xD800 && uCode <= 0xDBFF)
+                {
+                    uint32_t uLow = 0;
+                    if (lpEnd - lpCur < 7 || lpCur[1] != '\\' || lpCur[2] != 'u'
+                        || ParseHex4(lpCur + 3, uLow) != 0 || uLow < 0xDC00 || uLow > 0xDFFF)
+                    {
+                        return nullptr;
+                    }
+                    lpCur += 6;
+                    uCode = 0x10000 + ((uCode - 0xD800) << 10) + (uLow - 0xDC00);
+                }
+                else if (uCode >= 0xDC00 && uCode <= 0xDFFF)
+                {
+                    return nullptr;
+                }
+
+                if (uCode < 0x80)
+                {
+                    *lpOut++ = char(uCode);
+                }
+                else if (uCode < 0x800)
+                {
+                    *lpOut++ = char(0xC0 | (uCode >> 6));
+                    *lpOut++ = char(0x80 | (uCode & 0x3F));
+                }
+                else if (uCode < 0x10000)
+                {
+                    *lpOut++ = char(0xE0 | (uCode >> 12));
+                    *lpOut++ = char(0x80 | ((uCode >> 6) & 0x3F));
+                    *lpOut++ = char(0x80 | (uCode & 0x3F));
+                }
+                else
+                {
+                    *lpOut++ = char(0xF0 | (uCode >> 18));
+                    *lpOut++ = char(0x80 | ((uCode >> 12) & 0x3F));
+                    *lpOut++ = char(0x80 | ((uCode >> 6) & 0x3F));
+                    *lpOut++ = char(0x80 | (uCode & 0x3F));
+                }
+                break;
+            }
+
+            default:
+                return nullptr;
+        }
+    }
+
+    return lpOut;
+}
+
+const char *FindStringStop(const char *lpCur, const char *lpEnd)
+{
+#if defined(__SSE2__)
+    const __m128i stQuote = _mm_set1_epi8('"');
+    const __m128i stBackslash = _mm_set1_epi8('\\');
+    const __m128i stControl = _mm_set1_epi8(0x1F);
+    for (; lpEnd - lpCur >= 16; lpCur += 16)
+    {
+        auto stChunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lpCur));
+        auto stStop = _mm_or_si128(_mm_cmpeq_epi8(stChunk, stQuote), _mm_cmpeq_epi8(stChunk, stBackslash));
+        stStop = _mm_or_si128(stStop, _mm_cmpeq_epi8(_mm_min_epu8(stChunk, stControl), stChunk));
+        auto uMask = uint32_t(_mm_movemask_epi8(stStop));
+        if (uMask != 0)
+        {
+            return lpCur + __builtin_ctz(uMask);
+        }
+    }
+#endif
+
+    while (lpCur < lpEnd && *lpCur != '"' && *lpCur != '\\' && uint8_t(*lpCur) >= 0x20)
+    {
+        lpCur++;
+    }
+
+    return lpCur;
+}
+
+}
@@ -0,0 +1,21 @@
+#ifndef __JSON_STRING_H_
+#define __JSON_STRING_H_
+
+#include <os_common.h>
+
+namespace cppbase
+{
+
+// Decodes the json escapes of [lpCur, lpEnd), the raw contents between two
+// quotes, into lpOut. The output is never longer than the input, so lpOut
+// may alias lpCur for in-place decoding. Returns the end of the output, or
+// nullptr on a malformed escape.
+char *UnescapeString(const char *lpCur, const char *lpEnd, char *lpOut);
+
+// Returns the first quote, backslash or control byte below 0x20 in
+// [lpCur, lpEnd), or lpEnd.
+const char *FindStringStop(const char *lpCur, const char *lpEnd);
+
+}
+
+#endif //__JSON_STRING_H_
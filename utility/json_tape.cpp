@@ -0,0 +1,1104 @@
+#include "json_tape.h"
+#include "json_scanner.h"
+#include "json_number.h"
+#include "json_string.h"
+#include "json_writer.h"
+#include "json_file.h"
+#include "json_binary.h"
+#include "json_snapshot.h"
+#include <error_no.h>
+
+namespace cppbase
+{
+
+namespace
+{
+
+inline uint64_t MakeWord(IJsonObj::ObjType eType, uint64_t uPayload)
+{
+    return (uint64_t(eType) << CJsonTapeNode::TypeShift) | uPayload;
+}
+
+inline const char *GetStr(const uint64_t *lpValue)
+{
+    return reinterpret_cast<const char *>(lpValue[1]);
+}
+
+inline uint32_t GetStrLen(const uint64_t *lpValue)
+{
+    return uint32_t(*lpValue & CJsonTapeNode::PayloadMask);
+}
+
+inline double GetDouble(const uint64_t *lpValue)
+{
+    double dValue;
+    memcpy(&dValue, lpValue + 1, sizeof(dValue));
+    return dValue;
+}
+
+inline CJsonTapeNode *GetNode(const uint64_t *lpValue)
+{
+    return reinterpret_cast<CJsonTapeNode *>(const_cast<uint64_t *>(lpValue + 1));
+}
+
+// whether the key at lpKey repeats one of the members from lpMember up to it
+bool IsDuplicateKey(const uint64_t *lpMember, const uint64_t *lpKey)
+{
+    auto uLen = GetStrLen(lpKey);
+    for (; lpMember != lpKey; lpMember = CJsonTapeNode::Skip(lpMember + 2))
+    {
+        if (GetStrLen(lpMember) == uLen && memcmp(GetStr(lpMember), GetStr(lpKey), uLen) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}
+
+int32_t CJsonTapeNode::Init(ObjType eType)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeNode::OpenFromFile(const char *lpFile)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeNode::OpenFromBuffer(const char *lpBuffer)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeNode::OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeNode::OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeNode::OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeNode::OpenSnapshot(const char *lpFile)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeNode::Clear()
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeNode::AddNull(const char *lpKey)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeNode::AddBool(const char *lpKey, bool bValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeNode::AddInt(const char *lpKey, int64_t nValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeNode::AddDouble(const char *lpKey, double dValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeNode::AddString(const char *lpKey, const char *lpValue)
+{
+    return InvaliadCall;
+}
+
+IJsonObj *CJsonTapeNode::AddArray(const char *lpKey)
+{
+    return nullptr;
+}
+
+IJsonObj *CJsonTapeNode::AddObject(const char *lpKey)
+{
+    return nullptr;
+}
+
+bool CJsonTapeNode::IsObject() const
+{
+    return GetType(GetMembers() - ContainerWords) == ObjType::Object;
+}
+
+const uint64_t *CJsonTapeNode::FindValue(const Key &stKey) const
+{
+    if (unlikely(stKey.lpKey == nullptr || !IsObject()))
+    {
+        return nullptr;
+    }
+
+    // keys are compared in place, jumping over the values in between
+    auto lpMember = GetMembers();
+    for (uint32_t i = 0; i < m_uCount; i++)
+    {
+        if (GetStrLen(lpMember) == stKey.uLen && memcmp(GetStr(lpMember), stKey.lpKey, stKey.uLen) == 0)
+        {
+            return lpMember + 2;
+        }
+        lpMember = Skip(lpMember + 2);
+    }
+
+    return nullptr;
+}
+
+const uint64_t *CJsonTapeNode::GetMember(uint32_t uIndex, const uint64_t *&lpKey) const
+{
+    if (uIndex >= m_uCount)
+    {
+        return nullptr;
+    }
+
+    bool bObject = IsObject();
+    auto lpMember = GetMembers();
+    for (uint32_t i = 0; i < uIndex; i++)
+    {
+        lpMember = Skip(lpMember + (bObject ? 2 : 0));
+    }
+
+    lpKey = bObject ? lpMember : nullptr;
+    return lpMember + (bObject ? 2 : 0);
+}
+
+bool CJsonTapeNode::GetNull(const char *lpKey)
+{
+    return CJsonTapeNode::GetNull(Key(lpKey));
+}
+
+bool CJsonTapeNode::GetBool(const char *lpKey, bool bDefaultValue)
+{
+    return CJsonTapeNode::GetBool(Key(lpKey), bDefaultValue);
+}
+
+int64_t CJsonTapeNode::GetInt(const char *lpKey, int64_t nDefaultValue)
+{
+    return CJsonTapeNode::GetInt(Key(lpKey), nDefaultValue);
+}
+
+double CJsonTapeNode::GetDouble(const char *lpKey, double dDefaultValue)
+{
+    return CJsonTapeNode::GetDouble(Key(lpKey), dDefaultValue);
+}
+
+const char *CJsonTapeNode::GetString(const char *lpKey, const char *lpDefaultValue)
+{
+    return CJsonTapeNode::GetString(Key(lpKey), lpDefaultValue);
+}
+
+IJsonObj *CJsonTapeNode::GetArray(const char *lpKey)
+{
+    return CJsonTapeNode::GetArray(Key(lpKey));
+}
+
+IJsonObj *CJsonTapeNode::GetObject(const char *lpKey)
+{
+    return CJsonTapeNode::GetObject(Key(lpKey));
+}
+
+bool CJsonTapeNode::IsExist(const char *lpKey)
+{
+    return CJsonTapeNode::IsExist(Key(lpKey));
+}
+
+bool CJsonTapeNode::GetNull(const Key &stKey)
+{
+    auto lpValue = FindValue(stKey);
+    return lpValue != nullptr && GetType(lpValue) == ObjType::Null;
+}
+
+bool CJsonTapeNode::GetBool(const Key &stKey, bool bDefaultValue)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && GetType(lpValue) == ObjType::Boolean))
+    {
+        return (*lpValue & 1) != 0;
+    }
+
+    return bDefaultValue;
+}
+
+int64_t CJsonTapeNode::GetInt(const Key &stKey, int64_t nDefaultValue)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && GetType(lpValue) == ObjType::Integer))
+    {
+        return int64_t(lpValue[1]);
+    }
+
+    return nDefaultValue;
+}
+
+double CJsonTapeNode::GetDouble(const Key &stKey, double dDefaultValue)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && GetType(lpValue) == ObjType::Double))
+    {
+        return cppbase::GetDouble(lpValue);
+    }
+
+    return dDefaultValue;
+}
+
+const char *CJsonTapeNode::GetString(const Key &stKey, const char *lpDefaultValue)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && GetType(lpValue) == ObjType::String))
+    {
+        return GetStr(lpValue);
+    }
+
+    return lpDefaultValue;
+}
+
+IJsonObj *CJsonTapeNode::GetArray(const Key &stKey)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && GetType(lpValue) == ObjType::Array))
+    {
+        return GetNode(lpValue);
+    }
+
+    return nullptr;
+}
+
+IJsonObj *CJsonTapeNode::GetObject(const Key &stKey)
+{
+    auto lpValue = FindValue(stKey);
+    if (likely(lpValue != nullptr && GetType(lpValue) == ObjType::Object))
+    {
+        return GetNode(lpValue);
+    }
+
+    return nullptr;
+}
+
+bool CJsonTapeNode::IsExist(const Key &stKey)
+{
+    return FindValue(stKey) != nullptr;
+}
+
+IJsonObj::ObjType CJsonTapeNode::GetType()
+{
+    return GetType(GetMembers() - ContainerWords);
+}
+
+uint32_t CJsonTapeNode::GetSize()
+{
+    return m_uCount;
+}
+
+IJsonObj::ObjType CJsonTapeNode::GetType(const char *lpKey)
+{
+    return CJsonTapeNode::GetType(Key(lpKey));
+}
+
+IJsonObj::ObjType CJsonTapeNode::GetType(const Key &stKey)
+{
+    auto lpValue = FindValue(stKey);
+    return lpValue != nullptr ? GetType(lpValue) : ObjType::Unknow;
+}
+
+IJsonObj::ObjType CJsonTapeNode::GetType(uint32_t uIndex)
+{
+    const uint64_t *lpKey = nullptr;
+    auto lpValue = GetMember(uIndex, lpKey);
+    return lpValue != nullptr ? GetType(lpValue) : ObjType::Unknow;
+}
+
+void CJsonTapeNode::FillKvItem(const uint64_t *lpKey, const uint64_t *lpValue, KvItem *lpKvItem)
+{
+    lpKvItem->eType = GetType(lpValue);
+    lpKvItem->lpKey = lpKey != nullptr ? GetStr(lpKey) : nullptr;
+    switch (lpKvItem->eType)
+    {
+        case ObjType::Null:
+            lpKvItem->IsNull = true;
+            break;
+
+        case ObjType::Boolean:
+            lpKvItem->bValue = (*lpValue & 1) != 0;
+            break;
+
+        case ObjType::Integer:
+            lpKvItem->nValue = int64_t(lpValue[1]);
+            break;
+
+        case ObjType::Double:
+            lpKvItem->dValue = cppbase::GetDouble(lpValue);
+            break;
+
+        case ObjType::String:
+            lpKvItem->strValue = GetStr(lpValue);
+            break;
+
+        default:
+            lpKvItem->lpArray = GetNode(lpValue);
+            break;
+    }
+}
+
+int32_t CJsonTapeNode::GetItem(uint32_t uIndex, KvItem *lpKvItem)
+{
+    if (unlikely(lpKvItem == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    const uint64_t *lpKey = nullptr;
+    auto lpValue = GetMember(uIndex, lpKey);
+    if (unlikely(lpValue == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    FillKvItem(lpKey, lpValue, lpKvItem);
+    return 0;
+}
+
+bool CJsonTapeNode::First(Cursor *lpCursor, KvItem *lpKvItem)
+{
+    static_assert(sizeof(CursorState) <= sizeof(Cursor::Reserve), "Cursor too small for CursorState");
+
+    if (unlikely(lpCursor == nullptr || lpKvItem == nullptr))
+    {
+        return false;
+    }
+
+    auto lpState = new(lpCursor->Reserve) CursorState{GetMembers(), m_uCount};
+    if (lpState->uLeft == 0)
+    {
+        return false;
+    }
+
+    bool bObject = IsObject();
+    FillKvItem(bObject ? lpState->lpNext : nullptr, lpState->lpNext + (bObject ? 2 : 0), lpKvItem);
+    return true;
+}
+
+bool CJsonTapeNode::Next(Cursor *lpCursor, KvItem *lpKvItem)
+{
+    if (unlikely(lpCursor == nullptr || lpKvItem == nullptr))
+    {
+        return false;
+    }
+
+    // the members are consecutive on the tape, a step is one skip
+    auto lpState = reinterpret_cast<CursorState *>(lpCursor->Reserve);
+    if (lpState->uLeft <= 1)
+    {
+        lpState->uLeft = 0;
+        return false;
+    }
+
+    bool bObject = IsObject();
+    lpState->lpNext = Skip(lpState->lpNext + (bObject ? 2 : 0));
+    lpState->uLeft--;
+    FillKvItem(bObject ? lpState->lpNext : nullptr, lpState->lpNext + (bObject ? 2 : 0), lpKvItem);
+    return true;
+}
+
+int32_t CJsonTapeNode::WriteValue(CJsonWriter &writer, const uint64_t *lpValue, bool bPretty, uint32_t uDepth)
+{
+    switch (GetType(lpValue))
+    {
+        case ObjType::Null:
+            return writer.WriteNull();
+
+        case ObjType::Boolean:
+            return writer.WriteBool((*lpValue & 1) != 0);
+
+        case ObjType::Integer:
+            return writer.WriteInt(int64_t(lpValue[1]));
+
+        case ObjType::Double:
+            return writer.WriteDouble(cppbase::GetDouble(lpValue));
+
+        case ObjType::String:
+            return writer.WriteString(GetStr(lpValue), GetStrLen(lpValue));
+
+        default:
+            break;
+    }
+
+    bool bObject = GetType(lpValue) == ObjType::Object;
+    auto lpNode = GetNode(lpValue);
+    auto iErrorNo = writer.WriteChar(bObject ? '{' : '[');
+    auto lpMember = lpNode->GetMembers();
+    for (uint32_t i = 0; i < lpNode->m_uCount && iErrorNo == 0; i++)
+    {
+        if (i > 0)
+        {
+            iErrorNo = writer.WriteChar(',');
+        }
+        if (iErrorNo == 0 && bPretty)
+        {
+            iErrorNo = writer.WriteIndent(uDepth + 1);
+        }
+        if (iErrorNo == 0 && bObject)
+        {
+            iErrorNo = writer.WriteString(GetStr(lpMember), GetStrLen(lpMember));
+            if (iErrorNo == 0)
+            {
+                iErrorNo = bPretty ? writer.WriteRaw(": ", 2) : writer.WriteChar(':');
+            }
+            lpMember += 2;
+        }
+        if (iErrorNo == 0)
+        {
+            iErrorNo = WriteValue(writer, lpMember, bPretty, uDepth + 1);
+        }
+        lpMember = Skip(lpMember);
+    }
+
+    if (iErrorNo == 0 && bPretty && lpNode->m_uCount > 0)
+    {
+        iErrorNo = writer.WriteIndent(uDepth);
+    }
+
+    return iErrorNo == 0 ? writer.WriteChar(bObject ? '}' : ']') : iErrorNo;
+}
+
+const char *CJsonTapeNode::GetJsonStr(bool bPretty)
+{
+    return m_lpDoc->WriteJsonStr(GetMembers() - ContainerWords, bPretty);
+}
+
+const char *CJsonTapeNode::GetBinary(BinaryFormat eFormat, uint64_t *lpLen)
+{
+    return m_lpDoc->WriteBinary(this, eFormat, lpLen);
+}
+
+int32_t CJsonTapeNode::SaveSnapshot(const char *lpFile)
+{
+    return SaveJsonSnapshot(this, lpFile);
+}
+
+IJsonObj *CJsonTapeNode::Freeze()
+{
+    return FreezeJsonObject(this);
+}
+
+CJsonTapeDoc::~CJsonTapeDoc()
+{
+    delete m_lpWriter;
+    free(m_lpTape);
+    free(m_lpStrings);
+}
+
+char CJsonTapeDoc::PeekToken(const BuildContext &stCtx, uint32_t uIndex)
+{
+    return likely(uIndex < stCtx.uCount) ? stCtx.lpContent[stCtx.lpIndex[uIndex]] : '\0';
+}
+
+bool CJsonTapeDoc::IsDelimiter(const BuildContext &stCtx, uint64_t uPos)
+{
+    return uPos >= stCtx.uLen || CJsonScanner::IsDelimiter(stCtx.lpContent[uPos]);
+}
+
+void CJsonTapeDoc::Measure(const BuildContext &stCtx, uint64_t &uWords, uint64_t &uStrBytes)
+{
+    // every token is worth a fixed number of words, and a string the bytes
+    // between its quotes plus the NUL, which decoding only ever shrinks;
+    // the builder checks both bounds, so malformed input only fails later
+    uWords = 0;
+    uStrBytes = 0;
+    for (uint32_t i = 0; i < stCtx.uCount; i++)
+    {
+        switch (stCtx.lpContent[stCtx.lpIndex[i]])
+        {
+            case '{':
+            case '[':
+                uWords += CJsonTapeNode::ContainerWords;
+                break;
+
+            case '"':
+                uWords += 2;
+                if (i + 1 < stCtx.uCount)
+                {
+                    uStrBytes += stCtx.lpIndex[i + 1] - stCtx.lpIndex[i];
+                }
+                i++;
+                break;
+
+            case ':':
+            case ',':
+            case '}':
+            case ']':
+                break;
+
+            case 't':
+            case 'f':
+            case 'n':
+                uWords += 1;
+                break;
+
+            default:
+                uWords += 2;
+                break;
+        }
+    }
+}
+
+int32_t CJsonTapeDoc::BuildString(BuildContext &stCtx, uint32_t &uIndex)
+{
+    // the scanner records both quotes of a string
+    if (unlikely(uIndex + 1 >= stCtx.uCount || PeekToken(stCtx, uIndex + 1) != '"'))
+    {
+        return ParseDataFialed;
+    }
+
+    auto uBegin = stCtx.lpIndex[uIndex] + 1;
+    auto uEnd = stCtx.lpIndex[uIndex + 1];
+    auto lpBegin = stCtx.lpContent + uBegin;
+    auto lpEnd = stCtx.lpContent + uEnd;
+    uIndex += 2;
+    if (unlikely(stCtx.lpTapeEnd - stCtx.lpTape < 2))
+    {
+        return ParseDataFialed;
+    }
+
+    // in situ the string stays where it is, with the closing quote as its NUL
+    auto lpEscape = reinterpret_cast<const char *>(memchr(lpBegin, '\\', lpEnd - lpBegin));
+    char *lpOut = nullptr;
+    char *lpOutEnd = nullptr;
+    if (stCtx.lpInSitu != nullptr)
+    {
+        lpOut = stCtx.lpInSitu + uBegin;
+        lpOutEnd = lpEscape == nullptr ? stCtx.lpInSitu + uEnd
+                                       : UnescapeString(lpEscape, lpEnd, stCtx.lpInSitu + (lpEscape - stCtx.lpContent));
+    }
+    else
+    {
+        if (unlikely(uint64_t(stCtx.lpStrEnd - stCtx.lpStr) < uint64_t(lpEnd - lpBegin) + 1))
+        {
+            return ParseDataFialed;
+        }
+
+        lpOut = stCtx.lpStr;
+        auto uPlain = (lpEscape != nullptr ? lpEscape : lpEnd) - lpBegin;
+        memcpy(lpOut, lpBegin, uPlain);
+        lpOutEnd = lpEscape == nullptr ? lpOut + uPlain : UnescapeString(lpEscape, lpEnd, lpOut + uPlain);
+    }
+
+    if (unlikely(lpOutEnd == nullptr))
+    {
+        return ParseDataFialed;
+    }
+
+    *lpOutEnd = '\0';
+    if (stCtx.lpInSitu == nullptr)
+    {
+        stCtx.lpStr = lpOutEnd + 1;
+    }
+
+    stCtx.lpTape[0] = MakeWord(ObjType::String, uint64_t(lpOutEnd - lpOut));
+    stCtx.lpTape[1] = reinterpret_cast<uint64_t>(lpOut);
+    stCtx.lpTape += 2;
+    return 0;
+}
+
+int32_t CJsonTapeDoc::BuildValue(BuildContext &stCtx, uint32_t &uIndex)
+{
+    if (unlikely(uIndex >= stCtx.uCount))
+    {
+        return ParseDataFialed;
+    }
+
+    auto uPos = stCtx.lpIndex[uIndex];
+    auto lpToken = &stCtx.lpContent[uPos];
+    switch (*lpToken)
+    {
+        case '{':
+        case '[':
+            return BuildContainer(stCtx, uIndex);
+
+        case '"':
+            return BuildString(stCtx, uIndex);
+
+        default:
+            break;
+    }
+
+    // a literal takes one word, a number two
+    if (unlikely(stCtx.lpTapeEnd - stCtx.lpTape < 1))
+    {
+        return ParseDataFialed;
+    }
+
+    switch (*lpToken)
+    {
+        case 't':
+        case 'f':
+        {
+            bool bValue = *lpToken == 't';
+            uint64_t uWordLen = bValue ? 4 : 5;
+            if (uPos + uWordLen > stCtx.uLen || memcmp(lpToken, bValue ? "true" : "false", uWordLen) != 0
+                || !IsDelimiter(stCtx, uPos + uWordLen))
+            {
+                return ParseDataFialed;
+            }
+            *stCtx.lpTape++ = MakeWord(ObjType::Boolean, bValue);
+            break;
+        }
+
+        case 'n':
+        {
+            if (uPos + 4 > stCtx.uLen || memcmp(lpToken, "null", 4) != 0 || !IsDelimiter(stCtx, uPos + 4))
+            {
+                return ParseDataFialed;
+            }
+            *stCtx.lpTape++ = MakeWord(ObjType::Null, 0);
+            break;
+        }
+
+        default:
+        {
+            JsonNumber stNumber;
+            auto lpNumEnd = ParseNumber(lpToken, stCtx.lpContent + stCtx.uLen, stNumber);
+            if (lpNumEnd == nullptr || !IsDelimiter(stCtx, lpNumEnd - stCtx.lpContent)
+                || unlikely(stCtx.lpTapeEnd - stCtx.lpTape < 2))
+            {
+                return ParseDataFialed;
+            }
+            if (stNumber.bDouble)
+            {
+                stCtx.lpTape[0] = MakeWord(ObjType::Double, 0);
+                memcpy(stCtx.lpTape + 1, &stNumber.dValue, sizeof(double));
+            }
+            else
+            {
+                stCtx.lpTape[0] = MakeWord(ObjType::Integer, 0);
+                stCtx.lpTape[1] = uint64_t(stNumber.nValue);
+            }
+            stCtx.lpTape += 2;
+            break;
+        }
+    }
+
+    uIndex++;
+    return 0;
+}
+
+int32_t CJsonTapeDoc::BuildContainer(BuildContext &stCtx, uint32_t &uIndex)
+{
+    // { "key" : value , ... } or [ value , ... ]
+    if (unlikely(++stCtx.uDepth > MaxParseDepth || stCtx.lpTapeEnd - stCtx.lpTape < CJsonTapeNode::ContainerWords))
+    {
+        return ParseDataFialed;
+    }
+
+    bool bObject = PeekToken(stCtx, uIndex++) == '{';
+    char chEnd = bObject ? '}' : ']';
+    auto lpWord = stCtx.lpTape;
+    stCtx.lpTape += CJsonTapeNode::ContainerWords;
+
+    uint32_t uMembers = 0;
+    if (PeekToken(stCtx, uIndex) == chEnd)
+    {
+        uIndex++;
+    }
+    else
+    {
+        while (true)
+        {
+            // a key repeated in the object is rejected, as the other documents do
+            if (bObject)
+            {
+                if (PeekToken(stCtx, uIndex) != '"' || BuildString(stCtx, uIndex) != 0
+                    || IsDuplicateKey(lpWord + CJsonTapeNode::ContainerWords, stCtx.lpTape - 2)
+                    || PeekToken(stCtx, uIndex++) != ':')
+                {
+                    return ParseDataFialed;
+                }
+            }
+
+            if (BuildValue(stCtx, uIndex) != 0)
+            {
+                return ParseDataFialed;
+            }
+            uMembers++;
+
+            auto ch = PeekToken(stCtx, uIndex++);
+            if (ch == chEnd)
+            {
+                break;
+            }
+            else if (ch != ',')
+            {
+                return ParseDataFialed;
+            }
+        }
+    }
+
+    *lpWord = MakeWord(bObject ? ObjType::Object : ObjType::Array, uint64_t(stCtx.lpTape - lpWord));
+    new(lpWord + 1) CJsonTapeNode(this, uMembers);
+    stCtx.uDepth--;
+    return 0;
+}
+
+int32_t CJsonTapeDoc::Build(const char *lpContent, uint64_t uLen, bool bInSitu)
+{
+    static_assert(sizeof(CJsonTapeNode) == (CJsonTapeNode::ContainerWords - 1) * sizeof(uint64_t),
+                  "the node must fill the words reserved for it");
+
+    if (m_lpRoot != nullptr)
+    {
+        return InvaliadCall;
+    }
+
+    CJsonScanner scanner;
+    auto iErrorNo = scanner.Scan(lpContent, uLen);
+    if (iErrorNo != 0)
+    {
+        return iErrorNo;
+    }
+
+    BuildContext stCtx;
+    stCtx.lpContent = lpContent;
+    stCtx.lpInSitu = bInSitu ? const_cast<char *>(lpContent) : nullptr;
+    stCtx.uLen = uLen;
+    stCtx.lpIndex = scanner.GetIndex();
+    stCtx.uCount = scanner.GetCount();
+    stCtx.uDepth = 0;
+    auto ch = PeekToken(stCtx, 0);
+    if (ch != '{' && ch != '[')
+    {
+        return ParseDataFialed;
+    }
+
+    // the tape and the strings are sized up front and never grow; a
+    // cleared document reuses its buffers when they are large enough
+    uint64_t uWords = 0, uStrBytes = 0;
+    Measure(stCtx, uWords, uStrBytes);
+    if (uWords > m_uTapeWords)
+    {
+        free(m_lpTape);
+        m_lpTape = reinterpret_cast<uint64_t *>(malloc(uWords * sizeof(uint64_t)));
+        m_uTapeWords = m_lpTape != nullptr ? uWords : 0;
+    }
+    if (!bInSitu && uStrBytes > m_uStrBytes)
+    {
+        free(m_lpStrings);
+        m_lpStrings = reinterpret_cast<char *>(malloc(uStrBytes));
+        m_uStrBytes = m_lpStrings != nullptr ? uStrBytes : 0;
+    }
+    if (unlikely(m_lpTape == nullptr || (m_lpStrings == nullptr && !bInSitu && uStrBytes > 0)))
+    {
+        return MallocFailed;
+    }
+
+    stCtx.lpTape = m_lpTape;
+    stCtx.lpTapeEnd = m_lpTape + uWords;
+    stCtx.lpStr = bInSitu ? nullptr : m_lpStrings;
+    stCtx.lpStrEnd = stCtx.lpStr != nullptr ? stCtx.lpStr + uStrBytes : nullptr;
+
+    // only whitespace may follow the root value
+    uint32_t uIndex = 0;
+    iErrorNo = BuildContainer(stCtx, uIndex);
+    if (iErrorNo != 0 || uIndex != stCtx.uCount)
+    {
+        return ParseDataFialed;
+    }
+
+    m_lpRoot = GetNode(m_lpTape);
+    return 0;
+}
+
+int32_t CJsonTapeDoc::BuildFileContent(void *lpParam, const char *lpContent, uint64_t uLen)
+{
+    return reinterpret_cast<CJsonTapeDoc *>(lpParam)->Build(lpContent, uLen, false);
+}
+
+int32_t CJsonTapeDoc::Init(ObjType eType)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeDoc::OpenFromFile(const char *lpFile)
+{
+    if (unlikely(lpFile == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    return m_lpRoot == nullptr ? ParseJsonFile(lpFile, BuildFileContent, this) : InvaliadCall;
+}
+
+int32_t CJsonTapeDoc::OpenFromBuffer(const char *lpBuffer)
+{
+    if (unlikely(lpBuffer == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    return Build(lpBuffer, strlen(lpBuffer), false);
+}
+
+int32_t CJsonTapeDoc::OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen)
+{
+    if (unlikely(lpBuffer == nullptr))
+    {
+        return InvaliadParam;
+    }
+
+    return Build(lpBuffer, uLen, true);
+}
+
+int32_t CJsonTapeDoc::OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeDoc::OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeDoc::OpenSnapshot(const char *lpFile)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeDoc::Clear()
+{
+    // the tape and the strings stay for the next Open to build into
+    m_lpRoot = nullptr;
+    return 0;
+}
+
+int32_t CJsonTapeDoc::AddNull(const char *lpKey)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeDoc::AddBool(const char *lpKey, bool bValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeDoc::AddInt(const char *lpKey, int64_t nValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeDoc::AddDouble(const char *lpKey, double dValue)
+{
+    return InvaliadCall;
+}
+
+int32_t CJsonTapeDoc::AddString(const char *lpKey, const char *lpValue)
+{
+    return InvaliadCall;
+}
+
+IJsonObj *CJsonTapeDoc::AddArray(const char *lpKey)
+{
+    return nullptr;
+}
+
+IJsonObj *CJsonTapeDoc::AddObject(const char *lpKey)
+{
+    return nullptr;
+}
+
+bool CJsonTapeDoc::GetNull(const char *lpKey)
+{
+    return m_lpRoot != nullptr && m_lpRoot->GetNull(lpKey);
+}
+
+bool CJsonTapeDoc::GetBool(const char *lpKey, bool bDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetBool(lpKey, bDefaultValue) : bDefaultValue;
+}
+
+int64_t CJsonTapeDoc::GetInt(const char *lpKey, int64_t nDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetInt(lpKey, nDefaultValue) : nDefaultValue;
+}
+
+double CJsonTapeDoc::GetDouble(const char *lpKey, double dDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetDouble(lpKey, dDefaultValue) : dDefaultValue;
+}
+
+const char *CJsonTapeDoc::GetString(const char *lpKey, const char *lpDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetString(lpKey, lpDefaultValue) : lpDefaultValue;
+}
+
+IJsonObj *CJsonTapeDoc::GetArray(const char *lpKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetArray(lpKey) : nullptr;
+}
+
+IJsonObj *CJsonTapeDoc::GetObject(const char *lpKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetObject(lpKey) : nullptr;
+}
+
+bool CJsonTapeDoc::IsExist(const char *lpKey)
+{
+    return m_lpRoot != nullptr && m_lpRoot->IsExist(lpKey);
+}
+
+bool CJsonTapeDoc::GetNull(const Key &stKey)
+{
+    return m_lpRoot != nullptr && m_lpRoot->GetNull(stKey);
+}
+
+bool CJsonTapeDoc::GetBool(const Key &stKey, bool bDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetBool(stKey, bDefaultValue) : bDefaultValue;
+}
+
+int64_t CJsonTapeDoc::GetInt(const Key &stKey, int64_t nDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetInt(stKey, nDefaultValue) : nDefaultValue;
+}
+
+double CJsonTapeDoc::GetDouble(const Key &stKey, double dDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetDouble(stKey, dDefaultValue) : dDefaultValue;
+}
+
+const char *CJsonTapeDoc::GetString(const Key &stKey, const char *lpDefaultValue)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetString(stKey, lpDefaultValue) : lpDefaultValue;
+}
+
+IJsonObj *CJsonTapeDoc::GetArray(const Key &stKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetArray(stKey) : nullptr;
+}
+
+IJsonObj *CJsonTapeDoc::GetObject(const Key &stKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetObject(stKey) : nullptr;
+}
+
+bool CJsonTapeDoc::IsExist(const Key &stKey)
+{
+    return m_lpRoot != nullptr && m_lpRoot->IsExist(stKey);
+}
+
+IJsonObj::ObjType CJsonTapeDoc::GetType()
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetType() : ObjType::Unknow;
+}
+
+uint32_t CJsonTapeDoc::GetSize()
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetSize() : 0;
+}
+
+IJsonObj::ObjType CJsonTapeDoc::GetType(const char *lpKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetType(lpKey) : ObjType::Unknow;
+}
+
+IJsonObj::ObjType CJsonTapeDoc::GetType(const Key &stKey)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetType(stKey) : ObjType::Unknow;
+}
+
+IJsonObj::ObjType CJsonTapeDoc::GetType(uint32_t uIndex)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetType(uIndex) : ObjType::Unknow;
+}
+
+int32_t CJsonTapeDoc::GetItem(uint32_t uIndex, KvItem *lpKvItem)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetItem(uIndex, lpKvItem) : InvaliadParam;
+}
+
+bool CJsonTapeDoc::First(Cursor *lpCursor, KvItem *lpKvItem)
+{
+    return m_lpRoot != nullptr && m_lpRoot->First(lpCursor, lpKvItem);
+}
+
+bool CJsonTapeDoc::Next(Cursor *lpCursor, KvItem *lpKvItem)
+{
+    return m_lpRoot != nullptr && m_lpRoot->Next(lpCursor, lpKvItem);
+}
+
+const char *CJsonTapeDoc::GetJsonStr(bool bPretty)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetJsonStr(bPretty) : nullptr;
+}
+
+const char *CJsonTapeDoc::GetBinary(BinaryFormat eFormat, uint64_t *lpLen)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->GetBinary(eFormat, lpLen) : nullptr;
+}
+
+int32_t CJsonTapeDoc::SaveSnapshot(const char *lpFile)
+{
+    return m_lpRoot != nullptr ? m_lpRoot->SaveSnapshot(lpFile) : InvaliadCall;
+}
+
+IJsonObj *CJsonTapeDoc::Freeze()
+{
+    return m_lpRoot != nullptr ? m_lpRoot->Freeze() : nullptr;
+}
+
+CJsonWriter *CJsonTapeDoc::GetWriter()
+{
+    if (m_lpWriter == nullptr)
+    {
+        m_lpWriter = NEW CJsonWriter();
+        if (m_lpWriter == nullptr)
+        {
+            return nullptr;
+        }
+    }
+
+    m_lpWriter->Clear();
+    return m_lpWriter;
+}
+
+const char *CJsonTapeDoc::WriteJsonStr(const uint64_t *lpValue, bool bPretty)
+{
+    auto lpWriter = GetWriter();
+    if (lpWriter == nullptr || CJsonTapeNode::WriteValue(*lpWriter, lpValue, bPretty, 0) != 0)
+    {
+        return nullptr;
+    }
+
+    return lpWriter->GetStr();
+}
+
+const char *CJsonTapeDoc::WriteBinary(IJsonObj *lpNode, BinaryFormat eFormat, uint64_t *lpLen)
+{
+    auto lpWriter = lpLen != nullptr ? GetWriter() : nullptr;
+    if (lpWriter == nullptr || CJsonBinaryWriter(*lpWriter, eFormat).WriteNode(lpNode) != 0)
+    {
+        return nullptr;
+    }
+
+    *lpLen = lpWriter->GetSize();
+    return lpWriter->GetData();
+}
+
+}
+
+cppbase::IJsonObj *NewTapeJsonObject()
+{
+    return NEW cppbase::CJsonTapeDoc();
+}
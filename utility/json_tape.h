@@ -0,0 +1,241 @@
+#ifndef __JSON_TAPE_H_
+#define __JSON_TAPE_H_
+
+#include <os_common.h>
+#include <json_obj.h>
+
+namespace cppbase
+{
+
+class CJsonWriter;
+class CJsonTapeDoc;
+
+/*
+ * Read-only document laid out as one array of 64-bit words, the tape, in
+ * document order. Every value starts with a word holding its type in the
+ * top byte:
+ *
+ *   null, bool      [type | value]
+ *   int, double     [type] [64-bit value]
+ *   string          [type | length] [pointer to the NUL-terminated bytes]
+ *   array, object   [type | words up to the next value] [node, 3 words]
+ *                   members...
+ *
+ * Object members are a string value for the key followed by the value. The
+ * node is the IJsonObj handed out for the container, constructed in place,
+ * so a document costs the tape and one buffer for its decoded strings.
+ */
+class CJsonTapeNode : public IJsonObj
+{
+public:
+    static constexpr uint32_t TypeShift = 56;
+    static constexpr uint64_t PayloadMask = (uint64_t(1) << TypeShift) - 1;
+    // the container word and the node
+    static constexpr uint32_t ContainerWords = 1 + 3;
+
+    CJsonTapeNode(CJsonTapeDoc *lpDoc, uint32_t uCount) : m_lpDoc(lpDoc), m_uCount(uCount) {}
+    ~CJsonTapeNode() override = default;
+
+    int32_t Init(ObjType eType) override;
+
+    int32_t OpenFromFile(const char *lpFile) override;
+    int32_t OpenFromBuffer(const char *lpBuffer) override;
+    int32_t OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen) override;
+    int32_t OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount) override;
+    int32_t OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat) override;
+    int32_t OpenSnapshot(const char *lpFile) override;
+    int32_t Clear() override;
+
+    int32_t AddNull(const char *lpKey) override;
+    int32_t AddBool(const char *lpKey, bool bValue) override;
+    int32_t AddInt(const char *lpKey, int64_t nValue) override;
+    int32_t AddDouble(const char *lpKey, double dValue) override;
+    int32_t AddString(const char *lpKey, const char *lpValue) override;
+    IJsonObj *AddArray(const char *lpKey) override;
+    IJsonObj *AddObject(const char *lpKey) override;
+
+    bool GetNull(const char *lpKey) override;
+    bool GetBool(const char *lpKey, bool bDefaultValue = false) override;
+    int64_t GetInt(const char *lpKey, int64_t nDefaultValue = 0) override;
+    double GetDouble(const char *lpKey, double dDefaultValue = 0.0) override;
+    const char *GetString(const char *lpKey, const char *lpDefaultValue = nullptr) override;
+    IJsonObj *GetArray(const char *lpKey) override;
+    IJsonObj *GetObject(const char *lpKey) override;
+    bool IsExist(const char *lpKey) override;
+
+    bool GetNull(const Key &stKey) override;
+    bool GetBool(const Key &stKey, bool bDefaultValue = false) override;
+    int64_t GetInt(const Key &stKey, int64_t nDefaultValue = 0) override;
+    double GetDouble(const Key &stKey, double dDefaultValue = 0.0) override;
+    const char *GetString(const Key &stKey, const char *lpDefaultValue = nullptr) override;
+    IJsonObj *GetArray(const Key &stKey) override;
+    IJsonObj *GetObject(const Key &stKey) override;
+    bool IsExist(const Key &stKey) override;
+
+    ObjType GetType() override;
+    uint32_t GetSize() override;
+    ObjType GetType(const char *lpKey) override;
+    ObjType GetType(const Key &stKey) override;
+    ObjType GetType(uint32_t uIndex) override;
+    int32_t GetItem(uint32_t uIndex, KvItem *lpKvItem) override;
+    bool First(Cursor *lpCursor, KvItem *lpKvItem) override;
+    bool Next(Cursor *lpCursor, KvItem *lpKvItem) override;
+
+    const char *GetJsonStr(bool bPretty) override;
+    const char *GetBinary(BinaryFormat eFormat, uint64_t *lpLen) override;
+    int32_t SaveSnapshot(const char *lpFile) override;
+    IJsonObj *Freeze() override;
+
+    static inline ObjType GetType(const uint64_t *lpValue)
+    {
+        return ObjType(*lpValue >> TypeShift);
+    }
+
+    // the first word of the value after lpValue
+    static inline const uint64_t *Skip(const uint64_t *lpValue)
+    {
+        switch (GetType(lpValue))
+        {
+            case ObjType::Array:
+            case ObjType::Object:
+                return lpValue + (*lpValue & PayloadMask);
+
+            case ObjType::Null:
+            case ObjType::Boolean:
+                return lpValue + 1;
+
+            default:
+                return lpValue + 2;
+        }
+    }
+
+    static int32_t WriteValue(CJsonWriter &writer, const uint64_t *lpValue, bool bPretty, uint32_t uDepth);
+
+private:
+    // what a Cursor holds: the next member and how many are left
+    struct CursorState
+    {
+        const uint64_t *lpNext;
+        uint64_t uLeft;
+    };
+
+    inline const uint64_t *GetMembers() const
+    {
+        return reinterpret_cast<const uint64_t *>(this) + ContainerWords - 1;
+    }
+
+    const uint64_t *FindValue(const Key &stKey) const;
+    const uint64_t *GetMember(uint32_t uIndex, const uint64_t *&lpKey) const;
+    bool IsObject() const;
+    static void FillKvItem(const uint64_t *lpKey, const uint64_t *lpValue, KvItem *lpKvItem);
+
+private:
+    CJsonTapeDoc *m_lpDoc;
+    uint32_t m_uCount;
+};
+
+/*
+ * What NewTapeJsonObject returns: the owner of the tape, answering for its
+ * root container. It is filled by one of the Open calls and read-only from
+ * then on.
+ */
+class CJsonTapeDoc : public IJsonObj
+{
+public:
+    CJsonTapeDoc() = default;
+    ~CJsonTapeDoc() override;
+
+    int32_t Init(ObjType eType) override;
+
+    int32_t OpenFromFile(const char *lpFile) override;
+    int32_t OpenFromBuffer(const char *lpBuffer) override;
+    int32_t OpenFromBufferInSitu(char *lpBuffer, uint64_t uLen) override;
+    int32_t OpenFromBuffer(const char *lpBuffer, const char *const *lpPaths, uint32_t uPathCount) override;
+    int32_t OpenFromBinary(const char *lpBuffer, uint64_t uLen, BinaryFormat eFormat) override;
+    int32_t OpenSnapshot(const char *lpFile) override;
+    int32_t Clear() override;
+
+    int32_t AddNull(const char *lpKey) override;
+    int32_t AddBool(const char *lpKey, bool bValue) override;
+    int32_t AddInt(const char *lpKey, int64_t nValue) override;
+    int32_t AddDouble(const char *lpKey, double dValue) override;
+    int32_t AddString(const char *lpKey, const char *lpValue) override;
+    IJsonObj *AddArray(const char *lpKey) override;
+    IJsonObj *AddObject(const char *lpKey) override;
+
+    bool GetNull(const char *lpKey) override;
+    bool GetBool(const char *lpKey, bool bDefaultValue = false) override;
+    int64_t GetInt(const char *lpKey, int64_t nDefaultValue = 0) override;
+    double GetDouble(const char *lpKey, double dDefaultValue = 0.0) override;
+    const char *GetString(const char *lpKey, const char *lpDefaultValue = nullptr) override;
+    IJsonObj *GetArray(const char *lpKey) override;
+    IJsonObj *GetObject(const char *lpKey) override;
+    bool IsExist(const char *lpKey) override;
+
+    bool GetNull(const Key &stKey) override;
+    bool GetBool(const Key &stKey, bool bDefaultValue = false) override;
+    int64_t GetInt(const Key &stKey, int64_t nDefaultValue = 0) override;
+    double GetDouble(const Key &stKey, double dDefaultValue = 0.0) override;
+    const char *GetString(const Key &stKey, const char *lpDefaultValue = nullptr) override;
+    IJsonObj *GetArray(const Key &stKey) override;
+    IJsonObj *GetObject(const Key &stKey) override;
+    bool IsExist(const Key &stKey) override;
+
+    ObjType GetType() override;
+    uint32_t GetSize() override;
+    ObjType GetType(const char *lpKey) override;
+    ObjType GetType(const Key &stKey) override;
+    ObjType GetType(uint32_t uIndex) override;
+    int32_t GetItem(uint32_t uIndex, KvItem *lpKvItem) override;
+    bool First(Cursor *lpCursor, KvItem *lpKvItem) override;
+    bool Next(Cursor *lpCursor, KvItem *lpKvItem) override;
+
+    const char *GetJsonStr(bool bPretty) override;
+    const char *GetBinary(BinaryFormat eFormat, uint64_t *lpLen) override;
+    int32_t SaveSnapshot(const char *lpFile) override;
+    IJsonObj *Freeze() override;
+
+    // every node of the document shares one output buffer
+    const char *WriteJsonStr(const uint64_t *lpValue, bool bPretty);
+    const char *WriteBinary(IJsonObj *lpNode, BinaryFormat eFormat, uint64_t *lpLen);
+
+private:
+    static constexpr uint32_t MaxParseDepth = 1024;
+
+    // the tape builder walks the token offsets produced by CJsonScanner
+    struct BuildContext
+    {
+        const char *lpContent;
+        char *lpInSitu; // lpContent when strings are decoded in place, else nullptr
+        uint64_t uLen;
+        const uint32_t *lpIndex;
+        uint32_t uCount;
+        uint32_t uDepth;
+        uint64_t *lpTape;
+        uint64_t *lpTapeEnd;
+        char *lpStr;
+        char *lpStrEnd;
+    };
+
+    static char PeekToken(const BuildContext &stCtx, uint32_t uIndex);
+    static bool IsDelimiter(const BuildContext &stCtx, uint64_t uPos);
+    static void Measure(const BuildContext &stCtx, uint64_t &uWords, uint64_t &uStrBytes);
+    static int32_t BuildString(BuildContext &stCtx, uint32_t &uIndex);
+    int32_t BuildValue(BuildContext &stCtx, uint32_t &uIndex);
+    int32_t BuildContainer(BuildContext &stCtx, uint32_t &uIndex);
+    int32_t Build(const char *lpContent, uint64_t uLen, bool bInSitu);
+    static int32_t BuildFileContent(void *lpParam, const char *lpContent, uint64_t uLen);
+    CJsonWriter *GetWriter();
+
+private:
+    uint64_t *m_lpTape{nullptr};
+    char *m_lpStrings{nullptr};
+    uint64_t m_uTapeWords{0}; // what the buffers hold, more than the tape
+    uint64_t m_uStrBytes{0};  // uses after a Clear
+    CJsonTapeNode *m_lpRoot{nullptr};
+    CJsonWriter *m_lpWriter{nullptr};
+};
+
+}
+
+#endif //__JSON_TAPE_H_
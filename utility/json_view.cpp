@@ -0,0 +1,57 @@
+#include <json_view.h>
+#include "json_obj_impl.h"
+#include <cstddef>
+
+namespace cppbase
+{
+
+// CJsonView reads the nodes through JsonNodeLayout, so every change to
+// CJsonObjImpl, its value or its containers has to show up there as well
+struct JsonNodeLayoutCheck
+{
+    using Node = CJsonObjImpl;
+    using Value = CJsonObjImpl::_ValueType;
+    using Array = CJsonObjImpl::ArrayValueType;
+    using Object = CJsonObjImpl::ObjValueType;
+    using Layout = JsonNodeLayout;
+
+    static_assert(sizeof(Value) == sizeof(Layout::Value) && alignof(Value) == alignof(Layout::Value) &&
+                      offsetof(Value, uTag) == offsetof(Layout::Value, uTag),
+                  "JsonNodeLayout::Value");
+    static_assert(Value::TypeMask == Layout::Value::TypeMask && Value::ShortStr == Layout::Value::ShortStr &&
+                      Value::ShortStrLen == Layout::Value::ShortStrLen,
+                  "JsonNodeLayout::Value flags");
+    static_assert(sizeof(CJsonObjImpl::StrRef) == sizeof(Layout::Str) &&
+                      offsetof(CJsonObjImpl::StrRef, uLen) == offsetof(Layout::Str, uLen),
+                  "JsonNodeLayout::Str");
+    static_assert(sizeof(Object::Entry) == sizeof(Layout::Member) &&
+                      offsetof(Object::Entry, second) == offsetof(Layout::Member, stValue),
+                  "JsonNodeLayout::Member");
+    static_assert(sizeof(Array) == sizeof(Layout::Array) && offsetof(Array, m_lpItems) == offsetof(Layout::Array, lpItems) &&
+                      offsetof(Array, m_uSize) == offsetof(Layout::Array, uSize),
+                  "JsonNodeLayout::Array");
+    static_assert(sizeof(Object) == sizeof(Layout::Object) &&
+                      offsetof(Object, m_lpHashes) == offsetof(Layout::Object, lpHashes) &&
+                      offsetof(Object, m_lpEntries) == offsetof(Layout::Object, lpEntries) &&
+                      offsetof(Object, m_lpIndex) == offsetof(Layout::Object, lpIndex) &&
+                      offsetof(Object, m_uSize) == offsetof(Layout::Object, uSize) &&
+                      offsetof(Object, m_uIndexMask) == offsetof(Layout::Object, uIndexMask),
+                  "JsonNodeLayout::Object");
+    static_assert(Object::MaxLinearSize == 16, "JsonNodeLayout::Object");
+
+// offsetof is only promised for standard-layout types, which a class with
+// a vtable is not, but GCC and Clang lay it out as one behind the pointer
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+    static_assert(sizeof(Node) == sizeof(Layout) && offsetof(Node, m_eType) == offsetof(Layout, eType) &&
+                      offsetof(Node, m_unValue) == offsetof(Layout, stArray),
+                  "JsonNodeLayout");
+#pragma GCC diagnostic pop
+};
+
+}
+
+const cppbase::JsonNodeLayout *GetJsonNodeLayout(cppbase::IJsonObj *lpJsonObj)
+{
+    return reinterpret_cast<const cppbase::JsonNodeLayout *>(dynamic_cast<cppbase::CJsonObjImpl *>(lpJsonObj));
+}
@@ -0,0 +1,224 @@
+#include "json_writer.h"
+#include "json_number.h"
+#include <error_no.h>
+#include <cmath>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace cppbase
+{
+
+namespace
+{
+
+constexpr uint64_t MinWriterCapacity = 4096;
+constexpr uint32_t IndentWidth = 4;
+
+// 0: copied as is, 'u': \u00XX, otherwise the letter following the backslash
+const char g_szEscape[256] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    0, 0, '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0,
+};
+
+const char g_szHexDigits[] = "0123456789abcdef";
+
+inline char *WriteEscape(char *lpOut, uint8_t ch)
+{
+    auto chEscape = g_szEscape[ch];
+    *lpOut++ = '\\';
+    *lpOut++ = chEscape;
+    if (chEscape == 'u')
+    {
+        memcpy(lpOut, "00", 2);
+        lpOut[2] = g_szHexDigits[ch >> 4];
+        lpOut[3] = g_szHexDigits[ch & 0xF];
+        lpOut += 4;
+    }
+
+    return lpOut;
+}
+
+}
+
+CJsonWriter::~CJsonWriter()
+{
+    free(m_lpBuffer);
+}
+
+int32_t CJsonWriter::Grow(uint64_t uSize)
+{
+    auto uCapacity = m_uCapacity < MinWriterCapacity ? MinWriterCapacity : m_uCapacity;
+    while (uCapacity - m_uSize < uSize)
+    {
+        uCapacity *= 2;
+    }
+
+    auto lpBuffer = reinterpret_cast<char *>(realloc(m_lpBuffer, uCapacity));
+    if (unlikely(lpBuffer == nullptr))
+    {
+        return MallocFailed;
+    }
+
+    m_lpBuffer = lpBuffer;
+    m_uCapacity = uCapacity;
+    return 0;
+}
+
+int32_t CJsonWriter::WriteRaw(const char *lpData, uint64_t uLen)
+{
+    auto iErrorNo = Reserve(uLen);
+    if (unlikely(iErrorNo != 0))
+    {
+        return iErrorNo;
+    }
+
+    memcpy(m_lpBuffer + m_uSize, lpData, uLen);
+    m_uSize += uLen;
+    return 0;
+}
+
+int32_t CJsonWriter::WriteChar(char ch)
+{
+    auto iErrorNo = Reserve(1);
+    if (unlikely(iErrorNo != 0))
+    {
+        return iErrorNo;
+    }
+
+    m_lpBuffer[m_uSize++] = ch;
+    return 0;
+}
+
+int32_t CJsonWriter::WriteNull()
+{
+    return WriteRaw("null", 4);
+}
+
+int32_t CJsonWriter::WriteBool(bool bValue)
+{
+    return bValue ? WriteRaw("true", 4) : WriteRaw("false", 5);
+}
+
+int32_t CJsonWriter::WriteInt(int64_t nValue)
+{
+    auto iErrorNo = Reserve(MaxIntegerChars + 1);
+    if (unlikely(iErrorNo != 0))
+    {
+        return iErrorNo;
+    }
+
+    auto lpEnd = FormatInt64(nValue, m_lpBuffer + m_uSize);
+    m_uSize = lpEnd - m_lpBuffer;
+    return 0;
+}
+
+int32_t CJsonWriter::WriteDouble(double dValue)
+{
+    if (unlikely(!std::isfinite(dValue)))
+    {
+        return WriteNull();
+    }
+
+    auto iErrorNo = Reserve(MaxDoubleChars);
+    if (unlikely(iErrorNo != 0))
+    {
+        return iErrorNo;
+    }
+
+    auto lpEnd = FormatDouble(dValue, m_lpBuffer + m_uSize);
+    m_uSize = lpEnd - m_lpBuffer;
+    return 0;
+}
+
+int32_t CJsonWriter::WriteString(const char *lpStr, uint64_t uLen)
+{
+    auto iErrorNo = Reserve(MaxStringChars(uLen));
+    if (unlikely(iErrorNo != 0))
+    {
+        return iErrorNo;
+    }
+
+    auto lpOut = FormatString(lpStr, uLen, m_lpBuffer + m_uSize);
+    m_uSize = lpOut - m_lpBuffer;
+    return 0;
+}
+
+char *CJsonWriter::FormatString(const char *lpStr, uint64_t uLen, char *lpOut)
+{
+    *lpOut++ = '"';
+
+    uint64_t uPos = 0;
+#if defined(__SSE2__)
+    // copy 16 bytes at a time until one of them needs escaping
+    const __m128i stQuote = _mm_set1_epi8('"');
+    const __m128i stBackslash = _mm_set1_epi8('\\');
+    const __m128i stControl = _mm_set1_epi8(0x1F);
+    while (uPos + 16 <= uLen)
+    {
+        auto stChunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lpStr + uPos));
+        auto stMatch = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(stChunk, stQuote), _mm_cmpeq_epi8(stChunk, stBackslash)),
+                                    _mm_cmpeq_epi8(_mm_min_epu8(stChunk, stControl), stChunk));
+        auto uMask = uint32_t(_mm_movemask_epi8(stMatch));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lpOut), stChunk);
+        if (likely(uMask == 0))
+        {
+            lpOut += 16;
+            uPos += 16;
+            continue;
+        }
+
+        auto uClean = uint32_t(__builtin_ctz(uMask));
+        lpOut = WriteEscape(lpOut + uClean, uint8_t(lpStr[uPos + uClean]));
+        uPos += uClean + 1;
+    }
+#endif
+
+    for (; uPos < uLen; uPos++)
+    {
+        auto ch = uint8_t(lpStr[uPos]);
+        if (likely(g_szEscape[ch] == 0))
+        {
+            *lpOut++ = char(ch);
+        }
+        else
+        {
+            lpOut = WriteEscape(lpOut, ch);
+        }
+    }
+
+    *lpOut++ = '"';
+    return lpOut;
+}
+
+int32_t CJsonWriter::WriteIndent(uint32_t uDepth)
+{
+    auto uLen = uint64_t(uDepth) * IndentWidth + 1;
+    auto iErrorNo = Reserve(uLen);
+    if (unlikely(iErrorNo != 0))
+    {
+        return iErrorNo;
+    }
+
+    m_lpBuffer[m_uSize] = '\n';
+    memset(m_lpBuffer + m_uSize + 1, ' ', uLen - 1);
+    m_uSize += uLen;
+    return 0;
+}
+
+const char *CJsonWriter::GetStr()
+{
+    if (unlikely(Reserve(1) != 0))
+    {
+        return nullptr;
+    }
+
+    m_lpBuffer[m_uSize] = '\0';
+    return m_lpBuffer;
+}
+
+}
@@ -0,0 +1,85 @@
+#ifndef __JSON_WRITER_H_
+#define __JSON_WRITER_H_
+
+#include <os_common.h>
+
+namespace cppbase
+{
+
+/*
+ * Output buffer of the json serializer.
+ *
+ * The buffer only ever grows and is kept between documents, so a node
+ * that is serialized repeatedly stops allocating after the first call.
+ * Every Write* call returns MallocFailed when the buffer cannot grow.
+ */
+class CJsonWriter
+{
+public:
+    CJsonWriter() = default;
+    ~CJsonWriter();
+
+    CJsonWriter(const CJsonWriter &) = delete;
+    CJsonWriter &operator=(const CJsonWriter &) = delete;
+
+    inline void Clear() { m_uSize = 0; }
+
+    int32_t WriteRaw(const char *lpData, uint64_t uLen);
+    int32_t WriteChar(char ch);
+    int32_t WriteNull();
+    int32_t WriteBool(bool bValue);
+    int32_t WriteInt(int64_t nValue);
+    // NaN and infinities have no json form and are written as null
+    int32_t WriteDouble(double dValue);
+    int32_t WriteString(const char *lpStr, uint64_t uLen);
+    // newline followed by uDepth levels of four-space indentation
+    int32_t WriteIndent(uint32_t uDepth);
+
+    // what WriteString writes, quotes included, into lpOut of at least
+    // MaxStringChars(uLen) bytes; returns the end of the output
+    static char *FormatString(const char *lpStr, uint64_t uLen, char *lpOut);
+    // worst case: every byte becomes \u00XX, plus the quotes
+    static inline uint64_t MaxStringChars(uint64_t uLen) { return uLen * 6 + 2; }
+
+    // appends uLen bytes for the caller to fill, nullptr when the buffer
+    // cannot grow
+    inline char *Extend(uint64_t uLen)
+    {
+        if (unlikely(Reserve(uLen) != 0))
+        {
+            return nullptr;
+        }
+
+        auto lpOut = m_lpBuffer + m_uSize;
+        m_uSize += uLen;
+        return lpOut;
+    }
+
+    // NUL-terminated output, valid until the next write or Clear
+    const char *GetStr();
+    // the output as it is, for binary forms
+    inline const char *GetData() const { return m_lpBuffer; }
+    inline uint64_t GetSize() const { return m_uSize; }
+
+private:
+    inline int32_t Reserve(uint64_t uSize)
+    {
+        if (likely(m_uCapacity - m_uSize >= uSize))
+        {
+            return 0;
+        }
+
+        return Grow(uSize);
+    }
+
+    int32_t Grow(uint64_t uSize);
+
+private:
+    char *m_lpBuffer{nullptr};
+    uint64_t m_uSize{0};
+    uint64_t m_uCapacity{0};
+};
+
+}
+
+#endif //__JSON_WRITER_H_
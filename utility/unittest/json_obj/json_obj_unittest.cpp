@@ -1,5 +1,16 @@
 #include <gtest/gtest.h>
 #include <json_obj.h>
+#include <json_handler.h>
+#include <json_lines.h>
+#include <json_stream.h>
+#include <json_bind.h>
+#include <json_view.h>
+#include <error_no.h>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 TEST(JsonObj, SetAndGet)
 {
@@ -10,7 +21,7 @@ TEST(JsonObj, SetAndGet)
     EXPECT_EQ(lpJsonObj->AddBool("bool", true), 0);
     EXPECT_EQ(lpJsonObj->AddInt("int", 100), 0);
     EXPECT_EQ(lpJsonObj->AddString("string", "string"), 0);
-    EXPECT_EQ(lpJsonObj->AddArray("array")->AddInt("arr1", 1), 0);
+    EXPECT_EQ(lpJsonObj->AddArray("array")->AddInt(nullptr, 1), 0);
     EXPECT_EQ(lpJsonObj->AddObject("object")->AddString("str1", "str1"), 0);
     EXPECT_EQ(lpJsonObj->GetNull("null"), true);
     EXPECT_EQ(lpJsonObj->GetBool("bool", false), true);
@@ -19,12 +30,1657 @@ TEST(JsonObj, SetAndGet)
     cppbase::IJsonObj::KvItem kvItem;
     EXPECT_EQ(lpJsonObj->GetArray("array")->GetItem(0, &kvItem), 0);
     EXPECT_EQ(kvItem.nValue, 1);
-    EXPECT_EQ(lpJsonObj->GetObject("object")->GetString("str1", nullptr), "str1");
+    EXPECT_STREQ(lpJsonObj->GetObject("object")->GetString("str1", nullptr), "str1");
     EXPECT_EQ(lpJsonObj->GetSize(), 6);
     EXPECT_EQ(lpJsonObj->GetType(), cppbase::IJsonObj::ObjType::Object);
     DeleteJsonObject(lpJsonObj);
 }
 
+TEST(JsonObj, KeyHandle)
+{
+    static const cppbase::IJsonObj::Key stNull("null"), stBool("bool"), stInt("int"), stDouble("double"),
+        stString("string"), stArray("array"), stObject("object"), stMissing("missing"), stEmpty(nullptr);
+    // a key needs no terminator when the length is given
+    static const cppbase::IJsonObj::Key stPrefix("intx", 3);
+
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(
+        "{\"null\": null, \"bool\": true, \"int\": 7, \"double\": 0.5, \"string\": \"s\", \"array\": [1],"
+        " \"object\": {\"int\": 8}}"), 0);
+    EXPECT_TRUE(lpJsonObj->GetNull(stNull));
+    EXPECT_TRUE(lpJsonObj->GetBool(stBool, false));
+    EXPECT_EQ(lpJsonObj->GetInt(stInt, 0), 7);
+    EXPECT_EQ(lpJsonObj->GetInt(stPrefix, 0), 7);
+    EXPECT_EQ(lpJsonObj->GetDouble(stDouble, 0.0), 0.5);
+    EXPECT_STREQ(lpJsonObj->GetString(stString, nullptr), "s");
+    EXPECT_EQ(lpJsonObj->GetArray(stArray)->GetSize(), 1);
+    EXPECT_EQ(lpJsonObj->GetObject(stObject)->GetInt(stInt, 0), 8);
+    EXPECT_EQ(lpJsonObj->GetType(stDouble), cppbase::IJsonObj::ObjType::Double);
+    EXPECT_TRUE(lpJsonObj->IsExist(stArray));
+
+    // missing keys and type mismatches fall back like the string lookups
+    EXPECT_FALSE(lpJsonObj->IsExist(stMissing));
+    EXPECT_FALSE(lpJsonObj->IsExist(stEmpty));
+    EXPECT_EQ(lpJsonObj->GetInt(stMissing, -1), -1);
+    EXPECT_EQ(lpJsonObj->GetInt(stDouble, -1), -1);
+    EXPECT_EQ(lpJsonObj->GetType(stMissing), cppbase::IJsonObj::ObjType::Unknow);
+    EXPECT_EQ(lpJsonObj->GetArray(stObject), nullptr);
+    EXPECT_EQ(lpJsonObj->GetArray(stArray)->GetInt(stInt, -1), -1);
+    DeleteJsonObject(lpJsonObj);
+}
+
+TEST(JsonObj, OpenFromBuffer)
+{
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_NE(lpJsonObj, nullptr);
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(
+        " {\"null\": null, \"bool\" : false, \"int\":-42, \"double\": 1.5e3,\n"
+        "  \"string\": \"a\\\"b\\\\c\\u00e9\\ud83d\\ude00\", \"array\": [1, \"x\", [], {}, true],\n"
+        "  \"object\": {\"key\": \"value\"}} "), 0);
+    EXPECT_EQ(lpJsonObj->GetType(), cppbase::IJsonObj::ObjType::Object);
+    EXPECT_EQ(lpJsonObj->GetSize(), 7);
+    EXPECT_EQ(lpJsonObj->GetNull("null"), true);
+    EXPECT_EQ(lpJsonObj->GetBool("bool", true), false);
+    EXPECT_EQ(lpJsonObj->GetInt("int", 0), -42);
+    EXPECT_EQ(lpJsonObj->GetDouble("double", 0.0), 1500.0);
+    EXPECT_STREQ(lpJsonObj->GetString("string", nullptr), "a\"b\\c\xc3\xa9\xf0\x9f\x98\x80");
+    EXPECT_EQ(lpJsonObj->GetArray("array")->GetSize(), 5);
+    EXPECT_EQ(lpJsonObj->GetArray("array")->GetType(3), cppbase::IJsonObj::ObjType::Object);
+    EXPECT_STREQ(lpJsonObj->GetObject("object")->GetString("key", nullptr), "value");
+    DeleteJsonObject(lpJsonObj);
+
+    // escapes and tokens straddling the 64 byte scanner blocks
+    std::string strJson = "[";
+    for (int i = 0; i < 200; i++)
+    {
+        strJson += std::string(i % 7, ' ') + "\"" + std::string(i % 67, 'x') + "\\\\\\\"\",";
+    }
+    strJson += "12345678901]";
+    lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(strJson.c_str()), 0);
+    EXPECT_EQ(lpJsonObj->GetSize(), 201);
+    cppbase::IJsonObj::KvItem kvItem;
+    EXPECT_EQ(lpJsonObj->GetItem(66, &kvItem), 0);
+    EXPECT_EQ(std::string(kvItem.strValue), std::string(66, 'x') + "\\\"");
+    EXPECT_EQ(lpJsonObj->GetItem(200, &kvItem), 0);
+    EXPECT_EQ(kvItem.nValue, 12345678901);
+    DeleteJsonObject(lpJsonObj);
+}
+
+TEST(JsonObj, OpenFromBufferInvalid)
+{
+    const char *lpInvalid[] = {
+        "", "   ", "1", "{", "[1,]", "{\"a\" 1}", "{\"a\":}", "[tru]", "[nul]", "[01]", "[1.]", "[-]",
+        "[1 2]", "[\"abc]", "{\"a\":1}x", "[\"\\x\"]", "[\"\\ud800\"]", "{} {}", "[1e]", "[truex]"
+    };
+
+    for (auto lpJson : lpInvalid)
+    {
+        auto lpJsonObj = NewJsonObject();
+        EXPECT_NE(lpJsonObj->OpenFromBuffer(lpJson), 0) << lpJson;
+        DeleteJsonObject(lpJsonObj);
+    }
+}
+
+TEST(JsonObj, ControlCharsInStrings)
+{
+    // raw bytes below 0x20 must be escaped inside strings, here and past
+    // the first 64-byte block of the scanner
+    std::string strLong(100, 'x');
+    std::string szInvalid[] = {std::string("[\"a\x01b\"]"), std::string("{\"a\tb\": 1}"),
+                               std::string("[\"a\nb\"]"), "[\"" + strLong + "\x1f\"]",
+                               std::string("[\"\\\x01\"]")};
+    for (auto &strJson : szInvalid)
+    {
+        cppbase::IJsonObj *szJsonObj[] = {NewJsonObject(), NewArenaJsonObject(256), NewTapeJsonObject(),
+                                          NewLazyJsonObject(), NewParallelJsonObject(2)};
+        for (auto lpJsonObj : szJsonObj)
+        {
+            EXPECT_EQ(lpJsonObj->OpenFromBuffer(strJson.c_str()), cppbase::ParseDataFialed) << strJson;
+            DeleteJsonObject(lpJsonObj);
+        }
+
+        auto lpJsonObj = NewJsonObject();
+        std::string strInSitu = strJson;
+        EXPECT_EQ(lpJsonObj->OpenFromBufferInSitu(&strInSitu[0], strInSitu.size()), cppbase::ParseDataFialed);
+        DeleteJsonObject(lpJsonObj);
+
+        cppbase::IJsonHandler handler;
+        EXPECT_EQ(ParseJsonWithHandler(strJson.data(), strJson.size(), &handler), cppbase::ParseDataFialed);
+        auto lpParser = NewJsonPushParser(&handler);
+        auto iErrorNo = lpParser->Feed(strJson.data(), strJson.size());
+        EXPECT_EQ(iErrorNo != 0 ? iErrorNo : lpParser->Finish(), cppbase::ParseDataFialed) << strJson;
+        DeleteJsonPushParser(lpParser);
+    }
+
+    // escaped they are fine
+    auto lpJsonObj = NewTapeJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer("[\"a\\u0001b\\tc\"]"), 0);
+    cppbase::IJsonObj::KvItem kvItem;
+    EXPECT_EQ(lpJsonObj->GetItem(0, &kvItem), 0);
+    EXPECT_STREQ(kvItem.strValue, "a\x01" "b\tc");
+    DeleteJsonObject(lpJsonObj);
+}
+
+TEST(JsonObj, ParseNumbers)
+{
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(
+        "{\"max\": 9223372036854775807, \"min\": -9223372036854775808, \"over\": 9223372036854775808,"
+        " \"long\": 123456789012345678901234567890, \"eight\": 1234567812345678, \"zero\": -0.0,"
+        " \"frac\": 0.000000000000000000000000000123456789012345678901, \"exact\": 9007199254740993.0,"
+        " \"small\": 4.9406564584124654e-324, \"under\": 1e-400, \"huge\": 1.7976931348623157e308,"
+        " \"inf\": 2e308, \"exp\": 1e000000000000000000000000000000000000001, \"half\": 2.5e-1}"), 0);
+    EXPECT_EQ(lpJsonObj->GetInt("max", 0), INT64_MAX);
+    EXPECT_EQ(lpJsonObj->GetInt("min", 0), INT64_MIN);
+    EXPECT_EQ(lpJsonObj->GetType("over"), cppbase::IJsonObj::ObjType::Double);
+    EXPECT_EQ(lpJsonObj->GetDouble("over", 0.0), 9223372036854775808.0);
+    EXPECT_EQ(lpJsonObj->GetDouble("long", 0.0), 123456789012345678901234567890.0);
+    EXPECT_EQ(lpJsonObj->GetInt("eight", 0), 1234567812345678);
+    EXPECT_TRUE(std::signbit(lpJsonObj->GetDouble("zero", 1.0)));
+    EXPECT_EQ(lpJsonObj->GetDouble("frac", 0.0), 0.000000000000000000000000000123456789012345678901);
+    EXPECT_EQ(lpJsonObj->GetDouble("exact", 0.0), 9007199254740992.0);
+    EXPECT_EQ(lpJsonObj->GetDouble("small", 0.0), 5e-324);
+    EXPECT_EQ(lpJsonObj->GetDouble("under", 1.0), 0.0);
+    EXPECT_EQ(lpJsonObj->GetDouble("huge", 0.0), 1.7976931348623157e308);
+    EXPECT_TRUE(std::isinf(lpJsonObj->GetDouble("inf", 0.0)));
+    EXPECT_EQ(lpJsonObj->GetDouble("exp", 0.0), 10.0);
+    EXPECT_EQ(lpJsonObj->GetDouble("half", 0.0), 0.25);
+    DeleteJsonObject(lpJsonObj);
+
+    // a mantissa exactly halfway between two doubles needs every digit
+    lpJsonObj = NewJsonObject();
+    std::string strHalf = "[9007199254740993" + std::string(300, '0') + "e-300, 9007199254740993" + std::string(300, '0') + "1e-301]";
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(strHalf.c_str()), 0);
+    EXPECT_EQ(lpJsonObj->GetType(0U), cppbase::IJsonObj::ObjType::Double);
+    EXPECT_STREQ(lpJsonObj->GetJsonStr(false), "[9007199254740992.0,9007199254740994.0]");
+    DeleteJsonObject(lpJsonObj);
+}
+
+TEST(JsonObj, OpenFromBufferInSitu)
+{
+    char szJson[] = "{\"plain\": \"value\", \"esc\\u00e9\": \"a\\tb\\u0041\\ud83d\\ude00\", \"list\": [\"x\", 1]}";
+    auto lpEnd = szJson + sizeof(szJson) - 1;
+
+    // keys and strings stay inside the caller's buffer
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBufferInSitu(szJson, sizeof(szJson) - 1), 0);
+    auto lpPlain = lpJsonObj->GetString("plain", nullptr);
+    EXPECT_STREQ(lpPlain, "value");
+    EXPECT_TRUE(lpPlain > szJson && lpPlain < lpEnd);
+    EXPECT_STREQ(lpJsonObj->GetString("esc\xc3\xa9", nullptr), "a\tbA\xf0\x9f\x98\x80");
+    EXPECT_STREQ(lpJsonObj->GetArray("list")->GetJsonStr(false), "[\"x\",1]");
+
+    // owned and in-situ strings mix in one document
+    EXPECT_EQ(lpJsonObj->AddString("owned", "copy"), 0);
+    EXPECT_STREQ(lpJsonObj->GetString("owned", nullptr), "copy");
+    DeleteJsonObject(lpJsonObj);
+
+    char szArray[] = "[\"a\", \"b\\n\"] trailing bytes past uLen";
+    lpJsonObj = NewArenaJsonObject(0);
+    EXPECT_EQ(lpJsonObj->OpenFromBufferInSitu(szArray, 13), 0);
+    cppbase::IJsonObj::KvItem kvItem;
+    EXPECT_EQ(lpJsonObj->GetItem(1, &kvItem), 0);
+    EXPECT_STREQ(kvItem.strValue, "b\n");
+    DeleteJsonObject(lpJsonObj);
+
+    char szInvalid[] = "[\"bad \\x escape\"]";
+    lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBufferInSitu(szInvalid, sizeof(szInvalid) - 1), cppbase::ParseDataFialed);
+    EXPECT_EQ(lpJsonObj->OpenFromBufferInSitu(nullptr, 0), cppbase::InvaliadParam);
+    DeleteJsonObject(lpJsonObj);
+}
+
+TEST(JsonObj, OpenFromFile)
+{
+    // tokens longer than a line and values spanning several lines
+    std::string strLong(10000, 'v');
+    std::string strJson = "{\n  \"long\": \"" + strLong + "\",\n  \"list\": [1,\n 2,\n 3]\n}\n";
+
+    char szFile[] = "/tmp/json_obj_unittest_XXXXXX";
+    auto iFd = mkstemp(szFile);
+    EXPECT_GE(iFd, 0);
+    EXPECT_EQ(write(iFd, strJson.data(), strJson.size()), ssize_t(strJson.size()));
+    close(iFd);
+
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromFile(szFile), 0);
+    EXPECT_EQ(strLong, lpJsonObj->GetString("long", nullptr));
+    EXPECT_EQ(lpJsonObj->GetArray("list")->GetSize(), 3);
+    DeleteJsonObject(lpJsonObj);
+    unlink(szFile);
+
+    // pipes cannot be mapped and are read whole
+    int szPipe[2];
+    EXPECT_EQ(pipe(szPipe), 0);
+    EXPECT_EQ(write(szPipe[1], "[true, \"pipe\"]", 14), 14);
+    close(szPipe[1]);
+    std::string strPipe = "/proc/self/fd/" + std::to_string(szPipe[0]);
+    lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromFile(strPipe.c_str()), 0);
+    EXPECT_EQ(lpJsonObj->GetSize(), 2);
+    close(szPipe[0]);
+
+    EXPECT_EQ(lpJsonObj->OpenFromFile("/nonexistent/file.json"), cppbase::OpenFileFailed);
+    DeleteJsonObject(lpJsonObj);
+}
+
+TEST(JsonObj, OpenWithProjection)
+{
+    const char *lpJson = "{\"order\": {\"price\": 1.5, \"qty\": 3, \"note\": \"x\", \"legs\": [{\"px\": 1, \"venue\": \"A\"}, 2]},"
+                         " \"meta\": {\"skipped\": [1, {\"deep\": [[]]}], \"bad\": tru}, \"a/b\": {\"c~d\": null, \"e\": 1},"
+                         " \"tail\": [1, 2]}";
+    const char *szPaths[] = {"/order/price", "/order/qty", "/order/legs/px", "/a~1b/c~0d", "/tail"};
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(lpJson, szPaths, 5), 0);
+    EXPECT_STREQ(lpJsonObj->GetJsonStr(false),
+                 "{\"order\":{\"price\":1.5,\"qty\":3,\"legs\":[{\"px\":1},2]},\"a/b\":{\"c~d\":null},\"tail\":[1,2]}");
+    DeleteJsonObject(lpJsonObj);
+
+    // a path ending at a container keeps all of it, a path through a scalar
+    // keeps nothing
+    const char *szWhole[] = {"/order", "/tail/x", "/meta/bad/x"};
+    lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(lpJson, szWhole, 3), 0);
+    EXPECT_EQ(lpJsonObj->GetObject("order")->GetSize(), 4);
+    EXPECT_EQ(lpJsonObj->GetArray("tail")->GetSize(), 2);
+    EXPECT_EQ(lpJsonObj->GetObject("meta")->GetSize(), 0);
+    DeleteJsonObject(lpJsonObj);
+
+    // the empty path is the whole document, which then has to be valid
+    const char *szAll[] = {""};
+    lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(lpJson, szAll, 1), cppbase::ParseDataFialed);
+    DeleteJsonObject(lpJsonObj);
+    lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(lpJson, nullptr, 0), 0);
+    EXPECT_EQ(lpJsonObj->GetSize(), 0);
+    DeleteJsonObject(lpJsonObj);
+
+    // skipped values are still matched bracket for bracket
+    const char *szInvalid[] = {"{\"a\": [}, \"b\": 1}", "{\"a\": [1, 2}", "{\"a\": , \"b\": 1}", "{\"a\": {\"b\": 1}"};
+    for (auto lpInvalid : szInvalid)
+    {
+        const char *szB[] = {"/b"};
+        lpJsonObj = NewJsonObject();
+        EXPECT_NE(lpJsonObj->OpenFromBuffer(lpInvalid, szB, 1), 0) << lpInvalid;
+        DeleteJsonObject(lpJsonObj);
+    }
+
+    const char *szBadPath[] = {"order"};
+    const char *szBadEscape[] = {"/a~2"};
+    lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(lpJson, szBadPath, 1), cppbase::InvaliadParam);
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(lpJson, szBadEscape, 1), cppbase::InvaliadParam);
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(lpJson, nullptr, 1), cppbase::InvaliadParam);
+    DeleteJsonObject(lpJsonObj);
+
+    auto lpTape = NewTapeJsonObject();
+    EXPECT_EQ(lpTape->OpenFromBuffer(lpJson, szPaths, 5), cppbase::InvaliadCall);
+    DeleteJsonObject(lpTape);
+}
+
+TEST(JsonObj, ArenaDocument)
+{
+    // a tiny chunk size forces chained and dedicated chunks
+    auto lpJsonObj = NewArenaJsonObject(256);
+    EXPECT_NE(lpJsonObj, nullptr);
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer("{\"name\": \"arena\", \"list\": [1, 2.5, \"three\", {\"four\": 4}], \"empty\": {}}"), 0);
+    EXPECT_STREQ(lpJsonObj->GetString("name", nullptr), "arena");
+    EXPECT_EQ(lpJsonObj->GetArray("list")->GetSize(), 4);
+    EXPECT_EQ(lpJsonObj->GetArray("list")->GetType(1), cppbase::IJsonObj::ObjType::Double);
+    EXPECT_EQ(lpJsonObj->GetObject("empty")->GetSize(), 0);
+
+    std::string strLong(4096, 'x');
+    EXPECT_EQ(lpJsonObj->AddString("long", strLong.c_str()), 0);
+    auto lpArray = lpJsonObj->AddArray("numbers");
+    for (int64_t i = 0; i < 1000; i++)
+    {
+        EXPECT_EQ(lpArray->AddInt(nullptr, i), 0);
+    }
+    EXPECT_EQ(lpJsonObj->AddInt("name", 1), cppbase::InvaliadCall);
+
+    EXPECT_EQ(strLong, lpJsonObj->GetString("long", nullptr));
+    cppbase::IJsonObj::KvItem kvItem;
+    EXPECT_EQ(lpJsonObj->GetArray("numbers")->GetItem(999, &kvItem), 0);
+    EXPECT_EQ(kvItem.nValue, 999);
+    EXPECT_EQ(lpJsonObj->GetArray("list")->GetItem(3, &kvItem), 0);
+    EXPECT_EQ(kvItem.lpObj->GetInt("four", 0), 4);
+    DeleteJsonObject(lpJsonObj);
+}
+
+TEST(JsonObj, ObjectMembers)
+{
+    // small objects keep their members in parse order
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer("{\"z\": 1, \"a\": {\"y\": 2, \"b\": 3}, \"m\": [4]}"), 0);
+    EXPECT_STREQ(lpJsonObj->GetJsonStr(false), "{\"z\":1,\"a\":{\"y\":2,\"b\":3},\"m\":[4]}");
+    EXPECT_NE(lpJsonObj->OpenFromBuffer("{\"k\": 1, \"k\": 2}"), 0);
+    DeleteJsonObject(lpJsonObj);
+
+    // growing past the linear search limit switches to the index, with
+    // both kinds of document
+    cppbase::IJsonObj *szJsonObj[] = {NewJsonObject(), NewArenaJsonObject(0)};
+    for (auto lpObj : szJsonObj)
+    {
+        EXPECT_EQ(lpObj->Init(cppbase::IJsonObj::ObjType::Object), 0);
+        for (int i = 0; i < 1000; i++)
+        {
+            EXPECT_EQ(lpObj->AddInt(("key" + std::to_string(i)).c_str(), i), 0);
+            EXPECT_EQ(lpObj->GetInt(("key" + std::to_string(i / 2)).c_str(), -1), i / 2);
+        }
+        EXPECT_NE(lpObj->AddInt("key999", 0), 0);
+        EXPECT_EQ(lpObj->AddObject("key0"), nullptr);
+        EXPECT_EQ(lpObj->GetSize(), 1000);
+
+        cppbase::IJsonObj::KvItem kvItem;
+        for (uint32_t i = 0; i < 1000; i++)
+        {
+            EXPECT_EQ(lpObj->GetItem(i, &kvItem), 0);
+            EXPECT_EQ(kvItem.lpKey, "key" + std::to_string(i));
+            EXPECT_EQ(lpObj->GetInt(cppbase::IJsonObj::Key(kvItem.lpKey), -1), int64_t(i));
+        }
+        EXPECT_FALSE(lpObj->IsExist("key1000"));
+        EXPECT_FALSE(lpObj->IsExist(""));
+
+        // a parsed copy finds every member again
+        auto lpCopy = NewJsonObject();
+        EXPECT_EQ(lpCopy->OpenFromBuffer(lpObj->GetJsonStr(false)), 0);
+        EXPECT_STREQ(lpCopy->GetJsonStr(false), lpObj->GetJsonStr(false));
+        EXPECT_EQ(lpCopy->GetInt("key500", -1), 500);
+        DeleteJsonObject(lpCopy);
+        DeleteJsonObject(lpObj);
+    }
+}
+
+TEST(JsonObj, ValueLayout)
+{
+    // strings on both sides of the inline limit, including an escaped one
+    // that only fits once decoded
+    std::string strShort(13, 's'), strFull(14, 'f'), strLong(15, 'l');
+    std::string strJson = "[\"\", \"" + strShort + "\", \"" + strFull + "\", \"" + strLong
+                        + "\", \"\\u00e9\\u00e9\\u00e9\\u00e9\\u00e9\\u00e9\\u00e9\", -9223372036854775808, -0.0, false]";
+    cppbase::IJsonObj *szJsonObj[] = {NewJsonObject(), NewArenaJsonObject(0)};
+    for (auto lpJsonObj : szJsonObj)
+    {
+        EXPECT_EQ(lpJsonObj->OpenFromBuffer(strJson.c_str()), 0);
+        cppbase::IJsonObj::KvItem kvItem;
+        const char *szExpect[] = {"", strShort.c_str(), strFull.c_str(), strLong.c_str(),
+                                  "\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9"};
+        for (uint32_t i = 0; i < 5; i++)
+        {
+            EXPECT_EQ(lpJsonObj->GetItem(i, &kvItem), 0);
+            EXPECT_STREQ(kvItem.strValue, szExpect[i]);
+        }
+        EXPECT_EQ(lpJsonObj->GetItem(5, &kvItem), 0);
+        EXPECT_EQ(kvItem.nValue, INT64_MIN);
+        EXPECT_EQ(lpJsonObj->GetItem(6, &kvItem), 0);
+        EXPECT_TRUE(std::signbit(kvItem.dValue));
+        EXPECT_EQ(lpJsonObj->GetType(7U), cppbase::IJsonObj::ObjType::Boolean);
+
+        auto lpCopy = NewJsonObject();
+        EXPECT_EQ(lpCopy->OpenFromBuffer(lpJsonObj->GetJsonStr(false)), 0);
+        EXPECT_STREQ(lpCopy->GetJsonStr(false), lpJsonObj->GetJsonStr(false));
+        DeleteJsonObject(lpCopy);
+        DeleteJsonObject(lpJsonObj);
+    }
+
+    // containers live outside their parent and stay put while it grows
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->Init(cppbase::IJsonObj::ObjType::Object), 0);
+    auto lpInner = lpJsonObj->AddArray("inner");
+    EXPECT_EQ(lpInner->AddString(nullptr, "kept"), 0);
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(lpJsonObj->AddString(("key" + std::to_string(i)).c_str(), "value"), 0);
+    }
+    EXPECT_EQ(lpJsonObj->GetArray("inner"), lpInner);
+    EXPECT_EQ(lpInner->AddNull(nullptr), 0);
+    EXPECT_STREQ(lpInner->GetJsonStr(false), "[\"kept\",null]");
+    EXPECT_STREQ(lpJsonObj->GetString("key99"), "value");
+    DeleteJsonObject(lpJsonObj);
+}
+
+TEST(JsonObj, TapeDocument)
+{
+    const char *lpJson = "{\"id\": 7, \"px\": 1.25, \"ok\": true, \"none\": null, \"sym\": \"A\\u00e9\", "
+                         "\"book\": {\"bid\": [1, [2, []], {\"x\": -3}], \"ask\": []}, \"tail\": \"end\"}";
+    auto lpTape = NewTapeJsonObject();
+    EXPECT_EQ(lpTape->GetType(), cppbase::IJsonObj::ObjType::Unknow);
+    EXPECT_EQ(lpTape->OpenFromBuffer(lpJson), 0);
+    EXPECT_EQ(lpTape->OpenFromBuffer(lpJson), cppbase::InvaliadCall);
+
+    // the same answers, and the same output, as the mutable document
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(lpJson), 0);
+    EXPECT_STREQ(lpTape->GetJsonStr(false), lpJsonObj->GetJsonStr(false));
+    EXPECT_STREQ(lpTape->GetJsonStr(true), lpJsonObj->GetJsonStr(true));
+    DeleteJsonObject(lpJsonObj);
+
+    EXPECT_EQ(lpTape->GetSize(), 7);
+    EXPECT_EQ(lpTape->GetInt("id"), 7);
+    EXPECT_EQ(lpTape->GetDouble(cppbase::IJsonObj::Key("px")), 1.25);
+    EXPECT_TRUE(lpTape->GetBool("ok"));
+    EXPECT_TRUE(lpTape->GetNull("none"));
+    EXPECT_STREQ(lpTape->GetString("sym"), "A\xc3\xa9");
+    EXPECT_STREQ(lpTape->GetString("tail"), "end");
+    EXPECT_EQ(lpTape->GetInt("sym", -1), -1);
+    EXPECT_FALSE(lpTape->IsExist("missing"));
+    EXPECT_EQ(lpTape->GetType(5U), cppbase::IJsonObj::ObjType::Object);
+
+    // nested containers are reached over the skipped siblings
+    auto lpBid = lpTape->GetObject("book")->GetArray("bid");
+    EXPECT_EQ(lpBid->GetSize(), 3);
+    cppbase::IJsonObj::KvItem kvItem;
+    EXPECT_EQ(lpBid->GetItem(2, &kvItem), 0);
+    EXPECT_EQ(kvItem.lpObj->GetInt("x"), -3);
+    EXPECT_STREQ(lpBid->GetJsonStr(false), "[1,[2,[]],{\"x\":-3}]");
+    EXPECT_EQ(lpTape->GetObject("book")->GetArray("ask")->GetSize(), 0);
+
+    cppbase::IJsonObj::Cursor stCursor;
+    uint32_t uCount = 0;
+    for (bool bHas = lpTape->First(&stCursor, &kvItem); bHas; bHas = lpTape->Next(&stCursor, &kvItem))
+    {
+        cppbase::IJsonObj::KvItem kvIndexed;
+        EXPECT_EQ(lpTape->GetItem(uCount++, &kvIndexed), 0);
+        EXPECT_STREQ(kvItem.lpKey, kvIndexed.lpKey);
+    }
+    EXPECT_EQ(uCount, 7);
+    EXPECT_FALSE(lpTape->Next(&stCursor, &kvItem));
+
+    // read-only
+    EXPECT_EQ(lpTape->AddInt("new", 1), cppbase::InvaliadCall);
+    EXPECT_EQ(lpBid->AddNull(nullptr), cppbase::InvaliadCall);
+    EXPECT_EQ(lpTape->AddObject("new"), nullptr);
+    EXPECT_EQ(lpTape->Init(cppbase::IJsonObj::ObjType::Array), cppbase::InvaliadCall);
+    DeleteJsonObject(lpTape);
+
+    // in situ the strings stay in the caller's buffer
+    char szJson[] = "[\"plain\", \"a\\nb\", 12345678901234567890]";
+    lpTape = NewTapeJsonObject();
+    EXPECT_EQ(lpTape->OpenFromBufferInSitu(szJson, sizeof(szJson) - 1), 0);
+    EXPECT_EQ(lpTape->GetItem(0, &kvItem), 0);
+    EXPECT_TRUE(kvItem.strValue > szJson && kvItem.strValue < szJson + sizeof(szJson));
+    EXPECT_EQ(lpTape->GetItem(1, &kvItem), 0);
+    EXPECT_STREQ(kvItem.strValue, "a\nb");
+    EXPECT_EQ(lpTape->GetType(2U), cppbase::IJsonObj::ObjType::Double);
+    DeleteJsonObject(lpTape);
+
+    // a literal takes one word of the measured tape, even as the last value
+    const char *szLiteralLast[] = {"[true]", "[false]", "[null]", "[1,true]", "{\"b\":null}", "[{\"b\":null}]",
+                                   "{\"a\":[1,{\"b\":null}]}", "{\"a\":1,\"b\":false}"};
+    for (auto lpLiteralLast : szLiteralLast)
+    {
+        lpTape = NewTapeJsonObject();
+        EXPECT_EQ(lpTape->OpenFromBuffer(lpLiteralLast), 0) << lpLiteralLast;
+        EXPECT_STREQ(lpTape->GetJsonStr(false), lpLiteralLast);
+        DeleteJsonObject(lpTape);
+
+        std::string strInSitu = lpLiteralLast;
+        lpTape = NewTapeJsonObject();
+        EXPECT_EQ(lpTape->OpenFromBufferInSitu(&strInSitu[0], strInSitu.size()), 0) << lpLiteralLast;
+        DeleteJsonObject(lpTape);
+    }
+
+    const char *szInvalid[] = {"", "1", "{\"a\" 1}", "[1,]", "{\"a\": tru}", "[\"\\x\"]", "[] []", "[{]"};
+    for (auto lpInvalid : szInvalid)
+    {
+        lpTape = NewTapeJsonObject();
+        EXPECT_NE(lpTape->OpenFromBuffer(lpInvalid), 0) << lpInvalid;
+        EXPECT_EQ(lpTape->GetJsonStr(false), nullptr);
+        DeleteJsonObject(lpTape);
+    }
+
+    // a key repeated in one object fails like in the mutable document, even
+    // when it is spelled with escapes, while other objects may reuse it
+    const char *szDuplicate[] = {"{\"a\":1,\"a\":2}", "{\"a\":{\"b\":[1]},\"c\":0,\"a\":null}",
+                                 "[{\"x\":1},{\"y\":[],\"y\":[]}]", "{\"ab\":1,\"\\u0061b\":2}"};
+    for (auto lpDuplicate : szDuplicate)
+    {
+        lpJsonObj = NewJsonObject();
+        EXPECT_EQ(lpJsonObj->OpenFromBuffer(lpDuplicate), cppbase::ParseDataFialed) << lpDuplicate;
+        DeleteJsonObject(lpJsonObj);
+
+        lpTape = NewTapeJsonObject();
+        EXPECT_EQ(lpTape->OpenFromBuffer(lpDuplicate), cppbase::ParseDataFialed) << lpDuplicate;
+        DeleteJsonObject(lpTape);
+
+        std::string strInSitu = lpDuplicate;
+        lpTape = NewTapeJsonObject();
+        EXPECT_EQ(lpTape->OpenFromBufferInSitu(&strInSitu[0], strInSitu.size()), cppbase::ParseDataFialed);
+        DeleteJsonObject(lpTape);
+    }
+
+    lpTape = NewTapeJsonObject();
+    EXPECT_EQ(lpTape->OpenFromBuffer("{\"a\":{\"a\":1},\"b\":[{\"a\":2},{\"a\":3}],\"ab\":0}"), 0);
+    EXPECT_EQ(lpTape->GetObject("a")->GetInt("a"), 1);
+    DeleteJsonObject(lpTape);
+}
+
+TEST(JsonObj, LazyDocument)
+{
+    const char *lpJson = "{\"id\": 7, \"px\": 1.25, \"ok\": true, \"none\": null, \"sym\": \"A\\u00e9\", "
+                         "\"book\": {\"bid\": [1, [2, []], {\"x\": -3}], \"ask\": []}, \"k\\\"q\": \"end\"}";
+    auto lpLazy = NewLazyJsonObject();
+    EXPECT_EQ(lpLazy->GetType(), cppbase::IJsonObj::ObjType::Unknow);
+    EXPECT_EQ(lpLazy->OpenFromBuffer(lpJson), 0);
+    EXPECT_EQ(lpLazy->OpenFromBuffer(lpJson), cppbase::InvaliadCall);
+
+    // the same answers, and the same output, as the mutable document
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(lpJson), 0);
+    EXPECT_STREQ(lpLazy->GetJsonStr(false), lpJsonObj->GetJsonStr(false));
+    EXPECT_STREQ(lpLazy->GetJsonStr(true), lpJsonObj->GetJsonStr(true));
+    DeleteJsonObject(lpJsonObj);
+
+    EXPECT_EQ(lpLazy->GetSize(), 7);
+    EXPECT_EQ(lpLazy->GetInt("id"), 7);
+    EXPECT_EQ(lpLazy->GetDouble(cppbase::IJsonObj::Key("px")), 1.25);
+    EXPECT_TRUE(lpLazy->GetBool("ok"));
+    EXPECT_TRUE(lpLazy->GetNull("none"));
+    EXPECT_STREQ(lpLazy->GetString("sym"), "A\xc3\xa9");
+    EXPECT_STREQ(lpLazy->GetString("k\"q"), "end");
+    EXPECT_EQ(lpLazy->GetInt("sym", -1), -1);
+    EXPECT_FALSE(lpLazy->IsExist("missing"));
+    EXPECT_FALSE(lpLazy->IsExist("i"));
+    EXPECT_EQ(lpLazy->GetType(5U), cppbase::IJsonObj::ObjType::Object);
+
+    // values are converted once and kept
+    EXPECT_EQ(lpLazy->GetString("sym"), lpLazy->GetString("sym"));
+    EXPECT_EQ(lpLazy->GetObject("book"), lpLazy->GetObject("book"));
+
+    auto lpBid = lpLazy->GetObject("book")->GetArray("bid");
+    EXPECT_EQ(lpBid->GetSize(), 3);
+    cppbase::IJsonObj::KvItem kvItem;
+    EXPECT_EQ(lpBid->GetItem(2, &kvItem), 0);
+    EXPECT_EQ(kvItem.lpObj->GetInt("x"), -3);
+    EXPECT_EQ(lpBid->GetItem(0, &kvItem), 0);
+    EXPECT_EQ(kvItem.nValue, 1);
+    EXPECT_NE(lpBid->GetItem(3, &kvItem), 0);
+    EXPECT_STREQ(lpBid->GetJsonStr(false), "[1,[2,[]],{\"x\":-3}]");
+    EXPECT_EQ(lpLazy->GetObject("book")->GetArray("ask")->GetSize(), 0);
+
+    cppbase::IJsonObj::Cursor stCursor;
+    uint32_t uCount = 0;
+    for (bool bHas = lpLazy->First(&stCursor, &kvItem); bHas; bHas = lpLazy->Next(&stCursor, &kvItem))
+    {
+        cppbase::IJsonObj::KvItem kvIndexed;
+        EXPECT_EQ(lpLazy->GetItem(uCount++, &kvIndexed), 0);
+        EXPECT_STREQ(kvItem.lpKey, kvIndexed.lpKey);
+    }
+    EXPECT_EQ(uCount, 7);
+    EXPECT_FALSE(lpLazy->Next(&stCursor, &kvItem));
+
+    // read-only
+    EXPECT_EQ(lpLazy->AddInt("new", 1), cppbase::InvaliadCall);
+    EXPECT_EQ(lpBid->AddNull(nullptr), cppbase::InvaliadCall);
+    EXPECT_EQ(lpLazy->AddObject("new"), nullptr);
+    EXPECT_EQ(lpLazy->Init(cppbase::IJsonObj::ObjType::Array), cppbase::InvaliadCall);
+    DeleteJsonObject(lpLazy);
+
+    // in situ the buffer is read where it is and left untouched
+    char szJson[] = "[\"plain\", \"a\\nb\", 12345678901234567890, tru]";
+    lpLazy = NewLazyJsonObject();
+    EXPECT_EQ(lpLazy->OpenFromBufferInSitu(szJson, sizeof(szJson) - 1), 0);
+    EXPECT_EQ(lpLazy->GetItem(1, &kvItem), 0);
+    EXPECT_STREQ(kvItem.strValue, "a\nb");
+    EXPECT_STREQ(szJson, "[\"plain\", \"a\\nb\", 12345678901234567890, tru]");
+    EXPECT_EQ(lpLazy->GetType(2U), cppbase::IJsonObj::ObjType::Double);
+
+    // errors in the bytes of a scalar show up only when it is read
+    EXPECT_EQ(lpLazy->GetType(3U), cppbase::IJsonObj::ObjType::Unknow);
+    EXPECT_NE(lpLazy->GetItem(3, &kvItem), 0);
+    EXPECT_EQ(lpLazy->GetJsonStr(false), nullptr);
+    DeleteJsonObject(lpLazy);
+
+    // but the structure is checked at open, as the other documents do
+    const char *szInvalid[] = {"", "1", "\"a\"", "}", "{", "[1 2]", "[]]", "{\"a\":1]", "[[[[", "{\"a\":1}x",
+                               "[1,]", "[,1]", "{\"a\" 1}", "{\"a\":}", "{,}", "{1:2}", "[\"a\":1]",
+                               "[{\"a\":1},{\"b\":", "{\"a\":1,}", "[] []", "[{]", "{\"a\":[}"};
+    for (auto lpInvalid : szInvalid)
+    {
+        lpLazy = NewLazyJsonObject();
+        EXPECT_EQ(lpLazy->OpenFromBuffer(lpInvalid), cppbase::ParseDataFialed) << lpInvalid;
+        EXPECT_EQ(lpLazy->GetJsonStr(false), nullptr);
+        DeleteJsonObject(lpLazy);
+    }
+
+    // and past the depth the other documents take
+    std::string strDeep = std::string(1025, '[') + std::string(1025, ']');
+    lpLazy = NewLazyJsonObject();
+    EXPECT_EQ(lpLazy->OpenFromBuffer(strDeep.c_str()), cppbase::ParseDataFialed);
+    DeleteJsonObject(lpLazy);
+
+    // keys are not compared at open: a repeated one is kept, the lookups
+    // find its first member and the walks see both
+    lpLazy = NewLazyJsonObject();
+    EXPECT_EQ(lpLazy->OpenFromBuffer("{\"a\":1,\"b\":{\"c\":true,\"c\":false},\"a\":2}"), 0);
+    EXPECT_EQ(lpLazy->GetInt("a"), 1);
+    EXPECT_EQ(lpLazy->GetSize(), 3U);
+    EXPECT_EQ(lpLazy->GetItem(2, &kvItem), 0);
+    EXPECT_STREQ(kvItem.lpKey, "a");
+    EXPECT_EQ(kvItem.nValue, 2);
+    EXPECT_TRUE(lpLazy->GetObject("b")->GetBool("c"));
+    EXPECT_STREQ(lpLazy->GetJsonStr(false), "{\"a\":1,\"b\":{\"c\":true,\"c\":false},\"a\":2}");
+    DeleteJsonObject(lpLazy);
+}
+
+TEST(JsonObj, ParallelArray)
+{
+    // large enough for four shards, with nesting, escapes and scalars
+    std::string strJson = "[";
+    for (int i = 0; i < 40000; i++)
+    {
+        strJson += "{\"id\": " + std::to_string(i) + ", \"s\": \"a\\\"" + std::string(i % 20, 'z') +
+                   "\", \"l\": [[" + std::to_string(i % 7) + "], {}], \"d\": 0.5},\n ";
+        strJson += i % 1000 == 0 ? "\"" + std::string(30, 'q') + "\", null, " : "";
+    }
+    strJson += "[]]";
+    ASSERT_GT(strJson.size(), 4 * 256 * 1024);
+
+    auto lpSerial = NewJsonObject();
+    EXPECT_EQ(lpSerial->OpenFromBuffer(strJson.c_str()), 0);
+    auto lpParallel = NewParallelJsonObject(4);
+    EXPECT_EQ(lpParallel->OpenFromBuffer(strJson.c_str()), 0);
+    EXPECT_EQ(lpParallel->GetSize(), lpSerial->GetSize());
+    EXPECT_STREQ(lpParallel->GetJsonStr(false), lpSerial->GetJsonStr(false));
+
+    // the stitched document stays writable
+    EXPECT_EQ(lpParallel->AddInt(nullptr, 7), 0);
+    cppbase::IJsonObj::KvItem kvItem;
+    EXPECT_EQ(lpParallel->GetItem(lpParallel->GetSize() - 1, &kvItem), 0);
+    EXPECT_EQ(kvItem.nValue, 7);
+    EXPECT_EQ(lpParallel->GetItem(20000, &kvItem), 0);
+    EXPECT_EQ(kvItem.lpObj->AddString("new", "value"), 0);
+    EXPECT_STREQ(kvItem.lpObj->GetString("new"), "value");
+    DeleteJsonObject(lpParallel);
+
+    // in situ, and appended to an array already holding elements
+    std::string strCopy = strJson;
+    lpParallel = NewParallelJsonObject(3);
+    EXPECT_EQ(lpParallel->Init(cppbase::IJsonObj::ObjType::Array), 0);
+    EXPECT_EQ(lpParallel->AddBool(nullptr, true), 0);
+    EXPECT_EQ(lpParallel->OpenFromBufferInSitu(&strCopy[0], strCopy.size()), 0);
+    EXPECT_EQ(lpParallel->GetSize(), lpSerial->GetSize() + 1);
+    EXPECT_EQ(lpParallel->GetItem(1, &kvItem), 0);
+    EXPECT_STREQ(kvItem.lpObj->GetString("s"), "a\"");
+    DeleteJsonObject(lpParallel);
+
+    // the same errors as a serial parse, wherever they fall
+    std::string szInvalid[] = {strJson.substr(0, strJson.size() - 1) + "}", strJson + " 1",
+                               strJson.substr(0, strJson.size() - 3) + "]", "[1, " + strJson.substr(1, strJson.size() - 4) + ",]",
+                               strJson.substr(0, strJson.size() / 2) + "{]" + strJson.substr(strJson.size() / 2)};
+    for (auto &strInvalid : szInvalid)
+    {
+        lpParallel = NewParallelJsonObject(4);
+        EXPECT_NE(lpParallel->OpenFromBuffer(strInvalid.c_str()), 0);
+        DeleteJsonObject(lpParallel);
+    }
+
+    // small documents and objects take the serial path
+    lpParallel = NewParallelJsonObject(4);
+    EXPECT_EQ(lpParallel->OpenFromBuffer("[1, [2]]"), 0);
+    EXPECT_STREQ(lpParallel->GetJsonStr(false), "[1,[2]]");
+    DeleteJsonObject(lpParallel);
+    lpParallel = NewParallelJsonObject(4);
+    EXPECT_EQ(lpParallel->Init(cppbase::IJsonObj::ObjType::Object), 0);
+    EXPECT_EQ(lpParallel->OpenFromBuffer(strJson.c_str()), cppbase::InvaliadCall);
+    DeleteJsonObject(lpParallel);
+    DeleteJsonObject(lpSerial);
+}
+
+TEST(JsonObj, Cursor)
+{
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer(
+        "{\"n\": null, \"b\": true, \"i\": -3, \"d\": 2.5, \"s\": \"x\", \"a\": [1, 1.5, \"y\"], \"o\": {}}"), 0);
+
+    // objects: the same members in the same order as GetItem
+    cppbase::IJsonObj::Cursor stCursor;
+    cppbase::IJsonObj::KvItem kvItem, kvIndexed;
+    uint32_t uCount = 0;
+    for (bool bHas = lpJsonObj->First(&stCursor, &kvItem); bHas; bHas = lpJsonObj->Next(&stCursor, &kvItem))
+    {
+        EXPECT_EQ(lpJsonObj->GetItem(uCount++, &kvIndexed), 0);
+        EXPECT_STREQ(kvItem.lpKey, kvIndexed.lpKey);
+        EXPECT_EQ(kvItem.eType, kvIndexed.eType);
+        if (kvItem.eType == cppbase::IJsonObj::ObjType::Double)
+        {
+            EXPECT_STREQ(kvItem.lpKey, "d");
+            EXPECT_EQ(kvItem.dValue, 2.5);
+        }
+    }
+    EXPECT_EQ(uCount, 7);
+    EXPECT_FALSE(lpJsonObj->Next(&stCursor, &kvItem));
+
+    // arrays, with keyless items
+    auto lpArray = lpJsonObj->GetArray("a");
+    EXPECT_TRUE(lpArray->First(&stCursor, &kvItem));
+    EXPECT_EQ(kvItem.lpKey, nullptr);
+    EXPECT_EQ(kvItem.nValue, 1);
+    EXPECT_TRUE(lpArray->Next(&stCursor, &kvItem));
+    EXPECT_EQ(kvItem.dValue, 1.5);
+    EXPECT_EQ(lpArray->GetItem(1, &kvIndexed), 0);
+    EXPECT_EQ(kvIndexed.dValue, 1.5);
+    EXPECT_TRUE(lpArray->Next(&stCursor, &kvItem));
+    EXPECT_STREQ(kvItem.strValue, "y");
+    EXPECT_FALSE(lpArray->Next(&stCursor, &kvItem));
+    EXPECT_FALSE(lpArray->Next(&stCursor, &kvItem));
+
+    // empty containers, nodes that are no container and missing arguments
+    EXPECT_FALSE(lpJsonObj->GetObject("o")->First(&stCursor, &kvItem));
+    EXPECT_FALSE(lpJsonObj->First(nullptr, &kvItem));
+    EXPECT_FALSE(lpJsonObj->First(&stCursor, nullptr));
+    DeleteJsonObject(lpJsonObj);
+
+    lpJsonObj = NewJsonObject();
+    EXPECT_FALSE(lpJsonObj->First(&stCursor, &kvItem));
+    DeleteJsonObject(lpJsonObj);
+}
+
+TEST(JsonObj, GetJsonStr)
+{
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->GetJsonStr(false), nullptr);
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer("[1, -20, 2.5, 1e300, 0.1, true, null, \"a\\\"b\\\\c\\n\\u0001\\u00e9\", [], {}, [{\"k\": [3]}]]"), 0);
+    EXPECT_STREQ(lpJsonObj->GetJsonStr(false),
+                 "[1,-20,2.5,1e+300,0.1,true,null,\"a\\\"b\\\\c\\n\\u0001\xc3\xa9\",[],{},[{\"k\":[3]}]]");
+
+    cppbase::IJsonObj::KvItem kvItem;
+    EXPECT_EQ(lpJsonObj->GetItem(10, &kvItem), 0);
+    EXPECT_STREQ(kvItem.lpArray->GetJsonStr(true), "[\n    {\n        \"k\": [\n            3\n        ]\n    }\n]");
+    EXPECT_EQ(lpJsonObj->GetItem(8, &kvItem), 0);
+    EXPECT_STREQ(kvItem.lpArray->GetJsonStr(true), "[]");
+
+    // the output parses back to the same document
+    std::string strCompact = lpJsonObj->GetJsonStr(false);
+    auto lpCopy = NewArenaJsonObject(0);
+    EXPECT_EQ(lpCopy->OpenFromBuffer(lpJsonObj->GetJsonStr(true)), 0);
+    EXPECT_EQ(strCompact, lpCopy->GetJsonStr(false));
+    DeleteJsonObject(lpCopy);
+    DeleteJsonObject(lpJsonObj);
+
+    // doubles are written in their shortest form that reads back exactly
+    lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->Init(cppbase::IJsonObj::ObjType::Object), 0);
+    EXPECT_EQ(lpJsonObj->AddDouble("d", 1.0 / 3), 0);
+    EXPECT_EQ(lpJsonObj->AddDouble("e", -2.5e-7), 0);
+    EXPECT_EQ(lpJsonObj->AddDouble("f", 5e-324), 0);
+    EXPECT_EQ(lpJsonObj->AddDouble("g", 100.0), 0);
+    std::string strLong = std::string(20, 'x') + "\"\\\t" + std::string(30, 'y') + "\x1f";
+    EXPECT_EQ(lpJsonObj->AddString("s", strLong.c_str()), 0);
+    lpCopy = NewJsonObject();
+    EXPECT_EQ(lpCopy->OpenFromBuffer(lpJsonObj->GetJsonStr(false)), 0);
+    EXPECT_EQ(lpCopy->GetDouble("d", 0.0), 1.0 / 3);
+    EXPECT_EQ(lpCopy->GetDouble("e", 0.0), -2.5e-7);
+    EXPECT_EQ(lpCopy->GetDouble("f", 0.0), 5e-324);
+    EXPECT_EQ(lpCopy->GetType("g"), cppbase::IJsonObj::ObjType::Double);
+    EXPECT_EQ(strLong, lpCopy->GetString("s", nullptr));
+    DeleteJsonObject(lpCopy);
+    DeleteJsonObject(lpJsonObj);
+}
+
+class CEventRecorder : public cppbase::IJsonHandler
+{
+public:
+    bool OnNull() override { return Record("n"); }
+    bool OnBool(bool bValue) override { return Record(bValue ? "t" : "f"); }
+    bool OnInt(int64_t nValue) override { return Record("i" + std::to_string(nValue)); }
+    bool OnDouble(double dValue) override { return Record("d" + std::to_string(dValue)); }
+    bool OnString(const char *lpStr, uint32_t uLen) override { return Record("s" + std::string(lpStr, uLen)); }
+    bool OnKey(const char *lpKey, uint32_t uLen) override { return Record("k" + std::string(lpKey, uLen)); }
+    bool OnStartObject() override { return Record("{"); }
+    bool OnEndObject() override { return Record("}"); }
+    bool OnStartArray() override { return Record("["); }
+    bool OnEndArray() override { return Record("]"); }
+
+    bool Record(const std::string &strEvent)
+    {
+        m_strEvents += strEvent + " ";
+        return ++m_uEvents != m_uStopAt;
+    }
+
+    std::string m_strEvents;
+    uint32_t m_uEvents{0};
+    uint32_t m_uStopAt{0};
+};
+
+TEST(JsonObj, ParseJsonWithHandler)
+{
+    std::string strJson = "{\"a\": [1, -2.5, true, false, null, \"x\\ny\"], \"b\": {}, \"c\": [[]], \"d\": {\"e\": 9}}";
+    CEventRecorder recorder;
+    EXPECT_EQ(ParseJsonWithHandler(strJson.data(), strJson.size(), &recorder), 0);
+    EXPECT_EQ(recorder.m_strEvents, "{ ka [ i1 d-2.500000 t f n sx\ny ] kb { } kc [ [ ] ] kd { ke i9 } } ");
+
+    // the root is an array or object, as for every document
+    const char *szScalar[] = {" 42 ", "\"s\"", "true", "null", "-1.5"};
+    for (auto lpScalar : szScalar)
+    {
+        CEventRecorder scalar;
+        EXPECT_EQ(ParseJsonWithHandler(lpScalar, strlen(lpScalar), &scalar), cppbase::ParseDataFialed) << lpScalar;
+        EXPECT_EQ(scalar.m_strEvents, "");
+    }
+
+    // integers past int64_t fall back to doubles
+    CEventRecorder bounds;
+    const char szBounds[] = "[-9223372036854775808, 9223372036854775808]";
+    EXPECT_EQ(ParseJsonWithHandler(szBounds, sizeof(szBounds) - 1, &bounds), 0);
+    EXPECT_EQ(bounds.m_strEvents, "[ i-9223372036854775808 d9223372036854775808.000000 ] ");
+
+    // a handler returning false stops the parse
+    CEventRecorder stopper;
+    stopper.m_uStopAt = 3;
+    EXPECT_EQ(ParseJsonWithHandler(strJson.data(), strJson.size(), &stopper), cppbase::ParseCanceled);
+    EXPECT_EQ(stopper.m_strEvents, "{ ka [ ");
+
+    const char *szInvalid[] = {"", "{", "[1,]", "{\"a\" 1}", "{\"a\": 1,}", "[1 2]", "[tru]", "[01]", "{} {}", "[}", "{]"};
+    for (auto lpInvalid : szInvalid)
+    {
+        CEventRecorder invalid;
+        EXPECT_EQ(ParseJsonWithHandler(lpInvalid, strlen(lpInvalid), &invalid), cppbase::ParseDataFialed) << lpInvalid;
+    }
+    EXPECT_EQ(ParseJsonWithHandler(nullptr, 0, &recorder), cppbase::InvaliadParam);
+}
+
+TEST(JsonObj, ParseJsonWithHandlerLarge)
+{
+    // strings and token runs crossing the scanner's windows
+    std::string strLong(200000, 'z');
+    std::string strJson = "[\"" + strLong + "\"";
+    for (int i = 0; i < 100000; i++)
+    {
+        strJson += ", {\"k\": " + std::to_string(i) + "}";
+    }
+    strJson += "]";
+
+    class CCounter : public cppbase::IJsonHandler
+    {
+    public:
+        bool OnInt(int64_t nValue) override { m_nSum += nValue; return true; }
+        bool OnString(const char *lpStr, uint32_t uLen) override { m_uLen += uLen; return true; }
+        bool OnKey(const char *lpKey, uint32_t uLen) override { m_uKeys++; return true; }
+
+        int64_t m_nSum{0};
+        uint64_t m_uLen{0};
+        uint32_t m_uKeys{0};
+    } counter;
+
+    EXPECT_EQ(ParseJsonWithHandler(strJson.data(), strJson.size(), &counter), 0);
+    EXPECT_EQ(counter.m_uLen, strLong.size());
+    EXPECT_EQ(counter.m_uKeys, 100000);
+    EXPECT_EQ(counter.m_nSum, int64_t(99999) * 100000 / 2);
+}
+
+TEST(JsonObj, PushParser)
+{
+    std::string strJson = "{\"key\\\"1\": [12345, -0.5e-3, true, false, null, \"esc\\\\\\\"\\ud83d\\ude00\\u00e9\"],"
+                          " \"nested\": {\"a\": {}, \"b\": [[], {\"c\": \"\"}]}, \"big\": 123456789012345678901234}";
+    CEventRecorder expected;
+    EXPECT_EQ(ParseJsonWithHandler(strJson.data(), strJson.size(), &expected), 0);
+
+    // every split point, including inside strings, escapes, numbers and literals
+    for (size_t i = 0; i <= strJson.size(); i++)
+    {
+        CEventRecorder recorder;
+        auto lpParser = NewJsonPushParser(&recorder);
+        EXPECT_EQ(lpParser->Feed(strJson.data(), i), 0);
+        EXPECT_EQ(lpParser->Feed(strJson.data() + i, strJson.size() - i), 0);
+        EXPECT_EQ(lpParser->Finish(), 0);
+        EXPECT_EQ(recorder.m_strEvents, expected.m_strEvents) << i;
+        DeleteJsonPushParser(lpParser);
+    }
+
+    // one byte at a time, reusing the parser after Reset
+    CEventRecorder recorder;
+    auto lpParser = NewJsonPushParser(&recorder);
+    EXPECT_EQ(lpParser->Feed("[1", 2), 0);
+    EXPECT_EQ(lpParser->Finish(), cppbase::ParseDataFialed);
+    lpParser->Reset();
+    recorder.m_strEvents.clear();
+    for (auto ch : strJson)
+    {
+        EXPECT_EQ(lpParser->Feed(&ch, 1), 0);
+    }
+    EXPECT_EQ(lpParser->Finish(), 0);
+    EXPECT_EQ(recorder.m_strEvents, expected.m_strEvents);
+
+    // a number split between pieces is only complete at the byte after it
+    lpParser->Reset();
+    recorder.m_strEvents.clear();
+    EXPECT_EQ(lpParser->Feed("[12", 3), 0);
+    EXPECT_EQ(lpParser->Feed("34", 2), 0);
+    EXPECT_EQ(recorder.m_strEvents, "[ ");
+    EXPECT_EQ(lpParser->Feed("]", 1), 0);
+    EXPECT_EQ(lpParser->Finish(), 0);
+    EXPECT_EQ(recorder.m_strEvents, "[ i1234 ] ");
+
+    // and like ParseJsonWithHandler it takes no scalar as the root
+    const char *szScalar[] = {"42", " 42 ", "-1.5", "\"s\"", "true", "null"};
+    for (auto lpScalar : szScalar)
+    {
+        lpParser->Reset();
+        recorder.m_strEvents.clear();
+        auto iErrorNo = lpParser->Feed(lpScalar, strlen(lpScalar));
+        EXPECT_EQ(iErrorNo == 0 ? lpParser->Finish() : iErrorNo, cppbase::ParseDataFialed) << lpScalar;
+        EXPECT_EQ(recorder.m_strEvents, "") << lpScalar;
+    }
+
+    const char *szInvalid[] = {"[1,]", "{\"a\" 1}", "[1 2]", "[tru", "[trux]", "[01]", "{} {}", "[}", "[\"\\x\"]",
+                               "[-]"};
+    for (auto lpInvalid : szInvalid)
+    {
+        lpParser->Reset();
+        auto iErrorNo = lpParser->Feed(lpInvalid, strlen(lpInvalid));
+        EXPECT_EQ(iErrorNo == 0 ? lpParser->Finish() : iErrorNo, cppbase::ParseDataFialed) << lpInvalid;
+    }
+    DeleteJsonPushParser(lpParser);
+
+    // building a document piece by piece
+    auto lpJsonObj = NewJsonObject();
+    lpParser = NewJsonObjPushParser(lpJsonObj);
+    for (size_t i = 0; i < strJson.size(); i += 7)
+    {
+        EXPECT_EQ(lpParser->Feed(strJson.data() + i, std::min<size_t>(7, strJson.size() - i)), 0);
+    }
+    EXPECT_EQ(lpParser->Finish(), 0);
+    EXPECT_EQ(lpJsonObj->GetArray("key\"1")->GetSize(), 6);
+    EXPECT_EQ(lpJsonObj->GetObject("nested")->GetArray("b")->GetSize(), 2);
+    EXPECT_EQ(lpJsonObj->GetType("big"), cppbase::IJsonObj::ObjType::Double);
+    cppbase::IJsonObj::KvItem kvItem;
+    EXPECT_EQ(lpJsonObj->GetArray("key\"1")->GetItem(5, &kvItem), 0);
+    EXPECT_STREQ(kvItem.strValue, "esc\\\"\xf0\x9f\x98\x80\xc3\xa9");
+
+    // the root keeps its type and scalars cannot be one
+    lpParser->Reset();
+    EXPECT_EQ(lpParser->Feed("[1] ", 4), cppbase::InvaliadCall);
+    DeleteJsonPushParser(lpParser);
+    DeleteJsonObject(lpJsonObj);
+    lpJsonObj = NewJsonObject();
+    lpParser = NewJsonObjPushParser(lpJsonObj);
+    EXPECT_EQ(lpParser->Feed("\"root\"", 6), cppbase::ParseDataFialed);
+    DeleteJsonPushParser(lpParser);
+    DeleteJsonObject(lpJsonObj);
+}
+
+class CLinesCollector : public cppbase::IJsonLinesConsumer
+{
+public:
+    bool OnBatch(uint64_t uOffset, cppbase::IJsonObj *const *lpRecords, uint32_t uCount) override
+    {
+        EXPECT_TRUE(m_vecOffsets.empty() || !m_bOrdered || uOffset > m_vecOffsets.back());
+        m_vecOffsets.push_back(uOffset);
+        for (uint32_t i = 0; i < uCount; i++)
+        {
+            m_vecIds.push_back(lpRecords[i] != nullptr ? lpRecords[i]->GetInt("id", -2) : -1);
+        }
+        return m_vecOffsets.size() != m_uStopAt;
+    }
+
+    bool m_bOrdered{true};
+    uint32_t m_uStopAt{0};
+    std::vector<uint64_t> m_vecOffsets;
+    std::vector<int64_t> m_vecIds;
+};
+
+TEST(JsonObj, JsonLinesReader)
+{
+    // blank lines are skipped, CRLF and trailing blanks accepted, and a bad
+    // line is a nullptr record
+    std::string strLines;
+    std::vector<int64_t> vecExpected;
+    for (int i = 0; i < 1000; i++)
+    {
+        strLines += "{\"id\": " + std::to_string(i) + ", \"s\": \"" + std::string(i % 50, 'x') + "\"}";
+        strLines += i % 7 == 0 ? " \r\n\n" : "\n";
+        vecExpected.push_back(i);
+        if (i == 500)
+        {
+            strLines += "{\"id\": 501,\n";
+            vecExpected.push_back(-1);
+        }
+    }
+    strLines += "[1, 2]";
+    vecExpected.push_back(-2);
+
+    auto lpReader = NewJsonLinesReader(4, -1, 256, true);
+    CLinesCollector ordered;
+    EXPECT_EQ(lpReader->ReadBuffer(strLines.data(), strLines.size(), &ordered), 0);
+    EXPECT_EQ(ordered.m_vecIds, vecExpected);
+    EXPECT_EQ(ordered.m_vecOffsets.front(), 0);
+
+    // a reader is reused, and a consumer returning false stops it
+    CLinesCollector stopper;
+    stopper.m_uStopAt = 3;
+    EXPECT_EQ(lpReader->ReadBuffer(strLines.data(), strLines.size(), &stopper), cppbase::ParseCanceled);
+    EXPECT_EQ(stopper.m_vecOffsets.size(), 3);
+    EXPECT_EQ(lpReader->ReadBuffer(strLines.data(), strLines.size(), nullptr), cppbase::InvaliadParam);
+    DeleteJsonLinesReader(lpReader);
+
+    // unordered, and lines longer than a batch
+    std::string strLong = "{\"id\": 1, \"long\": \"" + std::string(5000, 'y') + "\"}\n{\"id\": 2}\n";
+    lpReader = NewJsonLinesReader(3, 0, 100, false);
+    CLinesCollector unordered;
+    unordered.m_bOrdered = false;
+    EXPECT_EQ(lpReader->ReadBuffer(strLines.data(), strLines.size(), &unordered), 0);
+    std::sort(unordered.m_vecIds.begin(), unordered.m_vecIds.end());
+    std::sort(vecExpected.begin(), vecExpected.end());
+    EXPECT_EQ(unordered.m_vecIds, vecExpected);
+
+    char szFile[] = "/tmp/json_obj_unittest_XXXXXX";
+    auto iFd = mkstemp(szFile);
+    EXPECT_GE(iFd, 0);
+    EXPECT_EQ(write(iFd, strLong.data(), strLong.size()), ssize_t(strLong.size()));
+    close(iFd);
+    CLinesCollector file;
+    file.m_bOrdered = false;
+    EXPECT_EQ(lpReader->ReadFile(szFile, &file), 0);
+    std::sort(file.m_vecIds.begin(), file.m_vecIds.end());
+    EXPECT_EQ(file.m_vecIds, std::vector<int64_t>({1, 2}));
+    unlink(szFile);
+
+    CLinesCollector empty;
+    EXPECT_EQ(lpReader->ReadBuffer("", 0, &empty), 0);
+    EXPECT_TRUE(empty.m_vecOffsets.empty());
+    DeleteJsonLinesReader(lpReader);
+}
+
+TEST(JsonObj, DocumentStream)
+{
+    // enough documents to cross several scanner windows, brackets inside
+    // strings included
+    std::string strDocs;
+    for (int i = 0; i < 5000; i++)
+    {
+        strDocs += i % 3 == 0 ? "[" + std::to_string(i) + ", \"]}\"]"
+                              : "{\"id\":" + std::to_string(i) + ",\"s\":\"{[" + std::string(i % 40, 'x') + "\"}";
+        strDocs += i % 5 == 0 ? "\n" : "";
+    }
+
+    auto lpStream = NewJsonDocStream(0);
+    ASSERT_NE(lpStream, nullptr);
+    cppbase::IJsonObj *lpDoc = nullptr;
+    EXPECT_EQ(lpStream->Next(&lpDoc), cppbase::InvaliadCall);
+    EXPECT_EQ(lpStream->OpenBuffer(strDocs.data(), strDocs.size()), 0);
+    int iCount = 0;
+    while (lpStream->Next(&lpDoc) == 0 && lpDoc != nullptr)
+    {
+        if (iCount % 3 == 0)
+        {
+            EXPECT_EQ(lpDoc->GetType(), cppbase::IJsonObj::ObjType::Array);
+            cppbase::IJsonObj::KvItem stItem;
+            EXPECT_EQ(lpDoc->GetItem(0, &stItem), 0);
+            EXPECT_EQ(stItem.nValue, iCount);
+        }
+        else
+        {
+            EXPECT_EQ(lpDoc->GetInt("id"), iCount);
+            EXPECT_EQ(strlen(lpDoc->GetString("s")), 2 + iCount % 40);
+        }
+        iCount++;
+    }
+    EXPECT_EQ(iCount, 5000);
+    EXPECT_EQ(lpDoc, nullptr);
+    EXPECT_EQ(lpStream->GetOffset(), strDocs.size());
+    EXPECT_EQ(lpStream->Next(&lpDoc), 0);
+    EXPECT_EQ(lpDoc, nullptr);
+
+    // a bad document fails alone, a bad top level ends the input
+    const char szBad[] = "{\"a\":1} {\"a\" 2}[3]  7 {}";
+    EXPECT_EQ(lpStream->OpenBuffer(szBad, strlen(szBad)), 0);
+    EXPECT_EQ(lpStream->Next(&lpDoc), 0);
+    EXPECT_EQ(lpDoc->GetInt("a"), 1);
+    EXPECT_EQ(lpStream->Next(&lpDoc), cppbase::ParseDataFialed);
+    EXPECT_EQ(lpStream->GetOffset(), 8);
+    EXPECT_EQ(lpStream->Next(&lpDoc), 0);
+    EXPECT_EQ(lpDoc->GetSize(), 1);
+    EXPECT_EQ(lpStream->Next(&lpDoc), cppbase::ParseDataFialed);
+    EXPECT_EQ(lpStream->GetOffset(), 20);
+    EXPECT_EQ(lpStream->Next(&lpDoc), cppbase::ParseDataFialed);
+
+    const char szCut[] = "[1] {\"a\":";
+    EXPECT_EQ(lpStream->OpenBuffer(szCut, strlen(szCut)), 0);
+    EXPECT_EQ(lpStream->Next(&lpDoc), 0);
+    EXPECT_EQ(lpStream->Next(&lpDoc), cppbase::ParseDataFialed);
+
+    char szFile[] = "/tmp/json_obj_unittest_XXXXXX";
+    auto iFd = mkstemp(szFile);
+    EXPECT_GE(iFd, 0);
+    const char szFileDocs[] = " {\"x\":[1,2]}[true]\n";
+    EXPECT_EQ(write(iFd, szFileDocs, strlen(szFileDocs)), ssize_t(strlen(szFileDocs)));
+    close(iFd);
+    EXPECT_EQ(lpStream->OpenFile(szFile), 0);
+    EXPECT_EQ(lpStream->Next(&lpDoc), 0);
+    EXPECT_STREQ(lpDoc->GetJsonStr(false), "{\"x\":[1,2]}");
+    EXPECT_EQ(lpStream->Next(&lpDoc), 0);
+    EXPECT_STREQ(lpDoc->GetJsonStr(false), "[true]");
+    EXPECT_EQ(lpStream->Next(&lpDoc), 0);
+    EXPECT_EQ(lpDoc, nullptr);
+    unlink(szFile);
+    EXPECT_EQ(lpStream->OpenFile("/nonexistent/file.json"), cppbase::OpenFileFailed);
+    EXPECT_EQ(lpStream->Next(&lpDoc), cppbase::InvaliadCall);
+    DeleteJsonDocStream(lpStream);
+}
+
+TEST(JsonObj, ClearAndPool)
+{
+    // documents of every kind are cleared and opened again
+    cppbase::IJsonObj *szJsonObj[] = {NewJsonObject(), NewArenaJsonObject(256), NewTapeJsonObject(),
+                                      NewLazyJsonObject(), NewParallelJsonObject(2)};
+    for (auto lpJsonObj : szJsonObj)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            std::string strJson = "{\"i\": " + std::to_string(i) + ", \"s\": \"" + std::string(100 * i, 'x') + "\"}";
+            EXPECT_EQ(lpJsonObj->OpenFromBuffer(strJson.c_str()), 0);
+            EXPECT_EQ(lpJsonObj->OpenFromBuffer("[1]"), cppbase::InvaliadCall);
+            EXPECT_EQ(lpJsonObj->GetInt("i"), i);
+            EXPECT_EQ(strlen(lpJsonObj->GetString("s")), 100 * i);
+            EXPECT_EQ(lpJsonObj->Clear(), 0);
+            EXPECT_EQ(lpJsonObj->GetType(), cppbase::IJsonObj::ObjType::Unknow);
+            EXPECT_EQ(lpJsonObj->OpenFromBuffer("[1, [2], {\"a\": 3}]"), 0);
+            EXPECT_EQ(lpJsonObj->GetSize(), 3);
+            EXPECT_EQ(lpJsonObj->GetObject(nullptr), nullptr);
+            EXPECT_EQ(lpJsonObj->Clear(), 0);
+        }
+        DeleteJsonObject(lpJsonObj);
+    }
+
+    // a node keeps its type, a document takes either
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer("{\"a\": {\"b\": 1}, \"c\": [1]}"), 0);
+    auto lpChild = lpJsonObj->GetObject("a");
+    EXPECT_EQ(lpChild->Clear(), 0);
+    EXPECT_EQ(lpChild->GetType(), cppbase::IJsonObj::ObjType::Object);
+    EXPECT_EQ(lpChild->AddInt("d", 2), 0);
+    EXPECT_STREQ(lpJsonObj->GetJsonStr(false), "{\"a\":{\"d\":2},\"c\":[1]}");
+    EXPECT_EQ(lpJsonObj->Clear(), 0);
+    EXPECT_EQ(lpJsonObj->Init(cppbase::IJsonObj::ObjType::Array), 0);
+    EXPECT_EQ(lpJsonObj->AddInt(nullptr, 1), 0);
+    EXPECT_STREQ(lpJsonObj->GetJsonStr(false), "[1]");
+    DeleteJsonObject(lpJsonObj);
+
+    auto lpTapeDoc = NewTapeJsonObject();
+    EXPECT_EQ(lpTapeDoc->OpenFromBuffer("{\"a\": [1]}"), 0);
+    EXPECT_EQ(lpTapeDoc->GetArray("a")->Clear(), cppbase::InvaliadCall);
+    DeleteJsonObject(lpTapeDoc);
+
+    // the pool hands back what the thread released, emptied
+    auto lpPooled = AcquireJsonObject();
+    ASSERT_NE(lpPooled, nullptr);
+    EXPECT_EQ(lpPooled->OpenFromBuffer("{\"a\": 1}"), 0);
+    ReleaseJsonObject(lpPooled);
+    auto lpAgain = AcquireJsonObject();
+    EXPECT_EQ(lpAgain, lpPooled);
+    EXPECT_EQ(lpAgain->GetType(), cppbase::IJsonObj::ObjType::Unknow);
+    EXPECT_EQ(lpAgain->OpenFromBuffer("[2]"), 0);
+    auto lpOther = AcquireJsonObject();
+    EXPECT_NE(lpOther, lpAgain);
+    ReleaseJsonObject(lpAgain);
+    ReleaseJsonObject(lpOther);
+    ReleaseJsonObject(NewJsonObject());
+    ReleaseJsonObject(nullptr);
+}
+
+TEST(JsonObj, BinaryFormats)
+{
+    using BinaryFormat = cppbase::IJsonObj::BinaryFormat;
+    const char *lpJson = "{\"i\":[0,-1,-33,127,300,-70000,4294967296,-9223372036854775807],\"d\":1.5,"
+                         "\"s\":\"a string longer than thirty-one bytes\",\"e\":\"\",\"n\":null,"
+                         "\"b\":[true,false],\"o\":{\"x\":{}}}";
+
+    // every kind of document converts both ways without a change
+    cppbase::IJsonObj *szJsonObj[] = {NewJsonObject(), NewArenaJsonObject(256), NewTapeJsonObject(),
+                                      NewLazyJsonObject()};
+    for (auto lpJsonObj : szJsonObj)
+    {
+        EXPECT_EQ(lpJsonObj->OpenFromBuffer(lpJson), 0);
+        for (auto eFormat : {BinaryFormat::MessagePack, BinaryFormat::Cbor})
+        {
+            uint64_t uLen = 0;
+            auto lpBinary = lpJsonObj->GetBinary(eFormat, &uLen);
+            ASSERT_NE(lpBinary, nullptr);
+            EXPECT_LT(uLen, strlen(lpJson));
+            std::string strBinary(lpBinary, uLen);
+
+            auto lpDecoded = NewArenaJsonObject(0);
+            EXPECT_EQ(lpDecoded->OpenFromBinary(strBinary.data(), strBinary.size(), eFormat), 0);
+            EXPECT_STREQ(lpDecoded->GetJsonStr(false), lpJson);
+            DeleteJsonObject(lpDecoded);
+        }
+        DeleteJsonObject(lpJsonObj);
+    }
+
+    // the bytes of {"a":1,"b":[true,null]} in either format
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBuffer("{\"a\":1,\"b\":[true,null]}"), 0);
+    uint64_t uLen = 0;
+    auto lpBinary = lpJsonObj->GetBinary(BinaryFormat::MessagePack, &uLen);
+    EXPECT_EQ(std::string(lpBinary, uLen), std::string("\x82\xa1" "a\x01\xa1" "b\x92\xc3\xc0", 9));
+    lpBinary = lpJsonObj->GetBinary(BinaryFormat::Cbor, &uLen);
+    EXPECT_EQ(std::string(lpBinary, uLen), std::string("\xa2\x61" "a\x01\x61" "b\x82\xf5\xf6", 9));
+    EXPECT_EQ(lpJsonObj->GetArray("b")->GetBinary(BinaryFormat::Cbor, nullptr), nullptr);
+    DeleteJsonObject(lpJsonObj);
+
+    // CBOR written by others: indefinite lengths, half floats, tags and
+    // undefined
+    const char szCbor[] = "\xbf\x61k\x7f\x62" "ab\x61" "c\xff\x61h\xf9\x3e\x00\x61t\xc1\x1a\x00\x00\x00\x01"
+                          "\x61u\xf7\x61" "a\x9f\x01\x02\xff\xff";
+    lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->OpenFromBinary(szCbor, sizeof(szCbor) - 1, BinaryFormat::Cbor), 0);
+    EXPECT_STREQ(lpJsonObj->GetJsonStr(false), "{\"k\":\"abc\",\"h\":1.5,\"t\":1,\"u\":null,\"a\":[1,2]}");
+    EXPECT_EQ(lpJsonObj->OpenFromBinary("\x90", 1, BinaryFormat::MessagePack), cppbase::InvaliadCall);
+    DeleteJsonObject(lpJsonObj);
+
+    // truncated, trailing, scalar roots, keys that are not strings, too deep
+    std::string strDeep(1100, '\x91');
+    std::pair<std::string, BinaryFormat> szBad[] = {
+        {std::string("\x82\xa1" "a\x01", 4), BinaryFormat::MessagePack},
+        {std::string("\x90\x90", 2), BinaryFormat::MessagePack},
+        {std::string("\x01", 1), BinaryFormat::MessagePack},
+        {std::string("\x81\x01\x01", 3), BinaryFormat::MessagePack},
+        {std::string("\x81\xa1" "a\xd4\x00\x00", 6), BinaryFormat::MessagePack},
+        {std::string("\xa1\x01\x01", 3), BinaryFormat::Cbor},
+        {std::string("\x82\x01\xff", 3), BinaryFormat::Cbor},
+        {std::string("\x9f\x01", 2), BinaryFormat::Cbor},
+        {strDeep + '\x90', BinaryFormat::MessagePack},
+    };
+    for (auto &bad : szBad)
+    {
+        lpJsonObj = NewJsonObject();
+        EXPECT_EQ(lpJsonObj->OpenFromBinary(bad.first.data(), bad.first.size(), bad.second), cppbase::ParseDataFialed);
+        DeleteJsonObject(lpJsonObj);
+    }
+
+    auto lpTapeDoc = NewTapeJsonObject();
+    EXPECT_EQ(lpTapeDoc->OpenFromBinary("\x90", 1, BinaryFormat::MessagePack), cppbase::InvaliadCall);
+    DeleteJsonObject(lpTapeDoc);
+}
+
+TEST(JsonObj, Snapshot)
+{
+    std::string strJson = "{\"i\":-7,\"d\":2.5,\"s\":\"" + std::string(40, 's') + "\",\"n\":null,\"b\":true,"
+                          "\"list\":[{\"k\":1},{\"k\":2},[],{}],\"keys\":{";
+    for (int i = 0; i < 1000; i++)
+    {
+        strJson += (i > 0 ? ",\"k" : "\"k") + std::to_string(i) + "\":" + std::to_string(i);
+    }
+    strJson += "}}";
+
+    char szFile[] = "/tmp/json_obj_unittest_XXXXXX";
+    auto iFd = mkstemp(szFile);
+    EXPECT_GE(iFd, 0);
+    close(iFd);
+
+    // any kind of document saves one, read back whole by a snapshot document
+    cppbase::IJsonObj *szJsonObj[] = {NewJsonObject(), NewArenaJsonObject(256), NewTapeJsonObject(),
+                                      NewLazyJsonObject()};
+    for (auto lpJsonObj : szJsonObj)
+    {
+        EXPECT_EQ(lpJsonObj->OpenFromBuffer(strJson.c_str()), 0);
+        EXPECT_EQ(lpJsonObj->SaveSnapshot(szFile), 0);
+        EXPECT_EQ(lpJsonObj->OpenSnapshot(szFile), cppbase::InvaliadCall);
+
+        auto lpSnapshot = NewSnapshotJsonObject();
+        EXPECT_EQ(lpSnapshot->OpenSnapshot(szFile), 0);
+        EXPECT_STREQ(lpSnapshot->GetJsonStr(false), strJson.c_str());
+        EXPECT_EQ(lpSnapshot->GetInt("i"), -7);
+        EXPECT_EQ(lpSnapshot->GetDouble("d"), 2.5);
+        EXPECT_TRUE(lpSnapshot->GetNull("n"));
+        EXPECT_TRUE(lpSnapshot->GetBool("b"));
+        EXPECT_EQ(lpSnapshot->GetType("s"), cppbase::IJsonObj::ObjType::String);
+        EXPECT_FALSE(lpSnapshot->IsExist("missing"));
+        auto lpKeys = lpSnapshot->GetObject("keys");
+        ASSERT_NE(lpKeys, nullptr);
+        EXPECT_EQ(lpKeys, lpSnapshot->GetObject(cppbase::IJsonObj::Key("keys")));
+        EXPECT_EQ(lpKeys->GetSize(), 1000);
+        for (int i = 0; i < 1000; i++)
+        {
+            EXPECT_EQ(lpKeys->GetInt(("k" + std::to_string(i)).c_str(), -1), i);
+        }
+
+        auto lpList = lpSnapshot->GetArray("list");
+        cppbase::IJsonObj::KvItem stItem;
+        EXPECT_EQ(lpList->GetItem(1, &stItem), 0);
+        EXPECT_EQ(stItem.lpObj->GetInt("k"), 2);
+        EXPECT_EQ(lpList->GetType(2), cppbase::IJsonObj::ObjType::Array);
+        uint32_t uCount = 0;
+        cppbase::IJsonObj::Cursor stCursor;
+        for (bool bMore = lpKeys->First(&stCursor, &stItem); bMore; bMore = lpKeys->Next(&stCursor, &stItem))
+        {
+            EXPECT_EQ(stItem.nValue, uCount++);
+        }
+        EXPECT_EQ(uCount, 1000);
+
+        // read-only, and opened once until cleared
+        EXPECT_EQ(lpSnapshot->AddInt("x", 1), cppbase::InvaliadCall);
+        EXPECT_EQ(lpKeys->AddInt("x", 1), cppbase::InvaliadCall);
+        EXPECT_EQ(lpSnapshot->OpenFromBuffer("{}"), cppbase::InvaliadCall);
+        EXPECT_EQ(lpSnapshot->OpenSnapshot(szFile), cppbase::InvaliadCall);
+        EXPECT_EQ(lpSnapshot->Clear(), 0);
+        EXPECT_EQ(lpSnapshot->GetType(), cppbase::IJsonObj::ObjType::Unknow);
+        EXPECT_EQ(lpSnapshot->OpenSnapshot(szFile), 0);
+
+        // a node of a snapshot saves its own, over the file it is mapped from
+        EXPECT_EQ(lpSnapshot->GetArray("list")->SaveSnapshot(szFile), 0);
+        EXPECT_EQ(lpSnapshot->GetInt("i"), -7);
+        DeleteJsonObject(lpSnapshot);
+        lpSnapshot = NewSnapshotJsonObject();
+        EXPECT_EQ(lpSnapshot->OpenSnapshot(szFile), 0);
+        EXPECT_STREQ(lpSnapshot->GetJsonStr(false), "[{\"k\":1},{\"k\":2},[],{}]");
+        DeleteJsonObject(lpSnapshot);
+        DeleteJsonObject(lpJsonObj);
+    }
+
+    // files that are not snapshots
+    auto lpFile = fopen(szFile, "w");
+    ASSERT_NE(lpFile, nullptr);
+    EXPECT_EQ(fwrite(strJson.data(), 1, strJson.size(), lpFile), strJson.size());
+    fclose(lpFile);
+    auto lpSnapshot = NewSnapshotJsonObject();
+    EXPECT_EQ(lpSnapshot->OpenSnapshot(szFile), cppbase::ParseDataFialed);
+    unlink(szFile);
+    EXPECT_EQ(lpSnapshot->OpenSnapshot(szFile), cppbase::OpenFileFailed);
+    EXPECT_EQ(lpSnapshot->SaveSnapshot(szFile), cppbase::InvaliadCall);
+    DeleteJsonObject(lpSnapshot);
+}
+
+namespace bind_test
+{
+
+struct Fill
+{
+    int32_t qty{0};
+    double price{0};
+};
+
+struct Order
+{
+    int64_t id{0};
+    std::string side;
+    bool active{false};
+    double price{0};
+    uint16_t qty{0};
+    std::vector<Fill> fills;
+    std::vector<std::vector<int32_t>> levels;
+    std::vector<std::string> tags;
+};
+
+CPPBASE_JSON_FIELDS(Fill, qty, price)
+CPPBASE_JSON_FIELDS(Order, id, side, active, price, qty, fills, levels, tags)
+
+}
+
+TEST(JsonObj, StructBinding)
+{
+    const char *lpJson = "{\"id\":42,\"unknown\":{\"a\":[1,{\"b\":2}]},\"side\":\"b\\\"uy\",\"active\":true,"
+                         "\"price\":12,\"qty\":300,\"fills\":[{\"qty\":1,\"price\":1.5,\"x\":null},{\"qty\":2}],"
+                         "\"levels\":[[1,2],[],[3]],\"tags\":[\"x\",\"y\"],\"more\":[[]]}";
+    bind_test::Order order;
+    order.fills.resize(5);
+    ASSERT_EQ(cppbase::ParseJsonStruct(lpJson, strlen(lpJson), order), 0);
+    EXPECT_EQ(order.id, 42);
+    EXPECT_EQ(order.side, "b\"uy");
+    EXPECT_TRUE(order.active);
+    EXPECT_EQ(order.price, 12.0);
+    EXPECT_EQ(order.qty, 300);
+    ASSERT_EQ(order.fills.size(), 2u);
+    EXPECT_EQ(order.fills[0].qty, 1);
+    EXPECT_EQ(order.fills[0].price, 1.5);
+    EXPECT_EQ(order.fills[1].qty, 2);
+    EXPECT_EQ(order.fills[1].price, 0.0);
+    ASSERT_EQ(order.levels.size(), 3u);
+    EXPECT_EQ(order.levels[0], std::vector<int32_t>({1, 2}));
+    EXPECT_TRUE(order.levels[1].empty());
+    EXPECT_EQ(order.tags, std::vector<std::string>({"x", "y"}));
+
+    // written in the order of the macro, and read back the same
+    std::string strJson;
+    cppbase::WriteJsonStruct(order, strJson);
+    EXPECT_EQ(strJson, "{\"id\":42,\"side\":\"b\\\"uy\",\"active\":true,\"price\":12.0,\"qty\":300,"
+                       "\"fills\":[{\"qty\":1,\"price\":1.5},{\"qty\":2,\"price\":0.0}],"
+                       "\"levels\":[[1,2],[],[3]],\"tags\":[\"x\",\"y\"]}");
+    bind_test::Order copy;
+    ASSERT_EQ(cppbase::ParseJsonStruct(strJson.c_str(), strJson.size(), copy), 0);
+    std::string strCopy;
+    cppbase::WriteJsonStruct(copy, strCopy);
+    EXPECT_EQ(strCopy, strJson);
+
+    // the same document as GetJsonStr writes
+    auto lpJsonObj = NewJsonObject();
+    ASSERT_EQ(lpJsonObj->OpenFromBuffer(strJson.c_str()), 0);
+    EXPECT_EQ(std::string(lpJsonObj->GetJsonStr(false)), strJson);
+    DeleteJsonObject(lpJsonObj);
+
+    // a top-level vector, and nulls leaving the members as they are
+    std::vector<bind_test::Fill> vecFills;
+    const char *lpFills = "[{\"qty\":7,\"price\":null},null,{}]";
+    ASSERT_EQ(cppbase::ParseJsonStruct(lpFills, strlen(lpFills), vecFills), 0);
+    ASSERT_EQ(vecFills.size(), 3u);
+    EXPECT_EQ(vecFills[0].qty, 7);
+    EXPECT_EQ(vecFills[1].qty, 0);
+    cppbase::WriteJsonStruct(vecFills, strJson);
+    EXPECT_EQ(strJson, "[{\"qty\":7,\"price\":0.0},{\"qty\":0,\"price\":0.0},{\"qty\":0,\"price\":0.0}]");
+
+    // parsed into again, the elements read over start from the defaults
+    const char *lpFewer = "[{\"price\":2}]";
+    ASSERT_EQ(cppbase::ParseJsonStruct(lpFewer, strlen(lpFewer), vecFills), 0);
+    ASSERT_EQ(vecFills.size(), 1u);
+    EXPECT_EQ(vecFills[0].qty, 0);
+    EXPECT_EQ(vecFills[0].price, 2.0);
+
+    // wrong types and numbers out of range fail; bad json fails as usual
+    const char *szBad[] = {"{\"id\":\"1\"}", "{\"qty\":70000}", "{\"qty\":-1}", "{\"id\":1.5}", "{\"side\":1}",
+                           "{\"fills\":{}}", "{\"fills\":[1]}", "[]", "{\"active\":1}"};
+    for (auto lpBad : szBad)
+    {
+        bind_test::Order bad;
+        EXPECT_EQ(cppbase::ParseJsonStruct(lpBad, strlen(lpBad), bad), cppbase::ParseDataFialed) << lpBad;
+    }
+    bind_test::Order bad;
+    EXPECT_NE(cppbase::ParseJsonStruct("{\"id\":1", 7, bad), 0);
+    EXPECT_EQ(bad.id, 1);
+
+    // NaN has no json form
+    bind_test::Fill fill;
+    fill.price = NAN;
+    cppbase::WriteJsonStruct(fill, strJson);
+    EXPECT_EQ(strJson, "{\"qty\":0,\"price\":null}");
+}
+
+TEST(JsonObj, LiteralKeys)
+{
+    static_assert(cppbase::IJsonObj::Key::ConstHash("price", 5) != cppbase::IJsonObj::Key::ConstHash("prica", 5),
+                  "the hash is computed at compile time");
+    constexpr cppbase::IJsonObj::Key stQty = JKEY("qty");
+    EXPECT_EQ(stQty.uLen, 3u);
+    EXPECT_EQ(stQty.uHash, cppbase::IJsonObj::Key("qty").uHash);
+    EXPECT_EQ(JKEY("").uHash, cppbase::IJsonObj::Key("").uHash);
+    EXPECT_EQ(JKEY("\xe9t\xe9").uHash, cppbase::IJsonObj::Key("\xe9t\xe9").uHash);
+
+    const char *lpJson = "{\"price\":12.5,\"qty\":300,\"big\":5000000000,\"ok\":true,\"name\":\"n\","
+                         "\"book\":{\"ts\":7},\"\":1}";
+    cppbase::IJsonObj *(*szNews[])() = {NewJsonObject, NewTapeJsonObject, NewLazyJsonObject};
+    for (auto lpNew : szNews)
+    {
+        auto lpJsonObj = lpNew();
+        ASSERT_EQ(lpJsonObj->OpenFromBuffer(lpJson), 0);
+        EXPECT_EQ(lpJsonObj->GetDouble(JKEY("price")), 12.5);
+        EXPECT_EQ(lpJsonObj->GetInt(stQty), 300);
+        EXPECT_EQ(lpJsonObj->GetInt(JKEY("")), 1);
+        EXPECT_EQ(lpJsonObj->GetObject(JKEY("book"))->GetInt(JKEY("ts")), 7);
+        EXPECT_FALSE(lpJsonObj->IsExist(JKEY("pric")));
+
+        // the typed getters
+        EXPECT_EQ(lpJsonObj->Get<double>(JKEY("price")), 12.5);
+        EXPECT_EQ(lpJsonObj->Get<float>(JKEY("price")), 12.5f);
+        EXPECT_EQ(lpJsonObj->Get<int32_t>(stQty), 300);
+        EXPECT_EQ(lpJsonObj->Get<uint16_t>(stQty), 300);
+        EXPECT_EQ(lpJsonObj->Get<int64_t>(JKEY("big")), 5000000000);
+        EXPECT_EQ(lpJsonObj->Get<double>(JKEY("qty")), 0.0);
+        EXPECT_TRUE(lpJsonObj->Get<bool>(JKEY("ok")));
+        EXPECT_STREQ(lpJsonObj->Get<const char *>(JKEY("name")), "n");
+        EXPECT_EQ(lpJsonObj->Get<const char *>(JKEY("none")), nullptr);
+        EXPECT_EQ(lpJsonObj->Get(JKEY("none"), -1), -1);
+        EXPECT_STREQ(lpJsonObj->Get(JKEY("none"), "d"), "d");
+        DeleteJsonObject(lpJsonObj);
+    }
+}
+
+TEST(JsonObj, View)
+{
+    std::string strJson = "{\"id\":42,\"price\":12.5,\"ok\":true,\"nil\":null,\"short\":\"abc\",";
+    strJson += "\"long\":\"a string longer than fourteen bytes\",\"tags\":[\"x\",2,[3]],\"book\":{\"ts\":7}";
+    for (int i = 0; i < 40; i++)
+    {
+        strJson += ",\"k" + std::to_string(i) + "\":" + std::to_string(i);
+    }
+    strJson += "}";
+
+    cppbase::IJsonObj *szDocs[] = {NewJsonObject(), NewArenaJsonObject(0), NewParallelJsonObject(2)};
+    std::string strInSitu = strJson;
+    ASSERT_EQ(szDocs[0]->OpenFromBuffer(strJson.c_str()), 0);
+    ASSERT_EQ(szDocs[1]->OpenFromBufferInSitu(&strInSitu[0], strInSitu.size()), 0);
+    ASSERT_EQ(szDocs[2]->OpenFromBuffer(strJson.c_str()), 0);
+    for (auto lpJsonObj : szDocs)
+    {
+        cppbase::CJsonView view(lpJsonObj);
+        ASSERT_TRUE(view.IsValid());
+        EXPECT_EQ(view.GetType(), cppbase::IJsonObj::ObjType::Object);
+        EXPECT_EQ(view.GetSize(), lpJsonObj->GetSize());
+        EXPECT_EQ(view.Get<int64_t>(JKEY("id")), 42);
+        EXPECT_EQ(view.Get<int32_t>(JKEY("id")), 42);
+        EXPECT_EQ(view.Get<double>(JKEY("price")), 12.5);
+        EXPECT_EQ(view.Get<int64_t>(JKEY("price"), -1), -1);
+        EXPECT_TRUE(view.Get<bool>(JKEY("ok")));
+        EXPECT_EQ(view.GetType(JKEY("nil")), cppbase::IJsonObj::ObjType::Null);
+        EXPECT_STREQ(view.Get<const char *>(JKEY("short")), "abc");
+        EXPECT_STREQ(view.Get<const char *>(JKEY("long")), "a string longer than fourteen bytes");
+        EXPECT_EQ(view.Get<const char *>(JKEY("missing")), nullptr);
+        EXPECT_FALSE(view.IsExist(JKEY("k40")));
+        EXPECT_EQ(view.GetType(JKEY("missing")), cppbase::IJsonObj::ObjType::Unknow);
+
+        // past 16 members objects are searched through their index
+        for (int i = 0; i < 40; i++)
+        {
+            auto strKey = "k" + std::to_string(i);
+            EXPECT_EQ(view.Get<int64_t>(cppbase::IJsonObj::Key(strKey.c_str()), -1), i) << strKey;
+        }
+
+        // members by position, and the nodes below
+        EXPECT_STREQ(view.GetKey(1), "price");
+        EXPECT_EQ(view.At<double>(1), 12.5);
+        EXPECT_EQ(view.GetKey(view.GetSize()), nullptr);
+        auto tags = view.Get<cppbase::CJsonView>(JKEY("tags"));
+        EXPECT_EQ(tags.GetType(), cppbase::IJsonObj::ObjType::Array);
+        ASSERT_EQ(tags.GetSize(), 3u);
+        EXPECT_STREQ(tags.At<const char *>(0), "x");
+        EXPECT_EQ(tags.At<int64_t>(1), 2);
+        EXPECT_EQ(tags.At<cppbase::CJsonView>(2).At<int64_t>(0), 3);
+        EXPECT_EQ(tags.GetKey(0), nullptr);
+        EXPECT_EQ(tags.At<int64_t>(3, -1), -1);
+        EXPECT_EQ(tags.Get<int64_t>(JKEY("x"), -1), -1);
+        EXPECT_EQ(view.Get<cppbase::CJsonView>(JKEY("book")).Get<int64_t>(JKEY("ts")), 7);
+        EXPECT_FALSE(view.Get<cppbase::CJsonView>(JKEY("id")).IsValid());
+
+        // a view follows the node as it changes
+        auto lpBook = lpJsonObj->GetObject(JKEY("book"));
+        EXPECT_EQ(lpBook->AddString("venue", "a venue name of some length"), 0);
+        EXPECT_STREQ(view.Get<cppbase::CJsonView>(JKEY("book")).Get<const char *>(JKEY("venue")),
+                     "a venue name of some length");
+        DeleteJsonObject(lpJsonObj);
+    }
+
+    // the read-only documents have their own layouts
+    auto lpTape = NewTapeJsonObject();
+    ASSERT_EQ(lpTape->OpenFromBuffer(strJson.c_str()), 0);
+    cppbase::CJsonView tape(lpTape);
+    EXPECT_FALSE(tape.IsValid());
+    EXPECT_EQ(tape.GetSize(), 0u);
+    EXPECT_EQ(tape.Get<int64_t>(JKEY("id"), -1), -1);
+    DeleteJsonObject(lpTape);
+    EXPECT_FALSE(cppbase::CJsonView(nullptr).IsValid());
+}
+
+TEST(JsonObj, Freeze)
+{
+    std::string strJson = "{\"name\":\"" + std::string(30, 'n') + "\",\"port\":8080,\"ratio\":0.5,\"on\":true,"
+                          "\"hosts\":[\"a\",\"b\",{\"x\":null}],\"limits\":{";
+    for (int i = 0; i < 100; i++)
+    {
+        strJson += (i > 0 ? ",\"l" : "\"l") + std::to_string(i) + "\":" + std::to_string(i);
+    }
+    strJson += "}}";
+
+    // any kind of document or node freezes into the same read-only copy
+    cppbase::IJsonObj *szJsonObj[] = {NewJsonObject(), NewArenaJsonObject(256), NewTapeJsonObject(),
+                                      NewLazyJsonObject()};
+    for (auto lpJsonObj : szJsonObj)
+    {
+        ASSERT_EQ(lpJsonObj->OpenFromBuffer(strJson.c_str()), 0);
+        auto lpFrozen = lpJsonObj->Freeze();
+        ASSERT_NE(lpFrozen, nullptr);
+        DeleteJsonObject(lpJsonObj);
+
+        EXPECT_STREQ(lpFrozen->GetJsonStr(false), strJson.c_str());
+        EXPECT_EQ(lpFrozen->Get<int32_t>(JKEY("port")), 8080);
+        EXPECT_EQ(lpFrozen->GetDouble("ratio"), 0.5);
+        EXPECT_TRUE(lpFrozen->GetBool("on"));
+        EXPECT_FALSE(lpFrozen->IsExist("missing"));
+        auto lpHosts = lpFrozen->GetArray("hosts");
+        ASSERT_NE(lpHosts, nullptr);
+        EXPECT_EQ(lpHosts->GetSize(), 3);
+        cppbase::IJsonObj::KvItem stItem;
+        EXPECT_EQ(lpHosts->GetItem(2, &stItem), 0);
+        EXPECT_TRUE(stItem.lpObj->GetNull("x"));
+
+        // nothing changes it
+        EXPECT_EQ(lpFrozen->AddInt("port", 1), cppbase::InvaliadCall);
+        EXPECT_EQ(lpFrozen->AddObject("o"), nullptr);
+        EXPECT_EQ(lpHosts->AddString(nullptr, "c"), cppbase::InvaliadCall);
+        EXPECT_EQ(lpFrozen->OpenFromBuffer("{}"), cppbase::InvaliadCall);
+        EXPECT_EQ(lpFrozen->Clear(), cppbase::InvaliadCall);
+        EXPECT_EQ(lpFrozen->GetInt("port"), 8080);
+
+        auto lpLimits = lpFrozen->GetObject("limits");
+        auto lpCopy = lpLimits->Freeze();
+        ASSERT_NE(lpCopy, nullptr);
+        EXPECT_EQ(lpCopy->GetSize(), 100);
+        EXPECT_EQ(lpCopy->GetInt("l99"), 99);
+        DeleteJsonObject(lpCopy);
+
+        // readers on many threads at once, without locks
+        std::vector<std::thread> vecThreads;
+        std::vector<int64_t> vecSums(8, 0);
+        for (uint32_t t = 0; t < vecSums.size(); t++)
+        {
+            vecThreads.emplace_back([lpFrozen, &vecSums, t]() {
+                for (int n = 0; n < 50; n++)
+                {
+                    auto lpObj = lpFrozen->GetObject(JKEY("limits"));
+                    for (int i = 0; i < 100; i++)
+                    {
+                        vecSums[t] += lpObj->GetInt(("l" + std::to_string(i)).c_str());
+                    }
+                    vecSums[t] += lpFrozen->GetArray("hosts")->GetSize();
+                }
+            });
+        }
+        for (auto &thread : vecThreads)
+        {
+            thread.join();
+        }
+        for (auto nSum : vecSums)
+        {
+            EXPECT_EQ(nSum, 50 * (4950 + 3));
+        }
+        DeleteJsonObject(lpFrozen);
+    }
+
+    auto lpJsonObj = NewJsonObject();
+    EXPECT_EQ(lpJsonObj->Freeze(), nullptr);
+    DeleteJsonObject(lpJsonObj);
+}
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);